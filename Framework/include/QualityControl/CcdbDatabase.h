@@ -18,8 +18,11 @@
 #define QC_REPOSITORY_CCDBDATABASE_H
 
 #include "QualityControl/DatabaseInterface.h"
+#include "QualityControl/RetrievalCache.h"
+#include "QualityControl/CcdbListingReader.h"
 #include <Common/Timer.h>
 #include <boost/property_tree/ptree.hpp>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -28,6 +31,11 @@ namespace o2::ccdb
 class CcdbApi;
 }
 
+namespace o2::quality_control::core
+{
+class ThreadPool;
+}
+
 namespace o2::quality_control::repository
 {
 
@@ -68,6 +76,8 @@ class CcdbDatabase : public DatabaseInterface
   void storeMO(std::shared_ptr<const o2::quality_control::core::MonitorObject> q, long from = -1, long to = -1) override;
   void storeQO(std::shared_ptr<const o2::quality_control::core::QualityObject> q, long from = -1, long to = -1) override;
   void storeTRFC(std::shared_ptr<const o2::quality_control::TimeRangeFlagCollection> trfc) override;
+  /// \brief Stores a TimeRangeFlagCollection with additional metadata, e.g. the state needed to resume its production.
+  void storeTRFC(std::shared_ptr<const o2::quality_control::TimeRangeFlagCollection> trfc, const std::map<std::string, std::string>& additionalMetadata);
   void storeAny(const void* obj, std::type_info const& typeInfo, std::string const& path, std::map<std::string, std::string> const& metadata,
                 std::string const& detectorName, std::string const& taskName, long from = -1, long to = -1) override;
 
@@ -77,12 +87,27 @@ class CcdbDatabase : public DatabaseInterface
                     const std::string& createdNotAfter = "", const std::string& createdNotBefore = "") override;
 
   // retrieval - MO - deprecated
+  /// \brief Retrieves a MonitorObject.
+  /// If the retrieval cache is enabled ("retrievalCacheMaxBytes" in the database configuration), the object is downloaded
+  /// only if it changed since it was retrieved with the same arguments. Otherwise, the same instance is returned again,
+  /// thus the returned objects should not be modified.
   std::shared_ptr<o2::quality_control::core::MonitorObject> retrieveMO(std::string objectPath, std::string objectName, long timestamp = -1, const core::Activity& activity = {}) override;
   // retrieval - QO - deprecated
+  /// \brief Retrieves a QualityObject. The retrieval cache is used as for retrieveMO.
   std::shared_ptr<o2::quality_control::core::QualityObject> retrieveQO(std::string qoPath, long timestamp = -1, const core::Activity& activity = {}) override;
+  /// \brief Retrieves the MOs concurrently, with up to "retrievalThreads" requests in flight (1 by default, sequential).
+  std::vector<std::shared_ptr<o2::quality_control::core::MonitorObject>> retrieveMOs(const std::vector<MORequest>& requests) override;
+  /// \brief Retrieves the QOs concurrently, with up to "retrievalThreads" requests in flight (1 by default, sequential).
+  std::vector<std::shared_ptr<o2::quality_control::core::QualityObject>> retrieveQOs(const std::vector<QORequest>& requests) override;
   std::shared_ptr<o2::quality_control::TimeRangeFlagCollection> retrieveTRFC(const std::string& name, const std::string& detector, int runNumber = 0,
                                                                              const std::string& passName = "", const std::string& periodName = "",
                                                                              const std::string& provenance = "", long timestamp = -1) override;
+  /// \brief Retrieves a TimeRangeFlagCollection as the other overload and fills the headers with its metadata.
+  /// The headers are left empty if there is no such collection, which is not reported as an error.
+  std::shared_ptr<o2::quality_control::TimeRangeFlagCollection> retrieveTRFC(const std::string& name, const std::string& detector, int runNumber,
+                                                                             const std::string& passName, const std::string& periodName,
+                                                                             const std::string& provenance, long timestamp,
+                                                                             std::map<std::string, std::string>& headers);
 
   // retrieval - general
   std::string retrieveJson(std::string path, long timestamp, const std::map<std::string, std::string>& metadata) override;
@@ -105,19 +130,46 @@ class CcdbDatabase : public DatabaseInterface
   /**
    * Return the listing of folder and/or objects in the subpath
    * @param path the folder we want to list the children of.
+   * @param createdNotBefore if not negative, only the objects created at this time (ms since epoch) or later are listed.
    * @return The list of folder and/or objects as Ptree
    */
-  boost::property_tree::ptree getListingAsPtree(const std::string& path); // TODO allow to filter by metadata
+  boost::property_tree::ptree getListingAsPtree(const std::string& path, long createdNotBefore = -1); // TODO allow to filter by metadata
+
+  /// One day, i.e. about a thousand versions of an object stored at each cycle.
+  static constexpr long sListingWindowDuration = 24 * 3600 * 1000;
+
+  /**
+   * \brief Reads the listing of the objects in the path one by one, without building it in memory.
+   * Only the requested keys of each object are extracted, see CcdbListingReader. The objects come from the newest to
+   * the oldest. The listing is requested in consecutive windows of creation time, see CcdbListingReader::readInWindows,
+   * thus a long history is never held in memory at once and no more windows are requested once the callback stopped.
+   * @param path the folder we want to list the objects of.
+   * @param keys the keys to extract, e.g. metadata_keys::validFrom or "path".
+   * @param callback called for each object, it can return false to stop the reading.
+   * @param createdNotBefore if not negative, only the objects created at this time (ms since epoch) or later are listed.
+   * @param createdNotAfter if not negative, only the objects created at this time (ms since epoch) or earlier are listed.
+   * @param windowDuration the duration of the first window (ms), the listing is requested at once if it is not positive.
+   * @return The number of objects which were read.
+   */
+  size_t forEachListedObject(const std::string& path, const std::vector<std::string>& keys, const CcdbListingReader::Callback& callback,
+                             long createdNotBefore = -1, long createdNotAfter = -1, long windowDuration = sListingWindowDuration);
 
   /**
    * \brief Returns a vector of all 'valid from' timestamps for an object.
    * \path Path on an object.
+   * \param createdNotBefore if not negative, only the versions created at this time (ms since epoch) or later are considered.
+   * \param createdNotAfter if not negative, only the versions created at this time (ms since epoch) or earlier are considered.
    * \return A vector of all 'valid from' timestamps for an object in non-descending order.
    */
-  std::vector<uint64_t> getTimestampsForObject(const std::string& path);
+  std::vector<uint64_t> getTimestampsForObject(const std::string& path, long createdNotBefore = -1, long createdNotAfter = -1);
 
   void setMaxObjectSize(size_t maxObjectSize) override;
 
+  /// \brief Enables the cache used by retrieveMO and retrieveQO, or disables it if maxBytes is 0.
+  void setRetrievalCacheSize(size_t maxBytes);
+  /// Returns the hits, misses and bytes saved by the retrieval cache, all zero if it is disabled.
+  RetrievalCache::Statistics getRetrievalCacheStatistics() const;
+
  private:
   /**
    * \brief Load StreamerInfos from a ROOT file.
@@ -132,9 +184,11 @@ class CcdbDatabase : public DatabaseInterface
    * Return the listing of folder and/or objects in the subpath.
    * @param subpath The folder we want to list the children of.
    * @param accept The format of the returned string as an \"Accept\", i.e. text/plain, application/json, text/xml
+   * @param createdNotBefore if not negative, only the objects created at this time (ms since epoch) or later are listed.
+   * @param createdNotAfter if not negative, only the objects created at this time (ms since epoch) or earlier are listed.
    * @return The listing of folder and/or objects in the format requested and as returned by the http server.
    */
-  std::string getListingAsString(const std::string& subpath = "", const std::string& accept = "text/plain");
+  std::string getListingAsString(const std::string& subpath = "", const std::string& accept = "text/plain", long createdNotBefore = -1, long createdNotAfter = -1);
 
   /**
    * Takes care of the possible errors returned by the storage calls.
@@ -159,12 +213,30 @@ class CcdbDatabase : public DatabaseInterface
    */
   static void addFrameworkMetadata(std::map<std::string, std::string>& fullMetadata, std::string detectorName, std::string className);
 
+  /// Calls retrieve(i) for each i in [0, n), concurrently if "retrievalThreads" > 1, with a pool created on first use.
+  /// An exception thrown by a call is logged and leaves the corresponding result empty.
+  void retrieveConcurrently(size_t n, const std::function<void(size_t)>& retrieve);
+
+  /**
+   * Retrieves an object through the retrieval cache, revalidating the cached version with its ETag.
+   * @param path
+   * @param metadata
+   * @param timestamp
+   * @param build Creates the object to return (and to cache) out of the downloaded one and its headers,
+   *              it is also called with nullptr if nothing could be retrieved.
+   */
+  std::shared_ptr<TObject> retrieveCached(const std::string& path, const std::map<std::string, std::string>& metadata, long timestamp,
+                                          const std::function<std::shared_ptr<TObject>(TObject*, std::map<std::string, std::string>&)>& build);
+
   std::unique_ptr<o2::ccdb::CcdbApi> ccdbApi;
   std::string mUrl;
   size_t mMaxObjectSize = 2097152; // 2MB by default
   int mFailureDelay = 60;          // 60 seconds delay between attempts to store things in the database
   bool mDatabaseFailure = false;
   AliceO2::Common::Timer mFailureTimer;
+  std::shared_ptr<RetrievalCache> mRetrievalCache; // nullptr if disabled
+  size_t mRetrievalThreads = 1; // no concurrency unless configured
+  std::shared_ptr<core::ThreadPool> mRetrievalPool;
 };
 
 } // namespace o2::quality_control::repository
@@ -0,0 +1,74 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CcdbListingReader.h
+///
+
+#ifndef QC_REPOSITORY_CCDBLISTINGREADER_H
+#define QC_REPOSITORY_CCDBLISTINGREADER_H
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace o2::quality_control::repository
+{
+
+/// \brief Streaming reader of the JSON listings returned by the CCDB.
+///
+/// The listing is parsed with the SAX interface of rapidjson, thus no document is built in memory. Only the requested
+/// keys of the entries of the "objects" array are extracted, all the other keys and the nested values are skipped.
+/// Numbers are provided in their textual form, as are strings.
+class CcdbListingReader
+{
+ public:
+  /// The values of the requested keys, in the order of the keys. A value is empty if the key is absent.
+  using Entry = std::vector<std::string>;
+  /// Called for each entry, it can return false to stop reading the listing.
+  using Callback = std::function<bool(const Entry&)>;
+  /// Returns the listing of the objects created between the two times (ms since epoch, inclusive, -1 for no limit).
+  using ListingGetter = std::function<std::string(long createdNotBefore, long createdNotAfter)>;
+
+  /// The size of the windows is adapted so that they contain about this number of entries.
+  static constexpr size_t sTargetEntriesPerWindow = 1000;
+
+  explicit CcdbListingReader(std::vector<std::string> keys);
+  ~CcdbListingReader() = default;
+
+  /// \brief Calls the callback for each entry of "objects", in the order of the listing.
+  /// Returns the number of entries which were read. Throws std::runtime_error if the listing is not valid JSON.
+  size_t read(const std::string& listing, const Callback& callback) const;
+
+  /// \brief Reads the listing in consecutive windows of creation time, from the newest to the oldest.
+  /// The CCDB cannot split a listing otherwise, thus only one window is held in memory at a time and no more windows
+  /// are requested once the callback stopped the reading. The entries come in the same order as in a single listing.
+  /// The first window lasts windowDuration ms, the next ones are doubled after a window with few entries and halved
+  /// after one with many, so that the sparse parts of the history take few requests. Without createdNotBefore,
+  /// the windows go back to the epoch. Without createdNotAfter, the newest window is not bounded, in case the clock
+  /// of the server is ahead, and the windows are counted from now. If windowDuration is not positive, the listing
+  /// is requested at once. Returns the number of entries which were read.
+  size_t readInWindows(const ListingGetter& getListing, const Callback& callback, long createdNotBefore, long createdNotAfter,
+                       long windowDuration, long now) const;
+
+  /// Returns the keys and the values of an entry, the absent keys are omitted.
+  std::map<std::string, std::string> asMetadata(const Entry& entry) const;
+
+  const std::vector<std::string>& getKeys() const { return mKeys; }
+
+ private:
+  std::vector<std::string> mKeys;
+};
+
+} // namespace o2::quality_control::repository
+
+#endif // QC_REPOSITORY_CCDBLISTINGREADER_H
@@ -61,7 +61,23 @@ class Check
    */
   void init();
 
-  core::QualityObjectsType check(std::map<std::string, std::shared_ptr<o2::quality_control::core::MonitorObject>>& moMap);
+  using MonitorObjectsMap = std::map<std::string, std::shared_ptr<o2::quality_control::core::MonitorObject>>;
+
+  /// \brief Runs the check on the relevant MOs of the map and beautifies them.
+  /// It is equivalent to calling evaluate() and beautify() on each of the inputs returned by prepareInputs().
+  core::QualityObjectsType check(MonitorObjectsMap& moMap);
+
+  /// \brief Selects the MOs this check should look at and groups them by the QualityObject they will produce.
+  /// There is one group, unless the update policy is OnEachSeparately, in which case there is one group per MO.
+  std::vector<MonitorObjectsMap> prepareInputs(const MonitorObjectsMap& moMap) const;
+  /// \brief Runs the user check on one group of MOs and returns the resulting QualityObject.
+  /// Returns nullptr if the group could not be checked. MOs are not modified.
+  /// Concurrent calls on the same Check are allowed only if isReentrant() is true.
+  std::shared_ptr<core::QualityObject> evaluate(MonitorObjectsMap& moMapToCheck);
+  /// \brief Applies the user beautification on the MOs, unless it is disabled for this check.
+  void beautify(MonitorObjectsMap& moMap, const core::Quality& quality);
+  /// \brief Returns true if the underlying CheckInterface declared its check() and beautify() reentrant.
+  bool isReentrant() const;
 
   const std::string& getName() const { return mCheckConfig.name; };
   o2::framework::OutputSpec getOutputSpec() const { return mCheckConfig.qoSpec; };
@@ -82,8 +98,6 @@ class Check
   static framework::OutputSpec createOutputSpec(const std::string& checkName);
 
  private:
-  void beautify(std::map<std::string, std::shared_ptr<core::MonitorObject>>& moMap, const core::Quality& quality);
-
   CheckConfig mCheckConfig;
   CheckInterface* mCheckInterface = nullptr;
 };
@@ -70,6 +70,18 @@ class CheckInterface : public UserCodeInterface
   /// \author Barthelemy von Haller
   virtual std::string getAcceptedType();
 
+  /// \brief Declares whether check() and beautify() can be called concurrently on this instance.
+  ///
+  /// When the parallel evaluation of checks is enabled in the CheckRunner, the MOs with the policy OnEachSeparately
+  /// are checked in parallel by the same instance if this method returns true. Return true only if check() does not
+  /// modify any member of the class (or protects it) and does not rely on the order of the calls.
+  /// Regardless of this flag, in parallel mode:
+  /// - check() might run at the same time as the check() of other Checks looking at the same MOs, thus it must not
+  ///   modify the MOs,
+  /// - beautify() is always called from one thread, after all the checks of the cycle are done.
+  /// Returns false by default.
+  virtual bool isReentrant() const { return false; }
+
   void setActivity(std::shared_ptr<core::Activity> activity) { mActivity = activity; }
   std::shared_ptr<const core::Activity> getActivity() const { return mActivity; }
 
@@ -40,11 +40,13 @@
 namespace o2::quality_control::core
 {
 class ServiceDiscovery;
+class ThreadPool;
 }
 
 namespace o2::quality_control::repository
 {
 class DatabaseInterface;
+class StorageQueue;
 }
 
 namespace o2::framework
@@ -133,6 +135,8 @@ class CheckRunner : public framework::Task
   static std::string getDetectorName(const std::vector<CheckConfig> checks);
 
  private:
+  using MonitorObjectsMap = std::map<std::string, std::shared_ptr<MonitorObject>>;
+
   /**
    * \brief Evaluate the quality of a MonitorObject.
    *
@@ -145,8 +149,17 @@ class CheckRunner : public framework::Task
    */
   QualityObjectsType check();
 
+  /**
+   * \brief Evaluates the checks with the thread pool.
+   *
+   * The user checks are run in parallel, then the beautification is done sequentially.
+   * QualityObjects are returned in the same order as in the sequential mode.
+   */
+  QualityObjectsType checkInParallel(const std::vector<Check*>& checks);
+
   /**
    * \brief Store the QualityObjects in the database.
+   * If asynchronous storage is enabled, the objects are only put in the storage queue.
    *
    * @param qualityObjects QOs to be stored in DB.
    */
@@ -200,6 +213,8 @@ class CheckRunner : public framework::Task
    * @param ctx
    */
   void prepareCacheData(framework::InputRecord& inputRecord);
+  /// Returns the entry of mMonitorObjects for the object ID, it is created for the first object with this ID.
+  MonitorObjectsMap::iterator getMonitorObjectSlot(ObjectIdType objectId, const std::shared_ptr<MonitorObject>& mo);
   /**
    * Send metrics to the monitoring system if the time has come.
    */
@@ -218,21 +233,27 @@ class CheckRunner : public framework::Task
   // General state
   std::string mDeviceName;
   std::map<std::string, Check> mChecks;
+  std::vector<Check*> mChecksByActorId; // the checks indexed by their actor ID in updatePolicyManager
   std::string mDetectorName;
   std::shared_ptr<Activity> mActivity;
   CheckRunnerConfig mConfig;
   std::shared_ptr<o2::quality_control::repository::DatabaseInterface> mDatabase;
+  std::shared_ptr<o2::quality_control::repository::StorageQueue> mStorageQueue; // set only if asynchronous storage is enabled
   std::unordered_set<std::string> mInputStoreSet;
   std::vector<std::shared_ptr<MonitorObject>> mMonitorObjectStoreVector;
   UpdatePolicyManager updatePolicyManager;
   bool mReceivedEOS = false;
+  std::shared_ptr<ThreadPool> mThreadPool; // set only if the checks are evaluated in parallel
 
   // DPL
   o2::framework::Inputs mInputs;
   o2::framework::Outputs mOutputs;
 
   // Checks cache
-  std::map<std::string, std::shared_ptr<MonitorObject>> mMonitorObjects;
+  MonitorObjectsMap mMonitorObjects;
+  // Entries of mMonitorObjects indexed by the object IDs of updatePolicyManager, mMonitorObjects.end() if not known yet.
+  // The received objects are stored there without looking up their names in mMonitorObjects.
+  std::vector<MonitorObjectsMap::iterator> mMonitorObjectSlots;
 
   // Service discovery
   std::shared_ptr<ServiceDiscovery> mServiceDiscovery;
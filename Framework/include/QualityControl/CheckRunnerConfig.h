@@ -33,6 +33,7 @@ struct CheckRunnerConfig {
   core::DiscardFileParameters infologgerDiscardParameters;
   core::Activity fallbackActivity;
   framework::Options options{};
+  size_t threads = 1; // number of threads evaluating the checks, 1 means no parallelism
 };
 
 } // namespace o2::quality_control::checker
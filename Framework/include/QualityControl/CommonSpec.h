@@ -40,6 +40,9 @@ struct CommonSpec {
   DiscardFileParameters infologgerDiscardParameters;
   double postprocessingPeriod = 10.0;
   std::string bookkeepingUrl;
+  size_t checkRunnerThreads = 1;
+  size_t taskExecutorCoresPerNode = 0; // 0 means no limit
+  bool taskExecutorPinThreads = false;
 };
 
 } // namespace o2::quality_control::core
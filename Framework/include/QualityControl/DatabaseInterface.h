@@ -150,6 +150,34 @@ class DatabaseInterface
    * @deprecated
    */
   virtual std::shared_ptr<o2::quality_control::core::QualityObject> retrieveQO(std::string qoPath, long timestamp = -1, const core::Activity& activity = {}) = 0;
+
+  /// Arguments of retrieveMO, used to ask for several objects at once.
+  struct MORequest {
+    std::string objectPath;
+    std::string objectName;
+    long timestamp = -1;
+    core::Activity activity = {};
+  };
+  /// Arguments of retrieveQO, used to ask for several objects at once.
+  struct QORequest {
+    std::string qoPath;
+    long timestamp = -1;
+    core::Activity activity = {};
+  };
+  /**
+   * \brief Look up several monitor objects at once.
+   * The implementations may retrieve them concurrently. The results are in the same order as the requests.
+   * If an object cannot be retrieved, its result is nullptr and the other ones are still returned.
+   * @param requests The arguments of retrieveMO for each object.
+   */
+  virtual std::vector<std::shared_ptr<o2::quality_control::core::MonitorObject>> retrieveMOs(const std::vector<MORequest>& requests) = 0;
+  /**
+   * \brief Look up several quality objects at once.
+   * The implementations may retrieve them concurrently. The results are in the same order as the requests.
+   * If an object cannot be retrieved, its result is nullptr and the other ones are still returned.
+   * @param requests The arguments of retrieveQO for each object.
+   */
+  virtual std::vector<std::shared_ptr<o2::quality_control::core::QualityObject>> retrieveQOs(const std::vector<QORequest>& requests) = 0;
   /**
    * \brief Look up a TimeRangeFlagCollection object and return it.
    * Look up a TimeRangeFlagCollection and return it if found or nullptr if not.
@@ -39,6 +39,8 @@ class DummyDatabase : public DatabaseInterface
   // QualityObject
   void storeQO(std::shared_ptr<const o2::quality_control::core::QualityObject> q, long from, long to) override;
   std::shared_ptr<o2::quality_control::core::QualityObject> retrieveQO(std::string checkerName, long timestamp = -1, const core::Activity& activity = {}) override;
+  std::vector<std::shared_ptr<o2::quality_control::core::MonitorObject>> retrieveMOs(const std::vector<MORequest>& requests) override;
+  std::vector<std::shared_ptr<o2::quality_control::core::QualityObject>> retrieveQOs(const std::vector<QORequest>& requests) override;
   // TRFC
   void storeTRFC(std::shared_ptr<const o2::quality_control::TimeRangeFlagCollection> trfc) override;
   std::shared_ptr<o2::quality_control::TimeRangeFlagCollection> retrieveTRFC(const std::string& name, const std::string& detector, int runNumber = 0,
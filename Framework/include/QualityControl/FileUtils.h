@@ -0,0 +1,33 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   FileUtils.h
+///
+
+#ifndef QC_FILE_UTILS_H
+#define QC_FILE_UTILS_H
+
+#include <string>
+
+namespace o2::quality_control::core
+{
+
+/// \brief Replaces the file at path with the complete file at temporaryPath, in a way which survives a crash.
+/// The temporary file is synced before the rename, otherwise a power loss could leave an empty file under the name of
+/// the previous one, and the directory is synced after it, so that the rename itself is not lost.
+/// Returns false and sets errno if the temporary file could not be synced, in which case nothing is renamed.
+/// A failure to sync the directory is only logged, the file is complete anyway.
+bool replaceFileDurably(const std::string& temporaryPath, const std::string& path);
+
+} // namespace o2::quality_control::core
+
+#endif // QC_FILE_UTILS_H
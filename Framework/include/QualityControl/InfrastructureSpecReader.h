@@ -78,6 +78,10 @@ std::vector<T> readSectionSpec(const boost::property_tree::ptree& wholeTree, con
 
 std::string validateDetectorName(std::string name);
 
+/// \brief Scales down the executor threads of the tasks so that they fit in "taskExecutor.coresPerNode", if it is set.
+/// Then it gives each active task a disjoint range of CPUs, used if the executor threads are pinned.
+void applyTaskExecutorBudget(InfrastructureSpec& spec);
+
 } // namespace InfrastructureSpecReader
 } // namespace o2::quality_control::core
 
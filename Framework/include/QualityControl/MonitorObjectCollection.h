@@ -18,12 +18,18 @@
 #define QUALITYCONTROL_MONITOROBJECTCOLLECTION_H
 
 #include <string>
+#include <unordered_map>
 #include <TObjArray.h>
 #include <Mergers/MergeInterface.h>
 
 namespace o2::quality_control::core
 {
 
+/// \brief A collection of MonitorObjects which can be merged with the Mergers.
+///
+/// The objects are matched by name when merging. The positions of the names are kept in a hash map, built in
+/// postDeserialization() or by the first merge, so that merging two collections of N objects costs O(N) lookups
+/// instead of the O(N^2) of FindObject().
 class MonitorObjectCollection : public TObjArray, public mergers::MergeInterface
 {
  public:
@@ -38,7 +44,15 @@ class MonitorObjectCollection : public TObjArray, public mergers::MergeInterface
   const std::string& getDetector() const;
 
  private:
+  /// Returns the position of the first object with this name, -1 if there is none, as FindObject() would.
+  /// The index is rebuilt when the number of entries changed since it was built or when it points to another object,
+  /// which covers adding and removing objects. Objects replaced in place with AddAt() might be missed.
+  Int_t findIndex(const char* name);
+  void buildIndex();
+
   std::string mDetector = "TST";
+  std::unordered_map<std::string, Int_t> mIndex; //! object names to their positions
+  Int_t mIndexedEntries = -1;                    //! GetEntriesFast() when mIndex was built, -1 if never built
 
   ClassDefOverride(MonitorObjectCollection, 1);
 };
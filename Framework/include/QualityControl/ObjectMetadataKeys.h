@@ -35,6 +35,7 @@ constexpr auto qcTaskClass = "qc_task_class";
 constexpr auto qcQuality = "qc_quality";
 constexpr auto qcCheckName = "qc_check_name";
 constexpr auto qcTRFCName = "qc_trfc_name";
+constexpr auto qcTRFCWatermarks = "qc_trfc_watermarks";
 constexpr auto qcAdjustableEOV = "adjustableEOV"; // this is a keyword for the CCDB
 // QC Activity
 constexpr auto runType = "RunType";
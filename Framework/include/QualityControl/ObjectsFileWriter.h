@@ -0,0 +1,123 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ObjectsFileWriter.h
+///
+
+#ifndef QC_CORE_OBJECTSFILEWRITER_H
+#define QC_CORE_OBJECTSFILEWRITER_H
+
+#include "QualityControl/ObjectsManager.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TObject;
+class TBufferFile;
+
+namespace o2::quality_control::core
+{
+
+/// \brief Saves snapshots of the objects of a task to a ROOT file in the background.
+///
+/// save() serializes the objects in the calling thread, so that the caller is free to modify them afterwards, and
+/// hands the snapshot to a writer thread. The writer fills a temporary file next to the destination and renames it
+/// once it is complete and synced (see replaceFileDurably), so that the destination is always either the previous or
+/// the new complete file, also after a crash of the machine.
+/// The objects are compared once serialized with their previous version and a snapshot in which nothing changed is not
+/// written at all. If trustFingerprints is set, histograms whose fingerprint (see ObjectsManager::computeFingerprint)
+/// did not change are not even serialized again, as with TaskRunnerConfig::skipUnchangedObjects. Changes which do not
+/// affect the statistics, e.g. of the title or the labels, are then not noticed. A snapshot still waiting to be written
+/// is replaced by a newer one.
+class ObjectsFileWriter
+{
+ public:
+  struct Stats {
+    uint64_t written = 0;       // snapshots written to the file
+    uint64_t skipped = 0;       // snapshots not written because nothing changed
+    uint64_t coalesced = 0;     // snapshots replaced by a newer one before being written
+    uint64_t failed = 0;        // snapshots which could not be written
+    size_t bytesWritten = 0;    // size of the last file written
+    size_t bytesSerialized = 0; // serialized by the last call to save(), only the changed objects are serialized
+    double lastLatencyMs = 0;   // from the snapshot until the last file was renamed
+    double meanLatencyMs = 0;
+  };
+
+  explicit ObjectsFileWriter(std::string filePath, bool trustFingerprints = false);
+  /// Stops the writer thread, the pending snapshot is written first.
+  ~ObjectsFileWriter();
+
+  ObjectsFileWriter(const ObjectsFileWriter&) = delete;
+  ObjectsFileWriter& operator=(const ObjectsFileWriter&) = delete;
+
+  /// \brief Takes a snapshot of the objects and queues it for writing.
+  /// The objects are written with their names as keys. Returns false if nothing changed since the previous call,
+  /// in which case the file is left as it is.
+  bool save(const std::vector<const TObject*>& objects);
+
+  /// Blocks until the pending snapshot is written.
+  void flush();
+
+  /// \brief Returns the counters accumulated so far.
+  /// The mean latency is reset at each call, the other counters are cumulative.
+  Stats getStats();
+
+  const std::string& getFilePath() const { return mFilePath; }
+
+ private:
+  using Buffer = std::shared_ptr<const std::vector<char>>;
+
+  /// What we know about an object since the previous snapshot.
+  struct ObjectState {
+    std::string name;
+    bool trackable = false; // true if the fingerprint can tell whether the object changed
+    ObjectsManager::Fingerprint fingerprint{};
+    Buffer buffer;
+  };
+
+  struct Snapshot {
+    std::vector<std::pair<std::string, Buffer>> objects;
+    std::chrono::steady_clock::time_point time;
+  };
+
+  Buffer serialize(const TObject* object);
+  void run();
+  bool write(const Snapshot& snapshot, size_t& bytesWritten);
+
+  std::string mFilePath;
+  bool mTrustFingerprints;
+  std::vector<ObjectState> mStates; // accessed only by the caller of save()
+  std::unique_ptr<TBufferFile> mBuffer;
+
+  std::mutex mMutex;
+  std::condition_variable mSnapshotAvailable;
+  std::condition_variable mIdle;
+  std::optional<Snapshot> mPending;
+  bool mWriting = false;
+  bool mStopping = false;
+  bool mForceWrite = true; // the first snapshot and the one after a failure are written even if nothing changed
+  Stats mStats;
+  double mLatencySumMs = 0;
+  uint64_t mLatencyCount = 0;
+
+  std::thread mWriter;
+};
+
+} // namespace o2::quality_control::core
+
+#endif // QC_CORE_OBJECTSFILEWRITER_H
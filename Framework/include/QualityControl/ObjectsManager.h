@@ -22,16 +22,21 @@
 #include "QualityControl/MonitorObject.h"
 #include "QualityControl/MonitorObjectCollection.h"
 // stl
+#include <array>
 #include <string>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 class TObject;
 class TObjArray;
+class TBufferFile;
 
 namespace o2::quality_control::core
 {
 
 class ServiceDiscovery;
+class ShardedHistogramBase;
 
 /// \brief  Keeps the list of encapsulated objects to publish and does the actual publication.
 ///
@@ -65,6 +70,19 @@ class ObjectsManager
    */
   void startPublishing(TObject* obj);
 
+  /**
+   * Start publishing the histogram of a ShardedHistogram. Its shards are merged into the histogram by
+   * mergeShardedHistograms(), which is called before each publication. The ownership remains to the caller.
+   * @param histogram The sharded histogram to publish.
+   * @throws DuplicateObjectError
+   */
+  void startPublishing(ShardedHistogramBase* histogram);
+
+  /**
+   * Merges the shards of the published ShardedHistograms into their histograms.
+   */
+  void mergeShardedHistograms();
+
   /**
    * Stop publishing this object
    * @param obj
@@ -96,6 +114,31 @@ class ObjectsManager
 
   MonitorObjectCollection* getNonOwningArray() const;
 
+  /**
+   * \brief Returns a non-owning array of the objects which changed since the previous call.
+   * An object is considered as changed if it is returned for the first time, if its metadata changed, if the activity
+   * changed or, for histograms, if the number of entries or the statistics changed. Other types of objects are
+   * always considered as changed. As getNonOwningArray(), the array must be deleted by the caller.
+   * If the objects are reset after each cycle, each publication is a delta which the receivers add to what they have,
+   * thus deltas should be set: a histogram is then considered as unchanged only if it is still empty, even if it got
+   * the same entries and statistics as during the previous cycle.
+   */
+  MonitorObjectCollection* getNonOwningArrayOfChangedObjects(bool deltas = false);
+
+  using Fingerprint = std::array<double, 16>;
+  /**
+   * \brief Fills a cheap summary of the content of a histogram: entries, number of cells and statistics.
+   * Returns false if the object is not a histogram, in which case its changes cannot be told from the fingerprint.
+   */
+  static bool computeFingerprint(const TObject* object, Fingerprint& fingerprint);
+
+  /**
+   * \brief Returns an estimation of the size of the objects once serialized, in bytes.
+   * The objects are serialized only when they are seen for the first time or when their binning changes,
+   * otherwise the previous size is reused.
+   */
+  size_t estimateSerializedSize(const MonitorObjectCollection& objects);
+
   /**
    * \brief Add metadata to a MonitorObject.
    * Add a metadata pair to a MonitorObject. This is propagated to the database.
@@ -179,7 +222,31 @@ class ObjectsManager
   void setActivity(const Activity& activity);
 
  private:
+  /// Returns the index of the object in mMonitorObjects or -1 if it is not published.
+  int findIndex(const std::string& objectName);
+  void rebuildIndex();
+
+  /// What we know about an object since it was last returned by getNonOwningArrayOfChangedObjects().
+  struct PublicationState {
+    bool published = false;
+    bool trackable = false; // true if the fingerprint can tell whether the object changed
+    Fingerprint fingerprint{};
+    std::map<std::string, std::string> metadata;
+    size_t serializedSize = 0;
+    double serializedSizeCells = -1; // number of cells of the histogram when its size was measured
+  };
+  PublicationState& getPublicationState(int index);
+  /// True if the fingerprint is the one of an empty histogram, e.g. just after a reset.
+  static bool isEmpty(const Fingerprint& fingerprint);
+
   std::unique_ptr<MonitorObjectCollection> mMonitorObjects;
+  // Index of the objects in mMonitorObjects by name, to avoid scanning the collection in each lookup.
+  // Slots of the objects which are not published anymore are left empty, so that the indices stay valid.
+  std::unordered_map<std::string, int> mIndex;
+  // Indexed like mMonitorObjects.
+  std::vector<PublicationState> mPublicationStates;
+  std::vector<ShardedHistogramBase*> mShardedHistograms;
+  std::unique_ptr<TBufferFile> mSizingBuffer;
   std::string mTaskName;
   std::string mTaskClass;
   std::string mDetectorName;
@@ -20,6 +20,7 @@
 #include <InfoLogger/InfoLogger.hxx>
 #include <InfoLogger/InfoLoggerMacros.hxx>
 #include <boost/property_tree/ptree_fwd.hpp>
+#include <memory>
 #include "QualityControl/DiscardFileParameters.h"
 
 typedef AliceO2::InfoLogger::InfoLogger infologger; // not to have to type the full stuff each time
@@ -46,9 +47,14 @@ class QcInfoLogger
  public:
   static AliceO2::InfoLogger::InfoLogger& GetInfoLogger()
   {
-    return *instance;
+    return threadInstance != nullptr ? *threadInstance : *instance;
   }
 
+  /// \brief Gives the calling thread its own InfoLogger, which is then used by ILOG in this thread.
+  /// InfoLogger is not thread safe, thus any thread other than the processing one should call it before logging,
+  /// e.g. the workers of ThreadPool do it. It takes the context and the filters of the main instance.
+  static void initThreadInfoLogger();
+
   // disable non-static
   QcInfoLogger() = delete;
   ~QcInfoLogger() = delete;
@@ -91,6 +97,8 @@ class QcInfoLogger
   // if we keep the default infologger it will any ways be valid till the end of the process.
   static AliceO2::InfoLogger::InfoLogger* instance;
   static AliceO2::InfoLogger::InfoLoggerContext* mContext;
+  static DiscardFileParameters mDiscardFileParameters;
+  static inline thread_local std::unique_ptr<AliceO2::InfoLogger::InfoLogger> threadInstance;
 };
 
 } // namespace o2::quality_control::core
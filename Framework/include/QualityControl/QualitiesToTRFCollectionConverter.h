@@ -18,7 +18,9 @@
 #define QUALITYCONTROL_QUALITIESTOTRFCOLLECTIONCONVERTER_H
 
 #include <DataFormatsQualityControl/TimeRangeFlag.h>
+#include "QualityControl/Quality.h"
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace o2::quality_control
@@ -41,6 +43,9 @@ class QualitiesToTRFCollectionConverter
 
   /// \brief Converts a Quality into TRFCollection. The converter should get Qualities in chronological order.
   void operator()(const QualityObject&);
+  /// \brief Converts a Quality known only by its metadata (e.g. from a repository listing), see the other operator().
+  void operator()(const Quality& quality, const CommentedFlagReasons& reasons, uint64_t validFrom, uint64_t validUntil,
+                  const std::string& detectorName, const std::string& qoPath);
 
   /// \brief Moves the final TRFCollection out and resets the converter.
   std::unique_ptr<TimeRangeFlagCollection> getResult();
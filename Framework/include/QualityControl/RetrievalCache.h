@@ -0,0 +1,92 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   RetrievalCache.h
+///
+
+#ifndef QC_REPOSITORY_RETRIEVALCACHE_H
+#define QC_REPOSITORY_RETRIEVALCACHE_H
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class TObject;
+
+namespace o2::quality_control::repository
+{
+
+/// \brief Size-bounded LRU cache of the objects retrieved from the repository.
+///
+/// Each entry keeps the last object retrieved for a path and metadata, together with the ETag it was served with.
+/// The user of the cache sends the ETag along with the next request for the same path and metadata, whatever its
+/// timestamp, and, if the repository answers that the object valid at that time is still the same one, reuses the
+/// cached object instead of downloading and deserializing it again. The least recently used entries are evicted
+/// when the sum of the object sizes exceeds the limit. All methods are thread-safe.
+class RetrievalCache
+{
+ public:
+  struct Entry {
+    std::shared_ptr<TObject> object;
+    std::string etag;
+    size_t size = 0; // in bytes, as downloaded
+  };
+
+  struct Statistics {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t bytesSaved = 0; // bytes which were not downloaded thanks to the hits
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+  };
+
+  /// \param maxBytes Maximum sum of the sizes of the cached objects. An object bigger than that is not cached.
+  explicit RetrievalCache(size_t maxBytes);
+  ~RetrievalCache() = default;
+
+  /// Builds the key of an object out of its path and metadata. The timestamp is not part of it, the callers usually
+  /// ask for "now" or a new time at each trigger and the repository tells with the ETag whether the object changed.
+  static std::string makeKey(const std::string& path, const std::map<std::string, std::string>& metadata);
+
+  /// Returns the entry or nullptr if it is not cached. The entry becomes the most recently used.
+  std::shared_ptr<const Entry> find(const std::string& key);
+  /// Inserts or replaces the entry, then evicts the least recently used entries if needed.
+  void insert(const std::string& key, Entry entry);
+  void erase(const std::string& key);
+  void clear();
+
+  /// Counts a request served with the cached object.
+  void recordHit(const Entry& entry);
+  /// Counts a request for which the object had to be downloaded.
+  void recordMiss();
+  Statistics getStatistics() const;
+
+ private:
+  using LruList = std::list<std::pair<std::string, std::shared_ptr<const Entry>>>;
+
+  void evict();
+
+  const size_t mMaxBytes;
+  mutable std::mutex mMutex;
+  LruList mLru; // the most recently used entries first
+  std::unordered_map<std::string, LruList::iterator> mIndex;
+  Statistics mStatistics;
+};
+
+} // namespace o2::quality_control::repository
+
+#endif // QC_REPOSITORY_RETRIEVALCACHE_H
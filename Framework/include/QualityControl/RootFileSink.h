@@ -20,19 +20,38 @@
 #include <Framework/Task.h>
 #include <Framework/CompletionPolicy.h>
 #include <Framework/DataProcessorLabel.h>
+#include <Framework/DataProcessorSpec.h>
+#include "QualityControl/MonitorObjectCollection.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
 
 namespace o2::quality_control::core
 {
 
 /// \brief A Data Processor which stores MonitorObjectCollections in a specified file
+///
+/// By default, the file is updated with each received collection, which is merged with the one stored in the file.
+/// With a positive "qc-sink-flush-interval" (seconds), the collections are merged in memory instead and the file is
+/// written at this interval, at the end of stream and at stop. A temporary file is written first, synced to the disk
+/// and then replaces the previous one, so that a crash never leaves a partially written file. If the collections kept
+/// in memory exceed "qc-sink-memory-limit" (MB), they are written and released, the next ones are merged with the file
+/// when flushed. The objects of the file which are not in a directory are kept as they are.
 class RootFileSink : public framework::Task
 {
  public:
   explicit RootFileSink(std::string filePath);
+  /// Merges the collections in memory as with the "qc-sink-flush-interval" and "qc-sink-memory-limit" options,
+  /// the memory limit is in bytes. Used when the sink is driven without DPL, e.g. in tests.
+  RootFileSink(std::string filePath, std::chrono::seconds flushInterval, size_t memoryLimit);
   ~RootFileSink() override = default;
 
   void init(framework::InitContext& ictx) override;
   void run(framework::ProcessingContext& pctx) override;
+  void endOfStream(framework::EndOfStreamContext& eosContext) override;
+  void stop() override;
 
   static framework::DataProcessorLabel getLabel()
   {
@@ -40,9 +59,30 @@ class RootFileSink : public framework::Task
   }
 
   static void customizeInfrastructure(std::vector<framework::CompletionPolicy>& policies);
+  static framework::Options getOptions();
+
+  /// \brief Keeps the collection in memory, merged with the previous ones of the same name, until the next flush.
+  /// The size (e.g. of the received message) of the first collection of each name is accounted in the memory limit.
+  void mergeInMemory(std::unique_ptr<MonitorObjectCollection> moc, size_t size);
+  /// Flushes if the flush interval elapsed, or flushes and releases the collections if they exceed the memory limit.
+  void flushIfNeeded();
+  /// Writes the file with the collections in memory and those of the previous file, then releases the collections
+  /// from memory if asked.
+  void flush(bool release);
 
  private:
+  struct CollectionInMemory {
+    std::unique_ptr<MonitorObjectCollection> collection;
+    bool includesFile = false; // true if the collection stored in the file is already merged into it
+  };
+
   std::string mFilePath;
+  std::chrono::seconds mFlushInterval{ 0 }; // 0 if each collection is stored right away
+  size_t mMemoryLimit = 0;                  // in bytes, 0 for no limit
+  std::map<std::string /* detector/name */, CollectionInMemory> mCollections;
+  size_t mMemoryInUse = 0; // estimated with the size of the first message of each collection
+  bool mDirty = false; // true if collections were received since the last flush
+  std::chrono::steady_clock::time_point mLastFlush;
 };
 
 } // namespace o2::quality_control::core
@@ -0,0 +1,199 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ShardedHistogram.h
+///
+
+#ifndef QC_CORE_SHARDEDHISTOGRAM_H
+#define QC_CORE_SHARDEDHISTOGRAM_H
+
+#include <array>
+#include <type_traits>
+#include <vector>
+
+#include <TH1.h>
+#include <TH2.h>
+
+namespace o2::quality_control::core
+{
+
+/// \brief Interface of ShardedHistogram which does not depend on the type of the histogram, used by ObjectsManager.
+class ShardedHistogramBase
+{
+ public:
+  virtual ~ShardedHistogramBase() = default;
+
+  /// The histogram which is published.
+  virtual TH1* getHistogram() const = 0;
+  /// Adds the content of the shards to the histogram and empties them. It must not be called while the shards are filled.
+  virtual void mergeShards() = 0;
+};
+
+/// \brief A histogram which can be filled by several threads at the same time, each of them with its own shard.
+///
+/// A shard is a contiguous buffer of bin contents, indexed by the global bin numbers of the histogram, with the sums
+/// needed for the statistics. The threads fill their shards without any synchronisation, the shards are added to the
+/// histogram by mergeShards(). The histogram stays a plain ROOT histogram. When it is published with
+/// ObjectsManager::startPublishing(ShardedHistogramBase*), the shards are merged before each publication.
+///
+/// The binning of the histogram must not change while the shards are filled. Call reset() after changing it.
+/// Each shard must be used by one thread at a time. ThreadPool::getThreadIndex() gives a suitable shard index for the
+/// jobs of a ThreadPool.
+///
+/// \code
+/// ShardedHistogram<TH1F> sharded(histogram, getExecutor().size() + 1);
+/// getExecutor().parallelFor(n, [&](size_t i) {
+///   auto& shard = sharded.shard(getExecutor().getThreadIndex());
+///   shard.fill(values[i]);
+/// });
+/// \endcode
+template <typename HistogramType>
+class ShardedHistogram : public ShardedHistogramBase
+{
+  static_assert(std::is_base_of_v<TH1, HistogramType>, "ShardedHistogram is meant for ROOT histograms");
+  static constexpr bool is2D = std::is_base_of_v<TH2, HistogramType>;
+
+ public:
+  class alignas(64) Shard
+  {
+   public:
+    template <typename H = HistogramType, std::enable_if_t<!std::is_base_of_v<TH2, H>, int> = 0>
+    void fill(double x, double w = 1.)
+    {
+      const int binx = mHistogram->GetXaxis()->FindFixBin(x);
+      add(binx, w);
+      if (binx > 0 && binx <= mHistogram->GetXaxis()->GetNbins()) {
+        addStats(w, x);
+      }
+    }
+
+    template <typename H = HistogramType, std::enable_if_t<std::is_base_of_v<TH2, H>, int> = 0>
+    void fill(double x, double y, double w = 1.)
+    {
+      const int binx = mHistogram->GetXaxis()->FindFixBin(x);
+      const int biny = mHistogram->GetYaxis()->FindFixBin(y);
+      add(mHistogram->GetBin(binx, biny), w);
+      if (binx > 0 && binx <= mHistogram->GetXaxis()->GetNbins() && biny > 0 && biny <= mHistogram->GetYaxis()->GetNbins()) {
+        addStats(w, x, y);
+      }
+    }
+
+    double getEntries() const { return mEntries; }
+
+   private:
+    friend class ShardedHistogram;
+
+    void add(int bin, double w)
+    {
+      mContent[bin] += w;
+      mSumw2[bin] += w * w;
+      mWeighted |= (w != 1.);
+      mEntries++;
+    }
+
+    void addStats(double w, double x, double y = 0.)
+    {
+      // as in TH1::GetStats and TH2::GetStats
+      mStats[0] += w;
+      mStats[1] += w * w;
+      mStats[2] += w * x;
+      mStats[3] += w * x * x;
+      if constexpr (is2D) {
+        mStats[4] += w * y;
+        mStats[5] += w * y * y;
+        mStats[6] += w * x * y;
+      }
+    }
+
+    void clear(size_t nCells)
+    {
+      mContent.assign(nCells, 0.);
+      mSumw2.assign(nCells, 0.);
+      mStats.fill(0.);
+      mEntries = 0;
+      mWeighted = false;
+    }
+
+    const HistogramType* mHistogram = nullptr;
+    std::vector<double> mContent; // indexed by the global bin number
+    std::vector<double> mSumw2;
+    std::array<double, 7> mStats{};
+    double mEntries = 0;
+    bool mWeighted = false;
+  };
+
+  /// \param histogram The histogram to fill, it is not owned.
+  /// \param nShards The number of shards, typically the number of threads filling the histogram.
+  ShardedHistogram(HistogramType* histogram, size_t nShards) : mHistogram(histogram), mShards(nShards > 0 ? nShards : 1)
+  {
+    for (auto& shard : mShards) {
+      shard.mHistogram = mHistogram;
+      shard.clear(mHistogram->GetNcells());
+    }
+  }
+
+  ShardedHistogram(const ShardedHistogram&) = delete;
+  ShardedHistogram& operator=(const ShardedHistogram&) = delete;
+
+  HistogramType* getHistogram() const override { return mHistogram; }
+  Shard& shard(size_t index) { return mShards[index]; }
+  size_t getNumberOfShards() const { return mShards.size(); }
+
+  void mergeShards() override
+  {
+    Double_t stats[TH1::kNstat] = { 0 };
+    mHistogram->GetStats(stats);
+    double entries = mHistogram->GetEntries();
+    for (auto& shard : mShards) {
+      if (shard.mEntries == 0) {
+        continue;
+      }
+      if (shard.mWeighted && mHistogram->GetSumw2N() == 0) {
+        mHistogram->Sumw2(); // as TH1::Fill does when it is given a weight
+      }
+      auto* sumw2 = mHistogram->GetSumw2N() > 0 ? mHistogram->GetSumw2()->fArray : nullptr;
+      const size_t nCells = shard.mContent.size();
+      for (size_t bin = 0; bin < nCells; bin++) {
+        mHistogram->fArray[bin] += shard.mContent[bin];
+      }
+      if (sumw2) {
+        for (size_t bin = 0; bin < nCells; bin++) {
+          sumw2[bin] += shard.mSumw2[bin];
+        }
+      }
+      for (size_t i = 0; i < shard.mStats.size(); i++) {
+        stats[i] += shard.mStats[i];
+      }
+      entries += shard.mEntries;
+      shard.clear(nCells);
+    }
+    mHistogram->PutStats(stats);
+    mHistogram->SetEntries(entries);
+  }
+
+  /// Resets the histogram and the shards, which are resized if the binning of the histogram changed.
+  void reset()
+  {
+    mHistogram->Reset();
+    for (auto& shard : mShards) {
+      shard.clear(mHistogram->GetNcells());
+    }
+  }
+
+ private:
+  HistogramType* mHistogram;
+  std::vector<Shard> mShards;
+};
+
+} // namespace o2::quality_control::core
+
+#endif // QC_CORE_SHARDEDHISTOGRAM_H
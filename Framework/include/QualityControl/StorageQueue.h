@@ -0,0 +1,130 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   StorageQueue.h
+///
+
+#ifndef QC_REPOSITORY_STORAGEQUEUE_H
+#define QC_REPOSITORY_STORAGEQUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace o2::quality_control::core
+{
+class MonitorObject;
+class QualityObject;
+} // namespace o2::quality_control::core
+
+namespace o2::quality_control::repository
+{
+
+class DatabaseInterface;
+
+/// \brief Bounded queue which stores MonitorObjects and QualityObjects in the background.
+///
+/// Objects are enqueued by the processing thread and uploaded by worker threads, each of them owning
+/// its own instance of DatabaseInterface. Objects are deep-copied when enqueued, thus the caller is free
+/// to modify (e.g. beautify) them afterwards. An object enqueued with the same path and validity start
+/// as an object still waiting in the queue replaces it, i.e. only the last version within one cycle is uploaded.
+/// When the queue is full, the behaviour is decided by the OverflowPolicy.
+class StorageQueue
+{
+ public:
+  enum class OverflowPolicy {
+    Block,      // the caller waits until a slot is free (back-pressure)
+    DropOldest, // the oldest pending object is discarded
+    DropNewest  // the object being enqueued is discarded
+  };
+
+  struct Stats {
+    size_t queueSize = 0;
+    uint64_t stored = 0;
+    uint64_t failed = 0;
+    uint64_t dropped = 0;
+    uint64_t coalesced = 0;
+    double meanLatencyMs = 0; // from enqueueing until the end of the upload
+    double maxLatencyMs = 0;
+  };
+
+  /// \brief Creates the queue and starts one worker thread per backend.
+  /// The backends must be already connected and should not be used by anyone else.
+  StorageQueue(std::vector<std::shared_ptr<DatabaseInterface>> backends, size_t capacity, OverflowPolicy policy = OverflowPolicy::Block);
+  /// Stops the workers, the objects still in the queue are uploaded first.
+  ~StorageQueue();
+
+  StorageQueue(const StorageQueue&) = delete;
+  StorageQueue& operator=(const StorageQueue&) = delete;
+
+  void enqueue(std::shared_ptr<const core::MonitorObject> mo, long from = -1, long to = -1);
+  void enqueue(std::shared_ptr<const core::QualityObject> qo, long from = -1, long to = -1);
+
+  /// Blocks until all the objects enqueued so far are processed.
+  void flush();
+
+  /// \brief Returns the counters accumulated so far.
+  /// Latency statistics are reset at each call, the other counters are cumulative.
+  Stats getStats();
+
+  size_t size() const;
+
+  static OverflowPolicy policyFromString(const std::string& policy);
+
+ private:
+  struct Item {
+    std::shared_ptr<const core::MonitorObject> mo;
+    std::shared_ptr<const core::QualityObject> qo;
+    long from;
+    long to;
+    std::chrono::steady_clock::time_point enqueueTime;
+  };
+  using Key = std::pair<std::string, long>; // path, validity start
+
+  void push(Key key, Item item);
+  void runWorker(const std::shared_ptr<DatabaseInterface>& backend);
+  void recordLatency(double latencyMs);
+
+  std::vector<std::thread> mWorkers;
+  size_t mCapacity;
+  OverflowPolicy mPolicy;
+
+  mutable std::mutex mMutex;
+  std::condition_variable mItemAvailable;
+  std::condition_variable mSlotAvailable;
+  std::condition_variable mIdle;
+  std::deque<Key> mOrder;
+  std::map<Key, Item> mPending;
+  size_t mInFlight = 0;
+  bool mStopping = false;
+
+  std::atomic<uint64_t> mStored = 0;
+  std::atomic<uint64_t> mFailed = 0;
+  std::atomic<uint64_t> mDropped = 0;
+  std::atomic<uint64_t> mCoalesced = 0;
+  std::mutex mLatencyMutex;
+  double mLatencySumMs = 0;
+  double mLatencyMaxMs = 0;
+  uint64_t mLatencyCount = 0;
+};
+
+} // namespace o2::quality_control::repository
+
+#endif // QC_REPOSITORY_STORAGEQUEUE_H
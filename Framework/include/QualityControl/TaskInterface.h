@@ -40,6 +40,8 @@ struct DataRequest;
 namespace o2::quality_control::core
 {
 
+class ThreadPool;
+
 /// \brief  Skeleton of a QC task.
 ///
 /// Purely abstract class defining the skeleton and the common interface of a QC task.
@@ -89,14 +91,20 @@ class TaskInterface : public UserCodeInterface
   void setMonitoring(const std::shared_ptr<o2::monitoring::Monitoring>& mMonitoring);
   void setGlobalTrackingDataRequest(std::shared_ptr<o2::globaltracking::DataRequest>);
   const o2::globaltracking::DataRequest* getGlobalTrackingDataRequest() const;
+  void setExecutor(std::shared_ptr<ThreadPool> executor);
 
  protected:
   std::shared_ptr<ObjectsManager> getObjectsManager();
+  /// \brief Returns the thread pool which the task can use to parallelise its processing, e.g. with parallelFor().
+  /// Its workers persist for the lifetime of the task and their number is set with "executorThreads" in the task
+  /// configuration. The calling thread takes part in the work, so a pool without workers executes the jobs sequentially.
+  ThreadPool& getExecutor();
   std::shared_ptr<o2::monitoring::Monitoring> mMonitoring;
 
  private:
   std::shared_ptr<ObjectsManager> mObjectsManager;
   std::shared_ptr<o2::globaltracking::DataRequest> mGlobalTrackingDataRequest;
+  std::shared_ptr<ThreadPool> mExecutor;
 };
 
 } // namespace o2::quality_control::core
@@ -50,6 +50,7 @@ namespace o2::quality_control::core
 
 class TaskInterface;
 class ObjectsManager;
+class ObjectsFileWriter;
 
 /// \brief A class driving the execution of a QC task inside DPL.
 ///
@@ -137,6 +138,7 @@ class TaskRunner : public framework::Task
   std::shared_ptr<monitoring::Monitoring> mCollector;
   std::shared_ptr<TaskInterface> mTask;
   std::shared_ptr<ObjectsManager> mObjectsManager;
+  std::unique_ptr<ObjectsFileWriter> mFileWriter; // writes the objects to mTaskConfig.saveToFile in the background
   int mRunNumber;
 
   void updateMonitoringStats(framework::ProcessingContext& pCtx);
@@ -149,6 +151,8 @@ class TaskRunner : public framework::Task
   int mNumberMessagesReceivedInCycle = 0;
   int mNumberObjectsPublishedInCycle = 0;
   int mTotalNumberObjectsPublished = 0; // over a run
+  int mNumberObjectsUnchangedInCycle = 0;  // not published because they did not change
+  size_t mPublishedBytesInCycle = 0;      // estimated
   double mLastPublicationDuration = 0;
   uint64_t mDataReceivedInCycle = 0;
   AliceO2::Common::Timer mTimerTotalDurationActivity;
@@ -58,6 +58,10 @@ struct TaskRunnerConfig {
   int parallelTaskID = 0;            // ID to differentiate parallel local Tasks from one another. 0 means this is the only one.
   std::string saveToFile{};
   int resetAfterCycles = 0;
+  bool skipUnchangedObjects = false; // publish only the objects which changed since the last cycle
+  size_t executorThreads = 1;        // threads available to the task, including its own
+  bool pinExecutorThreads = false;
+  size_t executorFirstCpu = 0; // the executor threads are pinned from this position of ThreadPool::getCpusByNumaNode()
   core::DiscardFileParameters infologgerDiscardParameters;
   Activity fallbackActivity;
   std::shared_ptr<o2::base::GRPGeomRequest> grpGeomRequest;
@@ -62,6 +62,9 @@ struct TaskSpec {
   int maxNumberCycles = -1;
   size_t resetAfterCycles = 0;
   std::string saveObjectsToFile;
+  bool skipUnchangedObjects = false;
+  size_t executorThreads = 1;  // including the thread of the task itself
+  size_t executorFirstCpu = 0; // start of the CPUs of the task among those of the node, see applyTaskExecutorBudget()
   std::unordered_map<std::string, std::string> customParameters = {};
   // multinode setups
   TaskLocationSpec location = TaskLocationSpec::Remote;
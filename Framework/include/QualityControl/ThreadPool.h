@@ -0,0 +1,104 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ThreadPool.h
+///
+
+#ifndef QC_CORE_THREADPOOL_H
+#define QC_CORE_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace o2::quality_control::core
+{
+
+/// \brief A fixed-size pool of threads executing the submitted jobs.
+///
+/// Each worker has its own queue. Jobs submitted from a worker go to its queue and are executed last-in first-out,
+/// the other jobs are distributed among the queues. A worker without jobs steals the oldest job of another worker.
+/// With no workers, the jobs are executed right away by the thread which submits them.
+///
+/// Jobs must not wait for other jobs submitted to the same pool, as it might lead to a deadlock.
+class ThreadPool
+{
+ public:
+  /// \param nThreads Number of worker threads, 0 means that the jobs are executed by the caller.
+  /// \param name Prefix of the worker threads names, as seen in `top` or `perf`.
+  /// \param pinThreads If true, each worker is pinned to one of the CPUs allowed for the process, see getCpusByNumaNode().
+  /// \param firstCpu The worker i is pinned to the CPU at position firstCpu + i in the list of getCpusByNumaNode(),
+  ///                 so that the pools which share a node can be given disjoint ranges of CPUs.
+  explicit ThreadPool(size_t nThreads, const std::string& name = "QC/Pool", bool pinThreads = false, size_t firstCpu = 0);
+  /// Waits for the queued jobs to finish and joins the workers.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  size_t size() const { return mWorkers.size(); }
+
+  /// \brief Returns 1 + the index of the calling thread among the workers, or 0 if it is not a worker of this pool.
+  /// It can be used to select per-thread data in parallelFor(), which runs on the workers and on the calling thread.
+  size_t getThreadIndex() const;
+
+  /// Queues a callable and returns the future of its result. Exceptions are propagated through the future.
+  template <typename F>
+  auto submit(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+  {
+    using R = std::invoke_result_t<std::decay_t<F>>;
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+    auto future = task->get_future();
+    push([task]() { (*task)(); });
+    return future;
+  }
+
+  /// \brief Calls function(i) for i in [0, n) and waits for all the calls to finish.
+  /// The calling thread takes part in the work. The first exception thrown by a call is rethrown.
+  /// It can be called from a job of the same pool.
+  void parallelFor(size_t n, const std::function<void(size_t)>& function);
+
+  /// \brief Returns the CPUs the process is allowed to run on, grouped by NUMA node.
+  /// The node of the calling thread comes first, so that the workers share its memory as long as there are enough CPUs.
+  static std::vector<int> getCpusByNumaNode();
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<std::function<void()>> jobs;
+    std::thread thread;
+  };
+
+  void push(std::function<void()> job);
+  bool tryPop(size_t workerIndex, std::function<void()>& job);
+  void run(size_t workerIndex);
+
+  std::vector<std::unique_ptr<Worker>> mWorkers;
+  std::atomic<size_t> mNextWorker{ 0 };
+  // protects mPendingJobs and mStopping, used to put idle workers to sleep
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  long mPendingJobs = 0; // might be briefly negative, as a job can be taken before it is counted
+  bool mStopping = false;
+};
+
+} // namespace o2::quality_control::core
+
+#endif // QC_CORE_THREADPOOL_H
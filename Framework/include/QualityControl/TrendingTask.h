@@ -26,6 +26,10 @@
 #include <TTree.h>
 
 class TAxis;
+class TCanvas;
+class TGraph;
+class TGraphErrors;
+class TH1F;
 
 namespace o2::quality_control::repository
 {
@@ -47,7 +51,7 @@ class TrendingTask : public PostProcessingInterface
 {
  public:
   TrendingTask() = default;
-  ~TrendingTask() override = default;
+  ~TrendingTask() override;
 
   void configure(const boost::property_tree::ptree& config) override;
   void initialize(Trigger, framework::ServiceRegistryRef) override;
@@ -66,14 +70,25 @@ class TrendingTask : public PostProcessingInterface
     }
   } mMetaData;
 
+  /// What is kept of a plot between two updates, so that only the new entries of the trend are added to it.
+  struct PlotState {
+    TCanvas* canvas = nullptr;
+    TGraph* graph = nullptr;             // drawn by TTree::Draw, nullptr if the plot has to be redrawn at each update
+    TGraphErrors* graphErrors = nullptr; // the error bars of the graph, if any
+    Long64_t entriesDrawn = 0;           // entries of the trend already in the plot
+  };
+
   void trendValues(const Trigger& t, repository::DatabaseInterface&);
   void generatePlots();
+  void drawPlot(const TrendingTaskConfig::Plot& plot, PlotState& state);
+  bool appendToPlot(const TrendingTaskConfig::Plot& plot, PlotState& state);
   bool canContinueTrend(TTree* tree);
 
   TrendingTaskConfig mConfig;
   UInt_t mTime;
   std::unique_ptr<TTree> mTrend;
-  std::map<std::string, TObject*> mPlots;
+  std::map<std::string, PlotState> mPlots;
+  std::unique_ptr<TH1F> mPlotDurations; // time spent on each plot in the last update, in ms
   std::unordered_map<std::string, std::unique_ptr<Reductor>> mReductors;
 };
 
@@ -52,6 +52,7 @@ struct TrendingTaskConfig : PostProcessingConfig {
 
   bool producePlotsOnUpdate{};
   bool resumeTrend{};
+  bool publishPlotDurations{};
   std::vector<Plot> plots;
   std::vector<DataSource> dataSources;
 };
@@ -17,8 +17,9 @@
 #ifndef QC_CHECKER_POLICYMANAGER_H
 #define QC_CHECKER_POLICYMANAGER_H
 
+#include <cstdint>
 #include <string>
-#include <map>
+#include <unordered_map>
 #include <vector>
 #include <functional>
 #include <iosfwd>
@@ -28,8 +29,13 @@
 namespace o2::quality_control::checker
 {
 
-using UpdatePolicyFunctionType = std::function<bool()>;
+struct UpdatePolicy;
+using UpdatePolicyFunctionType = std::function<bool(UpdatePolicy&)>;
 typedef uint32_t RevisionType;
+/// Dense index of an object name, see UpdatePolicyManager::getObjectId()
+typedef uint32_t ObjectIdType;
+/// Dense index of an actor, in the order in which the policies were added, see UpdatePolicyManager::getActorId()
+typedef uint32_t ActorIdType;
 
 /**
  * Represents a policy and all its associated elements.
@@ -38,10 +44,15 @@ struct UpdatePolicy {
   std::string actorName;
   UpdatePolicyFunctionType isReady;
   std::vector<std::string> inputObjects;
+  std::vector<ObjectIdType> inputObjectIds; // the IDs of inputObjects
   bool allInputObjects;
   // TODO this line makes me think that lambdas are not enough because we actually need to store a state...
   bool policyHelperFlag; // the purpose might change depending on policy,
   RevisionType revision = 0;
+  // maintained by the UpdatePolicyManager when the revisions change, so that the policies do not look at each input
+  size_t updatedInputs = 0;  // number of inputObjectIds whose revision is above `revision`
+  size_t receivedInputs = 0; // number of inputObjectIds which were received at least once
+  bool readyWithoutUpdates = false; // the policy might be fulfilled even if no input was updated
 
   friend std::ostream& operator<<(std::ostream& out, const UpdatePolicy& updatePolicy); // output
 };
@@ -59,6 +70,12 @@ struct UpdatePolicy {
  *     is used by some policies.
  *   - a revision is a number associated to each object to determine when it was received and associated to
  *     each actor to determine when it was last time triggered.
+ *   - each object name is given a dense ID the first time it is seen, the revisions of the objects are kept in a
+ *     vector indexed by these IDs. A caller which receives the same objects in each cycle can obtain their IDs once
+ *     with getObjectId() and update their revisions without any string lookup.
+ *   - each object knows the actors which use it. When its revision changes, the counters of updated and received
+ *     inputs of these actors are updated and the actors with updated inputs are marked as dirty. The policies only
+ *     compare these counters, and the caller can restrict itself to getDirtyActors(), the other actors are not ready.
  *
  * The following policies are available:
  *   - OnAny: triggers when an object is received that matches ANY object listed as a data source of the policy.
@@ -104,6 +121,8 @@ class UpdatePolicyManager
    */
   void updateActorRevision(const std::string& actorName, RevisionType revision);
   void updateActorRevision(const std::string& actorName);
+  void updateActorRevision(ActorIdType actorId, RevisionType revision);
+  void updateActorRevision(ActorIdType actorId);
   /**
    * \brief Update the revision number associated with an object.
    *
@@ -113,6 +132,22 @@ class UpdatePolicyManager
    */
   void updateObjectRevision(const std::string& objectName, RevisionType revision);
   void updateObjectRevision(const std::string& objectName);
+  void updateObjectRevision(ObjectIdType objectId, RevisionType revision);
+  void updateObjectRevision(ObjectIdType objectId);
+  /**
+   * \brief Returns the ID of an object, a new one is assigned if the object was not known yet.
+   *
+   * The IDs are contiguous from 0, they stay valid until reset().
+   * @param objectName
+   */
+  ObjectIdType getObjectId(const std::string& objectName);
+  /**
+   * \brief Returns the ID of an actor, throws if it has no policy.
+   *
+   * The IDs are contiguous from 0 in the order in which the policies were added, they stay valid until reset().
+   * @param actorName
+   */
+  ActorIdType getActorId(const std::string& actorName) const;
   /**
    * Add a policy for the given actor.
    * @param actorName
@@ -134,11 +169,27 @@ class UpdatePolicyManager
    * @return
    */
   bool isReady(const std::string& actorName);
+  bool isReady(ActorIdType actorId);
+
+  /**
+   * \brief Returns the actors which might be ready, sorted by ID.
+   *
+   * These are the actors with at least one input updated since they were triggered, and those whose policy does not
+   * depend on their inputs. isReady() returns false for all the others.
+   */
+  std::vector<ActorIdType> getDirtyActors() const;
 
  private:
-  std::map<std::string /* Actor name */, UpdatePolicy> mPoliciesByActor;
+  void refreshActor(ActorIdType actorId);
+  void setDirty(ActorIdType actorId, bool dirty);
+
+  std::vector<UpdatePolicy> mPolicies; // indexed by actor ID
+  std::unordered_map<std::string /* Actor name */, ActorIdType> mActorIds;
+  std::vector<uint64_t> mDirtyActors; // bitset indexed by actor ID
   RevisionType mGlobalRevision = 1;
-  std::map<std::string /* Object name */, RevisionType> mObjectsRevision;
+  std::unordered_map<std::string /* Object name */, ObjectIdType> mObjectIds;
+  std::vector<RevisionType> mObjectsRevision; // indexed by object ID, 0 if the object was never received
+  std::vector<std::vector<ActorIdType>> mObjectActors; // indexed by object ID, the actors having the object as input
 };
 
 } // namespace o2::quality_control::checker
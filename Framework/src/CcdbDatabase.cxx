@@ -21,6 +21,7 @@
 #include "QualityControl/RepoPathUtils.h"
 #include "QualityControl/DatabaseHelpers.h"
 #include "QualityControl/ObjectMetadataKeys.h"
+#include "QualityControl/ThreadPool.h"
 
 // O2
 #include <DataFormatsQualityControl/TimeRangeFlagCollection.h>
@@ -28,6 +29,7 @@
 #include <CCDB/CcdbApi.h>
 #include <CommonUtils/MemFileHelper.h>
 // ROOT
+#include <TBufferFile.h>
 #include <TBufferJSON.h>
 #include <TH1F.h>
 #include <TFile.h>
@@ -37,6 +39,7 @@
 #include <TStreamerInfo.h>
 #include <TSystem.h>
 // std
+#include <algorithm>
 #include <chrono>
 #include <sstream>
 #include <filesystem>
@@ -44,7 +47,6 @@
 // boost
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
-#include <boost/foreach.hpp>
 #include <utility>
 // misc
 #include "rapidjson/document.h"
@@ -114,6 +116,12 @@ void CcdbDatabase::connect(const std::unordered_map<std::string, std::string>& c
   if (config.count("maxObjectSize")) {
     mMaxObjectSize = std::stoi(config.at("maxObjectSize"));
   }
+  if (config.count("retrievalThreads")) {
+    mRetrievalThreads = std::max(1, std::stoi(config.at("retrievalThreads")));
+  }
+  if (config.count("retrievalCacheMaxBytes")) {
+    setRetrievalCacheSize(std::stoull(config.at("retrievalCacheMaxBytes")));
+  }
 }
 
 void CcdbDatabase::init()
@@ -281,9 +289,14 @@ void CcdbDatabase::storeQO(std::shared_ptr<const o2::quality_control::core::Qual
 }
 
 void CcdbDatabase::storeTRFC(std::shared_ptr<const o2::quality_control::TimeRangeFlagCollection> trfc)
+{
+  storeTRFC(std::move(trfc), {});
+}
+
+void CcdbDatabase::storeTRFC(std::shared_ptr<const o2::quality_control::TimeRangeFlagCollection> trfc, const std::map<std::string, std::string>& additionalMetadata)
 {
   // metadata
-  map<string, string> metadata;
+  map<string, string> metadata = additionalMetadata;
   metadata[metadata_keys::runNumber] = std::to_string(trfc->getRunNumber());
   metadata[metadata_keys::periodName] = trfc->getPeriodName();
   metadata[metadata_keys::passName] = trfc->getPassName();
@@ -330,68 +343,172 @@ void* CcdbDatabase::retrieveAny(const type_info& tinfo, const string& path, cons
   return object;
 }
 
-std::shared_ptr<o2::quality_control::core::MonitorObject> CcdbDatabase::retrieveMO(std::string objectPath, std::string objectName, long timestamp, const core::Activity& activity)
+std::shared_ptr<TObject> CcdbDatabase::retrieveCached(const std::string& path, const std::map<std::string, std::string>& metadata, long timestamp,
+                                                      const std::function<std::shared_ptr<TObject>(TObject*, std::map<std::string, std::string>&)>& build)
 {
-  string fullPath = activity.mProvenance + "/" + objectPath + "/" + objectName;
   map<string, string> headers;
-  map<string, string> metadata = database_helpers::asDatabaseMetadata(activity, false);
-  TObject* obj = retrieveTObject(fullPath, metadata, timestamp, &headers);
-
-  // no object found
-  if (obj == nullptr) {
-    if (headers.count("Error") > 0) {
-      ILOG(Error, Support) << headers["Error"] << ENDM;
-    }
-    return nullptr;
+  if (!mRetrievalCache) {
+    return build(retrieveTObject(path, metadata, timestamp, &headers), headers);
   }
 
-  // retrieve headers to determine the version of the QC framework
-  Version objectVersion(headers[metadata_keys::qcVersion]);
-  ILOG(Debug, Devel) << "Version of object is " << objectVersion << ENDM;
+  // The key does not contain the timestamp, the server answers 304 if the object valid at this time is the cached one.
+  auto key = RetrievalCache::makeKey(path, metadata);
+  auto cached = mRetrievalCache->find(key);
+  auto* object = ccdbApi->retrieveFromTFileAny<TObject>(path, metadata, timestamp, &headers, cached ? cached->etag : "");
+  if (object == nullptr && cached && headers.count("Error") == 0) {
+    // the server answered 304 Not Modified
+    ILOG(Debug, Support) << "Object " << path << " with timestamp " << timestamp << " did not change, using the cached version" << ENDM;
+    mRetrievalCache->recordHit(*cached);
+    return cached->object;
+  }
+  mRetrievalCache->recordMiss();
+  if (object == nullptr) {
+    ILOG(Error, Support) << "We could NOT retrieve the object " << path << " with timestamp " << timestamp << "." << ENDM;
+    mRetrievalCache->erase(key);
+    return build(nullptr, headers);
+  }
+  ILOG(Debug, Support) << "Retrieved object " << path << " with timestamp " << timestamp << ENDM;
 
-  std::shared_ptr<MonitorObject> mo;
-  if (objectVersion == Version("0.0.0") || objectVersion < Version("0.25")) {
-    ILOG(Debug, Devel) << "Version of object " << fullPath << " is < 0.25" << ENDM;
-    // The object is either in a TFile or is a blob but it was stored with storeAsTFile as a full MO
-    mo.reset(dynamic_cast<MonitorObject*>(obj));
-    if (mo == nullptr) {
-      ILOG(Error, Devel) << "Could not cast the object " << fullPath << " to MonitorObject" << ENDM;
-      return nullptr;
+  auto result = build(object, headers);
+  if (result != nullptr && headers.count("ETag") > 0) {
+    size_t size = 0;
+    if (headers.count("Content-Length") > 0) {
+      size = std::stoull(headers.at("Content-Length"));
+    } else {
+      TBufferFile buffer(TBuffer::kWrite);
+      buffer.WriteObject(object);
+      size = buffer.Length();
     }
+    mRetrievalCache->insert(key, { result, headers.at("ETag"), size });
   } else {
-    // Version >= 0.25 -> the object is stored directly unencapsulated
-    ILOG(Debug, Devel) << "Version of object " << fullPath << " is >= 0.25" << ENDM;
-    mo = make_shared<MonitorObject>(obj, headers[metadata_keys::qcTaskName], headers[metadata_keys::qcTaskClass], headers[metadata_keys::qcDetectorCode]);
-    // TODO should we remove the headers we know are general such as ETag and qc_task_name ?
-    mo->addMetadata(headers);
-    // we could just copy the argument here, but this would not cover cases where the activity in headers has more non-default fields
-    mo->setActivity(database_helpers::asActivity(headers, activity.mProvenance));
+    mRetrievalCache->erase(key);
   }
-  mo->setIsOwner(true);
-  return mo;
+  return result;
+}
+
+std::shared_ptr<o2::quality_control::core::MonitorObject> CcdbDatabase::retrieveMO(std::string objectPath, std::string objectName, long timestamp, const core::Activity& activity)
+{
+  string fullPath = activity.mProvenance + "/" + objectPath + "/" + objectName;
+  map<string, string> metadata = database_helpers::asDatabaseMetadata(activity, false);
+  auto build = [&](TObject* obj, map<string, string>& headers) -> std::shared_ptr<TObject> {
+    // no object found
+    if (obj == nullptr) {
+      if (headers.count("Error") > 0) {
+        ILOG(Error, Support) << headers["Error"] << ENDM;
+      }
+      return nullptr;
+    }
+
+    // retrieve headers to determine the version of the QC framework
+    Version objectVersion(headers[metadata_keys::qcVersion]);
+    ILOG(Debug, Devel) << "Version of object is " << objectVersion << ENDM;
+
+    std::shared_ptr<MonitorObject> mo;
+    if (objectVersion == Version("0.0.0") || objectVersion < Version("0.25")) {
+      ILOG(Debug, Devel) << "Version of object " << fullPath << " is < 0.25" << ENDM;
+      // The object is either in a TFile or is a blob but it was stored with storeAsTFile as a full MO
+      mo.reset(dynamic_cast<MonitorObject*>(obj));
+      if (mo == nullptr) {
+        ILOG(Error, Devel) << "Could not cast the object " << fullPath << " to MonitorObject" << ENDM;
+        return nullptr;
+      }
+    } else {
+      // Version >= 0.25 -> the object is stored directly unencapsulated
+      ILOG(Debug, Devel) << "Version of object " << fullPath << " is >= 0.25" << ENDM;
+      mo = make_shared<MonitorObject>(obj, headers[metadata_keys::qcTaskName], headers[metadata_keys::qcTaskClass], headers[metadata_keys::qcDetectorCode]);
+      // TODO should we remove the headers we know are general such as ETag and qc_task_name ?
+      mo->addMetadata(headers);
+      // we could just copy the argument here, but this would not cover cases where the activity in headers has more non-default fields
+      mo->setActivity(database_helpers::asActivity(headers, activity.mProvenance));
+    }
+    mo->setIsOwner(true);
+    return mo;
+  };
+  return std::static_pointer_cast<MonitorObject>(retrieveCached(fullPath, metadata, timestamp, build));
 }
 
 std::shared_ptr<o2::quality_control::core::QualityObject> CcdbDatabase::retrieveQO(std::string qoPath, long timestamp, const core::Activity& activity)
 {
-  map<string, string> headers;
   map<string, string> metadata = database_helpers::asDatabaseMetadata(activity, false);
   auto fullPath = activity.mProvenance + "/" + qoPath;
-  TObject* obj = retrieveTObject(fullPath, metadata, timestamp, &headers);
-  std::shared_ptr<QualityObject> qo(dynamic_cast<QualityObject*>(obj));
-  if (qo == nullptr) {
-    ILOG(Error, Devel) << "Could not cast the object " << fullPath << " to QualityObject" << ENDM;
-  } else {
-    // TODO should we remove the headers we know are general such as ETag and qc_task_name ?
-    qo->addMetadata(headers);
-    // we could just copy the argument here, but this would not cover cases where the activity in headers has more non-default fields
-    qo->setActivity(database_helpers::asActivity(headers, activity.mProvenance));
+  auto build = [&](TObject* obj, map<string, string>& headers) -> std::shared_ptr<TObject> {
+    std::shared_ptr<QualityObject> qo(dynamic_cast<QualityObject*>(obj));
+    if (qo == nullptr) {
+      ILOG(Error, Devel) << "Could not cast the object " << fullPath << " to QualityObject" << ENDM;
+      delete obj;
+    } else {
+      // TODO should we remove the headers we know are general such as ETag and qc_task_name ?
+      qo->addMetadata(headers);
+      // we could just copy the argument here, but this would not cover cases where the activity in headers has more non-default fields
+      qo->setActivity(database_helpers::asActivity(headers, activity.mProvenance));
+    }
+    return qo;
+  };
+  return std::static_pointer_cast<QualityObject>(retrieveCached(fullPath, metadata, timestamp, build));
+}
+
+void CcdbDatabase::retrieveConcurrently(size_t n, const std::function<void(size_t)>& retrieve)
+{
+  auto retrieveOrLog = [&](size_t i) {
+    try {
+      retrieve(i);
+    } catch (const std::exception& e) {
+      ILOG(Error, Support) << "Failed to retrieve an object: " << e.what() << ENDM;
+    } catch (...) {
+      ILOG(Error, Support) << "Failed to retrieve an object: unknown exception" << ENDM;
+    }
+  };
+  if (mRetrievalThreads <= 1 || n <= 1) {
+    for (size_t i = 0; i < n; i++) {
+      retrieveOrLog(i);
+    }
+    return;
+  }
+  if (!mRetrievalPool) {
+    // the objects are deserialized by several threads at the same time
+    ROOT::EnableThreadSafety();
+    // the calling thread takes part in the retrieval
+    mRetrievalPool = std::make_shared<ThreadPool>(mRetrievalThreads - 1, "QC/CcdbRetr");
   }
-  return qo;
+  mRetrievalPool->parallelFor(n, retrieveOrLog);
+}
+
+std::vector<std::shared_ptr<o2::quality_control::core::MonitorObject>> CcdbDatabase::retrieveMOs(const std::vector<MORequest>& requests)
+{
+  std::vector<std::shared_ptr<MonitorObject>> results(requests.size());
+  retrieveConcurrently(requests.size(), [&](size_t i) {
+    const auto& request = requests[i];
+    results[i] = retrieveMO(request.objectPath, request.objectName, request.timestamp, request.activity);
+  });
+  return results;
+}
+
+std::vector<std::shared_ptr<o2::quality_control::core::QualityObject>> CcdbDatabase::retrieveQOs(const std::vector<QORequest>& requests)
+{
+  std::vector<std::shared_ptr<QualityObject>> results(requests.size());
+  retrieveConcurrently(requests.size(), [&](size_t i) {
+    const auto& request = requests[i];
+    results[i] = retrieveQO(request.qoPath, request.timestamp, request.activity);
+  });
+  return results;
 }
 
 std::shared_ptr<o2::quality_control::TimeRangeFlagCollection> CcdbDatabase::retrieveTRFC(const std::string& trfcName, const std::string& detector, int runNumber, const string& passName, const string& periodName, const std::string& provenance, long timestamp)
 {
   map<string, string> headers;
+  auto trfc = retrieveTRFC(trfcName, detector, runNumber, passName, periodName, provenance, timestamp, headers);
+  if (headers.empty()) {
+    ILOG(Error, Support) << "Could not extract headers of TRFC at '" << RepoPathUtils::getTrfcPath(detector, trfcName, provenance) << "' with the metadata: " << ENDM; // TODO
+    ILOG(Error, Support) << " - RunNumber  : " << (runNumber != 0 ? std::to_string(runNumber) : "") << ENDM;
+    ILOG(Error, Support) << " - PassName   : " << passName << ENDM;
+    ILOG(Error, Support) << " - PeriodName : " << periodName << ENDM;
+  }
+  return trfc;
+}
+
+std::shared_ptr<o2::quality_control::TimeRangeFlagCollection> CcdbDatabase::retrieveTRFC(const std::string& trfcName, const std::string& detector, int runNumber, const string& passName, const string& periodName, const std::string& provenance, long timestamp,
+                                                                                         std::map<std::string, std::string>& headers)
+{
   map<string, string> metadata;
   if (runNumber != 0) {
     metadata[metadata_keys::runNumber] = std::to_string(runNumber);
@@ -412,12 +529,9 @@ std::shared_ptr<o2::quality_control::TimeRangeFlagCollection> CcdbDatabase::retr
   }
 
   auto resultMetadata = ccdbApi->retrieveHeaders(trfcPath, metadata, timestamp);
+  headers = resultMetadata;
   if (resultMetadata.empty()) {
-    ILOG(Error, Support) << "Could not extract headers of TRFC at '" << trfcPath << "' with the metadata: " << ENDM; // TODO
-    ILOG(Error, Support) << " - RunNumber  : " << metadata[metadata_keys::runNumber] << ENDM;
-    ILOG(Error, Support) << " - PassName   : " << metadata[metadata_keys::passName] << ENDM;
-    ILOG(Error, Support) << " - PeriodName : " << metadata[metadata_keys::periodName] << ENDM;
-    return nullptr;
+    return nullptr; // there is no such TRFC, the caller decides whether it is an error
   }
 
   auto success = ccdbApi->retrieveBlob(trfcPath, localFileDir, metadata, timestamp, false, localFileName);
@@ -501,7 +615,11 @@ std::string CcdbDatabase::retrieveJson(std::string path, long timestamp, const s
 
 void CcdbDatabase::disconnect()
 {
-  // NOOP for CCDB
+  if (mRetrievalCache) {
+    auto statistics = mRetrievalCache->getStatistics();
+    ILOG(Info, Support) << "Retrieval cache: " << statistics.hits << " hits, " << statistics.misses << " misses, "
+                        << statistics.bytesSaved << " bytes saved" << ENDM;
+  }
 }
 
 void CcdbDatabase::prepareTaskDataContainer(std::string /*taskName*/)
@@ -509,9 +627,9 @@ void CcdbDatabase::prepareTaskDataContainer(std::string /*taskName*/)
   // NOOP for CCDB
 }
 
-std::string CcdbDatabase::getListingAsString(const std::string& subpath, const std::string& accept)
+std::string CcdbDatabase::getListingAsString(const std::string& subpath, const std::string& accept, long createdNotBefore, long createdNotAfter)
 {
-  std::string tempString = ccdbApi->list(subpath, false, accept);
+  std::string tempString = ccdbApi->list(subpath, false, accept, createdNotAfter, createdNotBefore);
 
   return tempString;
 }
@@ -551,9 +669,9 @@ std::vector<std::string> CcdbDatabase::getListing(const std::string& subpath)
   return result;
 }
 
-boost::property_tree::ptree CcdbDatabase::getListingAsPtree(const std::string& path)
+boost::property_tree::ptree CcdbDatabase::getListingAsPtree(const std::string& path, long createdNotBefore)
 {
-  std::stringstream listingAsStringStream{ getListingAsString(path, "application/json") };
+  std::stringstream listingAsStringStream{ getListingAsString(path, "application/json", createdNotBefore) };
 
   boost::property_tree::ptree listingAsTree;
   boost::property_tree::read_json(listingAsStringStream, listingAsTree);
@@ -561,19 +679,28 @@ boost::property_tree::ptree CcdbDatabase::getListingAsPtree(const std::string& p
   return listingAsTree;
 }
 
-std::vector<uint64_t> CcdbDatabase::getTimestampsForObject(const std::string& path)
+size_t CcdbDatabase::forEachListedObject(const std::string& path, const std::vector<std::string>& keys,
+                                         const CcdbListingReader::Callback& callback,
+                                         long createdNotBefore, long createdNotAfter, long windowDuration)
 {
-  const auto& objects = getListingAsPtree(path).get_child("objects");
-  std::vector<uint64_t> timestamps;
-  timestamps.reserve(objects.size());
+  CcdbListingReader reader(keys);
+  auto getListing = [&](long windowStart, long windowEnd) {
+    return getListingAsString(path, "application/json", windowStart, windowEnd);
+  };
+  return reader.readInWindows(getListing, callback, createdNotBefore, createdNotAfter, windowDuration, getCurrentTimestamp());
+}
 
-  // As for today, we receive objects in the order of the newest to the oldest.
-  // We prefer the other order here.
-  for (auto rit = objects.rbegin(); rit != objects.rend(); ++rit) {
-    timestamps.emplace_back(rit->second.get<uint64_t>(metadata_keys::validFrom));
-  }
+std::vector<uint64_t> CcdbDatabase::getTimestampsForObject(const std::string& path, long createdNotBefore, long createdNotAfter)
+{
+  std::vector<uint64_t> timestamps;
+  forEachListedObject(
+    path, { metadata_keys::validFrom }, [&](const CcdbListingReader::Entry& entry) {
+      timestamps.emplace_back(std::stoull(entry[0]));
+      return true;
+    },
+    createdNotBefore, createdNotAfter);
 
-  // we make sure it is sorted. If it is already, it shouldn't cost much.
+  // We receive the objects from the newest to the oldest, by creation time, which is not always the order of validity.
   std::sort(timestamps.begin(), timestamps.end());
   return timestamps;
 }
@@ -583,17 +710,11 @@ std::vector<std::string> CcdbDatabase::getPublishedObjectNames(std::string taskN
   std::vector<string> result;
   string listing = ccdbApi->list(taskName + "/.*", true, "Application/JSON");
 
-  boost::property_tree::ptree pt;
-  stringstream ss;
-  ss << listing;
-  boost::property_tree::read_json(ss, pt);
-
-  BOOST_FOREACH (boost::property_tree::ptree::value_type& v, pt.get_child("objects")) {
-    assert(v.first.empty()); // array elements have no names
-    string data = v.second.get_child("path").data();
-    string path = data.substr(taskName.size());
-    result.push_back(path);
-  }
+  CcdbListingReader reader({ "path" });
+  reader.read(listing, [&](const CcdbListingReader::Entry& entry) {
+    result.push_back(entry[0].substr(std::min(taskName.size(), entry[0].size())));
+    return true;
+  });
 
   return result;
 }
@@ -643,4 +764,14 @@ void CcdbDatabase::setMaxObjectSize(size_t maxObjectSize)
   CcdbDatabase::mMaxObjectSize = maxObjectSize;
 }
 
+void CcdbDatabase::setRetrievalCacheSize(size_t maxBytes)
+{
+  mRetrievalCache = maxBytes > 0 ? std::make_shared<RetrievalCache>(maxBytes) : nullptr;
+}
+
+RetrievalCache::Statistics CcdbDatabase::getRetrievalCacheStatistics() const
+{
+  return mRetrievalCache ? mRetrievalCache->getStatistics() : RetrievalCache::Statistics{};
+}
+
 } // namespace o2::quality_control::repository
@@ -0,0 +1,195 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CcdbListingReader.cxx
+///
+
+#include "QualityControl/CcdbListingReader.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <rapidjson/error/en.h>
+#include <rapidjson/reader.h>
+
+namespace o2::quality_control::repository
+{
+
+namespace
+{
+
+/// SAX handler extracting the requested keys of the entries of the top-level "objects" array.
+/// Depth 1 is the root object, depth 2 the "objects" array, depth 3 an entry.
+class ListingHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, ListingHandler>
+{
+ public:
+  ListingHandler(const std::vector<std::string>& keys, const CcdbListingReader::Callback& callback)
+    : mKeys(keys), mCallback(callback), mEntry(keys.size())
+  {
+  }
+
+  bool StartObject()
+  {
+    mDepth++;
+    if (mDepth == 3 && mInObjects) {
+      for (auto& value : mEntry) {
+        value.clear();
+      }
+    }
+    mCurrentKey = -1;
+    return true;
+  }
+
+  bool EndObject(rapidjson::SizeType)
+  {
+    if (mDepth == 3 && mInObjects) {
+      mEntries++;
+      if (!mCallback(mEntry)) {
+        return false; // stops the parsing, it is not an error
+      }
+    }
+    mDepth--;
+    mCurrentKey = -1;
+    return true;
+  }
+
+  bool StartArray()
+  {
+    mDepth++;
+    if (mDepth == 2 && mLastTopLevelKeyIsObjects) {
+      mInObjects = true;
+    }
+    mCurrentKey = -1;
+    return true;
+  }
+
+  bool EndArray(rapidjson::SizeType)
+  {
+    if (mDepth == 2) {
+      mInObjects = false;
+    }
+    mDepth--;
+    mCurrentKey = -1;
+    return true;
+  }
+
+  bool Key(const char* str, rapidjson::SizeType length, bool)
+  {
+    mCurrentKey = -1;
+    if (mDepth == 1) {
+      mLastTopLevelKeyIsObjects = std::string_view(str, length) == "objects";
+    } else if (mDepth == 3 && mInObjects) {
+      for (size_t i = 0; i < mKeys.size(); i++) {
+        if (mKeys[i].size() == length && mKeys[i].compare(0, length, str, length) == 0) {
+          mCurrentKey = static_cast<int>(i);
+          break;
+        }
+      }
+    }
+    return true;
+  }
+
+  bool String(const char* str, rapidjson::SizeType length, bool) { return value(str, length); }
+  // with kParseNumbersAsStringsFlag all the numbers end up here, in their textual form
+  bool RawNumber(const char* str, rapidjson::SizeType length, bool) { return value(str, length); }
+  bool Bool(bool b) { return b ? value("true", 4) : value("false", 5); }
+  bool Null() { return value("", 0); }
+
+  size_t getEntries() const { return mEntries; }
+
+ private:
+  bool value(const char* str, rapidjson::SizeType length)
+  {
+    if (mCurrentKey >= 0) {
+      mEntry[mCurrentKey].assign(str, length);
+      mCurrentKey = -1;
+    }
+    return true;
+  }
+
+  const std::vector<std::string>& mKeys;
+  const CcdbListingReader::Callback& mCallback;
+  CcdbListingReader::Entry mEntry;
+  int mDepth = 0;
+  int mCurrentKey = -1;
+  bool mLastTopLevelKeyIsObjects = false;
+  bool mInObjects = false;
+  size_t mEntries = 0;
+};
+
+} // namespace
+
+CcdbListingReader::CcdbListingReader(std::vector<std::string> keys) : mKeys(std::move(keys))
+{
+}
+
+size_t CcdbListingReader::read(const std::string& listing, const Callback& callback) const
+{
+  bool stopped = false;
+  Callback wrapper = [&](const Entry& entry) {
+    stopped = !callback(entry);
+    return !stopped;
+  };
+  ListingHandler handler(mKeys, wrapper);
+  rapidjson::Reader reader;
+  rapidjson::StringStream stream(listing.c_str());
+  auto result = reader.Parse<rapidjson::kParseNumbersAsStringsFlag>(stream, handler);
+  if (result.IsError() && !(stopped && result.Code() == rapidjson::kParseErrorTermination)) {
+    throw std::runtime_error(std::string("Could not parse the CCDB listing: ") + rapidjson::GetParseError_En(result.Code()) +
+                             " (offset " + std::to_string(result.Offset()) + ")");
+  }
+  return handler.getEntries();
+}
+
+size_t CcdbListingReader::readInWindows(const ListingGetter& getListing, const Callback& callback, long createdNotBefore,
+                                        long createdNotAfter, long windowDuration, long now) const
+{
+  if (windowDuration <= 0) {
+    return read(getListing(createdNotBefore, createdNotAfter), callback);
+  }
+
+  bool stopped = false;
+  Callback wrapper = [&](const Entry& entry) {
+    stopped = !callback(entry);
+    return !stopped;
+  };
+  const long oldest = std::max(createdNotBefore, 0L);
+  long windowEnd = createdNotAfter < 0 ? now : createdNotAfter;
+  bool openEnded = createdNotAfter < 0;
+  size_t entries = 0;
+  while (!stopped && windowEnd >= oldest) {
+    long windowStart = std::max(oldest, windowEnd - windowDuration + 1);
+    size_t windowEntries = read(getListing(windowStart, openEnded ? -1 : windowEnd), wrapper);
+    entries += windowEntries;
+    if (windowEntries < sTargetEntriesPerWindow / 2) {
+      windowDuration *= 2;
+    } else if (windowEntries > sTargetEntriesPerWindow * 2) {
+      windowDuration = std::max(windowDuration / 2, 1L);
+    }
+    windowEnd = windowStart - 1;
+    openEnded = false;
+  }
+  return entries;
+}
+
+std::map<std::string, std::string> CcdbListingReader::asMetadata(const Entry& entry) const
+{
+  std::map<std::string, std::string> metadata;
+  for (size_t i = 0; i < mKeys.size() && i < entry.size(); i++) {
+    if (!entry[i].empty()) {
+      metadata.emplace(mKeys[i], entry[i]);
+    }
+  }
+  return metadata;
+}
+
+} // namespace o2::quality_control::repository
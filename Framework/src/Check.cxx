@@ -85,12 +85,28 @@ void Check::init()
 }
 
 QualityObjectsType Check::check(std::map<std::string, std::shared_ptr<MonitorObject>>& moMap)
+{
+  QualityObjectsType qualityObjects;
+  for (auto& moMapToCheck : prepareInputs(moMap)) {
+    auto qo = evaluate(moMapToCheck);
+    if (qo == nullptr) {
+      continue;
+    }
+    ILOG(Debug, Devel) << "Check '" << mCheckConfig.name << "', quality '" << qo->getQuality() << "'" << ENDM;
+    beautify(moMapToCheck, qo->getQuality());
+    qualityObjects.emplace_back(std::move(qo));
+  }
+
+  return qualityObjects;
+}
+
+std::vector<Check::MonitorObjectsMap> Check::prepareInputs(const MonitorObjectsMap& moMap) const
 {
   if (mCheckInterface == nullptr) {
     BOOST_THROW_EXCEPTION(FatalException() << errinfo_details("Attempting to check, but no CheckInterface is loaded"));
   }
 
-  std::map<std::string, std::shared_ptr<MonitorObject>> shadowMap;
+  MonitorObjectsMap shadowMap;
   // Take only the MOs which are needed to be checked
   if (mCheckConfig.allObjects) {
     /*
@@ -108,68 +124,71 @@ QualityObjectsType Check::check(std::map<std::string, std::shared_ptr<MonitorObj
      */
     for (auto& key : mCheckConfig.objectNames) {
       // don't create empty shared_ptr
-      if (moMap.count(key)) {
-        shadowMap.insert({ key, moMap[key] });
+      if (auto it = moMap.find(key); it != moMap.end()) {
+        shadowMap.insert(*it);
       }
     }
   }
 
   // Prepare a vector of MO maps to be checked, each one will receive a separate Quality.
-  std::vector<std::map<std::string, std::shared_ptr<MonitorObject>>> moMapsToCheck;
+  std::vector<MonitorObjectsMap> moMapsToCheck;
   if (mCheckConfig.policyType == UpdatePolicyType::OnEachSeparately) {
     // In this case we want to check all MOs separately and we get separate QOs for them.
     for (auto mo : shadowMap) {
       moMapsToCheck.push_back({ std::move(mo) });
     }
   } else {
-    moMapsToCheck.emplace_back(shadowMap);
+    moMapsToCheck.emplace_back(std::move(shadowMap));
   }
+  return moMapsToCheck;
+}
 
-  QualityObjectsType qualityObjects;
-  for (auto& moMapToCheck : moMapsToCheck) {
-    std::vector<std::string> monitorObjectsNames;
-    boost::copy(moMapToCheck | boost::adaptors::map_keys, std::back_inserter(monitorObjectsNames));
-
-    if (std::any_of(moMapToCheck.begin(), moMapToCheck.end(), [](const std::pair<std::string, std::shared_ptr<MonitorObject>>& item) {
-          return item.second == nullptr || item.second->getObject() == nullptr;
-        })) {
-      ILOG(Warning, Devel) << "Some MOs in the map to check are nullptr, skipping check '" << mCheckInterface->getName() << "'" << ENDM;
-      continue;
-    }
+std::shared_ptr<QualityObject> Check::evaluate(MonitorObjectsMap& moMapToCheck)
+{
+  std::vector<std::string> monitorObjectsNames;
+  boost::copy(moMapToCheck | boost::adaptors::map_keys, std::back_inserter(monitorObjectsNames));
 
-    Quality quality;
-    try {
-      quality = mCheckInterface->check(&moMapToCheck);
-    } catch (...) {
-      std::string diagnostic = boost::current_exception_diagnostic_information();
-      ILOG(Error, Ops) << "Unexpected exception in user code (check):"
-                       << diagnostic << ENDM;
-      continue;
-    }
-    auto commonActivity = ActivityHelpers::strictestMatchingActivity(
-      moMapToCheck.begin(),
-      moMapToCheck.end(),
-      [](const std::pair<std::string, std::shared_ptr<MonitorObject>>& item) -> const Activity& {
-        return item.second->getActivity();
-      });
+  if (std::any_of(moMapToCheck.begin(), moMapToCheck.end(), [](const std::pair<std::string, std::shared_ptr<MonitorObject>>& item) {
+        return item.second == nullptr || item.second->getObject() == nullptr;
+      })) {
+    ILOG(Warning, Devel) << "Some MOs in the map to check are nullptr, skipping check '" << mCheckInterface->getName() << "'" << ENDM;
+    return nullptr;
+  }
 
-    ILOG(Debug, Devel) << "Check '" << mCheckConfig.name << "', quality '" << quality << "'" << ENDM;
-    // todo: take metadata from somewhere
-    qualityObjects.emplace_back(std::make_shared<QualityObject>(
-      quality,
-      mCheckConfig.name,
-      mCheckConfig.detectorName,
-      UpdatePolicyTypeUtils::ToString(mCheckConfig.policyType),
-      stringifyInput(mCheckConfig.inputSpecs),
-      monitorObjectsNames));
-    qualityObjects.back()->setActivity(commonActivity);
-    beautify(moMapToCheck, quality);
+  Quality quality;
+  try {
+    quality = mCheckInterface->check(&moMapToCheck);
+  } catch (...) {
+    std::string diagnostic = boost::current_exception_diagnostic_information();
+    ILOG(Error, Ops) << "Unexpected exception in user code (check):"
+                     << diagnostic << ENDM;
+    return nullptr;
   }
+  auto commonActivity = ActivityHelpers::strictestMatchingActivity(
+    moMapToCheck.begin(),
+    moMapToCheck.end(),
+    [](const std::pair<std::string, std::shared_ptr<MonitorObject>>& item) -> const Activity& {
+      return item.second->getActivity();
+    });
 
-  return qualityObjects;
+  // todo: take metadata from somewhere
+  auto qualityObject = std::make_shared<QualityObject>(
+    quality,
+    mCheckConfig.name,
+    mCheckConfig.detectorName,
+    UpdatePolicyTypeUtils::ToString(mCheckConfig.policyType),
+    stringifyInput(mCheckConfig.inputSpecs),
+    monitorObjectsNames);
+  qualityObject->setActivity(commonActivity);
+  return qualityObject;
+}
+
+bool Check::isReentrant() const
+{
+  return mCheckInterface != nullptr && mCheckInterface->isReentrant();
 }
 
-void Check::beautify(std::map<std::string, std::shared_ptr<MonitorObject>>& moMap, const Quality& quality)
+void Check::beautify(MonitorObjectsMap& moMap, const Quality& quality)
 {
   if (!mCheckConfig.allowBeautify) {
     return;
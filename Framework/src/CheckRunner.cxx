@@ -28,6 +28,8 @@
 #include <utility>
 // QC
 #include "QualityControl/DatabaseFactory.h"
+#include "QualityControl/StorageQueue.h"
+#include "QualityControl/ThreadPool.h"
 #include "QualityControl/ServiceDiscovery.h"
 #include "QualityControl/runnerUtils.h"
 #include "QualityControl/InfrastructureSpecReader.h"
@@ -36,6 +38,7 @@
 #include "QualityControl/ConfigParamGlo.h"
 #include "QualityControl/Bookkeeping.h"
 
+#include <TROOT.h>
 #include <TSystem.h>
 
 using namespace std::chrono;
@@ -163,6 +166,7 @@ CheckRunner::CheckRunner(CheckRunnerConfig checkRunnerConfig, InputSpec input)
 CheckRunner::~CheckRunner()
 {
   ILOG(Debug, Trace) << "CheckRunner destructor (" << this << ")" << ENDM;
+  mStorageQueue.reset(); // uploads what is left in the queue
   if (mServiceDiscovery != nullptr) {
     mServiceDiscovery->deregister();
   }
@@ -228,9 +232,21 @@ void CheckRunner::init(framework::InitContext& iCtx)
     iCtx.services().get<CallbackService>().set<CallbackService::Id::Stop>([this]() { stop(); });
 
     updatePolicyManager.reset();
+    mChecksByActorId.clear();
     for (auto& [checkName, check] : mChecks) {
       check.init();
       updatePolicyManager.addPolicy(check.getName(), check.getUpdatePolicyType(), check.getObjectsNames(), check.getAllObjectsOption(), false);
+      auto actorId = updatePolicyManager.getActorId(check.getName());
+      if (actorId >= mChecksByActorId.size()) {
+        mChecksByActorId.resize(actorId + 1, nullptr);
+      }
+      mChecksByActorId[actorId] = &check;
+    }
+    if (mConfig.threads > 1) {
+      // the checks, i.e. user code, use ROOT in the worker threads. The workers log with their own InfoLogger.
+      ROOT::EnableThreadSafety();
+      mThreadPool = std::make_shared<ThreadPool>(mConfig.threads - 1, "QC/Check"); // the processing thread also takes part
+      ILOG(Info, Devel) << "Checks will be evaluated in parallel with " << mConfig.threads << " threads" << ENDM;
     }
   } catch (...) {
     // catch the exceptions and print it (the ultimate caller might not know how to display it)
@@ -291,13 +307,12 @@ void CheckRunner::prepareCacheData(framework::InputRecord& inputRecord)
                            << " entries from " << input.binding << ENDM;
       } else {
         // it is just a TObject not embedded in a TObjArray. We build a TObjArray for it.
-        auto* newArray = new TObjArray();    // we cannot use `array` to add an object as it is const
-        TObject* newTObject = tobj->Clone(); // we need a copy to avoid that it gets deleted behind our back.
-        newArray->Add(newTObject);
-        array.reset(newArray); // now that the array is ready we can adopt it.
         ILOG(Debug, Devel) << "CheckRunner " << mDeviceName
                            << " received a tobject named " << tobj->GetName()
                            << " from " << input.binding << ENDM;
+        auto* newArray = new TObjArray(); // we cannot use `array` to add an object as it is const
+        newArray->Add(tobj.release());    // the deserialized object is ours, no need to copy it
+        array.reset(newArray);            // now that the array is ready we can adopt it.
       }
 
       // for each item of the array, check whether it is a MonitorObject. If not, create one and encapsulate.
@@ -315,8 +330,9 @@ void CheckRunner::prepareCacheData(framework::InputRecord& inputRecord)
 
         if (mo) {
           mo->setIsOwner(true);
-          mMonitorObjects[mo->getFullName()] = mo;
-          updatePolicyManager.updateObjectRevision(mo->getFullName());
+          auto objectId = updatePolicyManager.getObjectId(mo->getFullName());
+          getMonitorObjectSlot(objectId, mo)->second = mo;
+          updatePolicyManager.updateObjectRevision(objectId);
           mTotalNumberObjectsReceived++;
 
           if (store) { // Monitor Object will be stored later, after possible beautification
@@ -328,6 +344,18 @@ void CheckRunner::prepareCacheData(framework::InputRecord& inputRecord)
   }
 }
 
+CheckRunner::MonitorObjectsMap::iterator CheckRunner::getMonitorObjectSlot(ObjectIdType objectId, const std::shared_ptr<MonitorObject>& mo)
+{
+  if (objectId >= mMonitorObjectSlots.size()) {
+    mMonitorObjectSlots.resize(objectId + 1, mMonitorObjects.end());
+  }
+  auto& slot = mMonitorObjectSlots[objectId];
+  if (slot == mMonitorObjects.end()) {
+    slot = mMonitorObjects.emplace(mo->getFullName(), nullptr).first;
+  }
+  return slot;
+}
+
 void CheckRunner::sendPeriodicMonitoring()
 {
   if (mTimer.isTimeout()) {
@@ -345,6 +373,17 @@ void CheckRunner::sendPeriodicMonitoring()
                        .addValue(rateQOs, "qos_per_second"));
     mCollector->send({ mTotalQOSent, "qc_checkrunner_qo_sent" });
     mCollector->send({ mTimerTotalDurationActivity.getTime(), "qc_checkrunner_duration" });
+    if (mStorageQueue) {
+      auto stats = mStorageQueue->getStats();
+      mCollector->send(Metric{ "qc_checkrunner_storage_queue" }
+                         .addValue(stats.queueSize, "depth")
+                         .addValue(stats.stored, "stored")
+                         .addValue(stats.failed, "failed")
+                         .addValue(stats.dropped, "dropped")
+                         .addValue(stats.coalesced, "coalesced")
+                         .addValue(stats.meanLatencyMs, "mean_latency_ms")
+                         .addValue(stats.maxLatencyMs, "max_latency_ms"));
+    }
     mNumberQOStored = 0;
     mNumberMOStored = 0;
   }
@@ -355,20 +394,83 @@ QualityObjectsType CheckRunner::check()
   ILOG(Debug, Devel) << "Trying " << mChecks.size() << " checks for " << mMonitorObjects.size() << " monitor objects"
                      << ENDM;
 
+  // The checks whose inputs were not updated are not ready, we do not even look at them.
+  // The actor IDs follow the order of mChecks, thus the checks are run in the same order as before.
+  std::vector<Check*> readyChecks;
+  for (auto actorId : updatePolicyManager.getDirtyActors()) {
+    auto* check = mChecksByActorId[actorId];
+    if (updatePolicyManager.isReady(actorId)) {
+      readyChecks.push_back(check);
+    } else {
+      ILOG(Info, Support) << "Monitor Objects for the check '" << check->getName() << "' are not ready, ignoring" << ENDM;
+    }
+  }
+
+  if (mThreadPool != nullptr) {
+    return checkInParallel(readyChecks);
+  }
+
   QualityObjectsType allQOs;
-  for (auto& [checkName, check] : mChecks) {
-    if (updatePolicyManager.isReady(check.getName())) {
-      auto newQOs = check.check(mMonitorObjects);
-      mTotalNumberCheckExecuted += newQOs.size();
+  for (auto* check : readyChecks) {
+    auto newQOs = check->check(mMonitorObjects);
+    mTotalNumberCheckExecuted += newQOs.size();
 
-      allQOs.insert(allQOs.end(), std::make_move_iterator(newQOs.begin()), std::make_move_iterator(newQOs.end()));
-      newQOs.clear();
+    allQOs.insert(allQOs.end(), std::make_move_iterator(newQOs.begin()), std::make_move_iterator(newQOs.end()));
+    newQOs.clear();
 
-      // Was checked, update latest revision
-      updatePolicyManager.updateActorRevision(checkName);
-    } else {
-      ILOG(Info, Support) << "Monitor Objects for the check '" << checkName << "' are not ready, ignoring" << ENDM;
+    // Was checked, update latest revision
+    updatePolicyManager.updateActorRevision(check->getName());
+  }
+  return allQOs;
+}
+
+QualityObjectsType CheckRunner::checkInParallel(const std::vector<Check*>& checks)
+{
+  // A job evaluates either one input of a reentrant check or all the inputs of a non-reentrant one,
+  // so that a non-reentrant CheckInterface is never called from two threads at the same time.
+  struct Job {
+    size_t check;
+    size_t firstInput;
+    size_t endInput;
+  };
+  std::vector<std::vector<Check::MonitorObjectsMap>> inputs(checks.size());
+  std::vector<QualityObjectsType> results(checks.size());
+  std::vector<Job> jobs;
+  for (size_t c = 0; c < checks.size(); c++) {
+    inputs[c] = checks[c]->prepareInputs(mMonitorObjects);
+    results[c].resize(inputs[c].size());
+    if (checks[c]->isReentrant()) {
+      for (size_t i = 0; i < inputs[c].size(); i++) {
+        jobs.push_back({ c, i, i + 1 });
+      }
+    } else if (!inputs[c].empty()) {
+      jobs.push_back({ c, 0, inputs[c].size() });
+    }
+  }
+
+  mThreadPool->parallelFor(jobs.size(), [&](size_t j) {
+    const auto& job = jobs[j];
+    for (size_t i = job.firstInput; i < job.endInput; i++) {
+      results[job.check][i] = checks[job.check]->evaluate(inputs[job.check][i]);
     }
+  });
+
+  // Beautification modifies MOs which might be shared by several checks, thus it is done sequentially.
+  // We also keep the order of QOs the same as in the sequential mode.
+  QualityObjectsType allQOs;
+  for (size_t c = 0; c < checks.size(); c++) {
+    for (size_t i = 0; i < inputs[c].size(); i++) {
+      auto& qo = results[c][i];
+      if (qo == nullptr) {
+        continue;
+      }
+      ILOG(Debug, Devel) << "Check '" << checks[c]->getName() << "', quality '" << qo->getQuality() << "'" << ENDM;
+      checks[c]->beautify(inputs[c][i], qo->getQuality());
+      allQOs.push_back(std::move(qo));
+      mTotalNumberCheckExecuted++;
+    }
+    // Was checked, update latest revision
+    updatePolicyManager.updateActorRevision(checks[c]->getName());
   }
   return allQOs;
 }
@@ -379,7 +481,11 @@ void CheckRunner::store(QualityObjectsType& qualityObjects, long validFrom)
   try {
     for (auto& qo : qualityObjects) {
       qo->setActivity(*mActivity);
-      mDatabase->storeQO(qo, validFrom);
+      if (mStorageQueue) {
+        mStorageQueue->enqueue(qo, validFrom);
+      } else {
+        mDatabase->storeQO(qo, validFrom);
+      }
       mTotalNumberQOStored++;
       mNumberQOStored++;
     }
@@ -394,7 +500,11 @@ void CheckRunner::store(std::vector<std::shared_ptr<MonitorObject>>& monitorObje
   try {
     for (auto& mo : monitorObjects) {
       mo->setActivity(*mActivity);
-      mDatabase->storeMO(mo, validFrom);
+      if (mStorageQueue) {
+        mStorageQueue->enqueue(mo, validFrom);
+      } else {
+        mDatabase->storeMO(mo, validFrom);
+      }
       mTotalNumberMOStored++;
       mNumberMOStored++;
     }
@@ -455,6 +565,27 @@ void CheckRunner::initDatabase()
   mDatabase = DatabaseFactory::create(mConfig.database.at("implementation"));
   mDatabase->connect(mConfig.database);
   ILOG(Info, Devel) << "Database that is going to be used > Implementation : " << mConfig.database.at("implementation") << " / Host : " << mConfig.database.at("host") << ENDM;
+
+  auto asyncStorage = mConfig.database.find("asyncStorage");
+  if (asyncStorage == mConfig.database.end() || (asyncStorage->second != "true" && asyncStorage->second != "1")) {
+    return;
+  }
+  auto getOrDefault = [&](const std::string& key, const std::string& defaultValue) {
+    auto it = mConfig.database.find(key);
+    return it != mConfig.database.end() ? it->second : defaultValue;
+  };
+  size_t threads = std::max(1, std::stoi(getOrDefault("asyncStorageThreads", "1")));
+  size_t queueSize = std::stoul(getOrDefault("asyncStorageQueueSize", "1000"));
+  auto policy = StorageQueue::policyFromString(getOrDefault("asyncStorageOverflowPolicy", "block"));
+  // each worker gets its own connection, so that the uploads do not share the state of a backend.
+  std::vector<std::shared_ptr<DatabaseInterface>> backends;
+  for (size_t i = 0; i < threads; i++) {
+    std::shared_ptr<DatabaseInterface> backend = DatabaseFactory::create(mConfig.database.at("implementation"));
+    backend->connect(mConfig.database);
+    backends.push_back(std::move(backend));
+  }
+  mStorageQueue = std::make_shared<StorageQueue>(std::move(backends), queueSize, policy);
+  ILOG(Info, Devel) << "Objects will be stored asynchronously with " << threads << " thread(s) and a queue of " << queueSize << " objects" << ENDM;
 }
 
 void CheckRunner::initMonitoring()
@@ -511,6 +642,9 @@ void CheckRunner::initLibraries()
 void CheckRunner::endOfStream(framework::EndOfStreamContext& eosContext)
 {
   mReceivedEOS = true;
+  if (mStorageQueue) {
+    mStorageQueue->flush();
+  }
 }
 
 void CheckRunner::start(ServiceRegistryRef services)
@@ -532,6 +666,9 @@ void CheckRunner::start(ServiceRegistryRef services)
 void CheckRunner::stop()
 {
   ILOG(Info, Support) << "Stopping run " << mActivity->mId << ENDM;
+  if (mStorageQueue) {
+    mStorageQueue->flush();
+  }
   if (!mReceivedEOS) {
     ILOG(Warning, Devel) << "The STOP transition happened before an EndOfStream was received. The very last QC objects in this run might not have been stored." << ENDM;
   }
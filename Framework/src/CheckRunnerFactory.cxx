@@ -98,7 +98,8 @@ CheckRunnerConfig CheckRunnerFactory::extractConfig(const CommonSpec& commonSpec
     commonSpec.bookkeepingUrl,
     commonSpec.infologgerDiscardParameters,
     fallbackActivity,
-    options
+    options,
+    commonSpec.checkRunnerThreads
   };
 }
 
@@ -56,6 +56,16 @@ std::shared_ptr<o2::quality_control::core::QualityObject> DummyDatabase::retriev
   return {};
 }
 
+std::vector<std::shared_ptr<o2::quality_control::core::MonitorObject>> DummyDatabase::retrieveMOs(const std::vector<MORequest>& requests)
+{
+  return std::vector<std::shared_ptr<o2::quality_control::core::MonitorObject>>(requests.size());
+}
+
+std::vector<std::shared_ptr<o2::quality_control::core::QualityObject>> DummyDatabase::retrieveQOs(const std::vector<QORequest>& requests)
+{
+  return std::vector<std::shared_ptr<o2::quality_control::core::QualityObject>>(requests.size());
+}
+
 void DummyDatabase::disconnect()
 {
 }
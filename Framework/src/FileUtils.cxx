@@ -0,0 +1,59 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   FileUtils.cxx
+///
+
+#include "QualityControl/FileUtils.h"
+#include "QualityControl/QcInfoLogger.h"
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace o2::quality_control::core
+{
+
+namespace
+{
+/// Makes the kernel write the file, or the directory entries, to the disk. Returns false and sets errno on failure.
+bool syncToDisk(const std::string& path)
+{
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  bool success = ::fsync(fd) == 0;
+  int error = errno;
+  ::close(fd);
+  errno = error;
+  return success;
+}
+} // namespace
+
+bool replaceFileDurably(const std::string& temporaryPath, const std::string& path)
+{
+  if (!syncToDisk(temporaryPath)) {
+    return false;
+  }
+  std::filesystem::rename(temporaryPath, path);
+  auto directory = std::filesystem::path(path).parent_path();
+  if (!syncToDisk(directory.empty() ? "." : directory.string())) {
+    ILOG(Warning, Support) << "Could not sync the directory of " << path << ", the rename might be lost after a crash: "
+                           << std::strerror(errno) << ENDM;
+  }
+  return true;
+}
+
+} // namespace o2::quality_control::core
@@ -303,7 +303,7 @@ framework::WorkflowSpec InfrastructureGenerator::generateLocalBatchInfrastructur
                          std::move(fileSinkInputs),
                          Outputs{},
                          adaptFromTask<RootFileSink>(sinkFilePath),
-                         Options{},
+                         RootFileSink::getOptions(),
                          CommonServices::defaultServices(),
                          { RootFileSink::getLabel() } });
   }
@@ -22,6 +22,7 @@
 
 #include <DataSampling/DataSampling.h>
 #include <Framework/DataDescriptorQueryBuilder.h>
+#include <algorithm>
 
 using namespace o2::utilities;
 using namespace o2::framework;
@@ -46,10 +47,37 @@ InfrastructureSpec InfrastructureSpecReader::readInfrastructureSpec(const boost:
   spec.aggregators = readSectionSpec<AggregatorSpec>(wholeTree, "aggregators");
   spec.postProcessingTasks = readSectionSpec<PostProcessingTaskSpec>(wholeTree, "postprocessing");
   spec.externalTasks = readSectionSpec<ExternalTaskSpec>(wholeTree, "externalTasks");
+  applyTaskExecutorBudget(spec);
 
   return spec;
 }
 
+void InfrastructureSpecReader::applyTaskExecutorBudget(InfrastructureSpec& spec)
+{
+  // We assume that the tasks of a configuration file run on the same nodes,
+  // so they share the cores which are given to their executors.
+  const size_t budget = spec.common.taskExecutorCoresPerNode;
+  size_t requested = 0;
+  for (const auto& task : spec.tasks) {
+    requested += task.active ? task.executorThreads : 0;
+  }
+  if (budget != 0 && requested > budget) {
+    ILOG(Info, Support) << "The tasks request " << requested << " executor threads, while the budget is " << budget
+                        << " cores per node. The executors are scaled down accordingly." << ENDM;
+    for (auto& task : spec.tasks) {
+      task.executorThreads = std::max<size_t>(1, task.executorThreads * budget / requested);
+    }
+  }
+  // Each task gets its own range of CPUs, so that the pinned executors do not compete for the same ones.
+  size_t firstCpu = 0;
+  for (auto& task : spec.tasks) {
+    if (task.active) {
+      task.executorFirstCpu = firstCpu;
+      firstCpu += task.executorThreads;
+    }
+  }
+}
+
 template <>
 CommonSpec InfrastructureSpecReader::readSpecEntry<CommonSpec>(const std::string&, const boost::property_tree::ptree& commonTree, const boost::property_tree::ptree&)
 {
@@ -76,6 +104,9 @@ CommonSpec InfrastructureSpecReader::readSpecEntry<CommonSpec>(const std::string
   };
   spec.postprocessingPeriod = commonTree.get<double>("postprocessing.periodSeconds", spec.postprocessingPeriod);
   spec.bookkeepingUrl = commonTree.get<std::string>("bookkeeping.url", spec.bookkeepingUrl);
+  spec.checkRunnerThreads = commonTree.get<size_t>("checkRunner.threads", spec.checkRunnerThreads);
+  spec.taskExecutorCoresPerNode = commonTree.get<size_t>("taskExecutor.coresPerNode", spec.taskExecutorCoresPerNode);
+  spec.taskExecutorPinThreads = commonTree.get<bool>("taskExecutor.pinThreads", spec.taskExecutorPinThreads);
 
   return spec;
 }
@@ -107,6 +138,8 @@ TaskSpec InfrastructureSpecReader::readSpecEntry<TaskSpec>(const std::string& ta
   ts.maxNumberCycles = taskTree.get<int>("maxNumberCycles", ts.maxNumberCycles);
   ts.resetAfterCycles = taskTree.get<size_t>("resetAfterCycles", ts.resetAfterCycles);
   ts.saveObjectsToFile = taskTree.get<std::string>("saveObjectsToFile", ts.saveObjectsToFile);
+  ts.skipUnchangedObjects = taskTree.get<bool>("skipUnchangedObjects", ts.skipUnchangedObjects);
+  ts.executorThreads = taskTree.get<size_t>("executorThreads", ts.executorThreads);
   if (taskTree.count("taskParameters") > 0) {
     for (const auto& [key, value] : taskTree.get_child("taskParameters")) {
       ts.customParameters.emplace(key, value.get_value<std::string>());
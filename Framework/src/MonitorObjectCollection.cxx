@@ -20,6 +20,8 @@
 
 #include <Mergers/MergerAlgorithm.h>
 
+#include <cstring>
+
 using namespace o2::mergers;
 
 namespace o2::quality_control::core
@@ -38,8 +40,9 @@ void MonitorObjectCollection::merge(mergers::MergeInterface* const other)
     auto otherObjectName = otherObject->GetName();
     if (std::strlen(otherObjectName) == 0) {
       ILOG(Warning, Devel) << "The other object does not have a name, probably it is empty. Skipping..." << ENDM;
-    } else if (auto targetObject = this->FindObject(otherObjectName)) {
+    } else if (auto targetIndex = findIndex(otherObjectName); targetIndex >= 0) {
       // A corresponding object in the target collection was found, we try to merge.
+      auto targetObject = this->UncheckedAt(targetIndex);
       auto otherMO = dynamic_cast<MonitorObject*>(otherObject);
       auto targetMO = dynamic_cast<MonitorObject*>(targetObject);
       if (!otherMO || !targetMO) {
@@ -60,6 +63,8 @@ void MonitorObjectCollection::merge(mergers::MergeInterface* const other)
       // A corresponding object in the target collection could not be found.
       // We prefer to clone instead of passing the pointer in order to simplify deleting the `other`.
       this->Add(otherObject->Clone());
+      mIndex.emplace(otherObjectName, this->GetLast());
+      mIndexedEntries = this->GetEntriesFast();
     }
   }
   delete otherIterator;
@@ -89,6 +94,37 @@ void MonitorObjectCollection::postDeserialization()
   }
   this->SetOwner(true);
   delete it;
+  buildIndex();
+}
+
+Int_t MonitorObjectCollection::findIndex(const char* name)
+{
+  if (mIndexedEntries != this->GetEntriesFast()) {
+    buildIndex();
+  }
+  auto entry = mIndex.find(name);
+  if (entry != mIndex.end()) {
+    auto object = this->UncheckedAt(entry->second);
+    if (object != nullptr && std::strcmp(object->GetName(), name) == 0) {
+      return entry->second;
+    }
+    // the object was replaced or removed without changing the number of entries
+    buildIndex();
+    entry = mIndex.find(name);
+  }
+  return entry != mIndex.end() ? entry->second : -1;
+}
+
+void MonitorObjectCollection::buildIndex()
+{
+  mIndex.clear();
+  mIndex.reserve(this->GetEntriesFast());
+  for (Int_t i = 0; i < this->GetEntriesFast(); i++) {
+    if (auto object = this->UncheckedAt(i)) {
+      mIndex.emplace(object->GetName(), i); // the first object wins, as with FindObject()
+    }
+  }
+  mIndexedEntries = this->GetEntriesFast();
 }
 
 void MonitorObjectCollection::setDetector(const std::string& detector)
@@ -0,0 +1,223 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ObjectsFileWriter.cxx
+///
+
+#include "QualityControl/ObjectsFileWriter.h"
+
+#include "QualityControl/QcInfoLogger.h"
+#include "QualityControl/FileUtils.h"
+
+#include <TBufferFile.h>
+#include <TFile.h>
+#include <TObject.h>
+#include <TROOT.h>
+#include <boost/exception/diagnostic_information.hpp>
+#include <cstring>
+#include <filesystem>
+
+namespace o2::quality_control::core
+{
+
+ObjectsFileWriter::ObjectsFileWriter(std::string filePath, bool trustFingerprints)
+  : mFilePath(std::move(filePath)), mTrustFingerprints(trustFingerprints), mBuffer(std::make_unique<TBufferFile>(TBuffer::kWrite))
+{
+  // the objects are deserialized and written by the writer thread while the task keeps on running
+  ROOT::EnableThreadSafety();
+  mWriter = std::thread([this]() {
+#ifdef __linux__
+    pthread_setname_np(pthread_self(), "QC/FileWriter");
+#endif
+    run();
+  });
+}
+
+ObjectsFileWriter::~ObjectsFileWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopping = true;
+  }
+  mSnapshotAvailable.notify_all();
+  if (mWriter.joinable()) {
+    mWriter.join();
+  }
+}
+
+ObjectsFileWriter::Buffer ObjectsFileWriter::serialize(const TObject* object)
+{
+  // the buffer is reused, so that we do not allocate it each time
+  mBuffer->Reset();
+  mBuffer->ResetMap();
+  mBuffer->WriteObject(object);
+  return std::make_shared<const std::vector<char>>(mBuffer->Buffer(), mBuffer->Buffer() + mBuffer->Length());
+}
+
+bool ObjectsFileWriter::save(const std::vector<const TObject*>& objects)
+{
+  auto now = std::chrono::steady_clock::now();
+  bool changed = objects.size() != mStates.size();
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    changed = changed || mForceWrite;
+    mForceWrite = false;
+  }
+  mStates.resize(objects.size());
+
+  size_t bytesSerialized = 0;
+  ObjectsManager::Fingerprint fingerprint{};
+  for (size_t i = 0; i < objects.size(); i++) {
+    const auto* object = objects[i];
+    auto& state = mStates[i];
+    if (object == nullptr) {
+      changed = changed || state.buffer != nullptr;
+      state = ObjectState{};
+      continue;
+    }
+    bool trackable = mTrustFingerprints && ObjectsManager::computeFingerprint(object, fingerprint);
+    bool sameName = state.name == object->GetName();
+    if (trackable && state.trackable && sameName && state.buffer != nullptr && fingerprint == state.fingerprint) {
+      continue; // the previous serialization is still valid
+    }
+    auto buffer = serialize(object);
+    bytesSerialized += buffer->size();
+    // we compare what the object looks like once serialized
+    bool sameContent = sameName && state.buffer != nullptr && state.buffer->size() == buffer->size() //
+                       && std::memcmp(state.buffer->data(), buffer->data(), buffer->size()) == 0;
+    changed = changed || !sameContent;
+    state.name = object->GetName();
+    state.trackable = trackable;
+    state.fingerprint = fingerprint;
+    state.buffer = std::move(buffer);
+  }
+
+  std::unique_lock<std::mutex> lock(mMutex);
+  mStats.bytesSerialized = bytesSerialized;
+  if (!changed) {
+    mStats.skipped++;
+    return false;
+  }
+  Snapshot snapshot{ {}, now };
+  snapshot.objects.reserve(mStates.size());
+  for (const auto& state : mStates) {
+    if (state.buffer != nullptr) {
+      snapshot.objects.emplace_back(state.name, state.buffer);
+    }
+  }
+  if (mPending.has_value()) {
+    // the previous snapshot was not written yet, we write only the newest one
+    snapshot.time = mPending->time;
+    mStats.coalesced++;
+  }
+  mPending = std::move(snapshot);
+  lock.unlock();
+  mSnapshotAvailable.notify_one();
+  return true;
+}
+
+void ObjectsFileWriter::run()
+{
+  QcInfoLogger::initThreadInfoLogger();
+
+  while (true) {
+    Snapshot snapshot;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mSnapshotAvailable.wait(lock, [this]() { return mPending.has_value() || mStopping; });
+      if (!mPending.has_value()) { // we are stopping and there is nothing left
+        return;
+      }
+      snapshot = std::move(*mPending);
+      mPending.reset();
+      mWriting = true;
+    }
+
+    size_t bytesWritten = 0;
+    bool success = false;
+    try {
+      success = write(snapshot, bytesWritten);
+      if (!success) {
+        ILOG(Warning, Support) << "Could not save the objects to " << mFilePath << ", the previous version is kept" << ENDM;
+      }
+    } catch (...) {
+      ILOG(Warning, Support) << "Could not save the objects to " << mFilePath << ": "
+                             << boost::current_exception_diagnostic_information(true) << ENDM;
+    }
+    double latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - snapshot.time).count();
+
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      if (success) {
+        mStats.written++;
+        mStats.bytesWritten = bytesWritten;
+        mStats.lastLatencyMs = latencyMs;
+        mLatencySumMs += latencyMs;
+        mLatencyCount++;
+      } else {
+        mStats.failed++;
+        mForceWrite = true; // the file is outdated, the next snapshot is written even if nothing changed
+      }
+      mWriting = false;
+      if (!mPending.has_value()) {
+        mIdle.notify_all();
+      }
+    }
+  }
+}
+
+bool ObjectsFileWriter::write(const Snapshot& snapshot, size_t& bytesWritten)
+{
+  // We fill a temporary file and replace the destination only once it is complete,
+  // so that a reader never sees a partially written file.
+  std::string tmpPath = mFilePath + ".tmp";
+  {
+    TFile file(tmpPath.c_str(), "RECREATE");
+    if (file.IsZombie()) {
+      return false;
+    }
+    for (const auto& [name, buffer] : snapshot.objects) {
+      TBufferFile input(TBuffer::kRead, buffer->size(), const_cast<char*>(buffer->data()), kFALSE);
+      std::unique_ptr<TObject> object(input.ReadObject(TObject::Class()));
+      if (object == nullptr || file.WriteTObject(object.get(), name.c_str()) <= 0) {
+        file.Close();
+        std::filesystem::remove(tmpPath);
+        return false;
+      }
+    }
+    file.Close();
+  }
+  bytesWritten = std::filesystem::file_size(tmpPath);
+  if (!replaceFileDurably(tmpPath, mFilePath)) {
+    std::filesystem::remove(tmpPath);
+    return false;
+  }
+  return true;
+}
+
+void ObjectsFileWriter::flush()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  mIdle.wait(lock, [this]() { return !mPending.has_value() && !mWriting; });
+}
+
+ObjectsFileWriter::Stats ObjectsFileWriter::getStats()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  Stats stats = mStats;
+  stats.meanLatencyMs = mLatencyCount > 0 ? mLatencySumMs / mLatencyCount : 0;
+  mLatencySumMs = 0;
+  mLatencyCount = 0;
+  return stats;
+}
+
+} // namespace o2::quality_control::core
@@ -19,9 +19,13 @@
 #include "QualityControl/QcInfoLogger.h"
 #include "QualityControl/ServiceDiscovery.h"
 #include "QualityControl/MonitorObjectCollection.h"
+#include "QualityControl/ShardedHistogram.h"
 #include <Common/Exceptions.h>
 #include <TObjArray.h>
+#include <TBufferFile.h>
+#include <TH1.h>
 
+#include <algorithm>
 #include <utility>
 
 using namespace o2::quality_control::core;
@@ -59,7 +63,7 @@ ObjectsManager::~ObjectsManager()
 
 void ObjectsManager::startPublishing(TObject* object)
 {
-  if (mMonitorObjects->FindObject(object->GetName()) != nullptr) {
+  if (findIndex(object->GetName()) >= 0) {
     ILOG(Warning, Support) << "Object is already being published (" << object->GetName() << ")" << ENDM;
     BOOST_THROW_EXCEPTION(DuplicateObjectError() << errinfo_object_name(object->GetName()));
   }
@@ -67,9 +71,50 @@ void ObjectsManager::startPublishing(TObject* object)
   newObject->setIsOwner(false);
   newObject->setActivity(mActivity);
   mMonitorObjects->Add(newObject);
+  // Add() puts the object right after the last non-empty slot
+  mIndex[object->GetName()] = mMonitorObjects->GetLast();
   mUpdateServiceDiscovery = true;
 }
 
+void ObjectsManager::startPublishing(ShardedHistogramBase* histogram)
+{
+  startPublishing(histogram->getHistogram());
+  mShardedHistograms.push_back(histogram);
+}
+
+void ObjectsManager::mergeShardedHistograms()
+{
+  for (auto* histogram : mShardedHistograms) {
+    histogram->mergeShards();
+  }
+}
+
+int ObjectsManager::findIndex(const std::string& objectName)
+{
+  auto it = mIndex.find(objectName);
+  if (it == mIndex.end()) {
+    return -1;
+  }
+  TObject* object = mMonitorObjects->UncheckedAt(it->second);
+  if (object != nullptr && objectName == object->GetName()) {
+    return it->second;
+  }
+  // The object was renamed after it was published. It is rare, thus we just rebuild the index.
+  rebuildIndex();
+  it = mIndex.find(objectName);
+  return it == mIndex.end() ? -1 : it->second;
+}
+
+void ObjectsManager::rebuildIndex()
+{
+  mIndex.clear();
+  for (int i = 0; i <= mMonitorObjects->GetLast(); i++) {
+    if (TObject* object = mMonitorObjects->UncheckedAt(i); object != nullptr) {
+      mIndex.emplace(object->GetName(), i);
+    }
+  }
+}
+
 void ObjectsManager::updateServiceDiscovery()
 {
   if (!mUpdateServiceDiscovery || mServiceDiscovery == nullptr) {
@@ -106,23 +151,35 @@ void ObjectsManager::stopPublishing(TObject* object)
 
 void ObjectsManager::stopPublishing(const string& objectName)
 {
-  auto* mo = dynamic_cast<MonitorObject*>(getMonitorObject(objectName));
-  mMonitorObjects->Remove(mo);
+  int index = findIndex(objectName);
+  if (index < 0) {
+    ILOG(Error, Support) << "ObjectsManager: Unable to find object \"" << objectName << "\"" << ENDM;
+    BOOST_THROW_EXCEPTION(ObjectNotFoundError() << errinfo_object_name(objectName));
+  }
+  // RemoveAt leaves an empty slot, thus the indices of the other objects do not change.
+  mMonitorObjects->RemoveAt(index);
+  mIndex.erase(objectName);
+  mShardedHistograms.erase(std::remove_if(mShardedHistograms.begin(), mShardedHistograms.end(),
+                                          [&](ShardedHistogramBase* histogram) { return objectName == histogram->getHistogram()->GetName(); }),
+                           mShardedHistograms.end());
+  if (static_cast<size_t>(index) < mPublicationStates.size()) {
+    mPublicationStates[index] = PublicationState{};
+  }
 }
 
 bool ObjectsManager::isBeingPublished(const string& name)
 {
-  return (mMonitorObjects->FindObject(name.c_str()) != nullptr);
+  return findIndex(name) >= 0;
 }
 
 MonitorObject* ObjectsManager::getMonitorObject(const std::string& objectName)
 {
-  TObject* object = mMonitorObjects->FindObject(objectName.c_str());
-  if (object == nullptr) {
+  int index = findIndex(objectName);
+  if (index < 0) {
     ILOG(Error, Support) << "ObjectsManager: Unable to find object \"" << objectName << "\"" << ENDM;
     BOOST_THROW_EXCEPTION(ObjectNotFoundError() << errinfo_object_name(objectName));
   }
-  return dynamic_cast<MonitorObject*>(object);
+  return dynamic_cast<MonitorObject*>(mMonitorObjects->UncheckedAt(index));
 }
 
 MonitorObject* ObjectsManager::getMonitorObject(size_t index)
@@ -141,6 +198,92 @@ MonitorObjectCollection* ObjectsManager::getNonOwningArray() const
   return new MonitorObjectCollection(*mMonitorObjects);
 }
 
+ObjectsManager::PublicationState& ObjectsManager::getPublicationState(int index)
+{
+  if (static_cast<size_t>(index) >= mPublicationStates.size()) {
+    mPublicationStates.resize(mMonitorObjects->GetLast() + 1);
+  }
+  return mPublicationStates[index];
+}
+
+bool ObjectsManager::computeFingerprint(const TObject* object, Fingerprint& fingerprint)
+{
+  static_assert(TH1::kNstat + 2 <= std::tuple_size_v<Fingerprint>);
+  const auto* histogram = dynamic_cast<const TH1*>(object);
+  if (histogram == nullptr) {
+    return false;
+  }
+  fingerprint.fill(0);
+  fingerprint[0] = histogram->GetEntries();
+  fingerprint[1] = histogram->GetNcells();
+  histogram->GetStats(fingerprint.data() + 2);
+  return true;
+}
+
+bool ObjectsManager::isEmpty(const Fingerprint& fingerprint)
+{
+  // no entries and all the statistics are null, the number of cells does not matter
+  return fingerprint[0] == 0 && std::all_of(fingerprint.begin() + 2, fingerprint.end(), [](double value) { return value == 0; });
+}
+
+MonitorObjectCollection* ObjectsManager::getNonOwningArrayOfChangedObjects(bool deltas)
+{
+  auto* array = new MonitorObjectCollection();
+  array->SetOwner(false);
+  array->SetName(mMonitorObjects->GetName());
+  array->setDetector(mMonitorObjects->getDetector());
+
+  Fingerprint fingerprint{};
+  for (int i = 0; i <= mMonitorObjects->GetLast(); i++) {
+    auto* mo = dynamic_cast<MonitorObject*>(mMonitorObjects->UncheckedAt(i));
+    if (mo == nullptr) {
+      continue;
+    }
+    auto& state = getPublicationState(i);
+    bool trackable = computeFingerprint(mo->getObject(), fingerprint);
+    // A delta is compared with the empty state in which the reset left the object, not with the previous delta.
+    bool sameContent = deltas ? trackable && isEmpty(fingerprint)
+                              : trackable && state.trackable && fingerprint == state.fingerprint;
+    bool changed = !state.published || !sameContent || mo->getMetadataMap() != state.metadata;
+    if (changed) {
+      array->Add(mo);
+      state.published = true;
+      state.trackable = trackable;
+      state.fingerprint = fingerprint;
+      state.metadata = mo->getMetadataMap();
+    }
+  }
+  return array;
+}
+
+size_t ObjectsManager::estimateSerializedSize(const MonitorObjectCollection& objects)
+{
+  if (mSizingBuffer == nullptr) {
+    mSizingBuffer = std::make_unique<TBufferFile>(TBuffer::kWrite);
+  }
+  size_t total = 0;
+  for (auto tobj : objects) {
+    auto* mo = dynamic_cast<MonitorObject*>(tobj);
+    int index = mo != nullptr ? findIndex(mo->getName()) : -1;
+    if (index < 0) {
+      continue;
+    }
+    auto& state = getPublicationState(index);
+    const auto* histogram = dynamic_cast<const TH1*>(mo->getObject());
+    double cells = histogram != nullptr ? histogram->GetNcells() : 0;
+    if (state.serializedSizeCells != cells) {
+      // the buffer is reused, so that we do not allocate it each time
+      mSizingBuffer->Reset();
+      mSizingBuffer->ResetMap();
+      mSizingBuffer->WriteObject(mo);
+      state.serializedSize = mSizingBuffer->Length();
+      state.serializedSizeCells = cells;
+    }
+    total += state.serializedSize;
+  }
+  return total;
+}
+
 void ObjectsManager::addMetadata(const std::string& objectName, const std::string& key, const std::string& value)
 {
   MonitorObject* mo = getMonitorObject(objectName);
@@ -192,6 +335,8 @@ const Activity& ObjectsManager::getActivity() const
 void ObjectsManager::setActivity(const Activity& activity)
 {
   mActivity = activity;
+  // all the objects should be sent again with the new activity
+  mPublicationStates.clear();
   // update the activity of all the objects
   for (auto tobj : *mMonitorObjects) {
     auto* mo = dynamic_cast<MonitorObject*>(tobj);
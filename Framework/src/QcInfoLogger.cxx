@@ -22,6 +22,7 @@ namespace o2::quality_control::core
 
 AliceO2::InfoLogger::InfoLogger* QcInfoLogger::instance;
 AliceO2::InfoLogger::InfoLoggerContext* QcInfoLogger::mContext;
+DiscardFileParameters QcInfoLogger::mDiscardFileParameters;
 QcInfoLogger::_init QcInfoLogger::_initializer;
 
 void QcInfoLogger::setFacility(const std::string& facility)
@@ -59,6 +60,18 @@ void QcInfoLogger::setPartition(const std::string& partitionName)
   ILOG(Debug, Devel) << "IL: Partition set to " << partitionName << ENDM;
 }
 
+void QcInfoLogger::initThreadInfoLogger()
+{
+  if (threadInstance != nullptr) {
+    return;
+  }
+  threadInstance = std::make_unique<AliceO2::InfoLogger::InfoLogger>();
+  threadInstance->setContext(*mContext);
+  // the discard file is not shared, the messages which would go there are discarded
+  threadInstance->filterDiscardDebug(mDiscardFileParameters.debug);
+  threadInstance->filterDiscardLevel(mDiscardFileParameters.fromLevel);
+}
+
 using namespace std;
 
 void QcInfoLogger::init(const std::string& facility,
@@ -74,6 +87,7 @@ void QcInfoLogger::init(const std::string& facility,
     mContext = dplContext;
   }
 
+  mDiscardFileParameters = discardFileParameters;
   // Set the proper discard filters
   ILOG_INST.filterDiscardDebug(discardFileParameters.debug);
   ILOG_INST.filterDiscardLevel(discardFileParameters.fromLevel);
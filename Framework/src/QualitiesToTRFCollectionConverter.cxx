@@ -36,12 +36,9 @@ QualitiesToTRFCollectionConverter::QualitiesToTRFCollectionConverter(std::unique
 {
 }
 
-std::vector<TimeRangeFlag> QO2TRFs(uint64_t startTime, uint64_t endTime, const QualityObject& qo)
+std::vector<TimeRangeFlag> QO2TRFs(uint64_t startTime, uint64_t endTime, const Quality& quality, const CommentedFlagReasons& reasons, const std::string& qoPath)
 {
-  auto& reasons = qo.getReasons();
-  auto qoPath = qo.getPath();
-
-  if (qo.getQuality().isWorseThan(Quality::Good) && reasons.empty()) {
+  if (quality.isWorseThan(Quality::Good) && reasons.empty()) {
     return { { startTime, endTime, FlagReasonFactory::Unknown(), {}, qoPath } };
   } else {
     std::vector<TimeRangeFlag> result;
@@ -55,19 +52,25 @@ std::vector<TimeRangeFlag> QO2TRFs(uint64_t startTime, uint64_t endTime, const Q
 
 void QualitiesToTRFCollectionConverter::operator()(const QualityObject& newQO)
 {
-  if (mConverted->getDetector() != newQO.getDetectorName()) {
+  uint64_t validFrom = strtoull(newQO.getMetadata(metadata_keys::validFrom).c_str(), nullptr, 10);
+  uint64_t validUntil = strtoull(newQO.getMetadata(metadata_keys::validUntil).c_str(), nullptr, 10);
+  (*this)(newQO.getQuality(), newQO.getReasons(), validFrom, validUntil, newQO.getDetectorName(), newQO.getPath());
+}
+
+void QualitiesToTRFCollectionConverter::operator()(const Quality& quality, const CommentedFlagReasons& reasons, uint64_t validFrom, uint64_t validUntil,
+                                                   const std::string& detectorName, const std::string& qoPath)
+{
+  if (mConverted->getDetector() != detectorName) {
     throw std::runtime_error("The TRFCollection '" + mConverted->getName() +
                              "' expects QOs from detector '" + mConverted->getDetector() +
-                             "' but received a QO for '" + newQO.getDetectorName() + "'");
+                             "' but received a QO for '" + detectorName + "'");
   }
 
   mQOsIncluded++;
-  if (newQO.getQuality().isWorseThan(Quality::Good)) {
+  if (quality.isWorseThan(Quality::Good)) {
     mWorseThanGoodQOs++;
   }
 
-  uint64_t validFrom = strtoull(newQO.getMetadata(metadata_keys::validFrom).c_str(), nullptr, 10);
-  uint64_t validUntil = strtoull(newQO.getMetadata(metadata_keys::validUntil).c_str(), nullptr, 10);
   if (validFrom < mCurrentStartTime) {
     throw std::runtime_error("The currently provided QO is dated as earlier than the one before (" //
                              + std::to_string(validFrom) + " vs. " + std::to_string(mCurrentStartTime) +
@@ -76,13 +79,13 @@ void QualitiesToTRFCollectionConverter::operator()(const QualityObject& newQO)
 
   // Is the beginning of time range covered by the first QO provided?
   if (mCurrentStartTime < mConverted->getStart() && validFrom > mConverted->getStart()) {
-    mConverted->insert({ mConverted->getStart(), validFrom - 1, FlagReasonFactory::UnknownQuality(), noQualityObjectsComment, newQO.getPath() });
+    mConverted->insert({ mConverted->getStart(), validFrom - 1, FlagReasonFactory::UnknownQuality(), noQualityObjectsComment, qoPath });
   }
 
   mCurrentStartTime = std::max(validFrom, mConverted->getStart());
   mCurrentEndTime = std::min(validUntil, mConverted->getEnd());
 
-  auto newTRFs = QO2TRFs(mCurrentStartTime, mCurrentEndTime, newQO);
+  auto newTRFs = QO2TRFs(mCurrentStartTime, mCurrentEndTime, quality, reasons, qoPath);
 
   for (auto& newTRF : newTRFs) {
     auto trfsOverlap = [&newTRF](const TimeRangeFlag& other) {
@@ -0,0 +1,116 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   RetrievalCache.cxx
+///
+
+#include "QualityControl/RetrievalCache.h"
+
+namespace o2::quality_control::repository
+{
+
+RetrievalCache::RetrievalCache(size_t maxBytes) : mMaxBytes(maxBytes)
+{
+}
+
+std::string RetrievalCache::makeKey(const std::string& path, const std::map<std::string, std::string>& metadata)
+{
+  // '\n' cannot appear in paths nor in metadata, thus the key is not ambiguous
+  std::string key = path;
+  for (const auto& [name, value] : metadata) {
+    key += '\n';
+    key += name;
+    key += '=';
+    key += value;
+  }
+  return key;
+}
+
+std::shared_ptr<const RetrievalCache::Entry> RetrievalCache::find(const std::string& key)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  auto it = mIndex.find(key);
+  if (it == mIndex.end()) {
+    return nullptr;
+  }
+  mLru.splice(mLru.begin(), mLru, it->second);
+  return it->second->second;
+}
+
+void RetrievalCache::insert(const std::string& key, Entry entry)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (auto it = mIndex.find(key); it != mIndex.end()) {
+    mStatistics.bytes -= it->second->second->size;
+    mLru.erase(it->second);
+    mIndex.erase(it);
+  }
+  if (entry.size > mMaxBytes) {
+    return;
+  }
+  mStatistics.bytes += entry.size;
+  mLru.emplace_front(key, std::make_shared<const Entry>(std::move(entry)));
+  mIndex[key] = mLru.begin();
+  evict();
+}
+
+void RetrievalCache::erase(const std::string& key)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (auto it = mIndex.find(key); it != mIndex.end()) {
+    mStatistics.bytes -= it->second->second->size;
+    mLru.erase(it->second);
+    mIndex.erase(it);
+  }
+}
+
+void RetrievalCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mLru.clear();
+  mIndex.clear();
+  mStatistics.bytes = 0;
+}
+
+void RetrievalCache::evict()
+{
+  while (mStatistics.bytes > mMaxBytes && !mLru.empty()) {
+    const auto& [key, entry] = mLru.back();
+    mStatistics.bytes -= entry->size;
+    mIndex.erase(key);
+    mLru.pop_back();
+    mStatistics.evictions++;
+  }
+}
+
+void RetrievalCache::recordHit(const Entry& entry)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mStatistics.hits++;
+  mStatistics.bytesSaved += entry.size;
+}
+
+void RetrievalCache::recordMiss()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mStatistics.misses++;
+}
+
+RetrievalCache::Statistics RetrievalCache::getStatistics() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  Statistics statistics = mStatistics;
+  statistics.entries = mIndex.size();
+  return statistics;
+}
+
+} // namespace o2::quality_control::repository
@@ -17,11 +17,20 @@
 #include "QualityControl/RootFileSink.h"
 #include "QualityControl/QcInfoLogger.h"
 #include "QualityControl/MonitorObjectCollection.h"
+#include "QualityControl/FileUtils.h"
 #include <Framework/DeviceSpec.h>
 #include <Framework/CompletionPolicyHelpers.h>
 #include <Framework/CompletionPolicy.h>
 #include <Framework/InputRecordWalker.h>
+#include <Framework/DataRefUtils.h>
 #include <TFile.h>
+#include <TKey.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <set>
 #if defined(__linux__) && __has_include(<malloc.h>)
 #include <malloc.h>
 #endif
@@ -36,6 +45,11 @@ RootFileSink::RootFileSink(std::string filePath)
 {
 }
 
+RootFileSink::RootFileSink(std::string filePath, std::chrono::seconds flushInterval, size_t memoryLimit)
+  : mFilePath(std::move(filePath)), mFlushInterval(flushInterval), mMemoryLimit(memoryLimit), mLastFlush(std::chrono::steady_clock::now())
+{
+}
+
 TFile* openSinkFile(const std::string& name)
 {
   auto file = new TFile(name.c_str(), "UPDATE");
@@ -83,12 +97,55 @@ void RootFileSink::customizeInfrastructure(std::vector<framework::CompletionPoli
   policies.emplace_back("qcRootFileSinkCompletionPolicy", matcher, callback);
 }
 
+framework::Options RootFileSink::getOptions()
+{
+  return {
+    { "qc-sink-flush-interval", framework::VariantType::Int, 0, { "Seconds between the writings of the file, the collections are merged in memory in the meantime. 0 updates the file with each received collection." } },
+    { "qc-sink-memory-limit", framework::VariantType::Int, 0, { "Memory (MB) for the collections merged in memory, above which they are written and released. 0 for no limit." } }
+  };
+}
+
 void RootFileSink::init(framework::InitContext& ictx)
 {
+  mFlushInterval = std::chrono::seconds(std::max(ictx.options().get<int>("qc-sink-flush-interval"), 0));
+  mMemoryLimit = static_cast<size_t>(std::max(ictx.options().get<int>("qc-sink-memory-limit"), 0)) * 1024 * 1024;
+  mLastFlush = std::chrono::steady_clock::now();
+  if (mFlushInterval.count() > 0) {
+    ILOG(Info, Support) << "The collections will be merged in memory and written to '" << mFilePath << "' every "
+                        << mFlushInterval.count() << " s" << ENDM;
+  }
+}
+
+void RootFileSink::endOfStream(framework::EndOfStreamContext&)
+{
+  if (mDirty) {
+    flush(true);
+  }
+}
+
+void RootFileSink::stop()
+{
+  if (mDirty) {
+    flush(true);
+  }
 }
 
 void RootFileSink::run(framework::ProcessingContext& pctx)
 {
+  if (mFlushInterval.count() > 0) {
+    for (const auto& input : InputRecordWalker(pctx.inputs())) {
+      auto moc = DataRefUtils::as<MonitorObjectCollection>(input);
+      if (moc == nullptr) {
+        ILOG(Error) << "Could not cast the input object to MonitorObjectCollection, skipping." << ENDM;
+        continue;
+      }
+      // the merged objects have the same size as the received ones, as long as they are histograms
+      mergeInMemory(std::move(moc), DataRefUtils::getPayloadSize(input));
+    }
+    flushIfNeeded();
+    return;
+  }
+
   TFile* sinkFile = nullptr;
   try {
     sinkFile = openSinkFile(mFilePath);
@@ -150,4 +207,123 @@ void RootFileSink::run(framework::ProcessingContext& pctx)
 #endif
 }
 
+void RootFileSink::mergeInMemory(std::unique_ptr<MonitorObjectCollection> moc, size_t size)
+{
+  moc->postDeserialization();
+  if (*moc->GetName() == '\0') {
+    ILOG(Error, Support) << "MonitorObjectCollection does not have a name, skipping." << ENDM;
+    return;
+  }
+
+  auto& stored = mCollections[moc->getDetector() + "/" + moc->GetName()];
+  if (stored.collection == nullptr) {
+    ILOG(Debug, Devel) << "Keeping MonitorObjectCollection '" << moc->GetName() << "' in memory" << ENDM;
+    mMemoryInUse += size;
+    stored.collection = std::move(moc);
+  } else {
+    ILOG(Debug, Devel) << "Merging MonitorObjectCollection '" << moc->GetName() << "' in memory" << ENDM;
+    stored.collection->merge(moc.get());
+  }
+  mDirty = true;
+}
+
+void RootFileSink::flushIfNeeded()
+{
+  bool overBudget = mMemoryLimit > 0 && mMemoryInUse > mMemoryLimit;
+  if (overBudget || std::chrono::steady_clock::now() - mLastFlush >= mFlushInterval) {
+    flush(overBudget);
+  }
+}
+
+void RootFileSink::flush(bool release)
+{
+  auto startTime = std::chrono::steady_clock::now();
+  std::string temporaryPath = mFilePath + ".tmp";
+  std::unique_ptr<TFile> previousFile;
+  if (std::filesystem::exists(mFilePath)) {
+    previousFile.reset(TFile::Open(mFilePath.c_str(), "READ"));
+    if (previousFile == nullptr || previousFile->IsZombie()) {
+      throw std::runtime_error("Failed to open the file: " + mFilePath);
+    }
+  }
+  auto outputFile = std::make_unique<TFile>(temporaryPath.c_str(), "RECREATE");
+  if (outputFile->IsZombie() || !outputFile->IsWritable()) {
+    throw std::runtime_error("Failed to open the file: " + temporaryPath);
+  }
+  auto getOutputDirectory = [&](const char* detector) {
+    auto directory = outputFile->GetDirectory(detector);
+    return directory != nullptr ? directory : outputFile->mkdir(detector);
+  };
+
+  // The collections of the previous file are either copied or merged with those in memory.
+  // The other objects are copied as they are, as they would have been kept when updating the file.
+  if (previousFile != nullptr) {
+    std::set<std::string> seenDirectories;
+    TIter nextDirectory(previousFile->GetListOfKeys());
+    while (auto directoryKey = dynamic_cast<TKey*>(nextDirectory())) {
+      if (!seenDirectories.insert(directoryKey->GetName()).second) {
+        continue;
+      }
+      auto inputDirectory = previousFile->GetDirectory(directoryKey->GetName());
+      if (inputDirectory == nullptr) {
+        std::unique_ptr<TObject> storedObject(directoryKey->ReadObj());
+        if (storedObject == nullptr || outputFile->WriteTObject(storedObject.get(), directoryKey->GetName()) <= 0) {
+          throw std::runtime_error("Could not copy '" + std::string(directoryKey->GetName()) + "' from the file " + mFilePath);
+        }
+        continue;
+      }
+      auto outputDirectory = getOutputDirectory(directoryKey->GetName());
+      std::set<std::string> seen; // the keys of previous cycles of an object are listed as well, we take the latest
+      TIter nextKey(inputDirectory->GetListOfKeys());
+      while (auto key = dynamic_cast<TKey*>(nextKey())) {
+        if (!seen.insert(key->GetName()).second) {
+          continue;
+        }
+        auto inMemory = mCollections.find(std::string(directoryKey->GetName()) + "/" + key->GetName());
+        if (inMemory != mCollections.end() && inMemory->second.includesFile) {
+          continue;
+        }
+        std::unique_ptr<TObject> storedObject(key->ReadObj());
+        auto storedMOC = dynamic_cast<MonitorObjectCollection*>(storedObject.get());
+        if (inMemory == mCollections.end() || storedMOC == nullptr) {
+          outputDirectory->WriteTObject(storedObject.get(), key->GetName());
+          continue;
+        }
+        storedMOC->postDeserialization();
+        ILOG(Info, Support) << "Merging object '" << storedMOC->GetName() << "' with the existing one in the file." << ENDM;
+        inMemory->second.collection->merge(storedMOC);
+        inMemory->second.includesFile = true;
+      }
+    }
+    previousFile->Close();
+  }
+
+  for (auto& [name, stored] : mCollections) {
+    auto outputDirectory = getOutputDirectory(stored.collection->getDetector().c_str());
+    if (outputDirectory == nullptr) {
+      throw std::runtime_error("Could not create directory '" + stored.collection->getDetector() + "' in the file " + temporaryPath);
+    }
+    outputDirectory->WriteObject(stored.collection.get(), stored.collection->GetName(), "Overwrite");
+    stored.includesFile = true;
+  }
+  outputFile->Close();
+  // The previous file is replaced at once, it stays complete if we crash before.
+  if (!replaceFileDurably(temporaryPath, mFilePath)) {
+    throw std::runtime_error("Could not sync the file " + temporaryPath + ": " + std::strerror(errno));
+  }
+
+  std::chrono::duration<double> duration = std::chrono::steady_clock::now() - startTime;
+  ILOG(Info, Support) << "Stored " << mCollections.size() << " MonitorObjectCollections in '" << mFilePath << "' in "
+                      << duration.count() << " s" << ENDM;
+  mDirty = false;
+  mLastFlush = std::chrono::steady_clock::now();
+  if (release) {
+    mCollections.clear();
+    mMemoryInUse = 0;
+#if defined(__linux__) && __has_include(<malloc.h>)
+    malloc_trim(0); // see the comment in run()
+#endif
+  }
+}
+
 } // namespace o2::quality_control::core
@@ -0,0 +1,223 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   StorageQueue.cxx
+///
+
+#include "QualityControl/StorageQueue.h"
+
+#include "QualityControl/DatabaseInterface.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/QualityObject.h"
+#include "QualityControl/QcInfoLogger.h"
+
+#include <Common/Exceptions.h>
+#include <TROOT.h>
+#include <boost/exception/diagnostic_information.hpp>
+#include <algorithm>
+
+using namespace o2::quality_control::core;
+
+namespace o2::quality_control::repository
+{
+
+StorageQueue::StorageQueue(std::vector<std::shared_ptr<DatabaseInterface>> backends, size_t capacity, OverflowPolicy policy)
+  : mCapacity(std::max<size_t>(capacity, 1)), mPolicy(policy)
+{
+  if (backends.empty()) {
+    BOOST_THROW_EXCEPTION(AliceO2::Common::FatalException() << AliceO2::Common::errinfo_details("StorageQueue needs at least one database backend"));
+  }
+  // the workers stream the objects while the caller keeps on using ROOT, e.g. to clone the next ones
+  ROOT::EnableThreadSafety();
+  mWorkers.reserve(backends.size());
+  for (size_t i = 0; i < backends.size(); i++) {
+    mWorkers.emplace_back([this, backend = backends[i], i]() {
+#ifdef __linux__
+      std::string threadName = "QC/Storage" + std::to_string(i);
+      pthread_setname_np(pthread_self(), threadName.c_str());
+#endif
+      runWorker(backend);
+    });
+  }
+}
+
+StorageQueue::~StorageQueue()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopping = true;
+  }
+  mItemAvailable.notify_all();
+  mSlotAvailable.notify_all();
+  for (auto& worker : mWorkers) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+StorageQueue::OverflowPolicy StorageQueue::policyFromString(const std::string& policy)
+{
+  if (policy.empty() || policy == "block") {
+    return OverflowPolicy::Block;
+  } else if (policy == "dropOldest") {
+    return OverflowPolicy::DropOldest;
+  } else if (policy == "dropNewest") {
+    return OverflowPolicy::DropNewest;
+  }
+  throw std::invalid_argument("Unknown storage queue overflow policy '" + policy + "', expected 'block', 'dropOldest' or 'dropNewest'");
+}
+
+void StorageQueue::enqueue(std::shared_ptr<const MonitorObject> mo, long from, long to)
+{
+  if (mo == nullptr) {
+    return;
+  }
+  // We store a deep copy, so that the caller can keep on modifying the original while we upload it.
+  auto snapshot = std::make_shared<MonitorObject>(*mo);
+  snapshot->setObject(mo->getObject() != nullptr ? mo->getObject()->Clone() : nullptr);
+  snapshot->setIsOwner(true);
+  Key key{ mo->getPath(), from };
+  push(std::move(key), Item{ std::move(snapshot), nullptr, from, to, std::chrono::steady_clock::now() });
+}
+
+void StorageQueue::enqueue(std::shared_ptr<const QualityObject> qo, long from, long to)
+{
+  if (qo == nullptr) {
+    return;
+  }
+  auto snapshot = std::make_shared<QualityObject>(*qo);
+  Key key{ qo->getPath(), from };
+  push(std::move(key), Item{ nullptr, std::move(snapshot), from, to, std::chrono::steady_clock::now() });
+}
+
+void StorageQueue::push(Key key, Item item)
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  while (true) {
+    if (auto pending = mPending.find(key); pending != mPending.end()) {
+      // the same object from the same cycle is still waiting, we upload only the newest version.
+      item.enqueueTime = pending->second.enqueueTime;
+      pending->second = std::move(item);
+      mCoalesced++;
+      return;
+    }
+    if (mOrder.size() < mCapacity || mStopping) {
+      break;
+    }
+    switch (mPolicy) {
+      case OverflowPolicy::Block:
+        mSlotAvailable.wait(lock);
+        continue; // the queue might have changed in the meantime, we check again
+      case OverflowPolicy::DropOldest:
+        mPending.erase(mOrder.front());
+        mOrder.pop_front();
+        mDropped++;
+        continue;
+      case OverflowPolicy::DropNewest:
+        mDropped++;
+        return;
+    }
+  }
+
+  mPending.emplace(key, std::move(item));
+  mOrder.push_back(std::move(key));
+  lock.unlock();
+  mItemAvailable.notify_one();
+}
+
+void StorageQueue::runWorker(const std::shared_ptr<DatabaseInterface>& backend)
+{
+  // the backends log with ILOG as well
+  QcInfoLogger::initThreadInfoLogger();
+
+  while (true) {
+    Item item;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mItemAvailable.wait(lock, [this]() { return !mOrder.empty() || mStopping; });
+      if (mOrder.empty()) { // we are stopping and there is nothing left
+        return;
+      }
+      auto pending = mPending.find(mOrder.front());
+      item = std::move(pending->second);
+      mPending.erase(pending);
+      mOrder.pop_front();
+      mInFlight++;
+    }
+    mSlotAvailable.notify_one();
+
+    try {
+      if (item.mo) {
+        backend->storeMO(item.mo, item.from, item.to);
+      } else {
+        backend->storeQO(item.qo, item.from, item.to);
+      }
+      mStored++;
+    } catch (...) {
+      mFailed++;
+      ILOG(Warning, Support) << "Asynchronous storage of '" << (item.mo ? item.mo->getPath() : item.qo->getPath())
+                             << "' failed: " << boost::current_exception_diagnostic_information(true) << ENDM;
+    }
+    recordLatency(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - item.enqueueTime).count());
+
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mInFlight--;
+      if (mOrder.empty() && mInFlight == 0) {
+        mIdle.notify_all();
+      }
+    }
+  }
+}
+
+void StorageQueue::recordLatency(double latencyMs)
+{
+  std::lock_guard<std::mutex> lock(mLatencyMutex);
+  mLatencySumMs += latencyMs;
+  mLatencyMaxMs = std::max(mLatencyMaxMs, latencyMs);
+  mLatencyCount++;
+}
+
+void StorageQueue::flush()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  mIdle.wait(lock, [this]() { return mOrder.empty() && mInFlight == 0; });
+}
+
+size_t StorageQueue::size() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mOrder.size();
+}
+
+StorageQueue::Stats StorageQueue::getStats()
+{
+  Stats stats;
+  stats.queueSize = size();
+  stats.stored = mStored;
+  stats.failed = mFailed;
+  stats.dropped = mDropped;
+  stats.coalesced = mCoalesced;
+  {
+    std::lock_guard<std::mutex> lock(mLatencyMutex);
+    stats.meanLatencyMs = mLatencyCount > 0 ? mLatencySumMs / mLatencyCount : 0;
+    stats.maxLatencyMs = mLatencyMaxMs;
+    mLatencySumMs = 0;
+    mLatencyMaxMs = 0;
+    mLatencyCount = 0;
+  }
+  return stats;
+}
+
+} // namespace o2::quality_control::repository
@@ -16,6 +16,7 @@
 ///
 
 #include "QualityControl/TaskInterface.h"
+#include "QualityControl/ThreadPool.h"
 
 namespace o2::quality_control::core
 {
@@ -46,6 +47,20 @@ const o2::globaltracking::DataRequest* TaskInterface::getGlobalTrackingDataReque
   return mGlobalTrackingDataRequest.get();
 }
 
+void TaskInterface::setExecutor(std::shared_ptr<ThreadPool> executor)
+{
+  mExecutor = std::move(executor);
+}
+
+ThreadPool& TaskInterface::getExecutor()
+{
+  if (!mExecutor) {
+    // e.g. a task which is not run by a TaskRunner
+    mExecutor = std::make_shared<ThreadPool>(0);
+  }
+  return *mExecutor;
+}
+
 void TaskInterface::configure()
 {
   // noop, override it if you want.
@@ -40,10 +40,11 @@
 #include "QualityControl/TaskRunnerFactory.h"
 #include "QualityControl/ConfigParamGlo.h"
 #include "QualityControl/ObjectsManager.h"
+#include "QualityControl/ObjectsFileWriter.h"
 #include "QualityControl/Bookkeeping.h"
+#include "QualityControl/ThreadPool.h"
 
 #include <string>
-#include <TFile.h>
 #include <boost/property_tree/ptree.hpp>
 #include <TSystem.h>
 
@@ -164,6 +165,11 @@ void TaskRunner::init(InitContext& iCtx)
   mTask.reset(TaskFactory::create(mTaskConfig, mObjectsManager));
   mTask->setMonitoring(mCollector);
   mTask->setGlobalTrackingDataRequest(mTaskConfig.globalTrackingDataRequest);
+  // the thread of the task takes part in the work, thus it is not counted among the workers
+  size_t executorWorkers = mTaskConfig.executorThreads > 0 ? mTaskConfig.executorThreads - 1 : 0;
+  // the first CPU of the range of the task is left to its own thread, the workers are pinned to the next ones
+  mTask->setExecutor(std::make_shared<ThreadPool>(executorWorkers, "QC/" + mTaskConfig.taskName.substr(0, 6),
+                                                  mTaskConfig.pinExecutorThreads, mTaskConfig.executorFirstCpu + 1));
 
   // load config params
   if (!ConfigParamGlo::keyValues.empty()) {
@@ -324,6 +330,9 @@ void TaskRunner::endOfStream(framework::EndOfStreamContext& eosContext)
   } else {
     ILOG(Info, Support) << "Received an EndOfStream, finishing the current cycle" << ENDM;
     finishCycle(eosContext.outputs());
+    if (mFileWriter) {
+      mFileWriter->flush();
+    }
   }
   mNoMoreCycles = true;
 }
@@ -372,6 +381,7 @@ void TaskRunner::reset()
 {
   try {
     mTask.reset();
+    mFileWriter.reset(); // the pending snapshot is written first
     mCollector.reset();
     mObjectsManager.reset();
     mRunNumber = 0;
@@ -454,6 +464,8 @@ void TaskRunner::startCycle()
   mTask->startOfCycle();
   mNumberMessagesReceivedInCycle = 0;
   mNumberObjectsPublishedInCycle = 0;
+  mNumberObjectsUnchangedInCycle = 0;
+  mPublishedBytesInCycle = 0;
   mDataReceivedInCycle = 0;
   mTimerDurationCycle.reset();
   mCycleOn = true;
@@ -518,7 +530,24 @@ void TaskRunner::publishCycleStats()
                      .addValue(mNumberObjectsPublishedInCycle, "in_cycle")
                      .addValue(rate, "per_second")
                      .addValue(mTotalNumberObjectsPublished, "whole_run")
-                     .addValue(wholeRunRate, "per_second_whole_run"));
+                     .addValue(wholeRunRate, "per_second_whole_run")
+                     .addValue(mNumberObjectsUnchangedInCycle, "unchanged_in_cycle"));
+
+  mCollector->send(Metric{ "qc_data_published" }
+                     .addValue(mPublishedBytesInCycle, "data_in_cycle"));
+
+  if (mFileWriter) {
+    auto stats = mFileWriter->getStats();
+    mCollector->send(Metric{ "qc_save_to_file" }
+                       .addValue(stats.lastLatencyMs, "latency_ms")
+                       .addValue(stats.meanLatencyMs, "mean_latency_ms")
+                       .addValue(stats.bytesWritten, "bytes_written")
+                       .addValue(stats.bytesSerialized, "bytes_serialized")
+                       .addValue(stats.written, "written")
+                       .addValue(stats.skipped, "skipped")
+                       .addValue(stats.coalesced, "coalesced")
+                       .addValue(stats.failed, "failed"));
+  }
 }
 
 int TaskRunner::publish(DataAllocator& outputs)
@@ -526,18 +555,32 @@ int TaskRunner::publish(DataAllocator& outputs)
   ILOG(Debug, Support) << "Publishing " << mObjectsManager->getNumberPublishedObjects() << " MonitorObjects" << ENDM;
   AliceO2::Common::Timer publicationDurationTimer;
 
+  mObjectsManager->mergeShardedHistograms();
   auto concreteOutput = framework::DataSpecUtils::asConcreteDataMatcher(mTaskConfig.moSpec);
   // getNonOwningArray creates a TObjArray containing the monitoring objects, but not
   // owning them. The array is created by new and must be cleaned up by the caller
-  std::unique_ptr<MonitorObjectCollection> array(mObjectsManager->getNonOwningArray());
+  // When the objects are reset after each cycle, e.g. with Mergers in the delta mode, each publication is a delta
+  // added to the previous ones, thus an object is unchanged only if nothing was added to it since the reset.
+  const bool deltas = mTaskConfig.resetAfterCycles == 1;
+  std::unique_ptr<MonitorObjectCollection> array(mTaskConfig.skipUnchangedObjects
+                                                   ? mObjectsManager->getNonOwningArrayOfChangedObjects(deltas)
+                                                   : mObjectsManager->getNonOwningArray());
   int objectsPublished = array->GetEntries();
+  if (mTaskConfig.skipUnchangedObjects) {
+    mNumberObjectsUnchangedInCycle = mObjectsManager->getNumberPublishedObjects() - objectsPublished;
+  }
 
-  outputs.snapshot(
-    Output{ concreteOutput.origin,
-            concreteOutput.description,
-            concreteOutput.subSpec,
-            mTaskConfig.moSpec.lifetime },
-    *array);
+  // When nothing changed, there is no need to serialize and send an empty collection,
+  // the receivers keep the versions they already have.
+  if (objectsPublished > 0 || !mTaskConfig.skipUnchangedObjects) {
+    mPublishedBytesInCycle = mObjectsManager->estimateSerializedSize(*array);
+    outputs.snapshot(
+      Output{ concreteOutput.origin,
+              concreteOutput.description,
+              concreteOutput.subSpec,
+              mTaskConfig.moSpec.lifetime },
+      *array);
+  }
 
   mLastPublicationDuration = publicationDurationTimer.getTime();
   return objectsPublished;
@@ -546,12 +589,21 @@ int TaskRunner::publish(DataAllocator& outputs)
 void TaskRunner::saveToFile()
 {
   if (!mTaskConfig.saveToFile.empty()) {
-    ILOG(Debug, Support) << "Save data to file " << mTaskConfig.saveToFile << ENDM;
-    TFile f(mTaskConfig.saveToFile.c_str(), "RECREATE");
+    // The objects are serialized here and written by a background thread, so that the processing is not blocked
+    // by the file system. The file is replaced atomically, it is never seen half-written.
+    if (mFileWriter == nullptr) {
+      mFileWriter = std::make_unique<ObjectsFileWriter>(mTaskConfig.saveToFile, mTaskConfig.skipUnchangedObjects);
+    }
+    std::vector<const TObject*> objects;
+    objects.reserve(mObjectsManager->getNumberPublishedObjects());
     for (size_t i = 0; i < mObjectsManager->getNumberPublishedObjects(); i++) {
-      mObjectsManager->getMonitorObject(i)->getObject()->Write();
+      objects.push_back(mObjectsManager->getMonitorObject(i)->getObject());
+    }
+    if (mFileWriter->save(objects)) {
+      ILOG(Debug, Support) << "Saving data to file " << mTaskConfig.saveToFile << " in the background" << ENDM;
+    } else {
+      ILOG(Debug, Support) << "Objects unchanged, not saving them again to file " << mTaskConfig.saveToFile << ENDM;
     }
-    f.Close();
   }
 }
 
@@ -131,6 +131,15 @@ TaskRunnerConfig TaskRunnerFactory::extractConfig(const CommonSpec& globalConfig
 
   o2::globaltracking::RecoContainer rd;
 
+  // Mergers of entire objects replace everything they got from a task with its latest collection,
+  // so the objects missing in it would be lost.
+  bool skipUnchangedObjects = taskSpec.skipUnchangedObjects;
+  if (skipUnchangedObjects && parallelTaskID != 0 && taskSpec.mergingMode == "entire") {
+    ILOG(Warning, Support) << "skipUnchangedObjects cannot be used with the merging mode 'entire', it is disabled for the task "
+                           << taskSpec.taskName << ENDM;
+    skipUnchangedObjects = false;
+  }
+
   return {
     deviceName,
     taskSpec.taskName,
@@ -150,6 +159,10 @@ TaskRunnerConfig TaskRunnerFactory::extractConfig(const CommonSpec& globalConfig
     parallelTaskID,
     taskSpec.saveObjectsToFile,
     resetAfterCycles.value_or(taskSpec.resetAfterCycles),
+    skipUnchangedObjects,
+    taskSpec.executorThreads,
+    globalConfig.taskExecutorPinThreads,
+    taskSpec.executorFirstCpu,
     globalConfig.infologgerDiscardParameters,
     fallbackActivity,
     grpGeomRequest,
@@ -0,0 +1,254 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ThreadPool.cxx
+///
+
+#include "QualityControl/ThreadPool.h"
+#include "QualityControl/QcInfoLogger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <tuple>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace o2::quality_control::core
+{
+
+namespace
+{
+// lets push() know whether it is called by one of the workers of the pool
+thread_local const ThreadPool* tCurrentPool = nullptr;
+thread_local size_t tWorkerIndex = 0;
+} // namespace
+
+ThreadPool::ThreadPool(size_t nThreads, const std::string& name, bool pinThreads, size_t firstCpu)
+{
+  std::vector<int> cpus = pinThreads ? getCpusByNumaNode() : std::vector<int>{};
+  mWorkers.reserve(nThreads);
+  for (size_t i = 0; i < nThreads; i++) {
+    mWorkers.push_back(std::make_unique<Worker>());
+  }
+  for (size_t i = 0; i < nThreads; i++) {
+    mWorkers[i]->thread = std::thread([this, i, threadName = name + std::to_string(i), cpu = cpus.empty() ? -1 : cpus[(firstCpu + i) % cpus.size()]]() {
+#ifdef __linux__
+      // names longer than 15 characters are not accepted
+      pthread_setname_np(pthread_self(), threadName.substr(0, 15).c_str());
+      if (cpu >= 0) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(cpu, &cpuSet);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+      }
+#endif
+      // the jobs, including user code, log with ILOG, which must not share the InfoLogger of the processing thread
+      QcInfoLogger::initThreadInfoLogger();
+      run(i);
+    });
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopping = true;
+  }
+  mCondition.notify_all();
+  for (auto& worker : mWorkers) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+}
+
+size_t ThreadPool::getThreadIndex() const
+{
+  return tCurrentPool == this ? tWorkerIndex + 1 : 0;
+}
+
+void ThreadPool::push(std::function<void()> job)
+{
+  if (mWorkers.empty()) {
+    job();
+    return;
+  }
+  size_t index = tCurrentPool == this ? tWorkerIndex : mNextWorker++ % mWorkers.size();
+  {
+    std::lock_guard<std::mutex> lock(mWorkers[index]->mutex);
+    mWorkers[index]->jobs.push_back(std::move(job));
+  }
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPendingJobs++;
+  }
+  mCondition.notify_one();
+}
+
+bool ThreadPool::tryPop(size_t workerIndex, std::function<void()>& job)
+{
+  bool found = false;
+  {
+    // the most recent job of our own queue is the most likely to have its data in the cache
+    auto& own = *mWorkers[workerIndex];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.jobs.empty()) {
+      job = std::move(own.jobs.back());
+      own.jobs.pop_back();
+      found = true;
+    }
+  }
+  for (size_t i = 1; i < mWorkers.size() && !found; i++) {
+    auto& victim = *mWorkers[(workerIndex + i) % mWorkers.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.jobs.empty()) {
+      job = std::move(victim.jobs.front());
+      victim.jobs.pop_front();
+      found = true;
+    }
+  }
+  if (found) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPendingJobs--;
+  }
+  return found;
+}
+
+void ThreadPool::run(size_t workerIndex)
+{
+  tCurrentPool = this;
+  tWorkerIndex = workerIndex;
+  while (true) {
+    std::function<void()> job;
+    if (tryPop(workerIndex, job)) {
+      job();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCondition.wait(lock, [this]() { return mPendingJobs > 0 || mStopping; });
+    if (mPendingJobs <= 0) { // we are stopping and there is nothing left
+      return;
+    }
+  }
+}
+
+std::vector<int> ThreadPool::getCpusByNumaNode()
+{
+  std::vector<int> cpus;
+#ifdef __linux__
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed) != 0) {
+    return cpus;
+  }
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &allowed)) {
+      cpus.push_back(cpu);
+    }
+  }
+
+  // the CPUs of each node are listed in a format like "0-3,8-11"
+  std::map<int, int> nodeOfCpu;
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", error)) {
+    std::string directory = entry.path().filename().string();
+    if (directory.rfind("node", 0) != 0 || directory.size() == 4 || directory.find_first_not_of("0123456789", 4) != std::string::npos) {
+      continue;
+    }
+    int node = std::stoi(directory.substr(4));
+    std::ifstream cpuListFile(entry.path() / "cpulist");
+    std::string range;
+    while (std::getline(cpuListFile, range, ',')) {
+      int first = 0, last = 0;
+      char dash = 0;
+      std::istringstream rangeStream(range);
+      rangeStream >> first;
+      last = (rangeStream >> dash >> last) ? last : first;
+      for (int cpu = first; cpu <= last; cpu++) {
+        nodeOfCpu[cpu] = node;
+      }
+    }
+  }
+
+  int currentCpu = sched_getcpu();
+  int currentNode = nodeOfCpu.count(currentCpu) ? nodeOfCpu[currentCpu] : 0;
+  auto rank = [&](int cpu) {
+    int node = nodeOfCpu.count(cpu) ? nodeOfCpu[cpu] : 0;
+    return std::make_tuple(node != currentNode, node, cpu);
+  };
+  std::stable_sort(cpus.begin(), cpus.end(), [&](int a, int b) { return rank(a) < rank(b); });
+#endif
+  return cpus;
+}
+
+void ThreadPool::parallelFor(size_t n, const std::function<void(size_t)>& function)
+{
+  if (n == 0) {
+    return;
+  }
+
+  // Indices are distributed dynamically, so that a few slow calls do not leave the other threads idle.
+  // We do not wait for the helper jobs which did not start before all the indices were taken. Thus, parallelFor can be
+  // used inside a job of this pool. A late helper finds no index left and never touches `function`.
+  struct State {
+    std::atomic<size_t> next{ 0 };
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t running = 0;
+    std::exception_ptr exception;
+  };
+  auto state = std::make_shared<State>();
+  auto work = [state, n, &function]() {
+    for (size_t i = state->next++; i < n; i = state->next++) {
+      try {
+        function(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->exception) {
+          state->exception = std::current_exception();
+        }
+        state->next = n; // the remaining indices are abandoned
+      }
+    }
+  };
+
+  size_t helpers = std::min(mWorkers.size(), n - 1);
+  for (size_t i = 0; i < helpers; i++) {
+    push([state, work]() {
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->running++;
+      }
+      work();
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (--state->running == 0) {
+        state->finished.notify_all();
+      }
+    });
+  }
+
+  work();
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->finished.wait(lock, [&state]() { return state->running == 0; });
+  if (state->exception) {
+    std::rethrow_exception(state->exception);
+  }
+}
+
+} // namespace o2::quality_control::core
@@ -23,18 +23,23 @@
 #include "QualityControl/RepoPathUtils.h"
 
 #include <TH1.h>
+#include <TH1F.h>
 #include <TH2F.h>
 #include <TCanvas.h>
 #include <TPaveText.h>
 #include <TGraphErrors.h>
 #include <TPoint.h>
 
+#include <algorithm>
+#include <chrono>
 #include <set>
 
 using namespace o2::quality_control;
 using namespace o2::quality_control::core;
 using namespace o2::quality_control::postprocessing;
 
+TrendingTask::~TrendingTask() = default;
+
 void TrendingTask::configure(const boost::property_tree::ptree& config)
 {
   mConfig = TrendingTaskConfig(getID(), config);
@@ -116,8 +121,20 @@ void TrendingTask::initialize(Trigger, framework::ServiceRegistryRef services)
       mTrend->SetBranchAddress(sourceName.c_str(), reductor->getBranchAddress());
     }
   }
+  if (mConfig.publishPlotDurations) {
+    const int nPlots = mConfig.plots.size();
+    mPlotDurations = std::make_unique<TH1F>("plotDurations", "Time spent on each plot in the last update;;ms", nPlots, 0, nPlots);
+    mPlotDurations->SetDirectory(nullptr);
+    mPlotDurations->SetStats(false);
+    for (int i = 0; i < nPlots; i++) {
+      mPlotDurations->GetXaxis()->SetBinLabel(i + 1, mConfig.plots[i].name.c_str());
+    }
+  }
   if (mConfig.producePlotsOnUpdate) {
     getObjectsManager()->startPublishing(mTrend.get());
+    if (mPlotDurations) {
+      getObjectsManager()->startPublishing(mPlotDurations.get());
+    }
   }
 }
 
@@ -136,6 +153,9 @@ void TrendingTask::finalize(Trigger, framework::ServiceRegistryRef)
 {
   if (!mConfig.producePlotsOnUpdate) {
     getObjectsManager()->startPublishing(mTrend.get());
+    if (mPlotDurations) {
+      getObjectsManager()->startPublishing(mPlotDurations.get());
+    }
   }
   generatePlots();
 }
@@ -145,17 +165,32 @@ void TrendingTask::trendValues(const Trigger& t, repository::DatabaseInterface&
   mTime = t.timestamp / 1000; // ROOT expects seconds since epoch.
   mMetaData.runNumber = t.activity.mId;
 
+  // the objects are retrieved all at once, so that the latency of the trigger is close to the one of the slowest object
+  std::vector<repository::DatabaseInterface::MORequest> moRequests;
+  std::vector<repository::DatabaseInterface::QORequest> qoRequests;
+  for (auto& dataSource : mConfig.dataSources) {
+    if (dataSource.type == "repository") {
+      moRequests.push_back({ dataSource.path, dataSource.name, t.timestamp, t.activity });
+    } else if (dataSource.type == "repository-quality") {
+      qoRequests.push_back({ dataSource.path + "/" + dataSource.name, t.timestamp, t.activity });
+    }
+  }
+  auto mos = qcdb.retrieveMOs(moRequests);
+  auto qos = qcdb.retrieveQOs(qoRequests);
+
+  auto nextMO = mos.begin();
+  auto nextQO = qos.begin();
   for (auto& dataSource : mConfig.dataSources) {
 
     // todo: make it agnostic to MOs, QOs or other objects. Let the reductor cast to whatever it needs.
     if (dataSource.type == "repository") {
-      auto mo = qcdb.retrieveMO(dataSource.path, dataSource.name, t.timestamp, t.activity);
+      auto& mo = *nextMO++;
       TObject* obj = mo ? mo->getObject() : nullptr;
       if (obj) {
         mReductors[dataSource.name]->update(obj);
       }
     } else if (dataSource.type == "repository-quality") {
-      auto qo = qcdb.retrieveQO(dataSource.path + "/" + dataSource.name, t.timestamp, t.activity);
+      auto& qo = *nextQO++;
       if (qo) {
         mReductors[dataSource.name]->update(qo.get());
       }
@@ -197,6 +232,32 @@ void TrendingTask::setUserYAxisRange(TH1* hist, const std::string& graphYAxisRan
   hist->GetYaxis()->SetLimits(yMin, yMax);
 }
 
+namespace
+{
+// Entries$ is evaluated on the whole trend, thus a plot using it changes with each new entry
+bool dependsOnTrendLength(const TrendingTaskConfig::Plot& plot)
+{
+  for (const auto* expression : { &plot.varexp, &plot.selection, &plot.graphErrors }) {
+    if (expression->find("Entries$") != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Extends the limits of the axis to include [min, max], with a margin so that it is not extended at each update.
+void extendAxis(TAxis* axis, double min, double max)
+{
+  const double low = axis->GetXmin();
+  const double high = axis->GetXmax();
+  if (min >= low && max <= high) {
+    return;
+  }
+  const double margin = 0.1 * (std::max(max, high) - std::min(min, low));
+  axis->SetLimits(min < low ? min - margin : low, max > high ? max + margin : high);
+}
+} // namespace
+
 void TrendingTask::generatePlots()
 {
   if (mTrend->GetEntries() < 1) {
@@ -206,92 +267,163 @@ void TrendingTask::generatePlots()
 
   ILOG(Info, Support) << "Generating " << mConfig.plots.size() << " plots." << ENDM;
 
-  for (const auto& plot : mConfig.plots) {
+  for (size_t i = 0; i < mConfig.plots.size(); i++) {
+    const auto& plot = mConfig.plots[i];
+    auto start = std::chrono::steady_clock::now();
 
-    // Before we generate any new plots, we have to delete existing under the same names.
-    // It seems that ROOT cannot handle an existence of two canvases with a common name in the same process.
-    if (mPlots.count(plot.name)) {
-      getObjectsManager()->stopPublishing(plot.name);
-      delete mPlots[plot.name];
+    // Graphs get the new entries of the trend appended, the other plots are drawn again from the whole trend.
+    auto& state = mPlots[plot.name];
+    bool appended = state.graph != nullptr && appendToPlot(plot, state);
+    if (!appended) {
+      drawPlot(plot, state);
     }
 
-    // we determine the order of the plot, i.e. if it is a histogram (1), graph (2), or any higher dimension.
-    const size_t plotOrder = std::count(plot.varexp.begin(), plot.varexp.end(), ':') + 1;
-    // we have to delete the graph errors after the plot is saved, unfortunately the canvas does not take its ownership
-    TGraphErrors* graphErrors = nullptr;
-
-    auto* c = new TCanvas();
-
-    mTrend->Draw(plot.varexp.c_str(), plot.selection.c_str(), plot.option.c_str());
-
-    c->SetName(plot.name.c_str());
-    c->SetTitle(plot.title.c_str());
-
-    // For graphs we allow to draw errors if they are specified.
-    if (!plot.graphErrors.empty()) {
-      if (plotOrder != 2) {
-        ILOG(Error, Support) << "Non empty graphErrors seen for the plot '" << plot.name << "', which is not a graph, ignoring." << ENDM;
-      } else {
-        // We generate some 4-D points, where 2 dimensions represent graph points and 2 others are the error bars
-        std::string varexpWithErrors(plot.varexp + ":" + plot.graphErrors);
-        mTrend->Draw(varexpWithErrors.c_str(), plot.selection.c_str(), "goff");
-        graphErrors = new TGraphErrors(mTrend->GetSelectedRows(), mTrend->GetVal(1), mTrend->GetVal(0), mTrend->GetVal(2), mTrend->GetVal(3));
-        // We draw on the same plot as the main graph, but only error bars
-        graphErrors->Draw("SAME E");
-      }
+    double duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    ILOG(Debug, Support) << "Plot '" << plot.name << "' " << (appended ? "updated" : "drawn") << " in " << duration << " ms" << ENDM;
+    if (mPlotDurations) {
+      mPlotDurations->SetBinContent(i + 1, duration);
     }
+  }
+}
 
-    if (!plot.graphAxisLabel.empty()) {
-      if (auto histo = dynamic_cast<TH2F*>(c->GetPrimitive("htemp"))) {
-        setUserAxisLabel(histo->GetXaxis(), histo->GetYaxis(), plot.graphAxisLabel);
-      }
+bool TrendingTask::appendToPlot(const TrendingTaskConfig::Plot& plot, PlotState& state)
+{
+  const Long64_t entries = mTrend->GetEntries();
+  if (entries < state.entriesDrawn) {
+    return false; // not the trend which was drawn
+  }
+  const Long64_t newEntries = entries - state.entriesDrawn;
+  if (newEntries == 0) {
+    return true;
+  }
+
+  // Only the new entries are evaluated. With "goff" the canvas of the plot is not touched.
+  Long64_t rows = mTrend->Draw(plot.varexp.c_str(), plot.selection.c_str(), "goff", newEntries, state.entriesDrawn);
+  if (rows < 0) {
+    return false;
+  }
+  for (Long64_t row = 0; row < rows; row++) {
+    state.graph->SetPoint(state.graph->GetN(), mTrend->GetV2()[row], mTrend->GetV1()[row]);
+  }
+  if (state.graphErrors != nullptr) {
+    std::string varexpWithErrors(plot.varexp + ":" + plot.graphErrors);
+    rows = mTrend->Draw(varexpWithErrors.c_str(), plot.selection.c_str(), "goff", newEntries, state.entriesDrawn);
+    if (rows < 0) {
+      return false;
+    }
+    for (Long64_t row = 0; row < rows; row++) {
+      const int point = state.graphErrors->GetN();
+      state.graphErrors->SetPoint(point, mTrend->GetVal(1)[row], mTrend->GetVal(0)[row]);
+      state.graphErrors->SetPointError(point, mTrend->GetVal(2)[row], mTrend->GetVal(3)[row]);
+    }
+  }
+  state.entriesDrawn = entries;
+
+  // The frame was computed by TTree::Draw from the entries it had, the new points might be outside of it.
+  if (auto frame = dynamic_cast<TH2*>(state.canvas->GetPrimitive("htemp")); frame != nullptr && state.graph->GetN() > 0) {
+    double xMin, yMin, xMax, yMax;
+    (state.graphErrors != nullptr ? state.graphErrors : state.graph)->ComputeRange(xMin, yMin, xMax, yMax);
+    extendAxis(frame->GetXaxis(), xMin, xMax);
+    if (plot.graphYRange.empty()) {
+      extendAxis(frame->GetYaxis(), yMin, yMax);
     }
+  }
+  state.canvas->Modified();
+  return true;
+}
 
-    // Postprocessing the plot - adding specified titles, configuring time-based plots, flushing buffers.
-    // Notice that axes and title are drawn using a histogram, even in the case of graphs.
-    if (auto histo = dynamic_cast<TH1*>(c->GetPrimitive("htemp"))) {
-      // The title of histogram is printed, not the title of canvas => we set it as well.
-      histo->SetTitle(plot.title.c_str());
-      // We have to update the canvas to make the title appear.
-      c->Update();
+void TrendingTask::drawPlot(const TrendingTaskConfig::Plot& plot, PlotState& state)
+{
+  // The canvas is kept and published once. ROOT cannot handle two canvases with a common name in the same process,
+  // thus we clear it instead of creating a new one, which deletes what was drawn on it.
+  if (state.canvas == nullptr) {
+    state.canvas = new TCanvas();
+    state.canvas->SetName(plot.name.c_str());
+    state.canvas->SetTitle(plot.title.c_str());
+    getObjectsManager()->startPublishing(state.canvas);
+  } else {
+    state.canvas->cd();
+    state.canvas->Clear();
+  }
+  auto* c = state.canvas;
+  state.graph = nullptr;
+  state.graphErrors = nullptr;
 
-      // After the update, the title has a different size and it is not in the center anymore. We have to fix that.
-      if (auto title = dynamic_cast<TPaveText*>(c->GetPrimitive("title"))) {
-        title->SetBBoxCenterX(c->GetBBoxCenter().fX);
-        c->Modified();
-        c->Update();
-      } else {
-        ILOG(Error, Devel) << "Could not get the title TPaveText of the plot '" << plot.name << "'." << ENDM;
-      }
+  // we determine the order of the plot, i.e. if it is a histogram (1), graph (2), or any higher dimension.
+  const size_t plotOrder = std::count(plot.varexp.begin(), plot.varexp.end(), ':') + 1;
 
-      // We have to explicitly configure showing time on x axis.
-      // I hope that looking for ":time" is enough here and someone doesn't come with an exotic use-case.
-      if (plot.varexp.find(":time") != std::string::npos) {
-        histo->GetXaxis()->SetTimeDisplay(1);
-        // It deals with highly congested dates labels
-        histo->GetXaxis()->SetNdivisions(505);
-        // Without this it would show dates in order of 2044-12-18 on the day of 2019-12-19.
-        histo->GetXaxis()->SetTimeOffset(0.0);
-        histo->GetXaxis()->SetTimeFormat("%Y-%m-%d %H:%M");
-      } else if (plot.varexp.find(":meta.runNumber") != std::string::npos) {
-        histo->GetXaxis()->SetNoExponent(true);
-      }
+  mTrend->Draw(plot.varexp.c_str(), plot.selection.c_str(), plot.option.c_str());
+  state.entriesDrawn = mTrend->GetEntries();
 
-      // Set the user-defined range on the y axis if needed.
-      if (!plot.graphYRange.empty()) {
-        setUserYAxisRange(histo, plot.graphYRange);
-        c->Modified();
-        c->Update();
-      }
+  // Only graphs can be extended with new entries, the binning of histograms depends on the whole trend.
+  if (plotOrder == 2 && !dependsOnTrendLength(plot)) {
+    state.graph = dynamic_cast<TGraph*>(c->GetPrimitive("Graph"));
+  }
 
-      // QCG doesn't empty the buffers before visualizing the plot, nor does ROOT when saving the file,
-      // so we have to do it here.
-      histo->BufferEmpty();
+  // For graphs we allow to draw errors if they are specified.
+  if (!plot.graphErrors.empty()) {
+    if (plotOrder != 2) {
+      ILOG(Error, Support) << "Non empty graphErrors seen for the plot '" << plot.name << "', which is not a graph, ignoring." << ENDM;
     } else {
-      ILOG(Error, Devel) << "Could not get the htemp histogram of the plot '" << plot.name << "'." << ENDM;
+      // We generate some 4-D points, where 2 dimensions represent graph points and 2 others are the error bars
+      std::string varexpWithErrors(plot.varexp + ":" + plot.graphErrors);
+      mTrend->Draw(varexpWithErrors.c_str(), plot.selection.c_str(), "goff");
+      auto* graphErrors = new TGraphErrors(mTrend->GetSelectedRows(), mTrend->GetVal(1), mTrend->GetVal(0), mTrend->GetVal(2), mTrend->GetVal(3));
+      // the canvas deletes it when it is cleared
+      graphErrors->SetBit(TObject::kCanDelete);
+      state.graphErrors = graphErrors;
+      // We draw on the same plot as the main graph, but only error bars
+      graphErrors->Draw("SAME E");
+    }
+  }
+
+  if (!plot.graphAxisLabel.empty()) {
+    if (auto histo = dynamic_cast<TH2F*>(c->GetPrimitive("htemp"))) {
+      setUserAxisLabel(histo->GetXaxis(), histo->GetYaxis(), plot.graphAxisLabel);
     }
+  }
 
-    mPlots[plot.name] = c;
-    getObjectsManager()->startPublishing(c);
+  // Postprocessing the plot - adding specified titles, configuring time-based plots, flushing buffers.
+  // Notice that axes and title are drawn using a histogram, even in the case of graphs.
+  if (auto histo = dynamic_cast<TH1*>(c->GetPrimitive("htemp"))) {
+    // The title of histogram is printed, not the title of canvas => we set it as well.
+    histo->SetTitle(plot.title.c_str());
+    // We have to update the canvas to make the title appear.
+    c->Update();
+
+    // After the update, the title has a different size and it is not in the center anymore. We have to fix that.
+    if (auto title = dynamic_cast<TPaveText*>(c->GetPrimitive("title"))) {
+      title->SetBBoxCenterX(c->GetBBoxCenter().fX);
+      c->Modified();
+      c->Update();
+    } else {
+      ILOG(Error, Devel) << "Could not get the title TPaveText of the plot '" << plot.name << "'." << ENDM;
+    }
+
+    // We have to explicitly configure showing time on x axis.
+    // I hope that looking for ":time" is enough here and someone doesn't come with an exotic use-case.
+    if (plot.varexp.find(":time") != std::string::npos) {
+      histo->GetXaxis()->SetTimeDisplay(1);
+      // It deals with highly congested dates labels
+      histo->GetXaxis()->SetNdivisions(505);
+      // Without this it would show dates in order of 2044-12-18 on the day of 2019-12-19.
+      histo->GetXaxis()->SetTimeOffset(0.0);
+      histo->GetXaxis()->SetTimeFormat("%Y-%m-%d %H:%M");
+    } else if (plot.varexp.find(":meta.runNumber") != std::string::npos) {
+      histo->GetXaxis()->SetNoExponent(true);
+    }
+
+    // Set the user-defined range on the y axis if needed.
+    if (!plot.graphYRange.empty()) {
+      setUserYAxisRange(histo, plot.graphYRange);
+      c->Modified();
+      c->Update();
+    }
+
+    // QCG doesn't empty the buffers before visualizing the plot, nor does ROOT when saving the file,
+    // so we have to do it here.
+    histo->BufferEmpty();
+  } else {
+    ILOG(Error, Devel) << "Could not get the htemp histogram of the plot '" << plot.name << "'." << ENDM;
   }
 }
@@ -25,6 +25,7 @@ TrendingTaskConfig::TrendingTaskConfig(std::string id, const boost::property_tre
 {
   producePlotsOnUpdate = config.get<bool>("qc.postprocessing." + id + ".producePlotsOnUpdate", true);
   resumeTrend = config.get<bool>("qc.postprocessing." + id + ".resumeTrend", false);
+  publishPlotDurations = config.get<bool>("qc.postprocessing." + id + ".publishPlotDurations", false);
   for (const auto& plotConfig : config.get_child("qc.postprocessing." + id + ".plots")) {
     plots.push_back({ plotConfig.second.get<std::string>("name"),
                       plotConfig.second.get<std::string>("title", ""),
@@ -18,10 +18,12 @@
 #include "QualityControl/QcInfoLogger.h"
 #include "QualityControl/DatabaseHelpers.h"
 #include "QualityControl/CcdbDatabase.h"
+#include "QualityControl/CcdbListingReader.h"
 #include "QualityControl/ObjectMetadataKeys.h"
 
 #include <CCDB/CcdbApi.h>
 #include <Common/Timer.h>
+#include <algorithm>
 #include <chrono>
 #include <ostream>
 #include <tuple>
@@ -33,6 +35,16 @@ using namespace o2::quality_control::repository;
 namespace o2::quality_control::postprocessing
 {
 
+namespace
+{
+/// The keys needed to build the activity of a listed object. The first two are used directly by the triggers.
+std::vector<std::string> activityListingKeys()
+{
+  return { metadata_keys::validFrom, metadata_keys::created, metadata_keys::validUntil, metadata_keys::runType,
+           metadata_keys::runNumber, metadata_keys::passName, metadata_keys::periodName };
+}
+} // namespace
+
 std::ostream& operator<<(std::ostream& out, const Trigger& t)
 {
   out << "triggerType: " << t.triggerType << ", timestamp: " << t.timestamp;
@@ -187,44 +199,44 @@ TriggerFcn NewObject(const std::string& databaseUrl, const std::string& database
 
 TriggerFcn ForEachObject(const std::string& databaseUrl, const std::string& databaseType, const std::string& objectPath, const Activity& activity, const std::string& config)
 {
-  // Key names in the header map.
-  constexpr auto timestampKey = metadata_keys::validFrom;
   auto fullObjectPath = (databaseType == "qcdb" ? activity.mProvenance + "/" : "") + objectPath;
 
   // We support only CCDB here.
   auto db = std::make_shared<repository::CcdbDatabase>();
   db->connect(databaseUrl, "", "", "");
 
-  auto objects = db->getListingAsPtree(fullObjectPath).get_child("objects");
-  ILOG(Info, Support) << "Got " << objects.size() << " objects for the path '" << fullObjectPath << "'" << ENDM;
-  auto filteredObjects = std::make_shared<std::vector<boost::property_tree::ptree>>();
+  // the objects with their 'valid from' timestamps
+  auto filteredObjects = std::make_shared<std::vector<std::pair<Activity, int64_t>>>();
   const auto& filter = activity;
 
   ILOG(Debug, Devel) << "Filter activity: " << activity << ENDM;
 
-  // As for today, we receive objects in the order of the newest to the oldest.
-  // We prefer the other order here.
-  for (auto rit = objects.rbegin(); rit != objects.rend(); ++rit) {
-    auto objectActivity = repository::database_helpers::asActivity(rit->second, activity.mProvenance);
+  const CcdbListingReader reader(activityListingKeys());
+  size_t objects = db->forEachListedObject(fullObjectPath, reader.getKeys(), [&](const CcdbListingReader::Entry& entry) {
+    auto objectActivity = repository::database_helpers::asActivity(reader.asMetadata(entry), activity.mProvenance);
     ILOG(Debug, Trace) << "Matching the filter with object's activity: " << objectActivity << ENDM;
     if (filter.matches(objectActivity)) {
-      filteredObjects->emplace_back(rit->second);
+      filteredObjects->emplace_back(objectActivity, std::stoll(entry[0]));
       ILOG(Debug, Devel) << "Matched an object with activity: " << activity << ENDM;
     }
-  }
+    return true;
+  });
+  ILOG(Info, Support) << "Got " << objects << " objects for the path '" << fullObjectPath << "'" << ENDM;
   ILOG(Info, Support) << filteredObjects->size() << " objects matched the specified activity" << ENDM;
 
+  // As for today, we receive objects in the order of the newest to the oldest.
+  // We prefer the other order here.
+  std::reverse(filteredObjects->begin(), filteredObjects->end());
   // we make sure it is sorted. If it is already, it shouldn't cost much.
   std::sort(filteredObjects->begin(), filteredObjects->end(),
-            [](const boost::property_tree::ptree& a, const boost::property_tree::ptree& b) {
-              return a.get<int64_t>(timestampKey) < b.get<int64_t>(timestampKey);
+            [](const std::pair<Activity, int64_t>& a, const std::pair<Activity, int64_t>& b) {
+              return a.second < b.second;
             });
 
   return [filteredObjects, activity, currentObject = filteredObjects->begin(), config]() mutable -> Trigger {
     if (currentObject != filteredObjects->end()) {
-      auto currentActivity = repository::database_helpers::asActivity(*currentObject, activity.mProvenance);
       bool last = currentObject + 1 == filteredObjects->end();
-      Trigger trigger(TriggerType::ForEachObject, last, currentActivity, currentObject->get<int64_t>(timestampKey));
+      Trigger trigger(TriggerType::ForEachObject, last, currentObject->first, currentObject->second);
       ++currentObject;
       return trigger;
     } else {
@@ -235,38 +247,44 @@ TriggerFcn ForEachObject(const std::string& databaseUrl, const std::string& data
 
 TriggerFcn ForEachLatest(const std::string& databaseUrl, const std::string& databaseType, const std::string& objectPath, const Activity& activity, const std::string& config)
 {
-  // Key names in the header map.
-  constexpr auto timestampKey = metadata_keys::created;
   auto fullObjectPath = (databaseType == "qcdb" ? activity.mProvenance + "/" : "") + objectPath;
 
   // We support only CCDB here.
   auto db = std::make_shared<repository::CcdbDatabase>();
   db->connect(databaseUrl, "", "", "");
 
-  auto objects = db->getListingAsPtree(fullObjectPath).get_child("objects");
-  ILOG(Info, Support) << "Got " << objects.size() << " objects for the path '" << fullObjectPath << "'" << ENDM;
-  auto filteredObjects = std::make_shared<std::vector<std::pair<Activity, boost::property_tree::ptree>>>();
+  // the objects with their creation timestamps
+  std::vector<std::pair<Activity, int64_t>> objects;
   const auto& filter = activity;
 
   ILOG(Debug, Devel) << "Filter activity: " << activity << ENDM;
 
+  const CcdbListingReader reader(activityListingKeys());
+  db->forEachListedObject(fullObjectPath, reader.getKeys(), [&](const CcdbListingReader::Entry& entry) {
+    auto objectActivity = repository::database_helpers::asActivity(reader.asMetadata(entry), activity.mProvenance);
+    ILOG(Debug, Trace) << "Matching the filter with object's activity: " << objectActivity << ENDM;
+    if (filter.matches(objectActivity)) {
+      objects.emplace_back(objectActivity, std::stoll(entry[1]));
+    }
+    return true;
+  });
+  ILOG(Info, Support) << "Got " << objects.size() << " matching objects for the path '" << fullObjectPath << "'" << ENDM;
+
   // As for today, we receive objects in the order of the newest to the oldest.
   // The inverse order is more likely to follow what we want (ascending by period/pass/run),
   // thus sorting may take less time.
+  auto filteredObjects = std::make_shared<std::vector<std::pair<Activity, int64_t>>>();
   for (auto rit = objects.rbegin(); rit != objects.rend(); ++rit) {
-    auto objectActivity = repository::database_helpers::asActivity(rit->second, activity.mProvenance);
-    ILOG(Debug, Trace) << "Matching the filter with object's activity: " << objectActivity << ENDM;
-    if (filter.matches(objectActivity)) {
-      auto latestObject = std::find_if(filteredObjects->begin(), filteredObjects->end(), [&](const std::pair<Activity, boost::property_tree::ptree>& entry) {
-        return entry.first.same(objectActivity);
-      });
-      if (latestObject != filteredObjects->end() && latestObject->second.get<int64_t>(timestampKey) < rit->second.get<int64_t>(timestampKey)) {
-        *latestObject = { objectActivity, rit->second };
-        ILOG(Debug, Devel) << "Updated the object with activity: " << objectActivity << ENDM;
-      } else {
-        filteredObjects->emplace_back(objectActivity, rit->second);
-        ILOG(Debug, Devel) << "Matched an object with activity: " << objectActivity << ENDM;
-      }
+    const auto& [objectActivity, created] = *rit;
+    auto latestObject = std::find_if(filteredObjects->begin(), filteredObjects->end(), [&](const std::pair<Activity, int64_t>& entry) {
+      return entry.first.same(objectActivity);
+    });
+    if (latestObject != filteredObjects->end() && latestObject->second < created) {
+      *latestObject = *rit;
+      ILOG(Debug, Devel) << "Updated the object with activity: " << objectActivity << ENDM;
+    } else {
+      filteredObjects->emplace_back(*rit);
+      ILOG(Debug, Devel) << "Matched an object with activity: " << objectActivity << ENDM;
     }
   }
   ILOG(Info, Support) << filteredObjects->size() << " objects matched the specified activity" << ENDM;
@@ -274,21 +292,16 @@ TriggerFcn ForEachLatest(const std::string& databaseUrl, const std::string& data
   // Since we select concrete objects per each combination of run/pass/period,
   // we sort the entries in the ascending order by period, pass and run.
   std::sort(filteredObjects->begin(), filteredObjects->end(),
-            [](const std::pair<Activity, boost::property_tree::ptree>& a, const std::pair<Activity, boost::property_tree::ptree>& b) {
-              return std::forward_as_tuple(a.second.get<std::string>(metadata_keys::periodName, ""),
-                                           a.second.get<std::string>(metadata_keys::passName, ""),
-                                           a.second.get<int64_t>(metadata_keys::runNumber, 0)) <
-                     std::forward_as_tuple(b.second.get<std::string>(metadata_keys::periodName, ""),
-                                           b.second.get<std::string>(metadata_keys::passName, ""),
-                                           b.second.get<int64_t>(metadata_keys::runNumber, 0));
+            [](const std::pair<Activity, int64_t>& a, const std::pair<Activity, int64_t>& b) {
+              return std::forward_as_tuple(a.first.mPeriodName, a.first.mPassName, a.first.mId) <
+                     std::forward_as_tuple(b.first.mPeriodName, b.first.mPassName, b.first.mId);
             });
 
   return [filteredObjects, activity, currentObject = filteredObjects->begin(), config]() mutable -> Trigger {
     if (currentObject != filteredObjects->end()) {
-      const auto& currentActivity = currentObject->first;
-      const auto& currentPtree = currentObject->second;
+      const auto& [currentActivity, created] = *currentObject;
       bool last = currentObject + 1 == filteredObjects->end();
-      Trigger trigger(TriggerType::ForEachLatest, last, currentActivity, currentPtree.get<int64_t>(timestampKey), config);
+      Trigger trigger(TriggerType::ForEachLatest, last, currentActivity, created, config);
       ++currentObject;
       return trigger;
     } else {
@@ -14,6 +14,7 @@
 /// \author Barthelemy von Haller
 ///
 
+#include <algorithm>
 #include <utility>
 
 #include "QualityControl/UpdatePolicyManager.h"
@@ -33,19 +34,20 @@ void UpdatePolicyManager::updateGlobalRevision()
     // mGlobalRevision cannot be 0
     // 0 means overflow, increment and update all check revisions to 0
     ++mGlobalRevision;
-    for (auto& actor : mPoliciesByActor) {
-      updateActorRevision(actor.second.actorName, 0);
+    for (ActorIdType actorId = 0; actorId < mPolicies.size(); actorId++) {
+      updateActorRevision(actorId, 0);
     }
   }
 }
 
 void UpdatePolicyManager::updateActorRevision(const std::string& actorName, RevisionType revision)
 {
-  if (mPoliciesByActor.count(actorName) == 0) {
+  auto actor = mActorIds.find(actorName);
+  if (actor == mActorIds.end()) {
     ILOG(Error, Support) << "Cannot update revision for " << actorName << " : object not found" << ENDM;
     BOOST_THROW_EXCEPTION(ObjectNotFoundError() << errinfo_object_name(actorName));
   }
-  mPoliciesByActor.at(actorName).revision = revision;
+  updateActorRevision(actor->second, revision);
 }
 
 void UpdatePolicyManager::updateActorRevision(const std::string& actorName)
@@ -53,32 +55,96 @@ void UpdatePolicyManager::updateActorRevision(const std::string& actorName)
   updateActorRevision(actorName, mGlobalRevision);
 }
 
+void UpdatePolicyManager::updateActorRevision(ActorIdType actorId, RevisionType revision)
+{
+  mPolicies[actorId].revision = revision;
+  refreshActor(actorId);
+}
+
+void UpdatePolicyManager::updateActorRevision(ActorIdType actorId)
+{
+  updateActorRevision(actorId, mGlobalRevision);
+}
+
 void UpdatePolicyManager::updateObjectRevision(const std::string& objectName, RevisionType revision)
 {
-  mObjectsRevision[objectName] = revision;
+  updateObjectRevision(getObjectId(objectName), revision);
 }
 
 void UpdatePolicyManager::updateObjectRevision(const std::string& objectName)
 {
-  updateObjectRevision(objectName, mGlobalRevision);
+  updateObjectRevision(getObjectId(objectName), mGlobalRevision);
+}
+
+void UpdatePolicyManager::updateObjectRevision(ObjectIdType objectId, RevisionType revision)
+{
+  auto previous = mObjectsRevision[objectId];
+  if (previous == revision) {
+    return;
+  }
+  mObjectsRevision[objectId] = revision;
+
+  // only the actors using this object are affected, they are updated incrementally
+  for (auto actorId : mObjectActors[objectId]) {
+    auto& policy = mPolicies[actorId];
+    bool wasUpdated = previous > policy.revision;
+    bool isUpdated = revision > policy.revision;
+    if (wasUpdated != isUpdated) {
+      if (isUpdated) {
+        policy.updatedInputs++;
+      } else {
+        policy.updatedInputs--;
+      }
+      setDirty(actorId, policy.updatedInputs > 0 || policy.readyWithoutUpdates);
+    }
+    if (previous == 0) {
+      policy.receivedInputs++;
+    } else if (revision == 0) {
+      policy.receivedInputs--;
+    }
+  }
+}
+
+void UpdatePolicyManager::updateObjectRevision(ObjectIdType objectId)
+{
+  updateObjectRevision(objectId, mGlobalRevision);
+}
+
+ObjectIdType UpdatePolicyManager::getObjectId(const std::string& objectName)
+{
+  auto [it, inserted] = mObjectIds.try_emplace(objectName, static_cast<ObjectIdType>(mObjectsRevision.size()));
+  if (inserted) {
+    mObjectsRevision.push_back(0);
+    mObjectActors.emplace_back();
+  }
+  return it->second;
+}
+
+ActorIdType UpdatePolicyManager::getActorId(const std::string& actorName) const
+{
+  auto actor = mActorIds.find(actorName);
+  if (actor == mActorIds.end()) {
+    ILOG(Error, Support) << "Cannot find the policy of " << actorName << " : object not found" << ENDM;
+    BOOST_THROW_EXCEPTION(ObjectNotFoundError() << errinfo_object_name(actorName));
+  }
+  return actor->second;
 }
 
 void UpdatePolicyManager::addPolicy(const std::string& actorName, UpdatePolicyType policyType, std::vector<std::string> objectNames, bool allObjects, bool policyHelper)
 {
+  // The policies only look at the counters of updated and received inputs maintained by updateObjectRevision()
+  // and refreshActor(), so that evaluating them does not depend on the number of inputs.
   UpdatePolicyFunctionType policy;
+  bool readyWithoutUpdates = false;
   switch (policyType) {
     case UpdatePolicyType::OnAll: {
       /**
        * Run check if all MOs are updated
        */
-      policy = [&, actorName]() {
-        for (const auto& objectName : mPoliciesByActor.at(actorName).inputObjects) {
-          if (mObjectsRevision.count(objectName) == 0 || mObjectsRevision.at(objectName) <= mPoliciesByActor.at(actorName).revision) {
-            return false;
-          }
-        }
-        return true;
+      policy = [](UpdatePolicy& updatePolicy) {
+        return updatePolicy.updatedInputs == updatePolicy.inputObjectIds.size();
       };
+      readyWithoutUpdates = objectNames.empty();
       break;
     }
     case UpdatePolicyType::OnAnyNonZero: {
@@ -86,24 +152,16 @@ void UpdatePolicyManager::addPolicy(const std::string& actorName, UpdatePolicyTy
        * Return true if any declared MOs were updated
        * Guarantee that all declared MOs are available
        */
-      policy = [&, actorName]() {
-        if (!mPoliciesByActor.at(actorName).policyHelperFlag) {
+      policy = [](UpdatePolicy& updatePolicy) {
+        if (!updatePolicy.policyHelperFlag) {
           // Check if all monitor objects are available
-          for (const auto& objectName : mPoliciesByActor.at(actorName).inputObjects) {
-            if (!mObjectsRevision.count(objectName)) {
-              return false;
-            }
+          if (updatePolicy.receivedInputs < updatePolicy.inputObjectIds.size()) {
+            return false;
           }
           // From now on all MOs are available
-          mPoliciesByActor.at(actorName).policyHelperFlag = true;
+          updatePolicy.policyHelperFlag = true;
         }
-
-        for (const auto& objectName : mPoliciesByActor.at(actorName).inputObjects) {
-          if (mObjectsRevision[objectName] > mPoliciesByActor.at(actorName).revision) {
-            return true;
-          }
-        }
-        return false;
+        return updatePolicy.updatedInputs > 0;
       };
       break;
     }
@@ -112,18 +170,10 @@ void UpdatePolicyManager::addPolicy(const std::string& actorName, UpdatePolicyTy
         * Return true if any declared object were updated.
         * This is the same behaviour as OnAny.
         */
-      policy = [&, actorName]() {
-        if (mPoliciesByActor.at(actorName).allInputObjects) {
-          return true;
-        }
-
-        for (const auto& objectName : mPoliciesByActor.at(actorName).inputObjects) {
-          if (mObjectsRevision.count(objectName) && mObjectsRevision[objectName] > mPoliciesByActor.at(actorName).revision) {
-            return true;
-          }
-        }
-        return false;
+      policy = [](UpdatePolicy& updatePolicy) {
+        return updatePolicy.allInputObjects || updatePolicy.updatedInputs > 0;
       };
+      readyWithoutUpdates = allObjects;
       break;
     }
     case UpdatePolicyType::OnGlobalAny: {
@@ -133,10 +183,11 @@ void UpdatePolicyManager::addPolicy(const std::string& actorName, UpdatePolicyTy
        * Might return true even if MO is not used in Check
        */
 
-      policy = []() {
+      policy = [](UpdatePolicy&) {
         // Expecting check of this policy only if any change
         return true;
       };
+      readyWithoutUpdates = true;
       break;
     }
     case UpdatePolicyType::OnAny: {
@@ -146,30 +197,97 @@ void UpdatePolicyManager::addPolicy(const std::string& actorName, UpdatePolicyTy
        * Run check if any declared MOs are updated
        * Does not guarantee to contain all declared MOs
        */
-      policy = [&, actorName]() {
-        for (const auto& objectName : mPoliciesByActor.at(actorName).inputObjects) {
-          if (mObjectsRevision.count(objectName) && mObjectsRevision[objectName] > mPoliciesByActor.at(actorName).revision) {
-            return true;
-          }
-        }
-        return false;
+      policy = [](UpdatePolicy& updatePolicy) {
+        return updatePolicy.updatedInputs > 0;
       };
       break;
     }
   }
 
-  mPoliciesByActor[actorName] = { actorName, policy, std::move(objectNames), allObjects, policyHelper };
+  auto [actor, inserted] = mActorIds.try_emplace(actorName, static_cast<ActorIdType>(mPolicies.size()));
+  auto actorId = actor->second;
+  if (inserted) {
+    mPolicies.emplace_back();
+    mDirtyActors.resize(mPolicies.size() / 64 + 1, 0);
+  } else {
+    // the new policy replaces the previous one, which should not be triggered by its inputs anymore
+    for (auto objectId : mPolicies[actorId].inputObjectIds) {
+      auto& actors = mObjectActors[objectId];
+      actors.erase(std::remove(actors.begin(), actors.end(), actorId), actors.end());
+    }
+  }
+
+  // the objects which were not received yet get an ID as well, with the revision 0
+  std::vector<ObjectIdType> objectIds;
+  objectIds.reserve(objectNames.size());
+  for (const auto& objectName : objectNames) {
+    auto objectId = getObjectId(objectName);
+    objectIds.push_back(objectId);
+    mObjectActors[objectId].push_back(actorId);
+  }
+  mPolicies[actorId] = { actorName, policy, std::move(objectNames), std::move(objectIds), allObjects, policyHelper };
+  mPolicies[actorId].readyWithoutUpdates = readyWithoutUpdates;
+  refreshActor(actorId);
 
-  ILOG(Info, Devel) << "Added a policy : " << mPoliciesByActor[actorName] << ENDM;
+  ILOG(Info, Devel) << "Added a policy : " << mPolicies[actorId] << ENDM;
 }
 
 bool UpdatePolicyManager::isReady(const std::string& actorName)
 {
-  if (mPoliciesByActor.count(actorName) == 0) {
+  auto actor = mActorIds.find(actorName);
+  if (actor == mActorIds.end()) {
     ILOG(Error, Support) << "Cannot check if " << actorName << " is ready : object not found" << ENDM;
     BOOST_THROW_EXCEPTION(ObjectNotFoundError() << errinfo_object_name(actorName));
   }
-  return mPoliciesByActor.at(actorName).isReady();
+  return isReady(actor->second);
+}
+
+bool UpdatePolicyManager::isReady(ActorIdType actorId)
+{
+  auto& policy = mPolicies[actorId];
+  return policy.isReady(policy);
+}
+
+std::vector<ActorIdType> UpdatePolicyManager::getDirtyActors() const
+{
+  std::vector<ActorIdType> actors;
+  for (size_t word = 0; word < mDirtyActors.size(); word++) {
+    // the words without any dirty actor are skipped at once
+    uint64_t bits = mDirtyActors[word];
+    for (ActorIdType bit = 0; bits != 0; bit++, bits >>= 1) {
+      if (bits & 1) {
+        actors.push_back(static_cast<ActorIdType>(word * 64 + bit));
+      }
+    }
+  }
+  return actors;
+}
+
+void UpdatePolicyManager::refreshActor(ActorIdType actorId)
+{
+  auto& policy = mPolicies[actorId];
+  policy.updatedInputs = 0;
+  policy.receivedInputs = 0;
+  for (auto objectId : policy.inputObjectIds) {
+    auto revision = mObjectsRevision[objectId];
+    if (revision > policy.revision) {
+      policy.updatedInputs++;
+    }
+    if (revision != 0) {
+      policy.receivedInputs++;
+    }
+  }
+  setDirty(actorId, policy.updatedInputs > 0 || policy.readyWithoutUpdates);
+}
+
+void UpdatePolicyManager::setDirty(ActorIdType actorId, bool dirty)
+{
+  uint64_t mask = uint64_t{ 1 } << (actorId % 64);
+  if (dirty) {
+    mDirtyActors[actorId / 64] |= mask;
+  } else {
+    mDirtyActors[actorId / 64] &= ~mask;
+  }
 }
 
 std::ostream& operator<<(std::ostream& out, const UpdatePolicy& updatePolicy) // output
@@ -187,8 +305,12 @@ std::ostream& operator<<(std::ostream& out, const UpdatePolicy& updatePolicy) //
 
 void UpdatePolicyManager::reset()
 {
-  mPoliciesByActor.clear();
+  mPolicies.clear();
+  mActorIds.clear();
+  mDirtyActors.clear();
+  mObjectIds.clear();
   mObjectsRevision.clear();
+  mObjectActors.clear();
   mGlobalRevision = 1;
 }
 
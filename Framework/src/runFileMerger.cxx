@@ -18,16 +18,24 @@
 #include "QualityControl/QcInfoLogger.h"
 #include "QualityControl/MonitorObject.h"
 #include "QualityControl/MonitorObjectCollection.h"
+#include "QualityControl/ThreadPool.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <fstream>
 #include <filesystem>
+#include <unistd.h>
 #include <boost/program_options.hpp>
 #include <boost/exception/diagnostic_information.hpp>
+#include <TBufferFile.h>
 #include <TFile.h>
 #include <TKey.h>
 #include <TGrid.h>
+#include <TROOT.h>
 #include <variant>
 
 namespace bpo = boost::program_options;
@@ -48,6 +56,218 @@ struct Node {
   std::string getFullPath() const { return pathTo + std::filesystem::path::preferred_separator + name; }
 };
 
+namespace
+{
+
+using ErrorHandler = std::function<void(const std::string&)>;
+
+/// An item to be merged in the reduction tree: either a file (an input or a spilled intermediate result) or
+/// an intermediate result kept in memory.
+struct Source {
+  std::string filePath{};
+  std::unique_ptr<Node> node{};
+  bool isInput = false;      // an input file, accounted in the statistics
+  bool isTemporary = false;  // a spilled intermediate result, removed once read
+  bool isOutputFile = false; // the existing content of the output file
+  size_t sizeInMemory = 0;   // the estimated size of `node`, accounted in the memory budget
+};
+
+struct MergerStatistics {
+  std::atomic<size_t> filesRead{ 0 };
+  std::atomic<size_t> bytesRead{ 0 };
+  std::atomic<size_t> filesSpilled{ 0 };
+};
+
+void mergeDirectory(TDirectory* fileNode, Node& memoryNode, const std::vector<std::string>& excludedDirectories, const ErrorHandler& handleError)
+{
+  if (fileNode == nullptr) {
+    ILOG(Error) << "Provided parentNode pointer is null, skipping." << ENDM;
+    return;
+  }
+  TIter next(fileNode->GetListOfKeys());
+  TKey* key;
+  while ((key = (TKey*)next())) {
+    // we look for exact matches here. we skip if there are no subdirectories
+    if (std::find(excludedDirectories.begin(), excludedDirectories.end(), key->GetName()) != excludedDirectories.end()) {
+      ILOG(Info, Support) << "Skipping '" << key->GetName() << "' as requested in the input arguments" << ENDM;
+      continue;
+    }
+    // we check if we have to skip any subdirectories wrt where we are
+    std::vector<std::string> excludedSubdirectories;
+    for (const auto& excludedDirectory : excludedDirectories) {
+      auto match = std::string(key->GetName()) + '/';
+      if (excludedDirectory.find(match) == 0) {
+        if (excludedDirectory.size() < match.size()) {
+          ILOG(Warning, Support) << "Invalid exclusion path '" << excludedDirectory << "'" << ENDM;
+          continue;
+        }
+        excludedSubdirectories.push_back(excludedDirectory.substr(match.size()));
+      }
+    }
+
+    ILOG(Debug, Devel) << "Getting the value for key '" << key->GetName() << "'" << ENDM;
+    auto* value = fileNode->Get(key->GetName());
+    if (value == nullptr) {
+      ILOG(Error) << "Could not get the value '" << key->GetName() << "', skipping." << ENDM;
+      continue;
+    }
+    if (auto inputMOC = dynamic_cast<MonitorObjectCollection*>(value)) {
+      inputMOC->postDeserialization();
+
+      if (memoryNode.children.count(inputMOC->GetName())) {
+        try {
+          std::get<MonitorObjectCollection*>(memoryNode.children[inputMOC->GetName()])->merge(inputMOC);
+        } catch (...) {
+          handleError("Failed to merge the Monitor Object Collection. Exception caught: " + boost::current_exception_diagnostic_information(true));
+        }
+        delete inputMOC;
+      } else {
+        memoryNode.children[inputMOC->GetName()] = inputMOC;
+      }
+    } else if (auto dir = dynamic_cast<TDirectory*>(value)) {
+      auto name = dir->GetName();
+      if (memoryNode.children.count(name) == 0) {
+        memoryNode.children[name] = Node{ memoryNode.getFullPath(), name };
+      }
+      mergeDirectory(dir, std::get<Node>(memoryNode.children[name]), excludedSubdirectories, handleError);
+    } else {
+      handleError("Could not cast the node to MonitorObjectCollection nor TDirectory.");
+      delete value;
+      continue;
+    }
+  }
+}
+
+/// Merges the other node into the target, the objects of the other node are either moved or deleted.
+void mergeNodes(Node& target, Node& other, const ErrorHandler& handleError)
+{
+  for (auto& [name, value] : other.children) {
+    std::visit(overloaded{
+                 [&](Node& node) {
+                   if (target.children.count(name) == 0) {
+                     target.children[name] = Node{ target.getFullPath(), node.name };
+                   }
+                   mergeNodes(std::get<Node>(target.children[name]), node, handleError);
+                 },
+                 [&](MonitorObjectCollection* moc) {
+                   if (target.children.count(name)) {
+                     try {
+                       std::get<MonitorObjectCollection*>(target.children[name])->merge(moc);
+                     } catch (...) {
+                       handleError("Failed to merge the Monitor Object Collection. Exception caught: " + boost::current_exception_diagnostic_information(true));
+                     }
+                     delete moc;
+                   } else {
+                     target.children[name] = moc;
+                   }
+                 } },
+               value);
+  }
+  other.children.clear();
+}
+
+/// Writes the node in the directory and deletes its objects.
+void storeNode(TDirectory* fout, const Node& memoryNode, const ErrorHandler& handleError)
+{
+  for (const auto& [name, value] : memoryNode.children) {
+    std::visit(overloaded{
+                 [&](const Node& node) {
+                   auto* dir = fout->GetDirectory(node.name.c_str());
+                   if (dir == nullptr) {
+                     fout->mkdir(node.name.c_str());
+                   }
+                   dir = fout->GetDirectory(node.name.c_str());
+                   if (dir == nullptr) {
+                     handleError("Could not create directory '" + node.name + "' in path '" + node.pathTo + "'");
+                   } else {
+                     storeNode(dir, node, handleError);
+                   }
+                 },
+                 [&](const MonitorObjectCollection* moc) {
+                   fout->WriteObject(moc, moc->GetName(), "Overwrite");
+                   delete moc;
+                 } },
+               value);
+  }
+}
+
+/// Returns the size of the node once serialized, which is close to the memory it takes.
+size_t estimateSize(const Node& memoryNode)
+{
+  TBufferFile buffer(TBuffer::kWrite);
+  size_t total = 0;
+  std::function<void(const Node&)> estimateRecursively;
+  estimateRecursively = [&](const Node& node) {
+    for (const auto& [name, value] : node.children) {
+      if (auto child = std::get_if<Node>(&value)) {
+        estimateRecursively(*child);
+      } else {
+        buffer.Reset();
+        buffer.ResetMap();
+        buffer.WriteObject(std::get<MonitorObjectCollection*>(value));
+        total += buffer.Length();
+      }
+    }
+  };
+  estimateRecursively(memoryNode);
+  return total;
+}
+
+/// Merges the source into the target. The files which cannot be opened are reported and skipped.
+void mergeSource(Source& source, Node& target, const std::vector<std::string>& excludedDirectories, const ErrorHandler& handleError, MergerStatistics& statistics)
+{
+  if (source.node) {
+    mergeNodes(target, *source.node, handleError);
+    source.node.reset();
+    return;
+  }
+
+  // The output file might contain objects which are not ours, we do not stop because of them.
+  auto ignoreErrors = [](const std::string& message) { ILOG(Warning, Support) << message << ENDM; };
+  const auto& handleFileError = source.isOutputFile ? ErrorHandler(ignoreErrors) : handleError;
+  auto* file = TFile::Open(source.filePath.c_str(), "READ");
+  if (file == nullptr) {
+    handleFileError("File handler for '" + source.filePath + "' is nullptr.");
+    return;
+  }
+  if (file->IsZombie()) {
+    handleFileError("File '" + source.filePath + "' is zombie.");
+    delete file;
+    return;
+  }
+  if (!file->IsOpen()) {
+    handleFileError("Failed to open the file: " + source.filePath);
+    delete file;
+    return;
+  }
+  ILOG(Debug) << "Input file '" << source.filePath << "' successfully open." << ENDM;
+
+  // the spilled results were already filtered
+  mergeDirectory(file, target, source.isTemporary ? std::vector<std::string>{} : excludedDirectories, handleFileError);
+  if (source.isInput) {
+    statistics.filesRead++;
+    statistics.bytesRead += file->GetSize();
+  }
+  file->Close();
+  delete file;
+  if (source.isTemporary) {
+    std::filesystem::remove(source.filePath);
+  }
+}
+
+/// Removes the temporary files which were not read yet, e.g. when the merging is interrupted by an error.
+void removeTemporaryFiles(const std::vector<Source>& sources)
+{
+  for (const auto& source : sources) {
+    if (source.isTemporary) {
+      std::error_code error;
+      std::filesystem::remove(source.filePath, error);
+    }
+  }
+}
+
+} // namespace
+
 int main(int argc, const char* argv[])
 {
   size_t filesRead = 0;
@@ -60,7 +280,11 @@ int main(int argc, const char* argv[])
       ("output-file", bpo::value<std::string>()->default_value("merged.root"), "File path to store the merged results, if the file exists, it will be merged with new files.") //
       ("input-files-list", bpo::value<std::string>()->default_value(""), "Path to a file containing a list of input files (row by row)")                                       //
       ("input-files", bpo::value<std::vector<std::string>>()->multitoken(), "Space-separated file paths which should be merged.")                                              //
-      ("exclude-directories", bpo::value<std::vector<std::string>>()->multitoken(), "Space-separated directories which should be excluded when merging files.");
+      ("exclude-directories", bpo::value<std::vector<std::string>>()->multitoken(), "Space-separated directories which should be excluded when merging files.")                //
+      ("threads", bpo::value<size_t>()->default_value(1), "Number of threads merging the files in parallel.")                                                                  //
+      ("fan-in", bpo::value<size_t>()->default_value(0), "Number of files merged together at each level of the reduction, 0 or 1 merges all the files in one go.")             //
+      ("memory-limit", bpo::value<size_t>()->default_value(0), "Memory (MB) for the intermediate results, above which they are spilled to temporary files, 0 for no limit.")   //
+      ("temp-dir", bpo::value<std::string>()->default_value(""), "Directory of the temporary files, the system default if empty.");
 
     bpo::variables_map vm;
     store(bpo::command_line_parser(argc, argv).options(desc).run(), vm);
@@ -113,9 +337,16 @@ int main(int argc, const char* argv[])
       ILOG(Info, Support) << ENDM;
     }
 
-    auto handleError = vm["exit-on-error"].as<bool>()
+    auto reportError = vm["exit-on-error"].as<bool>()
                          ? [](const std::string& message) { throw std::runtime_error(message); }
                          : [](const std::string& message) { ILOG(Error, Support) << message << ENDM; };
+    // The errors are reported by the threads of the pool as well. They log with their own InfoLogger (see ThreadPool),
+    // we only make sure that the messages do not interleave. A thrown error is passed to this thread by parallelFor.
+    std::mutex errorMutex;
+    ErrorHandler handleError = [&](const std::string& message) {
+      std::lock_guard<std::mutex> lock(errorMutex);
+      reportError(message);
+    };
 
     auto outputFilePath = vm["output-file"].as<std::string>();
     auto outputFile = new TFile(outputFilePath.c_str(), "UPDATE");
@@ -129,139 +360,108 @@ int main(int argc, const char* argv[])
       throw std::runtime_error("File '" + outputFilePath + "' is not writable.");
     }
     ILOG(Debug) << "Output file '" << outputFilePath << "' successfully open." << ENDM;
+    // it is opened again to store the results, in the meantime it is read as the first source
+    outputFile->Close();
+    delete outputFile;
 
     // Unlike in RootFileSink and RootFileSource, where we assume that the latter only supports the output of the first,
     // here we have more relaxed assumptions and try to recursively merge everything, regardless of the directory structure.
     // This is because we might have to change the structure again when we support moving windows, so we might save some work
     // in the future.
-    // We choose to keep the merged file structure in memory and merge everything we can before storing in a file.
-    // If this becomes too memory-hungry, it could be rewritten to store anything merge immediately at the cost of
-    // more I/O operations.
-    Node mergedTree;
-    for (const auto& inputFilePath : inputFilePaths) {
-      auto* file = TFile::Open(inputFilePath.c_str(), "READ");
-      if (file == nullptr) {
-        handleError("File handler for '" + inputFilePath + "' is nullptr.");
-        continue;
-      }
-      if (file->IsZombie()) {
-        handleError("File '" + inputFilePath + "' is zombie.");
-        continue;
+    //
+    // The sources (the existing output file and then the input files) are merged with a tree reduction. At each level,
+    // groups of `fan-in` consecutive sources are merged in parallel, each group in its order, and the results become
+    // the sources of the next level. The shape of the tree depends only on the number of sources and the fan-in, thus
+    // the result does not depend on the number of threads nor on the timing. The results waiting for the next level
+    // are written to temporary files if they exceed the memory limit. By default there is only one group, merged in
+    // the order of the serial merger. With a fan-in, floating point sums might differ in the last bits from that order.
+    const auto threads = std::max<size_t>(vm["threads"].as<size_t>(), 1);
+    const auto fanIn = vm["fan-in"].as<size_t>();
+    const size_t memoryLimit = vm["memory-limit"].as<size_t>() * 1024 * 1024;
+    const auto tempDirectory = vm["temp-dir"].as<std::string>().empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(vm["temp-dir"].as<std::string>());
+    if (threads > 1) {
+      ROOT::EnableThreadSafety();
+      if (fanIn <= 1) {
+        ILOG(Warning, Support) << "All the files are merged in one group, use --fan-in to merge them in parallel" << ENDM;
       }
-      if (!file->IsOpen()) {
-        handleError("Failed to open the file: " + inputFilePath);
-        continue;
-      }
-      ILOG(Debug) << "Input file '" << inputFilePath << "' successfully open." << ENDM;
+    }
+    ThreadPool threadPool(threads - 1, "QC/FileMerger"); // the main thread also takes part
 
-      std::function<void(TDirectory*, Node&, const std::vector<std::string>&)> mergeRecursively;
-      mergeRecursively = [&](TDirectory* fileNode, Node& memoryNode, const std::vector<std::string>& excludedDirectories = {}) {
-        if (fileNode == nullptr) {
-          ILOG(Error) << "Provided parentNode pointer is null, skipping." << ENDM;
+    std::vector<Source> sources;
+    sources.push_back({ outputFilePath });
+    sources.back().isOutputFile = true;
+    for (const auto& inputFilePath : inputFilePaths) {
+      sources.push_back({ inputFilePath });
+      sources.back().isInput = true;
+    }
+
+    MergerStatistics statistics;
+    std::atomic<size_t> memoryInUse{ 0 };
+    auto startTime = std::chrono::steady_clock::now();
+    for (size_t level = 0; level == 0 || sources.size() > 1; level++) {
+      const size_t groupSize = fanIn > 1 ? fanIn : sources.size();
+      const size_t nGroups = (sources.size() + groupSize - 1) / groupSize;
+      ILOG(Info, Support) << "Merging " << sources.size() << " sources in " << nGroups << " groups with " << threads << " threads" << ENDM;
+
+      std::vector<Source> results(nGroups);
+      auto mergeGroup = [&](size_t group) {
+        auto merged = std::make_unique<Node>();
+        for (size_t i = group * groupSize; i < std::min(sources.size(), (group + 1) * groupSize); i++) {
+          memoryInUse -= sources[i].sizeInMemory;
+          mergeSource(sources[i], *merged, excludedDirectories, handleError, statistics);
+        }
+        auto& result = results[group];
+        if (memoryLimit == 0 || nGroups == 1) {
+          result.node = std::move(merged);
           return;
         }
-        TIter next(fileNode->GetListOfKeys());
-        TKey* key;
-        while ((key = (TKey*)next())) {
-          // we look for exact matches here. we skip if there are no subdirectories
-          if (std::find(excludedDirectories.begin(), excludedDirectories.end(), key->GetName()) != excludedDirectories.end()) {
-            ILOG(Info, Support) << "Skipping '" << key->GetName() << "' as requested in the input arguments" << ENDM;
-            continue;
-          }
-          // we check if we have to skip any subdirectories wrt where we are
-          std::vector<std::string> excludedSubdirectories;
-          for (const auto& excludedDirectory : excludedDirectories) {
-            auto match = std::string(key->GetName()) + '/';
-            if (excludedDirectory.find(match) == 0) {
-              if (excludedDirectory.size() < match.size()) {
-                ILOG(Warning, Support) << "Invalid exclusion path '" << excludedDirectory << "'" << ENDM;
-                continue;
-              }
-              excludedSubdirectories.push_back(excludedDirectory.substr(match.size()));
-            }
-          }
-
-          ILOG(Debug, Devel) << "Getting the value for key '" << key->GetName() << "'" << ENDM;
-          auto* value = fileNode->Get(key->GetName());
-          if (value == nullptr) {
-            ILOG(Error) << "Could not get the value '" << key->GetName() << "', skipping." << ENDM;
-            continue;
-          }
-          if (auto inputMOC = dynamic_cast<MonitorObjectCollection*>(value)) {
-            inputMOC->postDeserialization();
-
-            if (memoryNode.children.count(inputMOC->GetName()) == 0) {
-              std::string mocPath = memoryNode.getFullPath() + std::filesystem::path::preferred_separator + key->GetName();
-
-              auto mergedTObj = outputFile->Get(mocPath.c_str());
-              if (mergedTObj != nullptr) {
-                auto mergedMOC = dynamic_cast<MonitorObjectCollection*>(mergedTObj);
-                if (mergedMOC == nullptr) {
-                  handleError("Could not cast the merged object to MonitorObjectCollection, skipping.");
-                  delete mergedMOC;
-                  continue;
-                }
-                mergedMOC->postDeserialization();
-                memoryNode.children[mergedMOC->GetName()] = mergedMOC;
-                ILOG(Info) << "Read merged object '" << mergedMOC->GetName() << "'" << ENDM;
-              }
-            }
-
-            if (memoryNode.children.count(inputMOC->GetName())) {
-              try {
-                std::get<MonitorObjectCollection*>(memoryNode.children[inputMOC->GetName()])->merge(inputMOC);
-              } catch (...) {
-                handleError("Failed to merge the Monitor Object Collection. Exception caught: " + boost::current_exception_diagnostic_information(true));
-              }
-              delete inputMOC;
-            } else {
-              memoryNode.children[inputMOC->GetName()] = inputMOC;
-            }
-          } else if (auto dir = dynamic_cast<TDirectory*>(value)) {
-            auto name = dir->GetName();
-            if (memoryNode.children.count(name) == 0) {
-              memoryNode.children[name] = Node{ memoryNode.getFullPath(), name };
-            }
-            mergeRecursively(dir, std::get<Node>(memoryNode.children[name]), excludedSubdirectories);
-          } else {
-            handleError("Could not cast the node to MonitorObjectCollection nor TDirectory.");
-            delete value;
-            continue;
-          }
+        result.sizeInMemory = estimateSize(*merged);
+        if (memoryInUse.fetch_add(result.sizeInMemory) + result.sizeInMemory <= memoryLimit) {
+          result.node = std::move(merged);
+          return;
+        }
+        // over the budget, the result is spilled to a temporary file and read again at the next level
+        memoryInUse -= result.sizeInMemory;
+        result.sizeInMemory = 0;
+        result.isTemporary = true;
+        result.filePath = (tempDirectory / ("qc-file-merger-" + std::to_string(getpid()) + "-" + std::to_string(level) + "-" + std::to_string(group) + ".root")).string();
+        TFile spillFile(result.filePath.c_str(), "RECREATE");
+        if (spillFile.IsZombie() || !spillFile.IsWritable()) {
+          throw std::runtime_error("Could not create the temporary file '" + result.filePath + "'");
         }
+        storeNode(&spillFile, *merged, handleError);
+        spillFile.Close();
+        statistics.filesSpilled++;
       };
-
-      mergeRecursively(file, mergedTree, excludedDirectories);
-      file->Close();
-      delete file;
-      filesRead++;
+      try {
+        threadPool.parallelFor(nGroups, mergeGroup);
+      } catch (...) {
+        // parallelFor waits for the other groups, which might have spilled their results, before rethrowing
+        removeTemporaryFiles(sources);
+        removeTemporaryFiles(results);
+        throw;
+      }
+      sources = std::move(results);
     }
 
-    std::function<void(TDirectory*, const Node&)> storeRecursively;
-    storeRecursively = [&](TDirectory* fout, const Node& memoryNode) {
-      for (const auto& [name, value] : memoryNode.children) {
-        std::visit(overloaded{
-                     [&](const Node& node) {
-                       auto* dir = fout->GetDirectory(node.name.c_str());
-                       if (dir == nullptr) {
-                         fout->mkdir(node.name.c_str());
-                       }
-                       dir = fout->GetDirectory(node.name.c_str());
-                       if (dir == nullptr) {
-                         handleError("Could not create directory '" + node.name + "' in path '" + node.pathTo + "'");
-                       } else {
-                         storeRecursively(dir, node);
-                       }
-                     },
-                     [&](const MonitorObjectCollection* moc) {
-                       fout->WriteObject(moc, moc->GetName(), "Overwrite");
-                       delete moc;
-                     } },
-                   value);
-      }
-    };
-    storeRecursively(outputFile, mergedTree);
+    // the final result is always kept in memory
+    Node mergedTree;
+    mergeSource(sources.front(), mergedTree, excludedDirectories, handleError, statistics);
+    filesRead = statistics.filesRead;
+
+    outputFile = new TFile(outputFilePath.c_str(), "UPDATE");
+    if (!outputFile->IsOpen() || !outputFile->IsWritable()) {
+      throw std::runtime_error("Failed to open the file: " + outputFilePath);
+    }
+    storeNode(outputFile, mergedTree, handleError);
     outputFile->Close();
+    delete outputFile;
+
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - startTime;
+    double megabytes = statistics.bytesRead / 1024. / 1024.;
+    ILOG(Info, Support) << "Merged " << statistics.filesRead << " files (" << megabytes << " MB) in " << duration.count()
+                        << " s: " << statistics.filesRead / duration.count() << " files/s, " << megabytes / duration.count() << " MB/s, "
+                        << statistics.filesSpilled << " intermediate results spilled to " << tempDirectory << ENDM;
 
   } catch (const bpo::error& ex) {
     ILOG(Error, Ops) << "Exception caught: " << ex.what() << ENDM;
@@ -269,6 +469,9 @@ int main(int argc, const char* argv[])
   } catch (const boost::exception& ex) {
     ILOG(Error, Ops) << "Exception caught: " << boost::current_exception_diagnostic_information(true) << ENDM;
     return 1;
+  } catch (const std::exception& ex) {
+    ILOG(Error, Ops) << "Exception caught: " << ex.what() << ENDM;
+    return 1;
   }
 
   if (filesRead > 0) {
@@ -277,4 +480,4 @@ int main(int argc, const char* argv[])
     ILOG(Info, Support) << "No files were merged." << ENDM;
   }
   return 0;
-}
\ No newline at end of file
+}
@@ -229,6 +229,69 @@ BOOST_AUTO_TEST_CASE(ccdb_provenance, *utf::depends_on("ccdb_store"))
   BOOST_CHECK_EQUAL(mo->getActivity().mProvenance, "qc_hello");
 }
 
+BOOST_AUTO_TEST_CASE(ccdb_retrieve_batch, *utf::depends_on("ccdb_store"))
+{
+  test_fixture f;
+
+  // the results are in the order of the requests, a missing object does not prevent retrieving the others
+  auto mos = f.backend->retrieveMOs({ { f.getMoFolder("short"), "short", 15000 },
+                                      { "non/existing", "object" },
+                                      { f.getMoFolder("provenance"), "provenance", -1, { 0, 0, "", "", "qc_hello" } } });
+  BOOST_REQUIRE_EQUAL(mos.size(), 3);
+  BOOST_REQUIRE_NE(mos[0], nullptr);
+  BOOST_CHECK_EQUAL(mos[0]->getName(), "short");
+  BOOST_CHECK(mos[1] == nullptr);
+  BOOST_REQUIRE_NE(mos[2], nullptr);
+  BOOST_CHECK_EQUAL(mos[2]->getName(), "provenance");
+
+  auto qos = f.backend->retrieveQOs({ { "non/existing" },
+                                      { f.getQoPath("short", "", false), 15000 } });
+  BOOST_REQUIRE_EQUAL(qos.size(), 2);
+  BOOST_CHECK(qos[0] == nullptr);
+  BOOST_REQUIRE_NE(qos[1], nullptr);
+  BOOST_CHECK_EQUAL(qos[1]->getName(), f.taskName + "/short");
+
+  BOOST_CHECK(f.backend->retrieveMOs({}).empty());
+
+  // the requests are sent concurrently only if it is enabled in the configuration
+  CcdbDatabase concurrentBackend;
+  concurrentBackend.connect({ { "host", CCDB_ENDPOINT }, { "retrievalThreads", "4" } });
+  auto concurrentMos = concurrentBackend.retrieveMOs({ { f.getMoFolder("short"), "short", 15000 },
+                                                       { "non/existing", "object" },
+                                                       { f.getMoFolder("provenance"), "provenance", -1, { 0, 0, "", "", "qc_hello" } } });
+  BOOST_REQUIRE_EQUAL(concurrentMos.size(), 3);
+  BOOST_REQUIRE_NE(concurrentMos[0], nullptr);
+  BOOST_CHECK_EQUAL(concurrentMos[0]->getName(), "short");
+  BOOST_CHECK(concurrentMos[1] == nullptr);
+  BOOST_REQUIRE_NE(concurrentMos[2], nullptr);
+  BOOST_CHECK_EQUAL(concurrentMos[2]->getName(), "provenance");
+}
+
+BOOST_AUTO_TEST_CASE(ccdb_retrieval_cache, *utf::depends_on("ccdb_store"))
+{
+  test_fixture f;
+  f.backend->setRetrievalCacheSize(100 * 1024 * 1024);
+
+  // "short" is valid from 10000 to 20000, two triggers at different times in this interval get the same object,
+  // the second one is revalidated with the ETag and not downloaded again
+  auto first = f.backend->retrieveMO(f.getMoFolder("short"), "short", 12000);
+  auto second = f.backend->retrieveMO(f.getMoFolder("short"), "short", 18000);
+  BOOST_REQUIRE_NE(first, nullptr);
+  BOOST_REQUIRE_NE(second, nullptr);
+  BOOST_CHECK_EQUAL(second->getName(), "short");
+  auto statistics = f.backend->getRetrievalCacheStatistics();
+  BOOST_CHECK_EQUAL(statistics.misses, 1);
+  BOOST_CHECK_EQUAL(statistics.hits, 1);
+  BOOST_CHECK_EQUAL(statistics.entries, 1);
+
+  // the same goes for the latest version, asked with the current time
+  f.backend->retrieveMO(f.getMoFolder("quarantine"), "quarantine", CcdbDatabase::getCurrentTimestamp());
+  f.backend->retrieveMO(f.getMoFolder("quarantine"), "quarantine", CcdbDatabase::getCurrentTimestamp() + 1);
+  statistics = f.backend->getRetrievalCacheStatistics();
+  BOOST_CHECK_EQUAL(statistics.misses, 2);
+  BOOST_CHECK_EQUAL(statistics.hits, 2);
+}
+
 unique_ptr<CcdbDatabase> backendGlobal = std::make_unique<CcdbDatabase>();
 
 void askObject(std::string objectPath)
@@ -0,0 +1,200 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCcdbListingReader.cxx
+///
+
+#include "QualityControl/CcdbListingReader.h"
+
+#include <algorithm>
+#include <utility>
+
+#define BOOST_TEST_MODULE CcdbListingReader test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::repository;
+
+namespace
+{
+const std::string listing = R"({
+  "objects": [
+    {
+      "path": "qc/TST/MO/Task/obj",
+      "createTime": 1600000002000,
+      "Valid-From": 1600000000000,
+      "Valid-Until": 1600000100000,
+      "RunNumber": "123",
+      "replicas": [ "alien:///alice/data/1", { "Valid-From": 42 } ],
+      "nested": { "path": "should not be read" },
+      "qc_quality": 3,
+      "Partial": false,
+      "Empty": null
+    },
+    {
+      "path": "qc/TST/MO/Task/obj2",
+      "Valid-From": 1599999999000
+    }
+  ],
+  "subfolders": [ "qc/TST/MO/Task/sub" ],
+  "path": "not an object"
+})";
+}
+
+BOOST_AUTO_TEST_CASE(test_read_keys)
+{
+  CcdbListingReader reader({ "Valid-From", "path", "qc_quality", "RunNumber", "Partial", "missing" });
+  std::vector<CcdbListingReader::Entry> entries;
+  size_t count = reader.read(listing, [&](const CcdbListingReader::Entry& entry) {
+    entries.push_back(entry);
+    return true;
+  });
+
+  BOOST_REQUIRE_EQUAL(count, 2);
+  BOOST_REQUIRE_EQUAL(entries.size(), 2);
+  BOOST_CHECK_EQUAL(entries[0][0], "1600000000000");
+  BOOST_CHECK_EQUAL(entries[0][1], "qc/TST/MO/Task/obj");
+  BOOST_CHECK_EQUAL(entries[0][2], "3");
+  BOOST_CHECK_EQUAL(entries[0][3], "123");
+  BOOST_CHECK_EQUAL(entries[0][4], "false");
+  BOOST_CHECK_EQUAL(entries[0][5], "");
+  BOOST_CHECK_EQUAL(entries[1][0], "1599999999000");
+  BOOST_CHECK_EQUAL(entries[1][1], "qc/TST/MO/Task/obj2");
+  BOOST_CHECK_EQUAL(entries[1][2], "");
+
+  auto metadata = reader.asMetadata(entries[1]);
+  BOOST_CHECK_EQUAL(metadata.size(), 2);
+  BOOST_CHECK_EQUAL(metadata.at("path"), "qc/TST/MO/Task/obj2");
+  BOOST_CHECK(metadata.count("qc_quality") == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_stop_early)
+{
+  CcdbListingReader reader({ "path" });
+  std::vector<std::string> paths;
+  size_t count = reader.read(listing, [&](const CcdbListingReader::Entry& entry) {
+    paths.push_back(entry[0]);
+    return false;
+  });
+  BOOST_CHECK_EQUAL(count, 1);
+  BOOST_REQUIRE_EQUAL(paths.size(), 1);
+  BOOST_CHECK_EQUAL(paths[0], "qc/TST/MO/Task/obj");
+}
+
+BOOST_AUTO_TEST_CASE(test_empty_and_invalid)
+{
+  CcdbListingReader reader({ "path" });
+  auto fail = [](const CcdbListingReader::Entry&) {
+    BOOST_FAIL("no entry expected");
+    return true;
+  };
+  BOOST_CHECK_EQUAL(reader.read(R"({"objects":[],"subfolders":[]})", fail), 0);
+  BOOST_CHECK_EQUAL(reader.read(R"({"subfolders":[]})", fail), 0);
+  BOOST_CHECK_THROW(reader.read(R"({"objects":[{"path":)", fail), std::runtime_error);
+  BOOST_CHECK_THROW(reader.read("", fail), std::runtime_error);
+}
+
+namespace
+{
+/// Serves the listing of objects created at the given times, the newest first, and records the requested windows.
+struct FakeRepository {
+  std::vector<long> creationTimes;
+  std::vector<std::pair<long, long>> requests;
+
+  std::string getListing(long createdNotBefore, long createdNotAfter)
+  {
+    requests.emplace_back(createdNotBefore, createdNotAfter);
+    std::string listing = R"({"objects":[)";
+    bool first = true;
+    for (auto it = creationTimes.rbegin(); it != creationTimes.rend(); ++it) {
+      if ((createdNotBefore < 0 || *it >= createdNotBefore) && (createdNotAfter < 0 || *it <= createdNotAfter)) {
+        listing += std::string(first ? "" : ",") + R"({"createTime":)" + std::to_string(*it) + "}";
+        first = false;
+      }
+    }
+    return listing + "]}";
+  }
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_read_in_windows)
+{
+  CcdbListingReader reader({ "createTime" });
+  FakeRepository repository;
+  for (long time = 1000; time <= 100000; time += 1000) {
+    repository.creationTimes.push_back(time);
+  }
+  auto getListing = [&](long createdNotBefore, long createdNotAfter) { return repository.getListing(createdNotBefore, createdNotAfter); };
+
+  // all the objects, in the same order as a single listing, each of them once
+  std::vector<long> times;
+  auto collect = [&](const CcdbListingReader::Entry& entry) {
+    times.push_back(std::stol(entry[0]));
+    return true;
+  };
+  size_t count = reader.readInWindows(getListing, collect, 5000, -1, 10000, 100000);
+  BOOST_CHECK_EQUAL(count, 96);
+  BOOST_REQUIRE_EQUAL(times.size(), 96);
+  BOOST_CHECK_EQUAL(times.front(), 100000);
+  BOOST_CHECK_EQUAL(times.back(), 5000);
+  BOOST_CHECK(std::is_sorted(times.rbegin(), times.rend()));
+  BOOST_CHECK(std::adjacent_find(times.begin(), times.end()) == times.end());
+  BOOST_REQUIRE_GT(repository.requests.size(), 1);
+  // the newest window is not bounded, the next ones follow each other and stop at createdNotBefore
+  BOOST_CHECK_EQUAL(repository.requests.front().first, 90001);
+  BOOST_CHECK_EQUAL(repository.requests.front().second, -1);
+  for (size_t i = 1; i < repository.requests.size(); i++) {
+    BOOST_CHECK_EQUAL(repository.requests[i].second, repository.requests[i - 1].first - 1);
+  }
+  BOOST_CHECK_EQUAL(repository.requests.back().first, 5000);
+
+  // no more windows are requested once the callback stopped
+  repository.requests.clear();
+  times.clear();
+  count = reader.readInWindows(
+    getListing, [&](const CcdbListingReader::Entry& entry) {
+      times.push_back(std::stol(entry[0]));
+      return times.size() < 15;
+    },
+    -1, 100000, 10000, 200000);
+  BOOST_CHECK_EQUAL(count, 15);
+  BOOST_CHECK_EQUAL(times.back(), 86000);
+  BOOST_CHECK_EQUAL(repository.requests.size(), 2);
+  BOOST_CHECK_EQUAL(repository.requests.front().second, 100000);
+
+  // without a window, the listing is requested at once
+  repository.requests.clear();
+  BOOST_CHECK_EQUAL(reader.readInWindows(getListing, collect, -1, -1, 0, 100000), 100);
+  BOOST_REQUIRE_EQUAL(repository.requests.size(), 1);
+  BOOST_CHECK_EQUAL(repository.requests.front().first, -1);
+}
+
+BOOST_AUTO_TEST_CASE(test_read_in_windows_goes_back_to_epoch)
+{
+  CcdbListingReader reader({ "createTime" });
+  FakeRepository repository;
+  repository.creationTimes = { 10, 1000000000 };
+  auto getListing = [&](long createdNotBefore, long createdNotAfter) { return repository.getListing(createdNotBefore, createdNotAfter); };
+  std::vector<long> times;
+  size_t count = reader.readInWindows(
+    getListing, [&](const CcdbListingReader::Entry& entry) {
+      times.push_back(std::stol(entry[0]));
+      return true;
+    },
+    -1, -1, 1000, 1000000000);
+  BOOST_CHECK_EQUAL(count, 2);
+  BOOST_CHECK_EQUAL(repository.requests.back().first, 0);
+  // the windows grow over the empty parts of the history
+  BOOST_CHECK_LT(repository.requests.size(), 25);
+}
@@ -161,4 +161,29 @@ BOOST_AUTO_TEST_CASE(test_check_activity)
   BOOST_REQUIRE_EQUAL(qos.size(), 1);
   ValidityInterval correctValidity{ 1, 15 };
   BOOST_CHECK(qos[0]->getActivity().mValidity == correctValidity);
-}
\ No newline at end of file
+}
+BOOST_AUTO_TEST_CASE(test_check_prepare_and_evaluate)
+{
+  std::string configFilePath = std::string("json://") + getTestDataDirectory() + "testSharedConfig.json";
+
+  Check check(getCheckConfig(configFilePath, "singleCheck"));
+  check.init();
+  check.setActivity(std::make_shared<Activity>());
+
+  std::map<std::string, std::shared_ptr<MonitorObject>> moMap{
+    { "skeletonTask/example", dummyMO("example") },
+    { "skeletonTask/notSubscribed", dummyMO("notSubscribed") }
+  };
+
+  auto inputs = check.prepareInputs(moMap);
+  BOOST_REQUIRE_EQUAL(inputs.size(), 1);
+  BOOST_CHECK_EQUAL(inputs[0].size(), 1);
+  BOOST_CHECK(inputs[0].count("skeletonTask/example") == 1);
+
+  auto qo = check.evaluate(inputs[0]);
+  BOOST_REQUIRE(qo != nullptr);
+  auto qos = check.check(moMap);
+  BOOST_REQUIRE_EQUAL(qos.size(), 1);
+  BOOST_CHECK_EQUAL(qo->getQuality(), qos[0]->getQuality());
+  BOOST_CHECK_EQUAL(qo->getPath(), qos[0]->getPath());
+}
@@ -0,0 +1,191 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testFileMerger.cxx
+///
+
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/MonitorObjectCollection.h"
+
+#include <TFile.h>
+#include <TH1F.h>
+#include <TH2F.h>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#define BOOST_TEST_MODULE FileMerger test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::core;
+
+namespace
+{
+
+const size_t nInputFiles = 10;
+
+/// A temporary directory for the files of a test case, removed with its content at the end.
+struct TestDirectory {
+  std::filesystem::path path;
+
+  explicit TestDirectory(const std::string& name)
+    : path(std::filesystem::temp_directory_path() / ("testFileMerger_" + name + "_" + std::to_string(getpid())))
+  {
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path / "spill");
+  }
+  ~TestDirectory() { std::filesystem::remove_all(path); }
+};
+
+MonitorObject* makeMO(TH1* histogram)
+{
+  histogram->SetDirectory(nullptr);
+  auto mo = new MonitorObject(histogram, "task", "class", "TST");
+  mo->setIsOwner(true);
+  return mo;
+}
+
+/// Each file has different contents, so that a change of the merging order could be noticed.
+/// The big histogram takes about 640 kB in memory, so that a memory limit of 1 MB makes the merger spill results.
+std::vector<std::string> writeInputFiles(const std::filesystem::path& directory)
+{
+  std::vector<std::string> paths;
+  for (size_t i = 0; i < nInputFiles; i++) {
+    auto small = new TH1F("small", "small", 100, 0, 100);
+    auto big = new TH2F("big", "big", 400, 0, 400, 400, 0, 400);
+    for (size_t entry = 0; entry < 100 * (i + 1); entry++) {
+      small->Fill((entry * 7 + i) % 100 + 0.5);
+      big->Fill((entry * 13 + i) % 400 + 0.5, (entry * 3) % 400 + 0.5);
+    }
+    MonitorObjectCollection collection;
+    collection.SetOwner(true);
+    collection.SetName("task");
+    collection.Add(makeMO(small));
+    collection.Add(makeMO(big));
+
+    paths.push_back((directory / ("input" + std::to_string(i) + ".root")).string());
+    TFile file(paths.back().c_str(), "RECREATE");
+    file.mkdir("TST")->WriteObject(&collection, collection.GetName(), "Overwrite");
+    file.Close();
+  }
+  return paths;
+}
+
+/// Runs the merger on the input files and returns its exit code.
+int runMerger(const std::vector<std::string>& inputFiles, const std::string& outputFile, const std::string& arguments)
+{
+  std::string command = std::string(O2_QC_FILE_MERGER) + " --output-file " + outputFile + " " + arguments + " --input-files";
+  for (const auto& inputFile : inputFiles) {
+    command += " " + inputFile;
+  }
+  BOOST_TEST_MESSAGE("Running: " << command);
+  return std::system(command.c_str());
+}
+
+std::map<std::string, std::unique_ptr<TH1>> readHistograms(const std::string& filePath)
+{
+  std::map<std::string, std::unique_ptr<TH1>> histograms;
+  TFile file(filePath.c_str(), "READ");
+  BOOST_REQUIRE(!file.IsZombie());
+  std::unique_ptr<MonitorObjectCollection> collection(file.Get<MonitorObjectCollection>("TST/task"));
+  BOOST_REQUIRE(collection != nullptr);
+  collection->postDeserialization();
+  for (const auto* object : *collection) {
+    auto mo = dynamic_cast<const MonitorObject*>(object);
+    BOOST_REQUIRE(mo != nullptr);
+    auto histogram = dynamic_cast<TH1*>(mo->getObject()->Clone());
+    BOOST_REQUIRE(histogram != nullptr);
+    histogram->SetDirectory(nullptr);
+    histograms[mo->GetName()].reset(histogram);
+  }
+  return histograms;
+}
+
+/// The histograms are filled with unit weights at the bin centres, thus all the sums are exact whatever the order.
+void checkSameHistograms(const std::string& filePath, const std::string& expectedFilePath)
+{
+  auto histograms = readHistograms(filePath);
+  auto expectedHistograms = readHistograms(expectedFilePath);
+  BOOST_REQUIRE_EQUAL(histograms.size(), expectedHistograms.size());
+  for (const auto& [name, expected] : expectedHistograms) {
+    BOOST_TEST_CONTEXT("histogram " << name)
+    {
+      BOOST_REQUIRE(histograms.count(name));
+      const auto& histogram = histograms.at(name);
+      BOOST_CHECK_EQUAL(histogram->GetEntries(), expected->GetEntries());
+      BOOST_REQUIRE_EQUAL(histogram->GetNcells(), expected->GetNcells());
+      for (int bin = 0; bin < expected->GetNcells(); bin++) {
+        BOOST_REQUIRE_EQUAL(histogram->GetBinContent(bin), expected->GetBinContent(bin));
+      }
+      double stats[TH1::kNstat] = {};
+      double expectedStats[TH1::kNstat] = {};
+      histogram->GetStats(stats);
+      expected->GetStats(expectedStats);
+      for (int i = 0; i < TH1::kNstat; i++) {
+        BOOST_CHECK_EQUAL(stats[i], expectedStats[i]);
+      }
+    }
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(same_result_as_serial)
+{
+  TestDirectory directory("same_result");
+  auto inputFiles = writeInputFiles(directory.path);
+  auto outputFile = [&](const std::string& name) { return (directory.path / (name + ".root")).string(); };
+
+  BOOST_REQUIRE_EQUAL(runMerger(inputFiles, outputFile("serial"), "--fan-in 0"), 0);
+  auto serial = readHistograms(outputFile("serial"));
+  BOOST_REQUIRE_EQUAL(serial.size(), 2);
+  BOOST_CHECK_EQUAL(serial.at("small")->GetEntries(), 100 * nInputFiles * (nInputFiles + 1) / 2);
+
+  const std::vector<std::pair<std::string, std::string>> configurations{
+    { "default_1_thread", "--threads 1" },
+    { "default_4_threads", "--threads 4" },
+    { "fan_in_3_1_thread", "--threads 1 --fan-in 3" },
+    { "fan_in_3_4_threads", "--threads 4 --fan-in 3" },
+    { "fan_in_2_4_threads_spilled", "--threads 4 --fan-in 2 --memory-limit 1 --temp-dir " + (directory.path / "spill").string() },
+  };
+  for (const auto& [name, arguments] : configurations) {
+    BOOST_TEST_CONTEXT(name)
+    {
+      BOOST_REQUIRE_EQUAL(runMerger(inputFiles, outputFile(name), arguments), 0);
+      checkSameHistograms(outputFile(name), outputFile("serial"));
+    }
+  }
+  // the spilled results were read and removed
+  BOOST_CHECK(std::filesystem::is_empty(directory.path / "spill"));
+}
+
+BOOST_AUTO_TEST_CASE(exit_on_error_removes_temporary_files)
+{
+  TestDirectory directory("exit_on_error");
+  auto inputFiles = writeInputFiles(directory.path);
+  auto corruptedFile = (directory.path / "corrupted.root").string();
+  std::ofstream(corruptedFile) << "this is not a ROOT file";
+  inputFiles.push_back(corruptedFile);
+
+  auto arguments = "--exit-on-error --threads 4 --fan-in 2 --memory-limit 1 --temp-dir " + (directory.path / "spill").string();
+  BOOST_CHECK_NE(runMerger(inputFiles, (directory.path / "merged.root").string(), arguments), 0);
+  // the other groups might have spilled their results before the error, they are removed as well
+  BOOST_CHECK(std::filesystem::is_empty(directory.path / "spill"));
+}
@@ -0,0 +1,114 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testMonitorObjectCollection.cxx
+///
+
+#include "QualityControl/MonitorObjectCollection.h"
+#include "QualityControl/MonitorObject.h"
+
+#define BOOST_TEST_MODULE MonitorObjectCollection test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <TH1F.h>
+
+using namespace o2::quality_control::core;
+
+namespace
+{
+
+MonitorObject* makeMO(const std::string& name, int entries)
+{
+  auto histogram = new TH1F(name.c_str(), name.c_str(), 10, 0, 10);
+  histogram->SetDirectory(nullptr);
+  for (int i = 0; i < entries; i++) {
+    histogram->Fill(i % 10);
+  }
+  auto mo = new MonitorObject(histogram, "task", "class", "TST");
+  mo->setIsOwner(true);
+  return mo;
+}
+
+std::unique_ptr<MonitorObjectCollection> makeCollection(size_t firstObject, size_t nObjects, int entries)
+{
+  auto collection = std::make_unique<MonitorObjectCollection>();
+  collection->SetOwner(true);
+  for (size_t i = firstObject; i < firstObject + nObjects; i++) {
+    collection->Add(makeMO("histogram" + std::to_string(i), entries));
+  }
+  return collection;
+}
+
+double getEntries(MonitorObjectCollection& collection, const char* name)
+{
+  auto mo = dynamic_cast<MonitorObject*>(collection.FindObject(name));
+  BOOST_REQUIRE(mo != nullptr);
+  return dynamic_cast<TH1*>(mo->getObject())->GetEntries();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(merge_by_name)
+{
+  auto target = makeCollection(0, 3, 1);
+  auto other = makeCollection(1, 3, 2); // histogram1 and histogram2 are in both collections
+
+  target->merge(other.get());
+  BOOST_REQUIRE_EQUAL(target->GetEntries(), 4);
+  BOOST_CHECK_EQUAL(getEntries(*target, "histogram0"), 1);
+  BOOST_CHECK_EQUAL(getEntries(*target, "histogram1"), 3);
+  BOOST_CHECK_EQUAL(getEntries(*target, "histogram2"), 3);
+  BOOST_CHECK_EQUAL(getEntries(*target, "histogram3"), 2);
+
+  // the object added by the previous merge is found by the next one
+  target->merge(other.get());
+  BOOST_REQUIRE_EQUAL(target->GetEntries(), 4);
+  BOOST_CHECK_EQUAL(getEntries(*target, "histogram3"), 4);
+
+  // an object is removed and the next ones are moved, the positions in the index are not valid anymore
+  delete target->RemoveAt(1);
+  target->Compress();
+  auto another = makeCollection(0, 2, 1);
+  target->merge(another.get());
+  BOOST_REQUIRE_EQUAL(target->GetEntries(), 4);
+  BOOST_CHECK_EQUAL(getEntries(*target, "histogram0"), 2);
+  BOOST_CHECK_EQUAL(getEntries(*target, "histogram1"), 1);
+  BOOST_CHECK_EQUAL(getEntries(*target, "histogram3"), 4);
+
+  // the index does not survive the serialization, it is rebuilt
+  std::unique_ptr<MonitorObjectCollection> copy(dynamic_cast<MonitorObjectCollection*>(target->Clone()));
+  copy->postDeserialization();
+  copy->merge(another.get());
+  BOOST_REQUIRE_EQUAL(copy->GetEntries(), 4);
+  BOOST_CHECK_EQUAL(getEntries(*copy, "histogram1"), 2);
+}
+
+BOOST_AUTO_TEST_CASE(merge_benchmark)
+{
+  // A Merger receiving collections of a growing number of MOs, half of which are already in the target.
+  // The time per MO should stay the same, the name lookups do not depend on the size of the collection anymore.
+  for (size_t nObjects : { 1000, 2000, 4000, 8000 }) {
+    auto target = makeCollection(0, nObjects, 1);
+    auto other = makeCollection(nObjects / 2, nObjects, 1);
+    auto start = std::chrono::steady_clock::now();
+    target->merge(other.get());
+    std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now() - start;
+    BOOST_CHECK_EQUAL(target->GetEntries(), nObjects * 3 / 2);
+    BOOST_TEST_MESSAGE("Merging " << nObjects << " MOs: " << duration.count() / 1000 << " ms, "
+                                  << duration.count() / nObjects << " us per MO");
+  }
+}
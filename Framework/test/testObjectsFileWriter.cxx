@@ -0,0 +1,142 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testObjectsFileWriter.cxx
+///
+
+#include "QualityControl/ObjectsFileWriter.h"
+
+#include <TFile.h>
+#include <TH1F.h>
+#include <TNamed.h>
+#include <filesystem>
+#include <memory>
+#include <unistd.h>
+
+#define BOOST_TEST_MODULE ObjectsFileWriter test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::core;
+
+namespace
+{
+
+std::string makeFilePath()
+{
+  auto path = std::filesystem::temp_directory_path() / ("testObjectsFileWriter_" + std::to_string(getpid()) + ".root");
+  std::filesystem::remove(path);
+  return path.string();
+}
+
+double getEntries(const std::string& filePath, const char* name)
+{
+  TFile file(filePath.c_str(), "READ");
+  BOOST_REQUIRE(!file.IsZombie());
+  std::unique_ptr<TH1> histogram(file.Get<TH1>(name));
+  BOOST_REQUIRE(histogram != nullptr);
+  histogram->SetDirectory(nullptr);
+  return histogram->GetEntries();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(write_and_skip)
+{
+  auto filePath = makeFilePath();
+  TH1F histogram("histogram", "histogram", 10, 0, 10);
+  histogram.SetDirectory(nullptr);
+  TNamed named("named", "first title");
+  std::vector<const TObject*> objects{ &histogram, &named };
+
+  {
+    ObjectsFileWriter writer(filePath, true);
+    histogram.Fill(1);
+    BOOST_CHECK(writer.save(objects));
+    auto bytesSerializedFirst = writer.getStats().bytesSerialized;
+    // the objects can be modified as soon as save() returns, the snapshot is written
+    histogram.Fill(2);
+    writer.flush();
+    BOOST_CHECK_EQUAL(getEntries(filePath, "histogram"), 1);
+    BOOST_CHECK(!std::filesystem::exists(filePath + ".tmp"));
+
+    BOOST_CHECK(writer.save(objects)); // the histogram was filled after the first save
+    writer.flush();
+    // nothing changed since the previous save, the file is not written again
+    BOOST_CHECK(!writer.save(objects));
+    auto stats = writer.getStats();
+    BOOST_CHECK_EQUAL(stats.written, 2);
+    BOOST_CHECK_EQUAL(stats.skipped, 1);
+    BOOST_CHECK_EQUAL(stats.failed, 0);
+    BOOST_CHECK_GT(stats.bytesWritten, 0);
+    BOOST_CHECK_GT(stats.bytesSerialized, 0);
+    BOOST_CHECK_LT(stats.bytesSerialized, bytesSerializedFirst); // the unchanged histogram is not serialized again
+    BOOST_CHECK_EQUAL(getEntries(filePath, "histogram"), 2);
+
+    // objects which are not histograms are compared once serialized
+    named.SetTitle("second title");
+    BOOST_CHECK(writer.save(objects));
+    // the pending snapshot is written when the writer is destroyed
+  }
+  TFile file(filePath.c_str(), "READ");
+  std::unique_ptr<TNamed> stored(file.Get<TNamed>("named"));
+  BOOST_REQUIRE(stored != nullptr);
+  BOOST_CHECK_EQUAL(std::string(stored->GetTitle()), "second title");
+  file.Close();
+  std::filesystem::remove(filePath);
+}
+
+BOOST_AUTO_TEST_CASE(title_change)
+{
+  // By default the histograms are compared once serialized, a change which does not affect the statistics is written.
+  auto filePath = makeFilePath();
+  TH1F histogram("histogram", "first title", 10, 0, 10);
+  histogram.SetDirectory(nullptr);
+  histogram.Fill(1);
+  std::vector<const TObject*> objects{ &histogram };
+
+  ObjectsFileWriter writer(filePath);
+  BOOST_CHECK(writer.save(objects));
+  BOOST_CHECK(!writer.save(objects));
+  histogram.SetTitle("second title");
+  BOOST_CHECK(writer.save(objects));
+  writer.flush();
+  {
+    TFile file(filePath.c_str(), "READ");
+    std::unique_ptr<TH1> stored(file.Get<TH1>("histogram"));
+    BOOST_REQUIRE(stored != nullptr);
+    stored->SetDirectory(nullptr);
+    BOOST_CHECK_EQUAL(std::string(stored->GetTitle()), "second title");
+  }
+  std::filesystem::remove(filePath);
+}
+
+BOOST_AUTO_TEST_CASE(coalesce)
+{
+  auto filePath = makeFilePath();
+  TH1F histogram("histogram", "histogram", 10, 0, 10);
+  histogram.SetDirectory(nullptr);
+  std::vector<const TObject*> objects{ &histogram };
+
+  ObjectsFileWriter writer(filePath);
+  for (int i = 0; i < 100; i++) {
+    histogram.Fill(i % 10);
+    BOOST_CHECK(writer.save(objects));
+  }
+  writer.flush();
+  auto stats = writer.getStats();
+  BOOST_CHECK_EQUAL(stats.written + stats.coalesced, 100);
+  BOOST_CHECK_EQUAL(getEntries(filePath, "histogram"), 100); // the last snapshot is always written
+  std::filesystem::remove(filePath);
+}
@@ -15,6 +15,7 @@
 ///
 
 #include "QualityControl/ObjectsManager.h"
+#include "QualityControl/ShardedHistogram.h"
 
 #define BOOST_TEST_MODULE ObjectManager test
 #define BOOST_TEST_MAIN
@@ -23,6 +24,7 @@
 #include <TObjArray.h>
 #include <TH1F.h>
 #include <boost/test/unit_test.hpp>
+#include <chrono>
 
 using namespace std;
 using namespace o2::quality_control::core;
@@ -88,6 +90,28 @@ BOOST_AUTO_TEST_CASE(unpublish_test)
   BOOST_CHECK_THROW(objectsManager.stopPublishing("asdf"), ObjectNotFoundError);
 }
 
+BOOST_AUTO_TEST_CASE(sharded_histogram_test)
+{
+  Config config;
+  ObjectsManager objectsManager(config.taskName, config.taskClass, config.detectorName, config.consulUrl, 0, true);
+  TH1F histogram("histogram", "histogram", 10, 0, 10);
+  ShardedHistogram<TH1F> sharded(&histogram, 2);
+  objectsManager.startPublishing(&sharded);
+  BOOST_CHECK(objectsManager.isBeingPublished("histogram"));
+  BOOST_CHECK_THROW(objectsManager.startPublishing(&sharded), DuplicateObjectError);
+
+  sharded.shard(0).fill(1);
+  sharded.shard(1).fill(2);
+  objectsManager.mergeShardedHistograms();
+  BOOST_CHECK_EQUAL(histogram.GetEntries(), 2);
+
+  // the shards are not merged anymore once the histogram is not published
+  objectsManager.stopPublishing("histogram");
+  sharded.shard(0).fill(1);
+  objectsManager.mergeShardedHistograms();
+  BOOST_CHECK_EQUAL(histogram.GetEntries(), 2);
+}
+
 BOOST_AUTO_TEST_CASE(getters_test)
 {
   Config config;
@@ -157,4 +181,143 @@ BOOST_AUTO_TEST_CASE(drawOptions_test)
   BOOST_CHECK_EQUAL(objectsManager.getMonitorObject("histo")->getMetadataMap().at(ObjectsManager::gDisplayHintsKey), "gridy logy");
 }
 
+BOOST_AUTO_TEST_CASE(changed_objects_test)
+{
+  Config config;
+  ObjectsManager objectsManager(config.taskName, config.taskClass, config.detectorName, config.consulUrl, 0, true);
+  TH1F h1("histo1", "histo1", 10, 0, 10);
+  TH1F h2("histo2", "histo2", 10, 0, 10);
+  TObjString s("content");
+  objectsManager.startPublishing(&h1);
+  objectsManager.startPublishing(&h2);
+  objectsManager.startPublishing(&s);
+
+  // everything is new
+  unique_ptr<MonitorObjectCollection> array(objectsManager.getNonOwningArrayOfChangedObjects());
+  BOOST_CHECK_EQUAL(array->GetEntries(), 3);
+  BOOST_CHECK_GT(objectsManager.estimateSerializedSize(*array), 0);
+
+  // only the object which is not a histogram, we cannot tell if it changed
+  array.reset(objectsManager.getNonOwningArrayOfChangedObjects());
+  BOOST_REQUIRE_EQUAL(array->GetEntries(), 1);
+  BOOST_CHECK(array->FindObject("content") != nullptr);
+
+  h1.Fill(1);
+  objectsManager.setDisplayHint(&h2, "logy");
+  array.reset(objectsManager.getNonOwningArrayOfChangedObjects());
+  BOOST_CHECK_EQUAL(array->GetEntries(), 3);
+  BOOST_CHECK(!array->IsOwner());
+
+  // a reset is a change as well
+  h1.Reset();
+  array.reset(objectsManager.getNonOwningArrayOfChangedObjects());
+  BOOST_CHECK_EQUAL(array->GetEntries(), 2);
+  BOOST_CHECK(array->FindObject("histo1") != nullptr);
+
+  // a new activity requires sending everything again
+  objectsManager.setActivity(Activity{});
+  array.reset(objectsManager.getNonOwningArrayOfChangedObjects());
+  BOOST_CHECK_EQUAL(array->GetEntries(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(changed_objects_deltas_test)
+{
+  Config config;
+  ObjectsManager objectsManager(config.taskName, config.taskClass, config.detectorName, config.consulUrl, 0, true);
+  TH1F h1("histo1", "histo1", 10, 0, 10);
+  TH1F h2("histo2", "histo2", 10, 0, 10);
+  objectsManager.startPublishing(&h1);
+  objectsManager.startPublishing(&h2);
+
+  // everything is new
+  unique_ptr<MonitorObjectCollection> array(objectsManager.getNonOwningArrayOfChangedObjects(true));
+  BOOST_CHECK_EQUAL(array->GetEntries(), 2);
+
+  // two identical consecutive deltas, the second one must be sent as well so that the receivers add it
+  for (int cycle = 0; cycle < 2; cycle++) {
+    h1.Reset();
+    h2.Reset();
+    h1.Fill(1);
+    h1.Fill(2);
+    array.reset(objectsManager.getNonOwningArrayOfChangedObjects(true));
+    BOOST_REQUIRE_EQUAL(array->GetEntries(), 1);
+    BOOST_CHECK(array->FindObject("histo1") != nullptr);
+  }
+
+  // nothing was added after the reset
+  h1.Reset();
+  array.reset(objectsManager.getNonOwningArrayOfChangedObjects(true));
+  BOOST_CHECK_EQUAL(array->GetEntries(), 0);
+
+  // without deltas, the same content is not sent again
+  h1.Fill(1);
+  array.reset(objectsManager.getNonOwningArrayOfChangedObjects());
+  BOOST_CHECK_EQUAL(array->GetEntries(), 1);
+  h1.Reset();
+  h1.Fill(1);
+  array.reset(objectsManager.getNonOwningArrayOfChangedObjects());
+  BOOST_CHECK_EQUAL(array->GetEntries(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(stable_indices_test)
+{
+  Config config;
+  ObjectsManager objectsManager(config.taskName, config.taskClass, config.detectorName, config.consulUrl, 0, true);
+  TObjString a("a"), b("b"), c("c");
+  objectsManager.startPublishing(&a);
+  objectsManager.startPublishing(&b);
+  objectsManager.startPublishing(&c);
+
+  objectsManager.stopPublishing("b");
+  BOOST_CHECK(!objectsManager.isBeingPublished("b"));
+  BOOST_CHECK_EQUAL(objectsManager.getMonitorObject("a")->getObject(), &a);
+  BOOST_CHECK_EQUAL(objectsManager.getMonitorObject("c")->getObject(), &c);
+  BOOST_CHECK_EQUAL(objectsManager.getMonitorObject(2)->getObject(), &c);
+
+  objectsManager.startPublishing(&b);
+  BOOST_CHECK_EQUAL(objectsManager.getMonitorObject("b")->getObject(), &b);
+  BOOST_CHECK_THROW(objectsManager.startPublishing(&b), DuplicateObjectError);
+
+  // renaming a published object is not recommended, but it should not break the lookups of the old name
+  a.SetString("renamed");
+  BOOST_CHECK(!objectsManager.isBeingPublished("a"));
+  BOOST_CHECK_EQUAL(objectsManager.getMonitorObject("c")->getObject(), &c);
+}
+
+BOOST_AUTO_TEST_CASE(lookup_benchmark_test)
+{
+  // Not a strict performance test, it rather shows the cost of a lookup with many objects.
+  Config config;
+  ObjectsManager objectsManager(config.taskName, config.taskClass, config.detectorName, config.consulUrl, 0, true);
+  const size_t nObjects = 10000;
+  std::vector<std::unique_ptr<TObjString>> objects;
+  objects.reserve(nObjects);
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < nObjects; i++) {
+    objects.emplace_back(std::make_unique<TObjString>(("object" + std::to_string(i)).c_str()));
+    objectsManager.startPublishing(objects.back().get());
+  }
+  auto published = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < nObjects; i++) {
+    objectsManager.setDisplayHint(objects[i].get(), "logy");
+  }
+  auto lookedUp = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < nObjects; i += 2) {
+    objectsManager.stopPublishing(objects[i].get());
+  }
+  auto stopped = std::chrono::steady_clock::now();
+
+  auto perObject = [](auto duration) { return std::chrono::duration<double, std::nano>(duration).count() / nObjects; };
+  BOOST_TEST_MESSAGE("ObjectsManager with " << nObjects << " objects, per object: startPublishing " << perObject(published - start)
+                                            << " ns, lookup " << perObject(lookedUp - published)
+                                            << " ns, stopPublishing (half of them) " << perObject(stopped - lookedUp) << " ns");
+
+  for (size_t i = 0; i < nObjects; i++) {
+    BOOST_REQUIRE_EQUAL(objectsManager.isBeingPublished(objects[i]->GetName()), i % 2 == 1);
+  }
+  // with a linear scan the whole test would take seconds, we leave a lot of margin for slow machines
+  BOOST_CHECK(stopped - start < std::chrono::seconds(5));
+}
+
 } // namespace o2::quality_control::core
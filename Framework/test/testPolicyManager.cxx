@@ -24,6 +24,9 @@
 #define BOOST_TEST_DYN_LINK
 
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <chrono>
+#include <random>
 
 using namespace o2::quality_control::checker;
 using namespace std;
@@ -361,3 +364,257 @@ BOOST_AUTO_TEST_CASE(test_errors)
   BOOST_CHECK_EQUAL(updatePolicyManager.isReady("actor2"), false);
   updatePolicyManager.updateGlobalRevision();
 }
+
+BOOST_AUTO_TEST_CASE(test_object_ids)
+{
+  UpdatePolicyManager updatePolicyManager;
+  updatePolicyManager.addPolicy("actor1", UpdatePolicyType::OnAll, { "object1", "object2" }, false, false);
+
+  auto id1 = updatePolicyManager.getObjectId("object1");
+  auto id2 = updatePolicyManager.getObjectId("object2");
+  auto id3 = updatePolicyManager.getObjectId("object3");
+  BOOST_CHECK_NE(id1, id2);
+  BOOST_CHECK_EQUAL(id3, 2);
+  BOOST_CHECK_EQUAL(updatePolicyManager.getObjectId("object1"), id1);
+
+  // updating by ID or by name is equivalent
+  updatePolicyManager.updateObjectRevision(id1);
+  BOOST_CHECK_EQUAL(updatePolicyManager.isReady("actor1"), false);
+  updatePolicyManager.updateObjectRevision("object2");
+  BOOST_CHECK_EQUAL(updatePolicyManager.isReady("actor1"), true);
+
+  updatePolicyManager.reset();
+  BOOST_CHECK_EQUAL(updatePolicyManager.getObjectId("object3"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_object_ids_benchmark)
+{
+  // 10k MOs received in each cycle, checked by 100 checks of 100 MOs each. The revisions are updated once by name,
+  // as the CheckRunner used to do, and once with the IDs obtained when the MOs are first received.
+  constexpr size_t nObjects = 10000;
+  constexpr size_t nActors = 100;
+  constexpr size_t nCycles = 20;
+  std::vector<std::string> objectNames;
+  for (size_t i = 0; i < nObjects; i++) {
+    objectNames.push_back("qc/TST/MO/BenchmarkTask/Histograms/histogram" + std::to_string(i));
+  }
+
+  auto run = [&](bool withIds) {
+    UpdatePolicyManager updatePolicyManager;
+    for (size_t a = 0; a < nActors; a++) {
+      std::vector<std::string> inputs(objectNames.begin() + a * nObjects / nActors, objectNames.begin() + (a + 1) * nObjects / nActors);
+      updatePolicyManager.addPolicy("actor" + std::to_string(a), UpdatePolicyType::OnAll, inputs, false, false);
+    }
+    std::vector<ObjectIdType> ids;
+    size_t nReady = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t cycle = 0; cycle < nCycles; cycle++) {
+      for (size_t i = 0; i < nObjects; i++) {
+        if (!withIds) {
+          updatePolicyManager.updateObjectRevision(objectNames[i]);
+        } else {
+          if (ids.size() <= i) {
+            ids.push_back(updatePolicyManager.getObjectId(objectNames[i]));
+          }
+          updatePolicyManager.updateObjectRevision(ids[i]);
+        }
+      }
+      for (size_t a = 0; a < nActors; a++) {
+        auto actorName = "actor" + std::to_string(a);
+        if (updatePolicyManager.isReady(actorName)) {
+          nReady++;
+          updatePolicyManager.updateActorRevision(actorName);
+        }
+      }
+      updatePolicyManager.updateGlobalRevision();
+    }
+    std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+    return std::make_pair(nReady, duration.count() / nCycles);
+  };
+
+  auto [readyByName, durationByName] = run(false);
+  auto [readyById, durationById] = run(true);
+  BOOST_CHECK_EQUAL(readyByName, nActors * nCycles);
+  BOOST_CHECK_EQUAL(readyById, nActors * nCycles);
+  BOOST_TEST_MESSAGE("Cycle with " << nObjects << " objects, by name: " << durationByName << " ms, by ID: " << durationById << " ms");
+}
+
+BOOST_AUTO_TEST_CASE(test_dirty_actors)
+{
+  UpdatePolicyManager updatePolicyManager;
+  updatePolicyManager.addPolicy("actor1", UpdatePolicyType::OnAny, { "object1" }, false, false);
+  updatePolicyManager.addPolicy("actor2", UpdatePolicyType::OnAll, { "object1", "object2" }, false, false);
+  updatePolicyManager.addPolicy("actor3", UpdatePolicyType::OnGlobalAny, {}, true, false);
+  updatePolicyManager.addPolicy("actor4", UpdatePolicyType::OnAny, { "object3" }, false, false);
+  BOOST_CHECK_EQUAL(updatePolicyManager.getActorId("actor1"), 0);
+  BOOST_CHECK_EQUAL(updatePolicyManager.getActorId("actor4"), 3);
+  BOOST_CHECK_THROW(updatePolicyManager.getActorId("actor5"), ObjectNotFoundError);
+
+  // only the policies which do not depend on their inputs are dirty at the beginning
+  BOOST_CHECK(updatePolicyManager.getDirtyActors() == (std::vector<ActorIdType>{ 2 }));
+
+  updatePolicyManager.updateObjectRevision("object1");
+  BOOST_CHECK(updatePolicyManager.getDirtyActors() == (std::vector<ActorIdType>{ 0, 1, 2 }));
+  BOOST_CHECK_EQUAL(updatePolicyManager.isReady(ActorIdType{ 0 }), true);
+  BOOST_CHECK_EQUAL(updatePolicyManager.isReady(ActorIdType{ 1 }), false); // dirty, but not ready
+  updatePolicyManager.updateActorRevision(ActorIdType{ 0 });
+  updatePolicyManager.updateActorRevision(ActorIdType{ 2 });
+  BOOST_CHECK(updatePolicyManager.getDirtyActors() == (std::vector<ActorIdType>{ 1, 2 }));
+  updatePolicyManager.updateGlobalRevision();
+
+  // actor2 stays dirty until it is triggered
+  updatePolicyManager.updateObjectRevision("object2");
+  BOOST_CHECK(updatePolicyManager.getDirtyActors() == (std::vector<ActorIdType>{ 1, 2 }));
+  BOOST_CHECK_EQUAL(updatePolicyManager.isReady("actor2"), true);
+  updatePolicyManager.updateActorRevision("actor2");
+  BOOST_CHECK(updatePolicyManager.getDirtyActors() == (std::vector<ActorIdType>{ 2 }));
+
+  // the policy of an actor can be replaced
+  updatePolicyManager.addPolicy("actor1", UpdatePolicyType::OnAny, { "object3" }, false, false);
+  BOOST_CHECK_EQUAL(updatePolicyManager.getActorId("actor1"), 0);
+  updatePolicyManager.updateGlobalRevision();
+  updatePolicyManager.updateObjectRevision("object1");
+  BOOST_CHECK(updatePolicyManager.getDirtyActors() == (std::vector<ActorIdType>{ 1, 2 }));
+  updatePolicyManager.updateObjectRevision("object3");
+  BOOST_CHECK(updatePolicyManager.getDirtyActors() == (std::vector<ActorIdType>{ 0, 1, 2, 3 }));
+}
+
+BOOST_AUTO_TEST_CASE(test_incremental_readiness)
+{
+  // The policies are compared with a direct implementation which looks at all the inputs of each actor, as the
+  // UpdatePolicyManager used to do, on a random sequence of cycles with overlapping inputs.
+  constexpr size_t nObjects = 50;
+  constexpr size_t nActors = 200;
+  const std::vector<UpdatePolicyType> types{ UpdatePolicyType::OnAll, UpdatePolicyType::OnAnyNonZero, UpdatePolicyType::OnEachSeparately,
+                                             UpdatePolicyType::OnGlobalAny, UpdatePolicyType::OnAny };
+  struct Reference {
+    UpdatePolicyType type;
+    std::vector<size_t> inputs;
+    bool allObjects;
+    bool helperFlag = false;
+    RevisionType revision = 0;
+  };
+  std::mt19937 gen(42);
+  UpdatePolicyManager updatePolicyManager;
+  std::vector<Reference> references;
+  for (size_t a = 0; a < nActors; a++) {
+    Reference reference{ types[a % types.size()], {}, gen() % 4 == 0 };
+    std::vector<std::string> inputNames;
+    for (size_t i = 0, n = gen() % 6; i < n; i++) {
+      reference.inputs.push_back(gen() % nObjects);
+      inputNames.push_back("object" + std::to_string(reference.inputs.back()));
+    }
+    updatePolicyManager.addPolicy("actor" + std::to_string(a), reference.type, inputNames, reference.allObjects, false);
+    references.push_back(reference);
+  }
+
+  std::vector<RevisionType> objectRevisions(nObjects, 0);
+  RevisionType globalRevision = 1;
+  auto referenceIsReady = [&](Reference& reference) {
+    auto updated = std::count_if(reference.inputs.begin(), reference.inputs.end(), [&](size_t o) { return objectRevisions[o] > reference.revision; });
+    auto received = std::count_if(reference.inputs.begin(), reference.inputs.end(), [&](size_t o) { return objectRevisions[o] != 0; });
+    switch (reference.type) {
+      case UpdatePolicyType::OnAll:
+        return updated == static_cast<long>(reference.inputs.size());
+      case UpdatePolicyType::OnAnyNonZero:
+        if (!reference.helperFlag) {
+          if (received < static_cast<long>(reference.inputs.size())) {
+            return false;
+          }
+          reference.helperFlag = true;
+        }
+        return updated > 0;
+      case UpdatePolicyType::OnEachSeparately:
+        return reference.allObjects || updated > 0;
+      case UpdatePolicyType::OnGlobalAny:
+        return true;
+      default:
+        return updated > 0;
+    }
+  };
+
+  size_t nTriggered = 0;
+  for (size_t cycle = 0; cycle < 100; cycle++) {
+    for (size_t i = 0, n = gen() % 8; i < n; i++) {
+      auto object = gen() % nObjects;
+      objectRevisions[object] = globalRevision;
+      updatePolicyManager.updateObjectRevision("object" + std::to_string(object));
+    }
+    auto dirtyActors = updatePolicyManager.getDirtyActors();
+    for (ActorIdType a = 0; a < nActors; a++) {
+      bool expected = referenceIsReady(references[a]);
+      bool dirty = std::find(dirtyActors.begin(), dirtyActors.end(), a) != dirtyActors.end();
+      BOOST_REQUIRE_EQUAL(updatePolicyManager.isReady(a), expected);
+      BOOST_REQUIRE(dirty || !expected);
+      // only some of the ready actors are triggered, the others stay ready
+      if (expected && gen() % 3 != 0) {
+        updatePolicyManager.updateActorRevision(a);
+        references[a].revision = globalRevision;
+        nTriggered++;
+      }
+    }
+    updatePolicyManager.updateGlobalRevision();
+    globalRevision++;
+  }
+  BOOST_CHECK_GT(nTriggered, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_dirty_actors_benchmark)
+{
+  // 500 checks of 20 MOs each out of 10k MOs, only 100 of these MOs are updated in each cycle. Either each check is
+  // asked whether it is ready or only the dirty ones are.
+  constexpr size_t nObjects = 10000;
+  constexpr size_t nActors = 500;
+  constexpr size_t nUpdated = 100;
+  constexpr size_t nCycles = 100;
+  std::mt19937 gen(1);
+  UpdatePolicyManager updatePolicyManager;
+  std::vector<std::string> actorNames;
+  for (size_t a = 0; a < nActors; a++) {
+    std::vector<std::string> inputs;
+    for (size_t i = 0; i < 20; i++) {
+      inputs.push_back("object" + std::to_string(gen() % nObjects));
+    }
+    actorNames.push_back("actor" + std::to_string(a));
+    updatePolicyManager.addPolicy(actorNames.back(), UpdatePolicyType::OnAny, inputs, false, false);
+  }
+  std::vector<ObjectIdType> ids;
+  for (size_t i = 0; i < nObjects; i++) {
+    ids.push_back(updatePolicyManager.getObjectId("object" + std::to_string(i)));
+  }
+
+  auto run = [&](bool onlyDirty) {
+    size_t nReady = 0;
+    std::chrono::duration<double, std::milli> duration{ 0 };
+    for (size_t cycle = 0; cycle < nCycles; cycle++) {
+      for (size_t i = 0; i < nUpdated; i++) {
+        updatePolicyManager.updateObjectRevision(ids[(cycle * nUpdated + i) % nObjects]);
+      }
+      auto start = std::chrono::steady_clock::now();
+      if (onlyDirty) {
+        for (auto actorId : updatePolicyManager.getDirtyActors()) {
+          if (updatePolicyManager.isReady(actorId)) {
+            nReady++;
+            updatePolicyManager.updateActorRevision(actorId);
+          }
+        }
+      } else {
+        for (const auto& actorName : actorNames) {
+          if (updatePolicyManager.isReady(actorName)) {
+            nReady++;
+            updatePolicyManager.updateActorRevision(actorName);
+          }
+        }
+      }
+      duration += std::chrono::steady_clock::now() - start;
+      updatePolicyManager.updateGlobalRevision();
+    }
+    return std::make_pair(nReady, duration.count() / nCycles);
+  };
+
+  auto [readyAll, durationAll] = run(false);
+  auto [readyDirty, durationDirty] = run(true);
+  BOOST_CHECK_EQUAL(readyAll, readyDirty);
+  BOOST_TEST_MESSAGE("Readiness of " << nActors << " actors with " << nUpdated << " updated objects, all actors: "
+                                     << durationAll << " ms, dirty actors: " << durationDirty << " ms");
+}
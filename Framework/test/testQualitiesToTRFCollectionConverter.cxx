@@ -314,4 +314,41 @@ BOOST_AUTO_TEST_CASE(test_TheSameReasonsButSeparated)
   BOOST_CHECK_EQUAL(trf3.getFlag(), FlagReasonFactory::BadTracking());
   BOOST_CHECK_EQUAL(trf3.getComment(), "Bug in reco");
   BOOST_CHECK_EQUAL(trf3.getSource(), "qc/DET/QO/xyzCheck");
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE(test_QualitiesFromMetadata)
+{
+  // the qualities known only by their metadata, as in the incremental mode of TRFCollectionTask, give the same TRFs
+  std::vector<QualityObject> qos{
+    { Quality::Good, "xyzCheck", "DET", {}, {}, {}, { { metadata_keys::validFrom, "8" }, { metadata_keys::validUntil, "10" } } },
+    { Quality::Bad, "xyzCheck", "DET", {}, {}, {}, { { metadata_keys::validFrom, "10" }, { metadata_keys::validUntil, "40" } } },
+    { Quality::Bad, "xyzCheck", "DET", {}, {}, {}, { { metadata_keys::validFrom, "30" }, { metadata_keys::validUntil, "80" } } },
+    { Quality::Medium, "xyzCheck", "DET", {}, {}, {}, { { metadata_keys::validFrom, "50" }, { metadata_keys::validUntil, "60" } } },
+    { Quality::Good, "xyzCheck", "DET", {}, {}, {}, { { metadata_keys::validFrom, "60" }, { metadata_keys::validUntil, "90" } } }
+  };
+  qos[1].addReason(FlagReasonFactory::BadTracking(), "Bug in reco");
+  qos[2].addReason(FlagReasonFactory::BadTracking(), "Bug in reco");
+  qos[2].addReason(FlagReasonFactory::LimitedAcceptance(), "Sector C was off");
+
+  QualitiesToTRFCollectionConverter fromQOs(std::make_unique<TimeRangeFlagCollection>("test1", "DET", TimeRangeFlagCollection::RangeInterval{ 5, 100 }), "qc/DET/QO/xyzCheck");
+  QualitiesToTRFCollectionConverter fromMetadata(std::make_unique<TimeRangeFlagCollection>("test1", "DET", TimeRangeFlagCollection::RangeInterval{ 5, 100 }), "qc/DET/QO/xyzCheck");
+  for (const auto& qo : qos) {
+    fromQOs(qo);
+    fromMetadata(qo.getQuality(), qo.getReasons(), std::stoull(qo.getMetadata(metadata_keys::validFrom)),
+                 std::stoull(qo.getMetadata(metadata_keys::validUntil)), qo.getDetectorName(), qo.getPath());
+  }
+  BOOST_CHECK_EQUAL(fromMetadata.getQOsIncluded(), fromQOs.getQOsIncluded());
+  BOOST_CHECK_EQUAL(fromMetadata.getWorseThanGoodQOs(), fromQOs.getWorseThanGoodQOs());
+  auto expected = fromQOs.getResult();
+  auto trfc = fromMetadata.getResult();
+
+  BOOST_REQUIRE_EQUAL(trfc->size(), expected->size());
+  BOOST_CHECK_GT(trfc->size(), 2);
+  for (auto it = trfc->begin(), expectedIt = expected->begin(); it != trfc->end(); ++it, ++expectedIt) {
+    BOOST_CHECK_EQUAL(it->getStart(), expectedIt->getStart());
+    BOOST_CHECK_EQUAL(it->getEnd(), expectedIt->getEnd());
+    BOOST_CHECK_EQUAL(it->getFlag(), expectedIt->getFlag());
+    BOOST_CHECK_EQUAL(it->getComment(), expectedIt->getComment());
+    BOOST_CHECK_EQUAL(it->getSource(), expectedIt->getSource());
+  }
+}
@@ -0,0 +1,91 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testRetrievalCache.cxx
+///
+
+#include "QualityControl/RetrievalCache.h"
+
+#include <TObject.h>
+
+#define BOOST_TEST_MODULE RetrievalCache test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::repository;
+
+BOOST_AUTO_TEST_CASE(test_keys)
+{
+  std::map<std::string, std::string> metadata{ { "RunNumber", "123" } };
+  auto key = RetrievalCache::makeKey("qc/TST/MO/Task/obj", metadata);
+  BOOST_CHECK_EQUAL(key, RetrievalCache::makeKey("qc/TST/MO/Task/obj", metadata));
+  BOOST_CHECK_NE(key, RetrievalCache::makeKey("qc/TST/MO/Task/obj", {}));
+  BOOST_CHECK_NE(key, RetrievalCache::makeKey("qc/TST/MO/Task/obj", { { "RunNumber", "124" } }));
+  BOOST_CHECK_NE(key, RetrievalCache::makeKey("qc/TST/MO/Task/obj2", metadata));
+}
+
+BOOST_AUTO_TEST_CASE(test_lru)
+{
+  RetrievalCache cache(100);
+  auto object = std::make_shared<TObject>();
+  cache.insert("a", { object, "etag-a", 40 });
+  cache.insert("b", { std::make_shared<TObject>(), "etag-b", 40 });
+
+  auto a = cache.find("a");
+  BOOST_REQUIRE(a != nullptr);
+  BOOST_CHECK(a->object == object);
+  BOOST_CHECK_EQUAL(a->etag, "etag-a");
+  BOOST_CHECK(cache.find("c") == nullptr);
+
+  // "b" is the least recently used one, so it is evicted
+  cache.insert("c", { std::make_shared<TObject>(), "etag-c", 40 });
+  BOOST_CHECK(cache.find("a") != nullptr);
+  BOOST_CHECK(cache.find("b") == nullptr);
+  BOOST_CHECK(cache.find("c") != nullptr);
+  auto statistics = cache.getStatistics();
+  BOOST_CHECK_EQUAL(statistics.entries, 2);
+  BOOST_CHECK_EQUAL(statistics.bytes, 80);
+  BOOST_CHECK_EQUAL(statistics.evictions, 1);
+
+  // a new version replaces the old one
+  cache.insert("a", { std::make_shared<TObject>(), "etag-a2", 50 });
+  BOOST_CHECK_EQUAL(cache.find("a")->etag, "etag-a2");
+  BOOST_CHECK_EQUAL(cache.getStatistics().bytes, 90);
+
+  // objects bigger than the cache are not kept
+  cache.insert("d", { std::make_shared<TObject>(), "etag-d", 101 });
+  BOOST_CHECK(cache.find("d") == nullptr);
+  BOOST_CHECK_EQUAL(cache.getStatistics().entries, 2);
+
+  cache.erase("a");
+  BOOST_CHECK(cache.find("a") == nullptr);
+  BOOST_CHECK_EQUAL(cache.getStatistics().bytes, 40);
+  cache.clear();
+  BOOST_CHECK_EQUAL(cache.getStatistics().entries, 0);
+  BOOST_CHECK_EQUAL(cache.getStatistics().bytes, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_statistics)
+{
+  RetrievalCache cache(1000);
+  cache.recordMiss();
+  cache.insert("a", { std::make_shared<TObject>(), "etag-a", 300 });
+  cache.recordHit(*cache.find("a"));
+  cache.recordHit(*cache.find("a"));
+
+  auto statistics = cache.getStatistics();
+  BOOST_CHECK_EQUAL(statistics.hits, 2);
+  BOOST_CHECK_EQUAL(statistics.misses, 1);
+  BOOST_CHECK_EQUAL(statistics.bytesSaved, 600);
+}
@@ -0,0 +1,119 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testRootFileSink.cxx
+///
+
+#include "QualityControl/RootFileSink.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/MonitorObjectCollection.h"
+
+#include <TFile.h>
+#include <TH1F.h>
+#include <TNamed.h>
+#include <filesystem>
+#include <memory>
+#include <unistd.h>
+
+#define BOOST_TEST_MODULE RootFileSink test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::core;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+std::unique_ptr<MonitorObjectCollection> makeCollection(const char* name, int entries)
+{
+  auto histogram = new TH1F("histogram", "histogram", 10, 0, 10);
+  histogram->SetDirectory(nullptr);
+  for (int i = 0; i < entries; i++) {
+    histogram->Fill(i % 10);
+  }
+  auto mo = new MonitorObject(histogram, name, "class", "TST");
+  mo->setIsOwner(true);
+  auto collection = std::make_unique<MonitorObjectCollection>();
+  collection->SetOwner(true);
+  collection->SetName(name);
+  collection->setDetector("TST");
+  collection->Add(mo);
+  return collection;
+}
+
+double getEntries(const std::string& filePath, const char* collectionName)
+{
+  TFile file(filePath.c_str(), "READ");
+  BOOST_REQUIRE(!file.IsZombie());
+  std::unique_ptr<MonitorObjectCollection> collection(file.Get<MonitorObjectCollection>((std::string("TST/") + collectionName).c_str()));
+  BOOST_REQUIRE(collection != nullptr);
+  collection->postDeserialization();
+  auto mo = dynamic_cast<MonitorObject*>(collection->FindObject("histogram"));
+  BOOST_REQUIRE(mo != nullptr);
+  return dynamic_cast<TH1*>(mo->getObject())->GetEntries();
+}
+
+std::string getTitle(const std::string& filePath, const char* name)
+{
+  TFile file(filePath.c_str(), "READ");
+  std::unique_ptr<TNamed> named(file.Get<TNamed>(name));
+  BOOST_REQUIRE(named != nullptr);
+  return named->GetTitle();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(flush_release_and_merge_with_file)
+{
+  auto filePath = (std::filesystem::temp_directory_path() / ("testRootFileSink_" + std::to_string(getpid()) + ".root")).string();
+  {
+    // a file written before, with a collection which the sink does not receive and an object outside of directories
+    TFile file(filePath.c_str(), "RECREATE");
+    auto other = makeCollection("other", 5);
+    file.mkdir("TST")->WriteObject(other.get(), other->GetName());
+    TNamed info("info", "kept");
+    file.WriteTObject(&info);
+    file.Close();
+  }
+
+  // the flushes are triggered by the memory limit only
+  RootFileSink sink(filePath, 3600s, 100);
+
+  // over the memory limit, the collection is written, merged with nothing, and released
+  sink.mergeInMemory(makeCollection("task", 1), 1000);
+  sink.flushIfNeeded();
+  BOOST_CHECK_EQUAL(getEntries(filePath, "task"), 1);
+  BOOST_CHECK_EQUAL(getEntries(filePath, "other"), 5);
+  BOOST_CHECK_EQUAL(getTitle(filePath, "info"), "kept");
+  BOOST_CHECK(!std::filesystem::exists(filePath + ".tmp"));
+
+  // below the limit, nothing is written until the flush
+  sink.mergeInMemory(makeCollection("task", 2), 10);
+  sink.flushIfNeeded();
+  BOOST_CHECK_EQUAL(getEntries(filePath, "task"), 1);
+
+  // the released collection is merged with the one in the file
+  sink.flush(false);
+  BOOST_CHECK_EQUAL(getEntries(filePath, "task"), 3);
+
+  // the collection kept in memory already includes the file, it is not merged with it again
+  sink.mergeInMemory(makeCollection("task", 4), 10);
+  sink.flush(false);
+  BOOST_CHECK_EQUAL(getEntries(filePath, "task"), 7);
+  BOOST_CHECK_EQUAL(getEntries(filePath, "other"), 5);
+  BOOST_CHECK_EQUAL(getTitle(filePath, "info"), "kept");
+
+  std::filesystem::remove(filePath);
+}
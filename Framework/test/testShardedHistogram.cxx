@@ -0,0 +1,127 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testShardedHistogram.cxx
+///
+
+#include "QualityControl/ShardedHistogram.h"
+#include "QualityControl/ThreadPool.h"
+
+#include <TH1F.h>
+#include <TH2F.h>
+
+#define BOOST_TEST_MODULE ShardedHistogram test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::core;
+
+namespace
+{
+double value(size_t i) { return static_cast<double>(i % 137) / 10. - 2.; } // includes under- and overflows
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_sharded_histogram_1d)
+{
+  TH1F reference("reference", "reference", 10, 0, 10);
+  TH1F histogram("histogram", "histogram", 10, 0, 10);
+  ShardedHistogram<TH1F> sharded(&histogram, 3);
+  BOOST_CHECK_EQUAL(sharded.getNumberOfShards(), 3);
+  BOOST_CHECK_EQUAL(sharded.getHistogram(), &histogram);
+
+  for (size_t i = 0; i < 1000; i++) {
+    reference.Fill(value(i));
+    sharded.shard(i % 3).fill(value(i));
+  }
+  BOOST_CHECK_EQUAL(histogram.GetEntries(), 0);
+  sharded.mergeShards();
+  // merging again does not count the shards twice
+  sharded.mergeShards();
+
+  for (int bin = 0; bin < reference.GetNcells(); bin++) {
+    BOOST_CHECK_EQUAL(histogram.GetBinContent(bin), reference.GetBinContent(bin));
+  }
+  BOOST_CHECK_EQUAL(histogram.GetEntries(), reference.GetEntries());
+  BOOST_CHECK_CLOSE(histogram.GetMean(), reference.GetMean(), 0.001);
+  BOOST_CHECK_CLOSE(histogram.GetStdDev(), reference.GetStdDev(), 0.001);
+
+  sharded.reset();
+  BOOST_CHECK_EQUAL(histogram.GetEntries(), 0);
+  sharded.mergeShards();
+  BOOST_CHECK_EQUAL(histogram.GetEntries(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_sharded_histogram_weighted)
+{
+  TH1F reference("reference", "reference", 10, 0, 10);
+  TH1F histogram("histogram", "histogram", 10, 0, 10);
+  ShardedHistogram<TH1F> sharded(&histogram, 2);
+
+  for (size_t i = 0; i < 100; i++) {
+    reference.Fill(value(i), 0.5);
+    sharded.shard(i % 2).fill(value(i), 0.5);
+  }
+  sharded.mergeShards();
+
+  BOOST_CHECK(histogram.GetSumw2N() > 0);
+  for (int bin = 1; bin <= reference.GetNbinsX(); bin++) {
+    BOOST_CHECK_CLOSE(histogram.GetBinContent(bin), reference.GetBinContent(bin), 0.001);
+    BOOST_CHECK_CLOSE(histogram.GetBinError(bin), reference.GetBinError(bin), 0.001);
+  }
+  BOOST_CHECK_CLOSE(histogram.GetMean(), reference.GetMean(), 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(test_sharded_histogram_2d)
+{
+  TH2F reference("reference", "reference", 10, 0, 10, 5, 0, 5);
+  TH2F histogram("histogram", "histogram", 10, 0, 10, 5, 0, 5);
+  ShardedHistogram<TH2F> sharded(&histogram, 4);
+
+  for (size_t i = 0; i < 1000; i++) {
+    reference.Fill(value(i), value(i * 7) / 2.);
+    sharded.shard(i % 4).fill(value(i), value(i * 7) / 2.);
+  }
+  sharded.mergeShards();
+
+  for (int bin = 0; bin < reference.GetNcells(); bin++) {
+    BOOST_CHECK_EQUAL(histogram.GetBinContent(bin), reference.GetBinContent(bin));
+  }
+  BOOST_CHECK_EQUAL(histogram.GetEntries(), reference.GetEntries());
+  BOOST_CHECK_CLOSE(histogram.GetMean(1), reference.GetMean(1), 0.001);
+  BOOST_CHECK_CLOSE(histogram.GetMean(2), reference.GetMean(2), 0.001);
+  BOOST_CHECK_CLOSE(histogram.GetCorrelationFactor(), reference.GetCorrelationFactor(), 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(test_sharded_histogram_thread_pool)
+{
+  ThreadPool pool(4);
+  TH1F reference("reference", "reference", 100, -2, 12);
+  TH1F histogram("histogram", "histogram", 100, -2, 12);
+  ShardedHistogram<TH1F> sharded(&histogram, pool.size() + 1);
+
+  constexpr size_t nValues = 100000;
+  for (size_t i = 0; i < nValues; i++) {
+    reference.Fill(value(i));
+  }
+  pool.parallelFor(nValues, [&](size_t i) {
+    sharded.shard(pool.getThreadIndex()).fill(value(i));
+  });
+  sharded.mergeShards();
+
+  for (int bin = 0; bin < reference.GetNcells(); bin++) {
+    BOOST_CHECK_EQUAL(histogram.GetBinContent(bin), reference.GetBinContent(bin));
+  }
+  BOOST_CHECK_EQUAL(histogram.GetEntries(), nValues);
+  BOOST_CHECK_CLOSE(histogram.GetMean(), reference.GetMean(), 0.001);
+}
@@ -0,0 +1,195 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testStorageQueue.cxx
+///
+
+#include "QualityControl/StorageQueue.h"
+#include "QualityControl/DummyDatabase.h"
+#include "QualityControl/MonitorObject.h"
+#include "QualityControl/QualityObject.h"
+
+#include <TH1F.h>
+#include <mutex>
+#include <thread>
+
+#define BOOST_TEST_MODULE StorageQueue test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::core;
+using namespace o2::quality_control::repository;
+
+namespace
+{
+
+/// Remembers what was stored, optionally waiting before each upload to emulate a slow database.
+class RecordingDatabase : public DummyDatabase
+{
+ public:
+  explicit RecordingDatabase(std::chrono::milliseconds delay = std::chrono::milliseconds(0)) : mDelay(delay) {}
+
+  void storeMO(std::shared_ptr<const MonitorObject> mo, long from, long) override
+  {
+    std::this_thread::sleep_for(mDelay);
+    std::lock_guard<std::mutex> lock(mMutex);
+    storedMOs.emplace_back(mo->getName(), from);
+    storedEntries.push_back(dynamic_cast<TH1*>(mo->getObject())->GetEntries());
+  }
+
+  void storeQO(std::shared_ptr<const QualityObject> qo, long from, long) override
+  {
+    std::this_thread::sleep_for(mDelay);
+    std::lock_guard<std::mutex> lock(mMutex);
+    storedQOs.emplace_back(qo->getName(), from);
+  }
+
+  std::mutex mMutex;
+  std::vector<std::pair<std::string, long>> storedMOs;
+  std::vector<double> storedEntries;
+  std::vector<std::pair<std::string, long>> storedQOs;
+
+ private:
+  std::chrono::milliseconds mDelay;
+};
+
+std::shared_ptr<MonitorObject> makeMO(const std::string& name)
+{
+  auto mo = std::make_shared<MonitorObject>(new TH1F(name.c_str(), name.c_str(), 10, 0, 10), "task", "class", "TST");
+  mo->setIsOwner(true);
+  return mo;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_storage_queue_stores_everything)
+{
+  auto database = std::make_shared<RecordingDatabase>();
+  {
+    StorageQueue queue({ database }, 100);
+    for (int i = 0; i < 10; i++) {
+      queue.enqueue(makeMO("histo" + std::to_string(i)), 1000);
+    }
+    queue.enqueue(std::make_shared<QualityObject>(Quality::Good, "check"), 1000);
+    queue.flush();
+
+    BOOST_CHECK_EQUAL(queue.size(), 0);
+    auto stats = queue.getStats();
+    BOOST_CHECK_EQUAL(stats.stored, 11);
+    BOOST_CHECK_EQUAL(stats.dropped, 0);
+  }
+  BOOST_REQUIRE_EQUAL(database->storedMOs.size(), 10);
+  BOOST_REQUIRE_EQUAL(database->storedQOs.size(), 1);
+  // one worker uploads in the order of enqueueing
+  for (int i = 0; i < 10; i++) {
+    BOOST_CHECK_EQUAL(database->storedMOs[i].first, "histo" + std::to_string(i));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_storage_queue_snapshot)
+{
+  auto database = std::make_shared<RecordingDatabase>();
+  StorageQueue queue({ database }, 100);
+
+  auto mo = makeMO("histo");
+  dynamic_cast<TH1F*>(mo->getObject())->Fill(1);
+  queue.enqueue(mo, 1000);
+  // the original can be modified right away, the queue owns a copy
+  dynamic_cast<TH1F*>(mo->getObject())->Fill(2);
+  queue.flush();
+
+  BOOST_REQUIRE_EQUAL(database->storedEntries.size(), 1);
+  BOOST_CHECK_EQUAL(database->storedEntries[0], 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_storage_queue_coalescing)
+{
+  auto database = std::make_shared<RecordingDatabase>(std::chrono::milliseconds(100));
+  StorageQueue queue({ database }, 100);
+
+  queue.enqueue(makeMO("blocker"), 1000); // keeps the only worker busy for a while
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  auto mo = makeMO("histo");
+  queue.enqueue(mo, 1000);
+  dynamic_cast<TH1F*>(mo->getObject())->Fill(1);
+  queue.enqueue(mo, 1000); // same path and cycle, replaces the previous one
+  queue.enqueue(mo, 2000); // another cycle, should be kept
+  queue.flush();
+
+  BOOST_CHECK_EQUAL(queue.getStats().coalesced, 1);
+  BOOST_REQUIRE_EQUAL(database->storedMOs.size(), 3);
+  BOOST_CHECK_EQUAL(database->storedMOs[1].first, "histo");
+  BOOST_CHECK_EQUAL(database->storedMOs[1].second, 1000);
+  BOOST_CHECK_EQUAL(database->storedEntries[1], 1);
+  BOOST_CHECK_EQUAL(database->storedMOs[2].second, 2000);
+}
+
+BOOST_AUTO_TEST_CASE(test_storage_queue_drop_policies)
+{
+  for (auto policy : { StorageQueue::OverflowPolicy::DropOldest, StorageQueue::OverflowPolicy::DropNewest }) {
+    auto database = std::make_shared<RecordingDatabase>(std::chrono::milliseconds(100));
+    StorageQueue queue({ database }, 2, policy);
+
+    queue.enqueue(makeMO("blocker"), 1000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.enqueue(makeMO("a"), 1000);
+    queue.enqueue(makeMO("b"), 1000);
+    queue.enqueue(makeMO("c"), 1000); // the queue is full
+    queue.flush();
+
+    BOOST_CHECK_EQUAL(queue.getStats().dropped, 1);
+    BOOST_REQUIRE_EQUAL(database->storedMOs.size(), 3);
+    if (policy == StorageQueue::OverflowPolicy::DropOldest) {
+      BOOST_CHECK_EQUAL(database->storedMOs[1].first, "b");
+      BOOST_CHECK_EQUAL(database->storedMOs[2].first, "c");
+    } else {
+      BOOST_CHECK_EQUAL(database->storedMOs[1].first, "a");
+      BOOST_CHECK_EQUAL(database->storedMOs[2].first, "b");
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_storage_queue_parallel)
+{
+  std::vector<std::shared_ptr<DatabaseInterface>> backends;
+  std::vector<std::shared_ptr<RecordingDatabase>> databases;
+  for (int i = 0; i < 4; i++) {
+    databases.push_back(std::make_shared<RecordingDatabase>(std::chrono::milliseconds(50)));
+    backends.push_back(databases.back());
+  }
+  StorageQueue queue(backends, 100);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 8; i++) {
+    queue.enqueue(makeMO("histo" + std::to_string(i)), 1000);
+  }
+  // enqueueing must not wait for the uploads
+  BOOST_CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(50));
+  queue.flush();
+
+  size_t total = 0;
+  for (const auto& database : databases) {
+    total += database->storedMOs.size();
+  }
+  BOOST_CHECK_EQUAL(total, 8);
+}
+
+BOOST_AUTO_TEST_CASE(test_storage_queue_policy_from_string)
+{
+  BOOST_CHECK(StorageQueue::policyFromString("") == StorageQueue::OverflowPolicy::Block);
+  BOOST_CHECK(StorageQueue::policyFromString("block") == StorageQueue::OverflowPolicy::Block);
+  BOOST_CHECK(StorageQueue::policyFromString("dropOldest") == StorageQueue::OverflowPolicy::DropOldest);
+  BOOST_CHECK(StorageQueue::policyFromString("dropNewest") == StorageQueue::OverflowPolicy::DropNewest);
+  BOOST_CHECK_THROW(StorageQueue::policyFromString("asdf"), std::invalid_argument);
+}
@@ -0,0 +1,155 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testThreadPool.cxx
+///
+
+#include "QualityControl/ThreadPool.h"
+
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <stdexcept>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#define BOOST_TEST_MODULE ThreadPool test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::core;
+
+BOOST_AUTO_TEST_CASE(test_thread_pool_submit)
+{
+  ThreadPool pool(4);
+  BOOST_CHECK_EQUAL(pool.size(), 4);
+
+  std::vector<std::future<int>> futures;
+  for (int i = 0; i < 100; i++) {
+    futures.push_back(pool.submit([i]() { return i * i; }));
+  }
+  for (int i = 0; i < 100; i++) {
+    BOOST_CHECK_EQUAL(futures[i].get(), i * i);
+  }
+
+  auto failing = pool.submit([]() { throw std::runtime_error("expected"); });
+  BOOST_CHECK_THROW(failing.get(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_pool_parallel_for)
+{
+  ThreadPool pool(3);
+
+  // every index is visited exactly once and results are written in order
+  std::vector<size_t> results(1000, 0);
+  std::atomic<size_t> calls = 0;
+  pool.parallelFor(results.size(), [&](size_t i) {
+    results[i] = i + 1;
+    calls++;
+  });
+  BOOST_CHECK_EQUAL(calls, results.size());
+  std::vector<size_t> expected(results.size());
+  std::iota(expected.begin(), expected.end(), 1);
+  BOOST_CHECK(results == expected);
+
+  pool.parallelFor(0, [&](size_t) { BOOST_FAIL("should not be called"); });
+
+  BOOST_CHECK_THROW(pool.parallelFor(10, [](size_t i) {
+    if (i == 5) {
+      throw std::runtime_error("expected");
+    }
+  }),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_pool_inline)
+{
+  // without workers, the jobs are executed by the caller
+  ThreadPool pool(0);
+  BOOST_CHECK_EQUAL(pool.size(), 0);
+  auto callerId = std::this_thread::get_id();
+  BOOST_CHECK(pool.submit([]() { return std::this_thread::get_id(); }).get() == callerId);
+
+  size_t sum = 0;
+  pool.parallelFor(10, [&](size_t i) {
+    BOOST_CHECK(std::this_thread::get_id() == callerId);
+    sum += i;
+  });
+  BOOST_CHECK_EQUAL(sum, 45);
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_pool_nested)
+{
+  // jobs pushed from a job land in the queue of its worker and are stolen by the idle ones
+  ThreadPool pool(4);
+  std::atomic<size_t> calls = 0;
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < 8; i++) {
+    futures.push_back(pool.submit([&]() {
+      pool.parallelFor(100, [&](size_t) { calls++; });
+    }));
+  }
+  for (auto& future : futures) {
+    future.get();
+  }
+  BOOST_CHECK_EQUAL(calls, 800);
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_pool_pinned)
+{
+  auto cpus = ThreadPool::getCpusByNumaNode();
+#ifdef __linux__
+  BOOST_CHECK(!cpus.empty());
+#endif
+
+  ThreadPool pool(2, "QC/Test", true);
+  std::atomic<size_t> calls = 0;
+  pool.parallelFor(100, [&](size_t) { calls++; });
+  BOOST_CHECK_EQUAL(calls, 100);
+
+#ifdef __linux__
+  // the pools given different ranges do not pin their workers to the same CPUs
+  if (cpus.size() > 1) {
+    ThreadPool first(1, "QC/First", true, 0);
+    ThreadPool second(1, "QC/Second", true, 1);
+    BOOST_CHECK_EQUAL(first.submit([]() { return sched_getcpu(); }).get(), cpus[0]);
+    BOOST_CHECK_EQUAL(second.submit([]() { return sched_getcpu(); }).get(), cpus[1]);
+  }
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_pool_thread_index)
+{
+  ThreadPool pool(3);
+  BOOST_CHECK_EQUAL(pool.getThreadIndex(), 0);
+
+  // each thread running the jobs of parallelFor gets its own index in [0, size]
+  std::vector<std::atomic<std::thread::id>> owners(pool.size() + 1);
+  std::atomic<bool> clash = false;
+  pool.parallelFor(1000, [&](size_t) {
+    auto index = pool.getThreadIndex();
+    std::thread::id none;
+    if (index > pool.size()) {
+      clash = true;
+    } else if (!owners[index].compare_exchange_strong(none, std::this_thread::get_id()) && none != std::this_thread::get_id()) {
+      clash = true;
+    }
+  });
+  BOOST_CHECK(!clash);
+
+  ThreadPool other(1);
+  auto index = pool.submit([&]() { return other.getThreadIndex(); }).get();
+  BOOST_CHECK_EQUAL(index, 0);
+}
@@ -23,6 +23,11 @@
 #include <Framework/ServiceRegistry.h>
 
 #include <Configuration/ConfigurationFactory.h>
+#include <TCanvas.h>
+#include <TGraph.h>
+#include <TGraphErrors.h>
+#include <TH2.h>
+#include <TMath.h>
 #include <TH1I.h>
 
 #define BOOST_TEST_MODULE TrendingTask test
@@ -39,6 +44,59 @@ using namespace o2::framework;
 
 const std::string CCDB_ENDPOINT = "ccdb-test.cern.ch:8080";
 
+namespace
+{
+TCanvas* getCanvas(ObjectsManager& objectsManager, const std::string& plotName)
+{
+  auto mo = objectsManager.getMonitorObject(plotName);
+  return mo != nullptr ? dynamic_cast<TCanvas*>(mo->getObject()) : nullptr;
+}
+
+TGraphErrors* getGraphErrors(TCanvas* canvas)
+{
+  for (auto* primitive : *canvas->GetListOfPrimitives()) {
+    if (primitive->IsA() == TGraphErrors::Class()) {
+      return static_cast<TGraphErrors*>(primitive);
+    }
+  }
+  return nullptr;
+}
+
+// the points of the graph have to be the ones which TTree::Draw gives for the whole trend
+void checkPointsOfWholeTrend(TTree* trend, TGraph* graph, const std::string& varexp)
+{
+  Long64_t rows = trend->Draw(varexp.c_str(), "", "goff");
+  BOOST_REQUIRE_EQUAL(graph->GetN(), rows);
+  for (int i = 0; i < graph->GetN(); i++) {
+    BOOST_CHECK_CLOSE(graph->GetX()[i], trend->GetV2()[i], 0.0001);
+    BOOST_CHECK_CLOSE(graph->GetY()[i], trend->GetV1()[i], 0.0001);
+  }
+}
+
+void checkErrorsOfWholeTrend(TTree* trend, TGraphErrors* graphErrors, const std::string& varexpWithErrors)
+{
+  Long64_t rows = trend->Draw(varexpWithErrors.c_str(), "", "goff");
+  BOOST_REQUIRE_EQUAL(graphErrors->GetN(), rows);
+  for (int i = 0; i < graphErrors->GetN(); i++) {
+    BOOST_CHECK_CLOSE(graphErrors->GetX()[i], trend->GetVal(1)[i], 0.0001);
+    BOOST_CHECK_CLOSE(graphErrors->GetY()[i], trend->GetVal(0)[i], 0.0001);
+    BOOST_CHECK_CLOSE(graphErrors->GetEX()[i], trend->GetVal(2)[i], 0.0001);
+    BOOST_CHECK_CLOSE(graphErrors->GetEY()[i], trend->GetVal(3)[i], 0.0001);
+  }
+}
+
+// the new points must not fall outside of the frame drawn by TTree::Draw for the first ones
+void checkFrameContains(TCanvas* canvas, TGraph* graph)
+{
+  auto frame = dynamic_cast<TH2*>(canvas->GetPrimitive("htemp"));
+  BOOST_REQUIRE(frame != nullptr);
+  BOOST_CHECK_LE(frame->GetXaxis()->GetXmin(), TMath::MinElement(graph->GetN(), graph->GetX()));
+  BOOST_CHECK_GE(frame->GetXaxis()->GetXmax(), TMath::MaxElement(graph->GetN(), graph->GetX()));
+  BOOST_CHECK_LE(frame->GetYaxis()->GetXmin(), TMath::MinElement(graph->GetN(), graph->GetY()));
+  BOOST_CHECK_GE(frame->GetYaxis()->GetXmax(), TMath::MaxElement(graph->GetN(), graph->GetY()));
+}
+} // namespace
+
 // WARNING!
 // This test might not pass if run concurrently - it interacts with a common CCDB instance.
 BOOST_AUTO_TEST_CASE(test_task)
@@ -89,11 +147,66 @@ BOOST_AUTO_TEST_CASE(test_task)
     task.setObjectsManager(objectManager);
     task.configure(ConfigurationFactory::getConfiguration(configFilePath)->getRecursive());
     task.initialize({ TriggerType::Once, false, { 0, 0, "", "", "qc" }, 1 }, services);
+    TCanvas* meanCanvas = nullptr;
+    TGraph* meanGraph = nullptr;
+    TGraphErrors* meanErrors = nullptr;
+    double firstFrameXMax = 0;
     for (size_t i = 0; i < trendTimes; i++) {
       task.update({ TriggerType::Always, false, { 0, 0, "", "", "qc" }, i * 1000 + 50 }, services);
       publicationCallback(objectManager->getNonOwningArray(), i * 1000, i * 1000 + 100);
+
+      auto trendMO = objectManager->getMonitorObject(taskName);
+      BOOST_REQUIRE(trendMO != nullptr);
+      auto trend = dynamic_cast<TTree*>(trendMO->getObject());
+      BOOST_REQUIRE(trend != nullptr);
+      BOOST_REQUIRE_EQUAL(trend->GetEntries(), i + 1);
+
+      // the graph is drawn at the first update and then only extended with the new entries of the trend
+      auto canvas = getCanvas(*objectManager, "mean_of_histogram");
+      BOOST_REQUIRE(canvas != nullptr);
+      auto graph = dynamic_cast<TGraph*>(canvas->GetPrimitive("Graph"));
+      BOOST_REQUIRE(graph != nullptr);
+      auto frame = dynamic_cast<TH2*>(canvas->GetPrimitive("htemp"));
+      BOOST_REQUIRE(frame != nullptr);
+      if (i == 0) {
+        meanCanvas = canvas;
+        meanGraph = graph;
+        firstFrameXMax = frame->GetXaxis()->GetXmax();
+      }
+      BOOST_CHECK_EQUAL(canvas, meanCanvas);
+      BOOST_CHECK_EQUAL(graph, meanGraph);
+      checkPointsOfWholeTrend(trend, graph, "testHistoTrending.mean:time");
+      checkFrameContains(canvas, graph);
+
+      // the same for its error bars
+      auto canvasWithErrors = getCanvas(*objectManager, "mean_with_errors");
+      BOOST_REQUIRE(canvasWithErrors != nullptr);
+      auto graphErrors = getGraphErrors(canvasWithErrors);
+      BOOST_REQUIRE(graphErrors != nullptr);
+      if (i == 0) {
+        meanErrors = graphErrors;
+      }
+      BOOST_CHECK_EQUAL(graphErrors, meanErrors);
+      checkErrorsOfWholeTrend(trend, graphErrors, "testHistoTrending.mean:time:0:testHistoTrending.stddev");
+
+      // Entries$ changes with each new entry, so all the points of this graph have to be evaluated again
+      auto fractionCanvas = getCanvas(*objectManager, "mean_of_trend_fraction");
+      BOOST_REQUIRE(fractionCanvas != nullptr);
+      auto fractionGraph = dynamic_cast<TGraph*>(fractionCanvas->GetPrimitive("Graph"));
+      BOOST_REQUIRE(fractionGraph != nullptr);
+      checkPointsOfWholeTrend(trend, fractionGraph, "testHistoTrending.mean:Entry$/Entries$");
+
+      // a histogram is binned on the whole trend, it is redrawn as well
+      auto histogramCanvas = getCanvas(*objectManager, "quality_histogram");
+      BOOST_REQUIRE(histogramCanvas != nullptr);
+      auto histogram = dynamic_cast<TH1*>(histogramCanvas->GetPrimitive("htemp"));
+      BOOST_REQUIRE(histogram != nullptr);
+      BOOST_CHECK_EQUAL(histogram->GetEntries(), trend->GetEntries());
     }
     task.finalize({ TriggerType::UserOrControl, false, { 0, 0, "", "", "qc" }, trendTimes * 1000 }, services);
+    BOOST_CHECK_EQUAL(meanGraph->GetN(), trendTimes);
+    // the time of the later entries was beyond the frame drawn for the first one
+    BOOST_CHECK_GT(dynamic_cast<TH2*>(meanCanvas->GetPrimitive("htemp"))->GetXaxis()->GetXmax(), firstFrameXMax);
   }
 
   // The test itself
@@ -0,0 +1,198 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CounterArray.h
+/// \brief  Fixed-size arrays of counters, incremented during the processing and copied into histograms once per cycle.
+///
+
+#ifndef QC_MODULE_COMMON_COUNTERARRAY_H
+#define QC_MODULE_COMMON_COUNTERARRAY_H
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <TAxis.h>
+#include <TH1.h>
+#include <TArrayD.h>
+
+namespace o2::quality_control_modules::common
+{
+
+/// \brief Fixed-size array of counters, meant to replace the histogram fills in the processing loop.
+///
+/// Incrementing a counter is an array access, the histograms are updated in bulk with fill() or addTo() when they
+/// are about to be published, typically in endOfCycle(). The counter i corresponds to the bin i + 1 of the x axis,
+/// in the row biny when the histogram is a TH2. The arrays can be merged, e.g. the partial counts of several workers.
+template <size_t Size, typename T = uint32_t>
+class CounterArray
+{
+ public:
+  static_assert(Size > 0, "the size of a CounterArray cannot be 0");
+
+  void add(size_t index, T weight) { mCounts[index] += weight; }
+  void count(size_t index) { ++mCounts[index]; }
+  T get(size_t index) const { return mCounts[index]; }
+  const T* data() const { return mCounts.data(); }
+  static constexpr size_t size() { return Size; }
+
+  void reset() { mCounts.fill(0); }
+
+  T total() const
+  {
+    T sum = 0;
+    for (const auto& count : mCounts) {
+      sum += count;
+    }
+    return sum;
+  }
+
+  void merge(const CounterArray& other)
+  {
+    for (size_t i = 0; i < Size; i++) {
+      mCounts[i] += other.mCounts[i];
+    }
+  }
+
+  /// \brief Sets the bins of the histogram to the counts, with errors equal to their square root.
+  /// Returns false and leaves the histogram untouched if its x axis does not have as many bins as there are counters.
+  bool fill(TH1* histogram, int biny = 0) const
+  {
+    if (histogram == nullptr || histogram->GetNbinsX() != static_cast<int>(Size)) {
+      return false;
+    }
+    // the previous contents of the bins are replaced, and so are the corresponding entries
+    double entries = histogram->GetEntries();
+    for (size_t i = 0; i < Size; i++) {
+      const int bin = histogram->GetBin(i + 1, biny);
+      entries += static_cast<double>(mCounts[i]) - histogram->GetBinContent(bin);
+      histogram->SetBinContent(bin, mCounts[i]);
+      histogram->SetBinError(bin, std::sqrt(static_cast<double>(mCounts[i])));
+    }
+    histogram->SetEntries(entries);
+    return true;
+  }
+
+  /// \brief Adds the counts to the bins of the histogram, as if each of them had been filled with unit weight.
+  /// Returns false and leaves the histogram untouched if its x axis does not have as many bins as there are counters.
+  bool addTo(TH1* histogram, int biny = 0) const
+  {
+    if (histogram == nullptr || histogram->GetNbinsX() != static_cast<int>(Size)) {
+      return false;
+    }
+    const double entries = histogram->GetEntries();
+    TArrayD* sumw2 = histogram->GetSumw2N() > 0 ? histogram->GetSumw2() : nullptr;
+    double sum = 0;
+    for (size_t i = 0; i < Size; i++) {
+      if (mCounts[i] == 0) {
+        continue;
+      }
+      const int bin = histogram->GetBin(i + 1, biny);
+      histogram->AddBinContent(bin, mCounts[i]);
+      if (sumw2) {
+        sumw2->fArray[bin] += mCounts[i];
+      }
+      sum += mCounts[i];
+    }
+    histogram->ResetStats();
+    histogram->SetEntries(entries + sum);
+    return true;
+  }
+
+ private:
+  std::array<T, Size> mCounts{};
+};
+
+/// \brief CounterArray which can be incremented concurrently by several threads.
+/// The increments are relaxed atomic operations, use copyTo() to obtain a CounterArray to fill the histograms.
+template <size_t Size, typename T = uint32_t>
+class AtomicCounterArray
+{
+ public:
+  AtomicCounterArray() { reset(); }
+
+  void add(size_t index, T weight) { mCounts[index].fetch_add(weight, std::memory_order_relaxed); }
+  void count(size_t index) { add(index, 1); }
+  T get(size_t index) const { return mCounts[index].load(std::memory_order_relaxed); }
+  static constexpr size_t size() { return Size; }
+
+  void reset()
+  {
+    for (auto& count : mCounts) {
+      count.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /// Overwrites target with the current counts.
+  void copyTo(CounterArray<Size, T>& target) const
+  {
+    target.reset();
+    for (size_t i = 0; i < Size; i++) {
+      target.add(i, get(i));
+    }
+  }
+
+ private:
+  std::array<std::atomic<T>, Size> mCounts;
+};
+
+/// \brief One CounterArray per worker thread, merged when the histograms are filled.
+/// Each worker increments its own shard without any synchronisation, the shards are placed on separate cache lines.
+/// mergeInto() must not be called while the workers are counting.
+template <size_t Size, typename T = uint32_t>
+class ShardedCounterArray
+{
+ public:
+  explicit ShardedCounterArray(size_t nShards) : mShards(nShards > 0 ? nShards : 1) {}
+
+  CounterArray<Size, T>& shard(size_t index) { return mShards[index].counts; }
+  size_t getNumberOfShards() const { return mShards.size(); }
+  static constexpr size_t size() { return Size; }
+
+  void reset()
+  {
+    for (auto& shard : mShards) {
+      shard.counts.reset();
+    }
+  }
+
+  /// Adds the counts of all the shards to target.
+  void mergeInto(CounterArray<Size, T>& target) const
+  {
+    for (const auto& shard : mShards) {
+      target.merge(shard.counts);
+    }
+  }
+
+ private:
+  struct alignas(64) Shard {
+    CounterArray<Size, T> counts;
+  };
+  std::vector<Shard> mShards;
+};
+
+/// \brief Sets the labels of the first nLabels bins of the axis, the null and empty labels are skipped.
+inline void setBinLabels(TAxis* axis, const char* const* labels, size_t nLabels)
+{
+  for (size_t i = 0; i < nLabels; i++) {
+    if (labels[i] && labels[i][0]) {
+      axis->SetBinLabel(i + 1, labels[i]);
+    }
+  }
+}
+
+} // namespace o2::quality_control_modules::common
+
+#endif // QC_MODULE_COMMON_COUNTERARRAY_H
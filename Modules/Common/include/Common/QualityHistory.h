@@ -0,0 +1,87 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   QualityHistory.h
+///
+
+#ifndef QUALITYCONTROL_QUALITYHISTORY_H
+#define QUALITYCONTROL_QUALITYHISTORY_H
+
+#include "QualityControl/Quality.h"
+#include <DataFormatsQualityControl/TimeRangeFlag.h>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace o2::quality_control
+{
+class TimeRangeFlagCollection;
+}
+
+namespace o2::quality_control_modules::common
+{
+
+/// A version of a QO, as described by its metadata in the repository listing.
+struct QualityVersion {
+  uint64_t validFrom;
+  uint64_t validUntil;
+  uint64_t created;
+  quality_control::core::Quality quality;
+  quality_control::core::CommentedFlagReasons reasons; // known only for qualities worse than Good
+};
+
+/// \brief The versions of a QO seen so far, sorted by validFrom, and the creation time of the newest one (the watermark).
+///
+/// The repository serves the most recently created version for a given validity start, thus a version replaces the
+/// known one with the same validFrom only if it was created later. Once some versions are known, only the versions
+/// created after the watermark need to be listed.
+/// The watermark can be restored from a previous execution together with the TRFCollection produced then. The versions
+/// still have to be listed again, but the reasons of those created until the restored watermark are taken from the
+/// flags of the collection instead of downloading the QOs.
+class QualityHistory
+{
+ public:
+  /// Returns the creation time from which the versions should be listed, -1 if all of them are needed.
+  long getCreatedNotBefore() const;
+  uint64_t getWatermark() const { return mWatermark; }
+  const std::vector<QualityVersion>& getVersions() const { return mVersions; }
+
+  /// Returns true if the version is not known yet or if it was created after the known one with the same validFrom.
+  bool isNewer(const QualityVersion& version) const;
+  /// Adds the version if it is newer, see isNewer(). Returns true if it was added.
+  bool add(QualityVersion version);
+
+  /// Sets the watermark reached by a previous execution and the TRFCollection it produced with the QO at qoPath.
+  void restore(uint64_t watermark, const quality_control::TimeRangeFlagCollection& trfc, const std::string& qoPath);
+  /// \brief Fills the reasons of a version worse than Good with the restored flags, if it was known before.
+  /// Returns false if the version was created after the restored watermark or if no flag covers it,
+  /// in which case the QO has to be downloaded.
+  bool restoreReasons(QualityVersion& version) const;
+
+  /// Encodes the watermarks of several QOs into one metadata value, e.g. "QcCheck:1650000000000;OtherCheck:1650000001000".
+  static std::string encodeWatermarks(const std::map<std::string, uint64_t>& watermarks);
+  /// Decodes the value produced by encodeWatermarks, the malformed items are ignored.
+  static std::map<std::string, uint64_t> decodeWatermarks(const std::string& encoded);
+
+ private:
+  uint64_t mWatermark = 0;
+  std::vector<QualityVersion> mVersions;
+
+  uint64_t mRestoredWatermark = 0;
+  uint64_t mRestoredStart = 0;
+  std::vector<quality_control::TimeRangeFlag> mRestoredFlags;
+};
+
+} // namespace o2::quality_control_modules::common
+
+#endif // QUALITYCONTROL_QUALITYHISTORY_H
@@ -18,12 +18,17 @@
 #define QUALITYCONTROL_TRFCOLLECTIONTASK_H
 
 #include "QualityControl/PostProcessingInterface.h"
+#include "QualityControl/Quality.h"
 #include "Common/TRFCollectionTaskConfig.h"
+#include "Common/QualityHistory.h"
 #include <DataFormatsQualityControl/TimeRangeFlagCollection.h>
+#include <unordered_map>
+#include <vector>
 
 namespace o2::quality_control::repository
 {
 class DatabaseInterface;
+class CcdbDatabase;
 }
 
 namespace o2::quality_control_modules::common
@@ -47,10 +52,20 @@ class TRFCollectionTask final : public quality_control::postprocessing::PostProc
  private:
   std::unique_ptr<quality_control::TimeRangeFlagCollection>
     transformQualities(quality_control::repository::DatabaseInterface& qcdb, const uint64_t timestampLimitStart, const uint64_t timestampLimitEnd);
+  std::unique_ptr<quality_control::TimeRangeFlagCollection>
+    transformQualitiesIncrementally(quality_control::repository::CcdbDatabase& qcdb, const uint64_t timestampLimitStart, const uint64_t timestampLimitEnd);
+
+  /// Adds to the history the versions created after its watermark. Returns the number of downloaded objects.
+  size_t updateHistory(quality_control::repository::CcdbDatabase& qcdb, const std::string& qoName, QualityHistory& history);
+  /// Restores the watermarks stored with the TRFCollection of a previous execution which started at the same time.
+  void restoreHistories(quality_control::repository::CcdbDatabase& qcdb, uint64_t timestampLimitStart);
+  /// Stores the TRFCollection, together with the watermarks in the incremental mode.
+  void storeTRFC(quality_control::repository::DatabaseInterface& qcdb, std::unique_ptr<quality_control::TimeRangeFlagCollection> trfc);
 
  private:
   TRFCollectionTaskConfig mConfig;
   uint64_t mLastTimestampLimitStart = 0;
+  std::unordered_map<std::string, QualityHistory> mHistories; // used in the incremental mode, the keys are QO names
 };
 
 } // namespace o2::quality_control_modules::common
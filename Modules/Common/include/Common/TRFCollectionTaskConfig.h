@@ -39,6 +39,7 @@ struct TRFCollectionTaskConfig : quality_control::postprocessing::PostProcessing
   std::string periodName;
   std::string provenance;
   std::vector<std::string> qualityObjects;
+  bool incremental = false; // keep the QO versions between triggers and fetch only the new ones
 };
 
 } // namespace o2::quality_control_modules::common
@@ -0,0 +1,120 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   QualityHistory.cxx
+///
+
+#include "Common/QualityHistory.h"
+
+#include <DataFormatsQualityControl/TimeRangeFlagCollection.h>
+#include <algorithm>
+#include <sstream>
+
+using namespace o2::quality_control;
+using namespace o2::quality_control::core;
+
+namespace o2::quality_control_modules::common
+{
+
+long QualityHistory::getCreatedNotBefore() const
+{
+  return mVersions.empty() ? -1 : static_cast<long>(mWatermark + 1);
+}
+
+bool QualityHistory::isNewer(const QualityVersion& version) const
+{
+  auto sameStart = std::lower_bound(mVersions.begin(), mVersions.end(), version.validFrom,
+                                    [](const QualityVersion& v, uint64_t validFrom) { return v.validFrom < validFrom; });
+  return sameStart == mVersions.end() || sameStart->validFrom != version.validFrom || sameStart->created < version.created;
+}
+
+bool QualityHistory::add(QualityVersion version)
+{
+  mWatermark = std::max(mWatermark, version.created);
+  auto sameStart = std::lower_bound(mVersions.begin(), mVersions.end(), version.validFrom,
+                                    [](const QualityVersion& v, uint64_t validFrom) { return v.validFrom < validFrom; });
+  if (sameStart != mVersions.end() && sameStart->validFrom == version.validFrom) {
+    if (sameStart->created >= version.created) {
+      return false; // the repository serves the most recently created version for a given time
+    }
+    *sameStart = std::move(version);
+  } else {
+    mVersions.insert(sameStart, std::move(version));
+  }
+  return true;
+}
+
+void QualityHistory::restore(uint64_t watermark, const TimeRangeFlagCollection& trfc, const std::string& qoPath)
+{
+  mRestoredWatermark = watermark;
+  mRestoredStart = trfc.getStart();
+  mRestoredFlags.clear();
+  for (const auto& flag : trfc) {
+    if (flag.getSource() == qoPath) {
+      mRestoredFlags.push_back(flag);
+    }
+  }
+}
+
+bool QualityHistory::restoreReasons(QualityVersion& version) const
+{
+  if (mRestoredWatermark == 0 || version.created == 0 || version.created > mRestoredWatermark) {
+    return false;
+  }
+  // The converter starts the flags of a version at its validFrom, or earlier if they continue the same flags of the
+  // previous version, and it ends them at the start of the next version at the earliest.
+  const uint64_t start = std::max(version.validFrom, mRestoredStart);
+  CommentedFlagReasons reasons;
+  for (const auto& flag : mRestoredFlags) {
+    if (flag.getStart() <= start && flag.getEnd() > start) {
+      reasons.emplace_back(flag.getFlag(), flag.getComment());
+    }
+  }
+  if (reasons.empty()) {
+    return false;
+  }
+  version.reasons = std::move(reasons);
+  return true;
+}
+
+std::string QualityHistory::encodeWatermarks(const std::map<std::string, uint64_t>& watermarks)
+{
+  std::string encoded;
+  for (const auto& [name, watermark] : watermarks) {
+    if (!encoded.empty()) {
+      encoded += ';';
+    }
+    encoded += name + ':' + std::to_string(watermark);
+  }
+  return encoded;
+}
+
+std::map<std::string, uint64_t> QualityHistory::decodeWatermarks(const std::string& encoded)
+{
+  std::map<std::string, uint64_t> watermarks;
+  std::istringstream stream(encoded);
+  std::string item;
+  while (std::getline(stream, item, ';')) {
+    auto separator = item.rfind(':');
+    if (separator == std::string::npos || separator == 0 || separator + 1 == item.size()) {
+      continue;
+    }
+    try {
+      watermarks[item.substr(0, separator)] = std::stoull(item.substr(separator + 1));
+    } catch (const std::logic_error&) {
+      // not a number, ignored
+    }
+  }
+  return watermarks;
+}
+
+} // namespace o2::quality_control_modules::common
@@ -20,11 +20,15 @@
 #include "QualityControl/CcdbDatabase.h"
 #include "QualityControl/RepoPathUtils.h"
 #include "QualityControl/QualitiesToTRFCollectionConverter.h"
+#include "QualityControl/ObjectMetadataKeys.h"
 
 #include <DataFormatsQualityControl/TimeRangeFlagCollection.h>
 #include <DataFormatsQualityControl/TimeRangeFlag.h>
 #include <DataFormatsQualityControl/FlagReasons.h>
 
+#include <boost/property_tree/ptree.hpp>
+#include <algorithm>
+#include <map>
 #include <optional>
 
 using namespace o2::quality_control::postprocessing;
@@ -43,13 +47,45 @@ void TRFCollectionTask::configure(const boost::property_tree::ptree& config)
   mConfig = TRFCollectionTaskConfig(getID(), config);
 }
 
-void TRFCollectionTask::initialize(Trigger t, framework::ServiceRegistryRef)
+void TRFCollectionTask::initialize(Trigger t, framework::ServiceRegistryRef services)
 {
   mLastTimestampLimitStart = t.timestamp;
+  mHistories.clear();
+  if (mConfig.incremental) {
+    if (auto* qcdb = dynamic_cast<repository::CcdbDatabase*>(&services.get<repository::DatabaseInterface>())) {
+      restoreHistories(*qcdb, mLastTimestampLimitStart);
+    }
+  }
+}
+
+void TRFCollectionTask::restoreHistories(repository::CcdbDatabase& qcdb, uint64_t timestampLimitStart)
+{
+  std::map<std::string, std::string> headers;
+  auto previous = qcdb.retrieveTRFC(mConfig.name, mConfig.detector, mConfig.runNumber, mConfig.passName, mConfig.periodName,
+                                    mConfig.provenance, static_cast<long>(timestampLimitStart), headers);
+  auto encodedWatermarks = headers.find(repository::metadata_keys::qcTRFCWatermarks);
+  if (previous == nullptr || encodedWatermarks == headers.end()) {
+    ILOG(Info, Support) << "No TRFCollection with watermarks from a previous execution, the QO versions will be downloaded" << ENDM;
+    return;
+  }
+  for (const auto& [qoName, watermark] : QualityHistory::decodeWatermarks(encodedWatermarks->second)) {
+    std::string qoPath = RepoPathUtils::getQoPath(mConfig.detector, qoName, "", {}, mConfig.provenance);
+    mHistories[qoName].restore(watermark, *previous, qoPath);
+    ILOG(Info, Support) << "The QO versions of '" << qoPath << "' created until " << watermark
+                        << " are restored from the TRFCollection of a previous execution" << ENDM;
+  }
 }
 
 std::unique_ptr<quality_control::TimeRangeFlagCollection> TRFCollectionTask::transformQualities(repository::DatabaseInterface& qcdb, const uint64_t timestampLimitStart, const uint64_t timestampLimitEnd)
 {
+  if (mConfig.incremental) {
+    auto* qcdbAsCcdb = dynamic_cast<repository::CcdbDatabase*>(&qcdb);
+    if (qcdbAsCcdb == nullptr) {
+      throw std::runtime_error("The incremental mode of TRFCollectionTask supports only the CCDB backend");
+    }
+    return transformQualitiesIncrementally(*qcdbAsCcdb, timestampLimitStart, timestampLimitEnd);
+  }
+
   // ------ HELPERS ------
   std::function<std::vector<uint64_t>(const std::string& /*QO*/)> fetchAvailableTimestamps;
   try {
@@ -76,6 +112,8 @@ std::unique_ptr<quality_control::TimeRangeFlagCollection> TRFCollectionTask::tra
   for (const auto& qoName : mConfig.qualityObjects) {
 
     std::string qoPath = RepoPathUtils::getQoPath(mConfig.detector, qoName);
+    // retrieveQO adds the provenance by itself
+    std::string qoPathWithoutProvenance = RepoPathUtils::getQoPath(mConfig.detector, qoName, "", {}, "", false);
     QualitiesToTRFCollectionConverter converter(makeTRFC(), qoPath);
 
     auto availableTimestamps = fetchAvailableTimestamps(qoName);
@@ -90,7 +128,7 @@ std::unique_ptr<quality_control::TimeRangeFlagCollection> TRFCollectionTask::tra
     if (firstMatchingTimestamp != availableTimestamps.begin()) {
 
       auto currentObjTimestamp = firstMatchingTimestamp - 1;
-      auto qo = qcdb.retrieveQO(qoPath, *currentObjTimestamp);
+      auto qo = qcdb.retrieveQO(qoPathWithoutProvenance, *currentObjTimestamp);
       if (qo == nullptr) {
         throw std::runtime_error("Could not retrieve a QO for timestamp '" + std::to_string(*currentObjTimestamp) + "'");
       }
@@ -102,7 +140,7 @@ std::unique_ptr<quality_control::TimeRangeFlagCollection> TRFCollectionTask::tra
          currentStartTime != availableTimestamps.end() && *currentStartTime < timestampLimitEnd;
          currentStartTime++) {
 
-      auto newQO = qcdb.retrieveQO(qoPath, *currentStartTime);
+      auto newQO = qcdb.retrieveQO(qoPathWithoutProvenance, *currentStartTime);
       if (newQO == nullptr) {
         throw std::runtime_error("Could not retrieve a QO for timestamp '" + std::to_string(*currentStartTime) + "'");
       }
@@ -124,9 +162,100 @@ std::unique_ptr<quality_control::TimeRangeFlagCollection> TRFCollectionTask::tra
   return mainTrfCollection;
 }
 
-void TRFCollectionTask::update(Trigger, framework::ServiceRegistryRef)
+size_t TRFCollectionTask::updateHistory(repository::CcdbDatabase& qcdb, const std::string& qoName, QualityHistory& history)
 {
-  throw std::runtime_error("Only two timestamps should be given to the task");
+  namespace keys = repository::metadata_keys;
+  std::string qoPath = RepoPathUtils::getQoPath(mConfig.detector, qoName, "", {}, mConfig.provenance);
+  std::string qoPathWithoutProvenance = RepoPathUtils::getQoPath(mConfig.detector, qoName, "", {}, "", false);
+
+  // only the versions created after the newest one we know are listed
+  size_t downloaded = 0;
+  const std::vector<std::string> listingKeys{ keys::validFrom, keys::validUntil, keys::created, keys::qcQuality };
+  qcdb.forEachListedObject(qoPath, listingKeys, [&](const repository::CcdbListingReader::Entry& object) {
+    const auto& created = object[2];
+    const auto& qualityLevel = object[3];
+    QualityVersion version{ std::stoull(object[0]), std::stoull(object[1]), created.empty() ? 0 : std::stoull(created),
+                            Quality(qualityLevel.empty() ? Quality::NullLevel : std::stoul(qualityLevel)), {} };
+    if (!history.isNewer(version)) {
+      return true;
+    }
+
+    // The reasons are not in the metadata, thus we download the object only if it might have some
+    // and if they are not known from a previous execution.
+    if (version.quality.isWorseThan(Quality::Good) && !history.restoreReasons(version)) {
+      Activity activity;
+      activity.mProvenance = mConfig.provenance;
+      auto qo = qcdb.retrieveQO(qoPathWithoutProvenance, version.validFrom, activity);
+      if (qo == nullptr) {
+        throw std::runtime_error("Could not retrieve a QO for timestamp '" + std::to_string(version.validFrom) + "'");
+      }
+      version.quality = qo->getQuality();
+      version.reasons = qo->getReasons();
+      downloaded++;
+    }
+    history.add(std::move(version));
+    return true;
+  },
+                           history.getCreatedNotBefore());
+  return downloaded;
+}
+
+std::unique_ptr<quality_control::TimeRangeFlagCollection> TRFCollectionTask::transformQualitiesIncrementally(repository::CcdbDatabase& qcdb, const uint64_t timestampLimitStart, const uint64_t timestampLimitEnd)
+{
+  auto makeTRFC = [&]() {
+    return std::make_unique<TimeRangeFlagCollection>(mConfig.name, mConfig.detector,
+                                                     TimeRangeFlagCollection::RangeInterval{ timestampLimitStart, timestampLimitEnd },
+                                                     mConfig.runNumber, mConfig.periodName, mConfig.passName, mConfig.provenance);
+  };
+
+  size_t totalQOsIncluded = 0;
+  size_t totalWorseThanGoodQOs = 0;
+  size_t totalDownloaded = 0;
+
+  auto mainTrfCollection = makeTRFC();
+  for (const auto& qoName : mConfig.qualityObjects) {
+    auto& history = mHistories[qoName];
+    totalDownloaded += updateHistory(qcdb, qoName, history);
+
+    std::string qoPath = RepoPathUtils::getQoPath(mConfig.detector, qoName, "", {}, mConfig.provenance);
+    QualitiesToTRFCollectionConverter converter(makeTRFC(), qoPath);
+
+    const auto& versions = history.getVersions();
+    auto firstMatching = std::upper_bound(versions.begin(), versions.end(), timestampLimitStart,
+                                          [](uint64_t timestamp, const QualityVersion& v) { return timestamp < v.validFrom; });
+    if (firstMatching == versions.end()) {
+      ILOG(Warning) << "No object under the path '" << qoPath << "' available after timestamp '" << timestampLimitStart << "'" << ENDM;
+      continue;
+    }
+    // if available, we move one version back, because 'validUntil' might cover our period.
+    for (auto version = firstMatching != versions.begin() ? firstMatching - 1 : firstMatching;
+         version != versions.end() && (version < firstMatching || version->validFrom < timestampLimitEnd);
+         ++version) {
+      converter(version->quality, version->reasons, version->validFrom, version->validUntil, mConfig.detector, qoPath);
+    }
+
+    totalQOsIncluded += converter.getQOsIncluded();
+    totalWorseThanGoodQOs += converter.getWorseThanGoodQOs();
+    mainTrfCollection->merge(*converter.getResult());
+  }
+
+  ILOG(Info, Support) << "Total number of QOs included in TRFCollection: " << totalQOsIncluded
+                      << ", downloaded since the last trigger: " << totalDownloaded << ENDM;
+  ILOG(Info, Support) << "Total number of worse than good QOs: " << totalWorseThanGoodQOs << ENDM;
+  ILOG(Info, Support) << "Number of TRFs: " << mainTrfCollection->size() << ENDM;
+  ILOG(Info) << *mainTrfCollection << ENDM;
+
+  return mainTrfCollection;
+}
+
+void TRFCollectionTask::update(Trigger t, framework::ServiceRegistryRef services)
+{
+  if (!mConfig.incremental) {
+    throw std::runtime_error("Only two timestamps should be given to the task");
+  }
+  // in the incremental mode, we can afford to update the TRFCollection for the time range seen so far
+  auto& qcdb = services.get<repository::DatabaseInterface>();
+  storeTRFC(qcdb, transformQualities(qcdb, mLastTimestampLimitStart, t.timestamp));
 }
 
 void TRFCollectionTask::finalize(Trigger t, framework::ServiceRegistryRef services)
@@ -134,10 +263,27 @@ void TRFCollectionTask::finalize(Trigger t, framework::ServiceRegistryRef servic
   auto timestampLimitEnd = t.timestamp;
 
   auto& qcdb = services.get<repository::DatabaseInterface>();
-  auto trfCollection = transformQualities(qcdb, mLastTimestampLimitStart, timestampLimitEnd);
-  qcdb.storeTRFC(std::shared_ptr<const TimeRangeFlagCollection>(trfCollection.release()));
+  storeTRFC(qcdb, transformQualities(qcdb, mLastTimestampLimitStart, timestampLimitEnd));
 
   mLastTimestampLimitStart = timestampLimitEnd;
 }
 
+void TRFCollectionTask::storeTRFC(repository::DatabaseInterface& qcdb, std::unique_ptr<TimeRangeFlagCollection> trfc)
+{
+  std::shared_ptr<const TimeRangeFlagCollection> trfcToStore(trfc.release());
+  auto* qcdbAsCcdb = dynamic_cast<repository::CcdbDatabase*>(&qcdb);
+  if (!mConfig.incremental || qcdbAsCcdb == nullptr) {
+    qcdb.storeTRFC(trfcToStore);
+    return;
+  }
+  // a new execution of the task for the same time range can resume from these watermarks, see restoreHistories()
+  std::map<std::string, uint64_t> watermarks;
+  for (const auto& [qoName, history] : mHistories) {
+    if (!history.getVersions().empty()) {
+      watermarks[qoName] = history.getWatermark();
+    }
+  }
+  qcdbAsCcdb->storeTRFC(trfcToStore, { { repository::metadata_keys::qcTRFCWatermarks, QualityHistory::encodeWatermarks(watermarks) } });
+}
+
 } // namespace o2::quality_control_modules::common
@@ -31,6 +31,7 @@ TRFCollectionTaskConfig::TRFCollectionTaskConfig(std::string id, const boost::pr
   passName = config.get<std::string>("qc.config.Activity.passName", "");
   periodName = config.get<std::string>("qc.config.Activity.periodName", "");
   provenance = config.get<std::string>("qc.config.Activity.provenance", "qc");
+  incremental = config.get<bool>("qc.postprocessing." + id + ".incremental", false);
 }
 
 } // namespace o2::quality_control_modules::common
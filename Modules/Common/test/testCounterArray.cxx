@@ -0,0 +1,133 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCounterArray.cxx
+///
+
+#include "Common/CounterArray.h"
+
+#include <TH1F.h>
+#include <TH2F.h>
+#include <thread>
+
+#define BOOST_TEST_MODULE CounterArray test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control_modules::common;
+
+BOOST_AUTO_TEST_CASE(counter_array_counts)
+{
+  CounterArray<8> counters;
+  BOOST_CHECK_EQUAL(counters.size(), 8);
+  BOOST_CHECK_EQUAL(counters.total(), 0);
+
+  counters.count(1);
+  counters.count(1);
+  counters.add(7, 5);
+  BOOST_CHECK_EQUAL(counters.get(1), 2);
+  BOOST_CHECK_EQUAL(counters.get(7), 5);
+  BOOST_CHECK_EQUAL(counters.total(), 7);
+
+  CounterArray<8> other;
+  other.add(1, 3);
+  other.count(0);
+  counters.merge(other);
+  BOOST_CHECK_EQUAL(counters.get(0), 1);
+  BOOST_CHECK_EQUAL(counters.get(1), 5);
+  BOOST_CHECK_EQUAL(counters.total(), 11);
+
+  counters.reset();
+  BOOST_CHECK_EQUAL(counters.total(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(counter_array_histograms)
+{
+  CounterArray<4> counters;
+  counters.add(0, 4);
+  counters.add(3, 9);
+
+  TH1F wrongSize("wrongSize", "wrongSize", 5, 0, 5);
+  BOOST_CHECK(!counters.fill(&wrongSize));
+  BOOST_CHECK(!counters.addTo(&wrongSize));
+  BOOST_CHECK_EQUAL(wrongSize.GetEntries(), 0);
+
+  // fill() replaces the content, the counts are cumulative
+  TH1F histo("histo", "histo", 4, 0, 4);
+  BOOST_REQUIRE(counters.fill(&histo));
+  BOOST_REQUIRE(counters.fill(&histo));
+  BOOST_CHECK_EQUAL(histo.GetBinContent(1), 4);
+  BOOST_CHECK_EQUAL(histo.GetBinError(1), 2);
+  BOOST_CHECK_EQUAL(histo.GetBinContent(2), 0);
+  BOOST_CHECK_EQUAL(histo.GetBinContent(4), 9);
+  BOOST_CHECK_EQUAL(histo.GetEntries(), 13);
+
+  // addTo() adds the counts to the content at each call
+  TH1F added("added", "added", 4, 0, 4);
+  BOOST_REQUIRE(counters.addTo(&added));
+  BOOST_REQUIRE(counters.addTo(&added));
+  BOOST_CHECK_EQUAL(added.GetBinContent(1), 8);
+  BOOST_CHECK_EQUAL(added.GetBinContent(4), 18);
+  BOOST_CHECK_EQUAL(added.GetEntries(), 26);
+  BOOST_CHECK_CLOSE(added.GetMean(), (8 * 0.5 + 18 * 3.5) / 26., 0.001);
+
+  // one row per array
+  TH2F histo2d("histo2d", "histo2d", 4, 0, 4, 2, 0, 2);
+  CounterArray<4> row;
+  row.count(2);
+  BOOST_REQUIRE(counters.addTo(&histo2d, 1));
+  BOOST_REQUIRE(row.addTo(&histo2d, 2));
+  BOOST_CHECK_EQUAL(histo2d.GetBinContent(4, 1), 9);
+  BOOST_CHECK_EQUAL(histo2d.GetBinContent(3, 2), 1);
+  BOOST_CHECK_EQUAL(histo2d.GetEntries(), 14);
+}
+
+BOOST_AUTO_TEST_CASE(counter_array_concurrent)
+{
+  constexpr size_t nThreads = 4;
+  constexpr size_t nCounts = 100000;
+
+  AtomicCounterArray<16> atomicCounters;
+  ShardedCounterArray<16> shardedCounters(nThreads);
+  BOOST_CHECK_EQUAL(shardedCounters.getNumberOfShards(), nThreads);
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < nThreads; t++) {
+    threads.emplace_back([&, t]() {
+      auto& shard = shardedCounters.shard(t);
+      for (size_t i = 0; i < nCounts; i++) {
+        atomicCounters.count(i % 16);
+        shard.count(i % 16);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  CounterArray<16> fromAtomic;
+  atomicCounters.copyTo(fromAtomic);
+  CounterArray<16> fromShards;
+  shardedCounters.mergeInto(fromShards);
+  for (size_t i = 0; i < 16; i++) {
+    BOOST_CHECK_EQUAL(fromAtomic.get(i), nThreads * nCounts / 16);
+    BOOST_CHECK_EQUAL(fromShards.get(i), nThreads * nCounts / 16);
+  }
+
+  atomicCounters.reset();
+  shardedCounters.reset();
+  atomicCounters.copyTo(fromAtomic);
+  BOOST_CHECK_EQUAL(fromAtomic.total(), 0);
+  BOOST_CHECK_EQUAL(shardedCounters.shard(0).total(), 0);
+}
@@ -0,0 +1,171 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testQualityHistory.cxx
+///
+
+#include "Common/QualityHistory.h"
+#include "QualityControl/QualitiesToTRFCollectionConverter.h"
+
+#include <DataFormatsQualityControl/TimeRangeFlagCollection.h>
+#include <DataFormatsQualityControl/FlagReasons.h>
+
+#define BOOST_TEST_MODULE QualityHistory test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control;
+using namespace o2::quality_control::core;
+using namespace o2::quality_control_modules::common;
+
+namespace
+{
+
+/// Lists the versions as the repository would: only those created at createdNotBefore or later, if it is not negative.
+std::vector<QualityVersion> list(const std::vector<QualityVersion>& repository, long createdNotBefore)
+{
+  std::vector<QualityVersion> listed;
+  for (const auto& version : repository) {
+    if (createdNotBefore < 0 || version.created >= static_cast<uint64_t>(createdNotBefore)) {
+      listed.push_back(version);
+    }
+  }
+  return listed;
+}
+
+std::unique_ptr<TimeRangeFlagCollection> convert(const std::vector<QualityVersion>& versions, const std::string& qoPath)
+{
+  QualitiesToTRFCollectionConverter converter(std::make_unique<TimeRangeFlagCollection>("test", "DET", TimeRangeFlagCollection::RangeInterval{ 5, 100 }), qoPath);
+  for (const auto& version : versions) {
+    converter(version.quality, version.reasons, version.validFrom, version.validUntil, "DET", qoPath);
+  }
+  return converter.getResult();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_watermark)
+{
+  std::vector<QualityVersion> repository{
+    { 10, 20, 1000, Quality::Good, {} },
+    { 20, 30, 1001, Quality::Good, {} },
+  };
+  QualityHistory history;
+  BOOST_CHECK_EQUAL(history.getCreatedNotBefore(), -1);
+  for (auto& version : list(repository, history.getCreatedNotBefore())) {
+    BOOST_CHECK(history.add(version));
+  }
+  BOOST_CHECK_EQUAL(history.getVersions().size(), 2);
+  BOOST_CHECK_EQUAL(history.getWatermark(), 1001);
+  BOOST_CHECK_EQUAL(history.getCreatedNotBefore(), 1002);
+
+  // only the versions created after the watermark are listed again
+  repository.push_back({ 30, 40, 1002, Quality::Bad, {} });
+  auto listed = list(repository, history.getCreatedNotBefore());
+  BOOST_REQUIRE_EQUAL(listed.size(), 1);
+  BOOST_CHECK_EQUAL(listed[0].validFrom, 30);
+  BOOST_CHECK(history.add(listed[0]));
+  BOOST_CHECK_EQUAL(history.getWatermark(), 1002);
+  BOOST_CHECK(list(repository, history.getCreatedNotBefore()).empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_same_validity_start)
+{
+  QualityHistory history;
+  BOOST_CHECK(history.add({ 10, 20, 1000, Quality::Good, {} }));
+  BOOST_CHECK(history.add({ 30, 40, 1001, Quality::Good, {} }));
+
+  // the version created later replaces the one with the same validFrom, whatever the order of the listing
+  QualityVersion newer{ 10, 25, 1005, Quality::Bad, {} };
+  QualityVersion older{ 10, 22, 999, Quality::Medium, {} };
+  BOOST_CHECK(history.isNewer(newer));
+  BOOST_CHECK(!history.isNewer(older));
+  BOOST_CHECK(history.add(newer));
+  BOOST_CHECK(!history.add(older));
+  BOOST_CHECK(!history.add(newer));
+
+  const auto& versions = history.getVersions();
+  BOOST_REQUIRE_EQUAL(versions.size(), 2);
+  BOOST_CHECK_EQUAL(versions[0].validFrom, 10);
+  BOOST_CHECK_EQUAL(versions[0].validUntil, 25);
+  BOOST_CHECK_EQUAL(versions[0].created, 1005);
+  BOOST_CHECK(versions[0].quality == Quality::Bad);
+  BOOST_CHECK_EQUAL(versions[1].validFrom, 30);
+  BOOST_CHECK_EQUAL(history.getWatermark(), 1005);
+}
+
+BOOST_AUTO_TEST_CASE(test_restore)
+{
+  const std::string qoPath = "qc/DET/QO/xyzCheck";
+  std::vector<QualityVersion> repository{
+    { 8, 10, 1000, Quality::Good, {} },
+    { 10, 40, 1001, Quality::Bad, { { FlagReasonFactory::BadTracking(), "Bug in reco" } } },
+    { 30, 80, 1002, Quality::Bad, { { FlagReasonFactory::BadTracking(), "Bug in reco" }, { FlagReasonFactory::LimitedAcceptance(), "Sector C was off" } } },
+    { 50, 60, 1003, Quality::Medium, {} },
+    { 60, 90, 1004, Quality::Good, {} },
+  };
+  auto previousTRFC = convert(repository, qoPath);
+
+  // a new execution restores the watermark and the flags of the collection stored by the previous one
+  QualityHistory history;
+  history.restore(1004, *previousTRFC, qoPath);
+  repository.push_back({ 90, 120, 1005, Quality::Bad, {} });
+  std::vector<QualityVersion> restored;
+  for (auto version : list(repository, history.getCreatedNotBefore())) {
+    if (version.quality.isWorseThan(Quality::Good)) {
+      bool known = history.restoreReasons(version);
+      // the version created after the watermark has to be downloaded
+      BOOST_CHECK_EQUAL(known, version.created <= 1004);
+    }
+    restored.push_back(version);
+    history.add(version);
+  }
+  BOOST_REQUIRE_EQUAL(restored.size(), repository.size());
+  BOOST_CHECK_EQUAL(restored[1].reasons.size(), 1);
+  BOOST_CHECK_EQUAL(restored[2].reasons.size(), 2);
+  BOOST_REQUIRE_EQUAL(restored[3].reasons.size(), 1);
+  BOOST_CHECK_EQUAL(restored[3].reasons[0].first, FlagReasonFactory::Unknown());
+
+  // the restored versions give the same TRFs as the original ones
+  restored.pop_back();
+  repository.pop_back();
+  auto trfc = convert(restored, qoPath);
+  auto expected = convert(repository, qoPath);
+  BOOST_REQUIRE_EQUAL(trfc->size(), expected->size());
+  for (auto it = trfc->begin(), expectedIt = expected->begin(); it != trfc->end(); ++it, ++expectedIt) {
+    BOOST_CHECK_EQUAL(it->getStart(), expectedIt->getStart());
+    BOOST_CHECK_EQUAL(it->getEnd(), expectedIt->getEnd());
+    BOOST_CHECK_EQUAL(it->getFlag(), expectedIt->getFlag());
+    BOOST_CHECK_EQUAL(it->getComment(), expectedIt->getComment());
+  }
+
+  // the flags of other QOs are not used
+  QualityHistory otherHistory;
+  otherHistory.restore(1004, *previousTRFC, "qc/DET/QO/otherCheck");
+  QualityVersion version = repository[1];
+  version.reasons.clear();
+  BOOST_CHECK(!otherHistory.restoreReasons(version));
+}
+
+BOOST_AUTO_TEST_CASE(test_encode_watermarks)
+{
+  std::map<std::string, uint64_t> watermarks{ { "QcCheck", 1650000000000 }, { "Task/OtherCheck", 1650000001000 } };
+  auto encoded = QualityHistory::encodeWatermarks(watermarks);
+  BOOST_CHECK_EQUAL(encoded, "QcCheck:1650000000000;Task/OtherCheck:1650000001000");
+  BOOST_CHECK(QualityHistory::decodeWatermarks(encoded) == watermarks);
+  BOOST_CHECK(QualityHistory::decodeWatermarks("").empty());
+  auto partial = QualityHistory::decodeWatermarks("QcCheck:12;broken;:34;Other:abc;Last:");
+  BOOST_REQUIRE_EQUAL(partial.size(), 1);
+  BOOST_CHECK_EQUAL(partial.at("QcCheck"), 12);
+}
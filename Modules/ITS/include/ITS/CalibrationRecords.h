@@ -0,0 +1,171 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CalibrationRecords.h
+///
+
+#ifndef QC_MODULE_ITS_CALIBRATIONRECORDS_H
+#define QC_MODULE_ITS_CALIBRATIONRECORDS_H
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <gsl/span>
+
+namespace o2::quality_control_modules::its
+{
+
+/// \brief Results of the threshold, ITHR, VCASN or pulse length scan of one chip.
+/// The values are in the units of the text format, in particular the time over threshold is in ns.
+struct ThresholdChipRecord {
+  static constexpr uint16_t Type = 1;
+
+  uint32_t chipID = 0; // O2 chip ID
+  float mainVal = 0;   // THR, ITHR or VCASN
+  float rms = 0;
+  float noise = 0;
+  float noiseRms = 0;
+  float status = 0;
+  float tot = 0; // time over threshold
+  float totRms = 0;
+  float rt = 0; // rise time
+  float rtRms = 0;
+};
+
+/// \brief Number of noisy, dead or inefficient pixels of one chip.
+struct PixelChipRecord {
+  static constexpr uint16_t Type = 2;
+
+  uint32_t chipID = 0; // O2 chip ID
+  int32_t type = 0;    // 0: noisy, 1: dead, 2: inefficient
+  int32_t counts = 0;
+  int32_t dcols = 0;
+
+  static constexpr int32_t NTypes = 3;
+};
+
+static_assert(std::is_trivially_copyable_v<ThresholdChipRecord> && sizeof(ThresholdChipRecord) == 40);
+static_assert(std::is_trivially_copyable_v<PixelChipRecord> && sizeof(PixelChipRecord) == 16);
+
+/// \brief Header of the binary payloads: it is followed by nRecords records of type recordType.
+///
+/// The ITS calibration can send the chip results either as text, "name:value," fields with the records separated by
+/// "O2", or as an array of records preceded by this header, in the same TSTR, QCSTR and PIXTYP inputs. The first byte
+/// of the magic number is not ASCII, thus a text payload is never mistaken for a binary one.
+struct CalibrationRecordsHeader {
+  static constexpr uint32_t Magic = 0x31525493;
+  static constexpr uint16_t Version = 1;
+
+  uint32_t magic = Magic;
+  uint16_t version = Version;
+  uint16_t recordType = 0;
+  uint32_t recordSize = 0;
+  uint32_t nRecords = 0;
+};
+
+static_assert(sizeof(CalibrationRecordsHeader) == 16);
+
+/// Returns true if the payload starts with a CalibrationRecordsHeader, false if it is in the text format.
+inline bool hasRecordsHeader(gsl::span<const char> payload)
+{
+  uint32_t magic = 0;
+  if (payload.size() < sizeof(CalibrationRecordsHeader)) {
+    return false;
+  }
+  std::memcpy(&magic, payload.data(), sizeof(magic));
+  return magic == CalibrationRecordsHeader::Magic;
+}
+
+/// \brief Returns the records of a binary payload, without copying them unless the payload is not suitably aligned,
+/// in which case they are copied to alignedCopy.
+/// An empty span is returned if the header does not describe records of type Record or if the payload is truncated.
+template <typename Record>
+gsl::span<const Record> getRecords(gsl::span<const char> payload, std::vector<Record>& alignedCopy)
+{
+  if (!hasRecordsHeader(payload)) {
+    return {};
+  }
+  CalibrationRecordsHeader header;
+  std::memcpy(&header, payload.data(), sizeof(header));
+  if (header.version != CalibrationRecordsHeader::Version || header.recordType != Record::Type || header.recordSize != sizeof(Record) ||
+      header.nRecords > (payload.size() - sizeof(header)) / sizeof(Record)) {
+    return {};
+  }
+  const char* begin = payload.data() + sizeof(header);
+  if (reinterpret_cast<uintptr_t>(begin) % alignof(Record) != 0) {
+    alignedCopy.resize(header.nRecords);
+    std::memcpy(alignedCopy.data(), begin, header.nRecords * sizeof(Record));
+    return { alignedCopy.data(), alignedCopy.size() };
+  }
+  return { reinterpret_cast<const Record*>(begin), header.nRecords };
+}
+
+/// Serialises the records with their header, as expected by getRecords().
+template <typename Record>
+std::vector<char> makeRecordsPayload(gsl::span<const Record> records)
+{
+  CalibrationRecordsHeader header;
+  header.recordType = Record::Type;
+  header.recordSize = sizeof(Record);
+  header.nRecords = records.size();
+  std::vector<char> payload(sizeof(header) + records.size() * sizeof(Record));
+  std::memcpy(payload.data(), &header, sizeof(header));
+  if (!records.empty()) {
+    std::memcpy(payload.data() + sizeof(header), records.data(), records.size() * sizeof(Record));
+  }
+  return payload;
+}
+
+/// \brief Returns true if the record describes an existing chip, i.e. its chipID is below nChips.
+/// The binary records are not checked when they are read, they must be validated before their fields are used as indices.
+inline bool isValidRecord(const ThresholdChipRecord& record, uint32_t nChips)
+{
+  return record.chipID < nChips;
+}
+
+/// Returns true if the record describes an existing chip and a known type of pixels.
+inline bool isValidRecord(const PixelChipRecord& record, uint32_t nChips)
+{
+  return record.chipID < nChips && record.type >= 0 && record.type < PixelChipRecord::NTypes;
+}
+
+/// Calls f(std::string_view) for each non-empty record of a text payload, the records being separated by "O2".
+template <typename F>
+void forEachTextRecord(std::string_view text, F&& f)
+{
+  size_t start = 0;
+  while (start < text.size()) {
+    size_t end = text.find("O2", start);
+    if (end == std::string_view::npos) {
+      end = text.size();
+    }
+    if (end > start) {
+      f(text.substr(start, end - start));
+    }
+    start = end + 2;
+  }
+}
+
+/// Parses a text record of a threshold-like scan, e.g. "L3_05,ChipID:3120,THR:100.5,Rms:5.1,...".
+/// Returns false if the record does not have a valid ChipID, the unknown fields are ignored.
+bool parseThresholdRecord(std::string_view text, ThresholdChipRecord& record);
+
+/// Parses a text record of a pixel scan, e.g. "ChipID:3120,PixelType:Dead,PixelNos:12,DcolNos:0".
+/// Returns false if the record does not have a valid ChipID or a known PixelType, the unknown fields are ignored.
+bool parsePixelRecord(std::string_view text, PixelChipRecord& record);
+
+} // namespace o2::quality_control_modules::its
+
+#endif // QC_MODULE_ITS_CALIBRATIONRECORDS_H
@@ -0,0 +1,76 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ChipGeometryCache.h
+///
+
+#ifndef QC_MODULE_ITS_CHIPGEOMETRYCACHE_H
+#define QC_MODULE_ITS_CHIPGEOMETRYCACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class TH2;
+
+namespace o2::its
+{
+class GeometryTGeo;
+}
+
+namespace o2::quality_control_modules::its
+{
+
+/// \brief Position and numbering of all the ITS chips, computed once per run and shared by the ITS tasks.
+///
+/// The tasks used to query GeometryTGeo for each chip in each TF, while the geometry only changes with the run.
+/// get() returns the table of the given run, it is computed by the first task which asks for it, typically when
+/// TimingInfo::globalRunNumberChanged is set, and shared by all the tasks of the process.
+class ChipGeometryCache
+{
+ public:
+  static constexpr int NChips = 24120;
+
+  struct ChipInfo {
+    float phi = 0; // azimuth of the centre of the chip, in degrees
+    float z = 0;   // z of the centre of the chip, in cm
+    int16_t layer = 0;
+    int16_t stave = 0;
+    int16_t subStave = 0;
+    int16_t module = 0;
+    int16_t chipInModule = 0;
+  };
+
+  /// \param chips The chips indexed by their O2 chip ID.
+  ChipGeometryCache(std::vector<ChipInfo> chips, int runNumber) : mChips(std::move(chips)), mRunNumber(runNumber) {}
+
+  /// Returns the table of the run, built from GeometryTGeo (with its L2G matrices) if it is not the one of the
+  /// previous call. It is thread-safe, the returned table stays valid as long as it is held.
+  static std::shared_ptr<const ChipGeometryCache> get(int runNumber);
+  /// Builds the table from the geometry, whose L2G matrices must be filled.
+  static std::vector<ChipInfo> computeChips(const o2::its::GeometryTGeo& geometry);
+
+  const ChipInfo& operator[](int chipID) const { return mChips[chipID]; }
+  size_t size() const { return mChips.size(); }
+  int getRunNumber() const { return mRunNumber; }
+
+  /// Returns the global bins of the chips [firstChip, lastChip) in a histogram of z (x axis) vs phi (y axis).
+  std::vector<int> getBins(const TH2* histogram, int firstChip, int lastChip) const;
+
+ private:
+  std::vector<ChipInfo> mChips;
+  int mRunNumber = 0;
+};
+
+} // namespace o2::quality_control_modules::its
+
+#endif // QC_MODULE_ITS_CHIPGEOMETRYCACHE_H
@@ -19,10 +19,14 @@
 #define QC_MODULE_ITS_ITSFHRTASK_H
 
 #include "QualityControl/TaskInterface.h"
+#include "QualityControl/ShardedHistogram.h"
+#include "ITS/PixelHitCounter.h"
+#include "ITS/ChipGeometryCache.h"
 #include <ITSMFTReconstruction/ChipMappingITS.h>
 #include <ITSMFTReconstruction/PixelData.h>
 #include <ITSBase/GeometryTGeo.h>
 #include <ITSMFTReconstruction/RawPixelDecoder.h>
+#include <DataFormatsITSMFT/Digit.h>
 
 #include <TText.h>
 #include <TH1.h>
@@ -73,6 +77,7 @@ class ITSFhrTask final : public TaskInterface
   void resetOccupancyPlots();
   void resetObject(TH1* obj);
   void getStavePoint(int layer, int stave, double* px, double* py); // prepare for fill TH2Poly, get all point for add TH2Poly bin
+  PixelHitCounter& getPixelHits(int stave, int hic, int chip) { return mPixelHits[(stave * nHicPerStave[mLayer] + hic) * nChipsPerHic[mLayer] + chip]; }
   // detector information
   static constexpr int NCols = 1024; // column number in Alpide chip
   static constexpr int NRows = 512;  // row number in Alpide chip
@@ -94,7 +99,6 @@ class ITSFhrTask final : public TaskInterface
   const float MidPointRad[7] = { 23.49, 31.586, 39.341, 197.598, 246.944, 345.348, 394.883 };                                                                                                                                                                               // mid point radius
 
   int mNThreads = 1;
-  std::unordered_map<unsigned int, int> mHitPixelID_Hash[7][48][2][14][14]; // layer, stave, substave, hic, chip
 
   o2::itsmft::RawPixelDecoder<o2::itsmft::ChipMappingITS>* mDecoder;
   ChipPixelData* mChipDataBuffer = nullptr;
@@ -114,16 +118,19 @@ class ITSFhrTask final : public TaskInterface
   float mPhysicalOccupancyOB = 4.3e-5;
   double mCutTFForSparse = 1; // cut to stop THnSparse filling after mCutTrgForSparse triggers
   int mDoHitmapFilter = 1;    // do filtering of noise pixel vector
-  std::unordered_map<unsigned int, int>*** mHitPixelID_InStave /* = new std::unordered_map<unsigned int, int>**[NStaves[lay]]*/;
+  std::vector<PixelHitCounter> mPixelHits; // hit number of each fired pixel, IB/OB : [stave][hic][chip], see getPixelHits()
   int** mHitnumberLane /* = new int*[NStaves[lay]]*/;       // IB : hitnumber[stave][chip]; OB : hitnumber[stave][lane]
   double** mOccupancyLane /* = new double*[NStaves[lay]]*/; // IB : occupancy[stave][chip]; OB : occupancy[stave][Lane]
   int*** mErrorCount /* = new int**[NStaves[lay]]*/;        // IB : errorcount[stave][FEE][errorid]
-  double** mChipPhi /* = new double*[NStaves[lay]]*/;       // IB/OB : mChipPhi[Stave][chip]
-  double** mChipZ /* = new double*[NStaves[lay]]*/;         // IB/OB : mChipZ[Stave][chip]
 
   int** mChipStat /* = new double*[NStaves[lay]]*/; // IB/OB : mChipStat[Stave][chip]
   int mNoisyPixelNumber[7][48] = { { 0 } };
 
+  // buffers used in each TF, kept to avoid allocating them again
+  std::vector<std::vector<o2::itsmft::Digit>> mDigitsPerHic;                        // IB : [stave][0]; OB : [stave][hic]
+  std::vector<int> mActiveStaves;                                                   // staves with at least one hit in the TF
+  std::vector<std::vector<PixelHitCounter::NoisyPixel>> mNoisyPixelsPerActiveStave; // noisy pixels found by each thread
+
   int mMaxGeneralAxisRange = -3;  // the range of TH2Poly plots z axis range, pow(10, mMinGeneralAxisRange) ~ pow(10, mMaxGeneralAxisRange)
   int mMinGeneralAxisRange = -12; //
   int mMaxGeneralNoisyAxisRange = 4000;
@@ -149,9 +156,12 @@ class ITSFhrTask final : public TaskInterface
   TH2D* mChipStaveOccupancy;
   TH2I* mChipStaveEventHitCheck;
   TH1D* mOccupancyPlot;
+  std::unique_ptr<ShardedHistogram<TH1D>> mOccupancyShards; // filled by the threads of the executor, merged before publication
 
-  // Geometry decoder
-  o2::its::GeometryTGeo* mGeom;
+  // Geometry of the chips, and global bins of the chips of the layer in mDeadChipPos/mAliveChipPos and in mTotalDeadChipPos/mTotalAliveChipPos
+  std::shared_ptr<const ChipGeometryCache> mChipGeometry;
+  std::vector<int> mChipPosBins;
+  std::vector<int> mTotalChipPosBins;
 };
 } // namespace o2::quality_control_modules::its
 
@@ -18,6 +18,7 @@
 #define QC_MODULE_ITS_ITSTHRESHOLDCALIBRATIONTASK_H
 
 #include "QualityControl/TaskInterface.h"
+#include "ITS/CalibrationRecords.h"
 #include <TH1D.h>
 #include <TH2D.h>
 #include <ITSBase/GeometryTGeo.h>
@@ -73,7 +74,6 @@ class ITSThresholdCalibrationTask : public TaskInterface
   void endOfCycle() override;
   void endOfActivity(Activity& activity) override;
   void reset() override;
-  std::vector<std::string> splitString(std::string, std::string);
 
  private:
   void publishHistos();
@@ -84,11 +84,12 @@ class ITSThresholdCalibrationTask : public TaskInterface
   Int_t getBarrel(Int_t iLayer);
   int getCurrentChip(int barrel, int chipid, int hic, int hs);
 
-  void doAnalysisTHR(string inString, int iScan);
-  void doAnalysisPixel(string inString);
+  void doAnalysisTHR(const CalibrationResStructTHR& result, int iScan);
+  void doAnalysisPixel(const CalibrationResStructPixel& result);
+  void fillChipDone(const CalibrationResStructTHR& result);
 
-  CalibrationResStructTHR CalibrationParserTHR(string input);
-  CalibrationResStructPixel CalibrationParserPixel(string input);
+  CalibrationResStructTHR CalibrationParserTHR(const ThresholdChipRecord& record);
+  CalibrationResStructPixel CalibrationParserPixel(const PixelChipRecord& record);
 
   std::vector<TObject*> mPublishedObjects;
 
@@ -0,0 +1,119 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   PixelHitCounter.h
+///
+
+#ifndef QC_MODULE_ITS_PIXELHITCOUNTER_H
+#define QC_MODULE_ITS_PIXELHITCOUNTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace o2::quality_control_modules::its
+{
+
+/// \brief Counts the hits of the fired pixels of one ALPIDE chip.
+///
+/// Only a small fraction of the 1024x512 pixels is fired, thus the counts are kept in a flat open-addressing hash table
+/// (linear probing, keys and counts in two contiguous arrays). Contrary to std::unordered_map, adding a hit does not
+/// allocate, unless the table has to grow, and clear() keeps the memory for the next use.
+class PixelHitCounter
+{
+ public:
+  static constexpr int NCols = 1024;
+  static constexpr int NRows = 512;
+
+  struct NoisyPixel {
+    uint16_t row;
+    uint16_t col;
+    uint32_t hits;
+  };
+
+  PixelHitCounter() = default;
+
+  /// Adds n hits to the pixel.
+  void add(uint16_t row, uint16_t col, uint32_t n = 1)
+  {
+    if ((mSize + 1) * 2 > mKeys.size()) { // we keep the load factor below 0.5, so that the probe sequences stay short
+      grow();
+    }
+    uint32_t key = makeKey(row, col);
+    size_t slot = findSlot(key);
+    if (mKeys[slot] == EmptyKey) {
+      mKeys[slot] = key;
+      mSize++;
+    }
+    mCounts[slot] += n;
+    mTotalHits += n;
+  }
+
+  /// Returns the number of hits of the pixel.
+  uint32_t get(uint16_t row, uint16_t col) const;
+  /// Returns the number of fired pixels.
+  size_t size() const { return mSize; }
+  bool empty() const { return mSize == 0; }
+  /// Returns the sum of the hits of all the pixels.
+  uint64_t getTotalHits() const { return mTotalHits; }
+  /// Forgets all the hits, but keeps the allocated memory.
+  void clear();
+
+  /// Calls function(row, col, hits) for each fired pixel, in an unspecified order.
+  template <typename F>
+  void forEach(F&& function) const
+  {
+    for (size_t slot = 0; slot < mKeys.size(); slot++) {
+      if (mKeys[slot] != EmptyKey) {
+        function(getRow(mKeys[slot]), getCol(mKeys[slot]), mCounts[slot]);
+      }
+    }
+  }
+
+  /// Removes the pixels with less than minOccupancy hits per trigger. Returns the number of removed pixels.
+  size_t removeBelowOccupancy(double nTriggers, double minOccupancy);
+
+  /// \brief Appends to noisyPixels the pixels which have more than minHits hits and more than minOccupancy hits per trigger.
+  /// Returns the number of pixels which were appended.
+  size_t extractNoisyPixels(double nTriggers, uint32_t minHits, double minOccupancy, std::vector<NoisyPixel>& noisyPixels) const;
+
+ private:
+  static constexpr uint32_t EmptyKey = 0xFFFFFFFF;
+
+  static uint32_t makeKey(uint16_t row, uint16_t col) { return static_cast<uint32_t>(row) * NCols + col; }
+  static uint16_t getRow(uint32_t key) { return key / NCols; }
+  static uint16_t getCol(uint32_t key) { return key % NCols; }
+
+  /// Returns the slot containing the key or the empty slot where it should be inserted.
+  size_t findSlot(uint32_t key) const
+  {
+    size_t mask = mKeys.size() - 1;
+    // Fibonacci hashing (the high bits of the product are used), neighbouring pixels end up in different slots
+    size_t slot = static_cast<uint32_t>(key * 2654435769u) >> mShift;
+    while (mKeys[slot] != key && mKeys[slot] != EmptyKey) {
+      slot = (slot + 1) & mask;
+    }
+    return slot;
+  }
+  void grow();
+  void rehash(size_t capacity);
+
+  std::vector<uint32_t> mKeys;
+  std::vector<uint32_t> mCounts;
+  unsigned int mShift = 32; // 32 - log2(capacity)
+  size_t mSize = 0;
+  uint64_t mTotalHits = 0;
+};
+
+} // namespace o2::quality_control_modules::its
+
+#endif // QC_MODULE_ITS_PIXELHITCOUNTER_H
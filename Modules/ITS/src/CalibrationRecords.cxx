@@ -0,0 +1,147 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CalibrationRecords.cxx
+///
+
+#include "ITS/CalibrationRecords.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace o2::quality_control_modules::its
+{
+
+namespace
+{
+
+// Calls f(name, value) for each "name:value" field, the fields being separated by ','.
+template <typename F>
+void forEachField(std::string_view text, F&& f)
+{
+  size_t start = 0;
+  while (start < text.size()) {
+    size_t end = std::min(text.find(',', start), text.size());
+    auto field = text.substr(start, end - start);
+    auto colon = field.find(':');
+    if (colon != std::string_view::npos) {
+      f(field.substr(0, colon), field.substr(colon + 1));
+    }
+    start = end + 1;
+  }
+}
+
+// The fields are not null-terminated, they are copied to a small buffer for strtod.
+bool toDouble(std::string_view value, double& result)
+{
+  char buffer[32];
+  if (value.empty() || value.size() >= sizeof(buffer)) {
+    return false;
+  }
+  std::memcpy(buffer, value.data(), value.size());
+  buffer[value.size()] = '\0';
+  char* end = nullptr;
+  result = std::strtod(buffer, &end);
+  return end != buffer;
+}
+
+bool toFloat(std::string_view value, float& result)
+{
+  double asDouble = 0;
+  if (!toDouble(value, asDouble)) {
+    return false;
+  }
+  result = static_cast<float>(asDouble);
+  return true;
+}
+
+bool toInt(std::string_view value, int32_t& result)
+{
+  double asDouble = 0; // as std::stod in the former parsers, which accepted e.g. "12.0"
+  if (!toDouble(value, asDouble)) {
+    return false;
+  }
+  result = static_cast<int32_t>(asDouble);
+  return true;
+}
+
+bool toChipID(std::string_view value, uint32_t& chipID)
+{
+  int32_t id = -1;
+  if (!toInt(value, id) || id < 0) {
+    return false;
+  }
+  chipID = id;
+  return true;
+}
+
+} // namespace
+
+bool parseThresholdRecord(std::string_view text, ThresholdChipRecord& record)
+{
+  record = ThresholdChipRecord{};
+  bool hasChipID = false;
+  forEachField(text, [&](std::string_view name, std::string_view value) {
+    if (name == "ChipID") {
+      hasChipID = toChipID(value, record.chipID);
+    } else if (name == "VCASN" || name == "THR" || name == "ITHR") {
+      toFloat(value, record.mainVal);
+    } else if (name == "Rms") {
+      toFloat(value, record.rms);
+    } else if (name == "Status") {
+      toFloat(value, record.status);
+    } else if (name == "Noise") {
+      toFloat(value, record.noise);
+    } else if (name == "NoiseRms") {
+      toFloat(value, record.noiseRms);
+    } else if (name == "Tot") {
+      toFloat(value, record.tot);
+    } else if (name == "TotRms") {
+      toFloat(value, record.totRms);
+    } else if (name == "Rt") {
+      toFloat(value, record.rt);
+    } else if (name == "RtRms") {
+      toFloat(value, record.rtRms);
+    }
+  });
+  return hasChipID;
+}
+
+bool parsePixelRecord(std::string_view text, PixelChipRecord& record)
+{
+  record = PixelChipRecord{};
+  bool hasChipID = false;
+  bool hasType = false;
+  forEachField(text, [&](std::string_view name, std::string_view value) {
+    if (name == "ChipID") {
+      hasChipID = toChipID(value, record.chipID);
+    } else if (name == "PixelType") {
+      hasType = true;
+      if (value == "Noisy") {
+        record.type = 0;
+      } else if (value == "Dead") {
+        record.type = 1;
+      } else if (value == "Ineff") {
+        record.type = 2;
+      } else {
+        hasType = false; // it would be counted as noisy otherwise
+      }
+    } else if (name == "PixelNos") {
+      toInt(value, record.counts);
+    } else if (name == "DcolNos") {
+      toInt(value, record.dcols);
+    }
+  });
+  return hasChipID && hasType;
+}
+
+} // namespace o2::quality_control_modules::its
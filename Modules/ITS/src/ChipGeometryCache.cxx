@@ -0,0 +1,74 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ChipGeometryCache.cxx
+///
+
+#include "ITS/ChipGeometryCache.h"
+#include "QualityControl/QcInfoLogger.h"
+
+#include <ITSBase/GeometryTGeo.h>
+#include <TH2.h>
+#include <TMath.h>
+
+#include <mutex>
+
+namespace o2::quality_control_modules::its
+{
+
+std::shared_ptr<const ChipGeometryCache> ChipGeometryCache::get(int runNumber)
+{
+  static std::mutex mutex;
+  static std::shared_ptr<const ChipGeometryCache> cache;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!cache || cache->getRunNumber() != runNumber) {
+    auto* geometry = o2::its::GeometryTGeo::Instance();
+    geometry->fillMatrixCache(o2::math_utils::bit2Mask(o2::math_utils::TransformType::L2G));
+    cache = std::make_shared<const ChipGeometryCache>(computeChips(*geometry), runNumber);
+    ILOG(Debug, Devel) << "ITS chip geometry computed for run " << runNumber << ENDM;
+  }
+  return cache;
+}
+
+std::vector<ChipGeometryCache::ChipInfo> ChipGeometryCache::computeChips(const o2::its::GeometryTGeo& geometry)
+{
+  std::vector<ChipInfo> chips(NChips);
+  const o2::math_utils::Point3D<float> loc(0., 0., 0.);
+  for (int ichip = 0; ichip < NChips; ichip++) {
+    auto glo = geometry.getMatrixL2G(ichip)(loc);
+    int lay, sta, ssta, mod, chip;
+    geometry.getChipId(ichip, lay, sta, ssta, mod, chip);
+    auto& info = chips[ichip];
+    info.phi = glo.phi() * 180 / TMath::Pi();
+    info.z = glo.Z();
+    info.layer = lay;
+    info.stave = sta;
+    info.subStave = ssta;
+    info.module = mod;
+    info.chipInModule = chip;
+  }
+  return chips;
+}
+
+std::vector<int> ChipGeometryCache::getBins(const TH2* histogram, int firstChip, int lastChip) const
+{
+  std::vector<int> bins;
+  bins.reserve(lastChip - firstChip);
+  for (int ichip = firstChip; ichip < lastChip; ichip++) {
+    const auto& info = mChips[ichip];
+    bins.push_back(histogram->GetBin(histogram->GetXaxis()->FindFixBin(info.z), histogram->GetYaxis()->FindFixBin(info.phi)));
+  }
+  return bins;
+}
+
+} // namespace o2::quality_control_modules::its
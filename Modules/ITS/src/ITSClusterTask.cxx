@@ -139,8 +139,8 @@ void ITSClusterTask::startOfCycle()
 void ITSClusterTask::monitorData(o2::framework::ProcessingContext& ctx)
 {
   if (ctx.services().get<o2::framework::TimingInfo>().globalRunNumberChanged) {
-    mGeom = o2::its::GeometryTGeo::Instance();
-    mGeom->fillMatrixCache(o2::math_utils::bit2Mask(o2::math_utils::TransformType::L2G));
+    mChipGeometry = ChipGeometryCache::get(ctx.services().get<o2::framework::TimingInfo>().runNumber);
+    mGeom = o2::its::GeometryTGeo::Instance(); // its L2G matrices are filled by ChipGeometryCache
   }
 
   if (mTimestamp == -1) { // get dict from ccdb
@@ -196,7 +196,12 @@ void ITSClusterTask::monitorData(o2::framework::ProcessingContext& ctx)
       int lay, sta, ssta, mod, chip, lane;
 
       if (ChipID != ChipIDprev) {
-        mGeom->getChipId(ChipID, lay, sta, ssta, mod, chip);
+        const auto& chipInfo = (*mChipGeometry)[ChipID];
+        lay = chipInfo.layer;
+        sta = chipInfo.stave;
+        ssta = chipInfo.subStave;
+        mod = chipInfo.module;
+        chip = chipInfo.chipInModule;
         mod = mod + (ssta * (mNHicPerStave[lay] / 2));
         int chipIdLocal = (ChipID - ChipBoundary[lay]) % (14 * mNHicPerStave[lay]);
         lane = (chipIdLocal % (14 * mNHicPerStave[lay])) / (14 / 2);
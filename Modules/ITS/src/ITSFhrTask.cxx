@@ -25,10 +25,7 @@
 #include "Framework/TimingInfo.h"
 
 #include "Common/Utils.h"
-
-#ifdef WITH_OPENMP
-#include <omp.h>
-#endif
+#include "QualityControl/ThreadPool.h"
 
 using namespace o2::framework;
 using namespace o2::itsmft;
@@ -63,26 +60,17 @@ ITSFhrTask::~ITSFhrTask()
   for (int istave = 0; istave < NStaves[mLayer]; istave++) {
     delete[] mHitnumberLane[istave];
     delete[] mOccupancyLane[istave];
-    delete[] mChipPhi[istave];
-    delete[] mChipZ[istave];
     delete[] mChipStat[istave];
     int maxlink = mLayer < NLayerIB ? 3 : 2;
     for (int ilink = 0; ilink < maxlink; ilink++) {
       delete[] mErrorCount[istave][ilink];
     }
     delete[] mErrorCount[istave];
-    for (int ihic = 0; ihic < nHicPerStave[mLayer]; ihic++) {
-      delete[] mHitPixelID_InStave[istave][ihic];
-    }
-    delete[] mHitPixelID_InStave[istave];
   }
   delete[] mHitnumberLane;
   delete[] mOccupancyLane;
-  delete[] mChipPhi;
-  delete[] mChipZ;
   delete[] mChipStat;
   delete[] mErrorCount;
-  delete[] mHitPixelID_InStave;
 }
 
 void ITSFhrTask::initialize(o2::framework::InitContext& /*ctx*/)
@@ -116,11 +104,10 @@ void ITSFhrTask::initialize(o2::framework::InitContext& /*ctx*/)
 
   if (mLayer != -1) {
     // define the hitnumber, occupancy, errorcount array
-    mHitPixelID_InStave = new std::unordered_map<unsigned int, int>**[NStaves[mLayer]];
+    mPixelHits.resize(NStaves[mLayer] * nHicPerStave[mLayer] * nChipsPerHic[mLayer]);
+    mDigitsPerHic.resize(NStaves[mLayer] * nHicPerStave[mLayer]);
     mHitnumberLane = new int*[NStaves[mLayer]];
     mOccupancyLane = new double*[NStaves[mLayer]];
-    mChipPhi = new double*[NStaves[mLayer]];
-    mChipZ = new double*[NStaves[mLayer]];
 
     mChipStat = new int*[NStaves[mLayer]];
     mErrorCount = new int**[NStaves[mLayer]];
@@ -173,19 +160,11 @@ void ITSFhrTask::initialize(o2::framework::InitContext& /*ctx*/)
       for (int istave = 0; istave < NStaves[mLayer]; istave++) {
         mHitnumberLane[istave] = new int[nChipsPerHic[mLayer]];
         mOccupancyLane[istave] = new double[nChipsPerHic[mLayer]];
-        mChipPhi[istave] = new double[nChipsPerHic[mLayer]];
-        mChipZ[istave] = new double[nChipsPerHic[mLayer]];
 
         mChipStat[istave] = new int[nChipsPerHic[mLayer]];
-        mHitPixelID_InStave[istave] = new std::unordered_map<unsigned int, int>*[nHicPerStave[mLayer]];
-        for (int ihic = 0; ihic < nHicPerStave[mLayer]; ihic++) {
-          mHitPixelID_InStave[istave][ihic] = new std::unordered_map<unsigned int, int>[nChipsPerHic[mLayer]];
-        }
         for (int ichip = 0; ichip < nChipsPerHic[mLayer]; ichip++) {
           mHitnumberLane[istave][ichip] = 0;
           mOccupancyLane[istave][ichip] = 0;
-          mChipPhi[istave][ichip] = 0;
-          mChipZ[istave][ichip] = 0;
 
           mChipStat[istave][ichip] = 0;
           mChipStaveOccupancy->GetXaxis()->SetBinLabel(ichip + 1, Form("Chip %i", ichip));
@@ -196,17 +175,9 @@ void ITSFhrTask::initialize(o2::framework::InitContext& /*ctx*/)
       for (int istave = 0; istave < NStaves[mLayer]; istave++) {
         mHitnumberLane[istave] = new int[nHicPerStave[mLayer] * 2];
         mOccupancyLane[istave] = new double[nHicPerStave[mLayer] * 2];
-        mChipPhi[istave] = new double[nHicPerStave[mLayer] * nChipsPerHic[mLayer]];
-        mChipZ[istave] = new double[nHicPerStave[mLayer] * nChipsPerHic[mLayer]];
 
         mChipStat[istave] = new int[nHicPerStave[mLayer] * nChipsPerHic[mLayer]];
-        mHitPixelID_InStave[istave] = new std::unordered_map<unsigned int, int>*[nHicPerStave[mLayer]];
-        for (int ihic = 0; ihic < nHicPerStave[mLayer]; ihic++) {
-          mHitPixelID_InStave[istave][ihic] = new std::unordered_map<unsigned int, int>[nChipsPerHic[mLayer]];
-        }
         for (int ichip = 0; ichip < nHicPerStave[mLayer] * nChipsPerHic[mLayer]; ichip++) {
-          mChipPhi[istave][ichip] = 0;
-          mChipZ[istave][ichip] = 0;
 
           mChipStat[istave][ichip] = 0;
         }
@@ -301,7 +272,8 @@ void ITSFhrTask::createOccupancyPlots() // create general plots like error, trig
     getObjectsManager()->startPublishing(mChipStaveEventHitCheck);
 
     mOccupancyPlot = new TH1D(Form("Occupancy/Layer%dOccupancy", mLayer), Form("ITS Layer %d Noise pixels occupancy distribution", mLayer), 300, -15, 0);
-    getObjectsManager()->startPublishing(mOccupancyPlot); // mOccupancyPlot
+    mOccupancyShards = std::make_unique<ShardedHistogram<TH1D>>(mOccupancyPlot, getExecutor().size() + 1);
+    getObjectsManager()->startPublishing(mOccupancyShards.get()); // mOccupancyPlot
 
   } else {
     // Create OB plots
@@ -325,7 +297,8 @@ void ITSFhrTask::createOccupancyPlots() // create general plots like error, trig
     getObjectsManager()->startPublishing(mChipStaveEventHitCheck);
 
     mOccupancyPlot = new TH1D(Form("Occupancy/Layer%dOccupancy", mLayer), Form("ITS Layer %d Noise pixels occupancy Distribution", mLayer), 300, -15, 0);
-    getObjectsManager()->startPublishing(mOccupancyPlot); // mOccupancyPlot
+    mOccupancyShards = std::make_unique<ShardedHistogram<TH1D>>(mOccupancyPlot, getExecutor().size() + 1);
+    getObjectsManager()->startPublishing(mOccupancyShards.get()); // mOccupancyPlot
   }
 }
 
@@ -389,8 +362,10 @@ void ITSFhrTask::startOfCycle() { ILOG(Debug, Devel) << "startOfCycle" << ENDM;
 void ITSFhrTask::monitorData(o2::framework::ProcessingContext& ctx)
 {
   if (ctx.services().get<o2::framework::TimingInfo>().globalRunNumberChanged) {
-    mGeom = o2::its::GeometryTGeo::Instance();
-    mGeom->fillMatrixCache(o2::math_utils::bit2Mask(o2::math_utils::TransformType::L2G));
+    // the positions of the chips of this layer in the dead/alive chip maps
+    mChipGeometry = ChipGeometryCache::get(ctx.services().get<o2::framework::TimingInfo>().runNumber);
+    mChipPosBins = mChipGeometry->getBins(mDeadChipPos, ChipBoundary[mLayer], ChipBoundary[mLayer + 1]);
+    mTotalChipPosBins = mChipGeometry->getBins(mTotalDeadChipPos, ChipBoundary[mLayer], ChipBoundary[mLayer + 1]);
   }
   // set timer
   std::chrono::time_point<std::chrono::high_resolution_clock> start;
@@ -402,38 +377,13 @@ void ITSFhrTask::monitorData(o2::framework::ProcessingContext& ctx)
   mDecoder->startNewTF(ctx.inputs());
   mDecoder->setDecodeNextAuto(true);
 
-  // define digit hit vector
-  std::vector<Digit>** digVec = new std::vector<Digit>*[NStaves[mLayer]]; // IB : digVec[stave][0]; OB : digVec[stave][hic]
-  const math_utils::Point3D<float> loc(0., 0., 0.);
-
-  if (mLayer < NLayerIB) {
-    for (int istave = 0; istave < NStaves[mLayer]; istave++) {
-      digVec[istave] = new std::vector<Digit>[nHicPerStave[mLayer]];
-    }
-  } else {
-    for (int istave = 0; istave < NStaves[mLayer]; istave++) {
-      digVec[istave] = new std::vector<Digit>[nHicPerStave[mLayer]];
-    }
+  // digit hit vectors, IB : [stave][0]; OB : [stave][hic]. They keep their capacity from one TF to the next.
+  for (auto& digits : mDigitsPerHic) {
+    digits.clear();
   }
+  auto digVec = [this](int stave, int hic) -> std::vector<Digit>& { return mDigitsPerHic[stave * nHicPerStave[mLayer] + hic]; };
 
   // decode raw data and save digit hit to digit hit vector, and save hitnumber per chip/hic
-  // get the position of all chips in this layer
-  for (int ichip = ChipBoundary[mLayer]; ichip < ChipBoundary[mLayer + 1]; ichip++) {
-    int stave = 0, chip = 0;
-    auto glo = mGeom->getMatrixL2G(ichip)(loc);
-    if (mLayer < NLayerIB) {
-      stave = ichip / 9 - StaveBoundary[mLayer];
-      chip = ichip % 9;
-      mChipPhi[stave][chip] = glo.phi() * 180 / TMath::Pi();
-      mChipZ[stave][chip] = glo.Z();
-    } else {
-      stave = (ichip - ChipBoundary[mLayer]) / (14 * nHicPerStave[mLayer]);
-      chip = (ichip - ChipBoundary[mLayer]) % (14 * nHicPerStave[mLayer]);
-      mChipPhi[stave][chip] = glo.phi() * 180 / TMath::Pi();
-      mChipZ[stave][chip] = glo.Z();
-    }
-  }
-
   while ((mChipDataBuffer = mDecoder->getNextChipData(mChipsBuffer))) {
     if (mChipDataBuffer) {
       int stave = 0, chip = 0;
@@ -461,7 +411,7 @@ void ITSFhrTask::monitorData(o2::framework::ProcessingContext& ctx)
           mHitnumberLane[stave][lane]++;
           mChipStat[stave][chipIdLocal]++;
         }
-        digVec[stave][hic].emplace_back(mChipDataBuffer->getChipID(), pixel.getRow(), pixel.getCol());
+        digVec(stave, hic).emplace_back(mChipDataBuffer->getChipID(), pixel.getRow(), pixel.getCol());
       }
       if (mLayer < NLayerIB) {
         if (pixels.size() > (unsigned int)mHitCutForCheck) {
@@ -476,29 +426,24 @@ void ITSFhrTask::monitorData(o2::framework::ProcessingContext& ctx)
   }
 
   // calculate active staves according digit hit vector
-  std::vector<int> activeStaves;
+  auto& activeStaves = mActiveStaves;
+  activeStaves.clear();
   for (int i = 0; i < NStaves[mLayer]; i++) {
     for (int j = 0; j < nHicPerStave[mLayer]; j++) {
-      if (digVec[i][j].size() != 0) {
+      if (digVec(i, j).size() != 0) {
         activeStaves.push_back(i);
         break;
       }
     }
   }
 
-#ifdef WITH_OPENMP
-  omp_set_num_threads(mNThreads);
-#pragma omp parallel for schedule(dynamic)
-#endif
-  // save digit hit vector to unordered_map by openMP multiple threads
-  // the reason of this step is: it will spend many time If we THnSparse::Fill the THnspase hit by hit.
-  // So we want save hit information to undordered_map and fill THnSparse by THnSparse::SetBinContent (pixel by pixel)
-  for (int i = 0; i < (int)activeStaves.size(); i++) {
+  // count the hits of each pixel with the task executor, each thread works on its own staves
+  getExecutor().parallelFor(activeStaves.size(), [&](size_t i) {
     int istave = activeStaves[i];
     if (mLayer < NLayerIB) {
-      for (auto& digit : digVec[istave][0]) {
+      for (auto& digit : digVec(istave, 0)) {
         int chip = digit.getChipIndex() % 9;
-        mHitPixelID_InStave[istave][0][chip][1000 * digit.getColumn() + digit.getRow()]++;
+        getPixelHits(istave, 0, chip).add(digit.getRow(), digit.getColumn());
         if (mTFCount <= mCutTFForSparse) {
           Double_t pixelPos[2] = { digit.getColumn() + (1024 * chip) + 1., digit.getRow() + 1. };
           mStaveHitmap[istave]->Fill(pixelPos);
@@ -506,9 +451,9 @@ void ITSFhrTask::monitorData(o2::framework::ProcessingContext& ctx)
       }
     } else {
       for (int ihic = 0; ihic < nHicPerStave[mLayer]; ihic++) {
-        for (auto& digit : digVec[istave][ihic]) {
+        for (auto& digit : digVec(istave, ihic)) {
           int chip = ((digit.getChipIndex() - ChipBoundary[mLayer]) % (14 * nHicPerStave[mLayer])) % 14;
-          mHitPixelID_InStave[istave][ihic][chip][1000 * digit.getColumn() + digit.getRow()]++;
+          getPixelHits(istave, ihic, chip).add(digit.getRow(), digit.getColumn());
           int ilink = ihic / (nHicPerStave[mLayer] / 2);
           if (mTFCount <= mCutTFForSparse) {
             if (chip < 7) {
@@ -522,35 +467,31 @@ void ITSFhrTask::monitorData(o2::framework::ProcessingContext& ctx)
         }
       }
     }
-  }
+  });
 
   // Reset Error plots
   mErrorPlots->Reset();
   mErrorVsFeeid->Reset(); // Error is   statistic by decoder so if we didn't reset decoder, then we need reset Error plots, and use TH::SetBinContent function
 
-  // define tmp occupancy plot, which will use for multiple threads
-  TH1D** occupancyPlotTmp = new TH1D*[(int)activeStaves.size()];
-  for (int i = 0; i < (int)activeStaves.size(); i++) {
-    occupancyPlotTmp[i] = new TH1D("", "", 300, -15, 0);
+  // noisy pixels found by each thread, their occupancies are filled in the shard of the thread
+  if (mNoisyPixelsPerActiveStave.size() < activeStaves.size()) {
+    mNoisyPixelsPerActiveStave.resize(activeStaves.size());
   }
+  const uint32_t hitCutForNoisyPixel = std::max(mHitCutForNoisyPixel, 0);
 
-  int totalhit = 0;
-#ifdef WITH_OPENMP
-  omp_set_num_threads(mNThreads);
-#pragma omp parallel for schedule(dynamic) reduction(+ \
-                                                     : totalhit)
-#endif
-  // fill Monitor Objects use openMP multiple threads, and calculate the occupancy
-  for (int i = 0; i < (int)activeStaves.size(); i++) {
+  // fill Monitor Objects with the task executor, and calculate the occupancy
+  getExecutor().parallelFor(activeStaves.size(), [&](size_t i) {
     int istave = activeStaves[i];
-    if (digVec[istave][0].size() < 1 && mLayer < NLayerIB) {
-      continue;
+    auto& occupancyShard = mOccupancyShards->shard(getExecutor().getThreadIndex());
+    auto& noisyPixels = mNoisyPixelsPerActiveStave[i];
+    if (digVec(istave, 0).size() < 1 && mLayer < NLayerIB) {
+      return;
     }
     const auto* DecoderTmp = mDecoder;
     int RUid = StaveBoundary[mLayer] + istave;
     const o2::itsmft::RUDecodeData* RUdecode = DecoderTmp->getRUDecode(RUid);
     if (!RUdecode) {
-      continue;
+      return;
     }
     if (mLayer < NLayerIB) {
       for (int ilink = 0; ilink < RUDecodeData::MaxLinksPerRU; ilink++) {
@@ -561,25 +502,17 @@ void ITSFhrTask::monitorData(o2::framework::ProcessingContext& ctx)
 
         mNoisyPixelNumber[mLayer][istave] = 0;
         for (int ichip = 0 + (ilink * 3); ichip < (ilink * 3) + 3; ichip++) {
-          std::unordered_map<unsigned int, int>::iterator iter;
+          auto& pixelHits = getPixelHits(istave, 0, ichip);
+          double nTriggers = GBTLinkInfo->statistics.nTriggers;
 
           if (mDoHitmapFilter == 1) {
-            for (auto iter = mHitPixelID_InStave[istave][0][ichip].begin(); iter != mHitPixelID_InStave[istave][0][ichip].end();) {
-              if ((double)iter->second / GBTLinkInfo->statistics.nTriggers < mPhysicalOccupancyIB) { // 40 hits/cm^2 * 5 pixels/hits * 4.5 cm^2 / 1024 / 512 = 1.7e-3/pixel/event for physics
-                mHitPixelID_InStave[istave][0][ichip].erase(iter++);
-              } else
-                ++iter;
-            }
+            pixelHits.removeBelowOccupancy(nTriggers, mPhysicalOccupancyIB); // 40 hits/cm^2 * 5 pixels/hits * 4.5 cm^2 / 1024 / 512 = 1.7e-3/pixel/event for physics
           }
 
-          for (auto iter = mHitPixelID_InStave[istave][0][ichip].begin(); iter != mHitPixelID_InStave[istave][0][ichip].end(); iter++) {
-            if ((iter->second > mHitCutForNoisyPixel) &&
-                (iter->second / (double)GBTLinkInfo->statistics.nTriggers) > mOccupancyCutForNoisyPixel) {
-              mNoisyPixelNumber[mLayer][istave]++; // count only in 10000 events as soon as nTriggers is 1e6
-              occupancyPlotTmp[i]->Fill(log10((double)iter->second / GBTLinkInfo->statistics.nTriggers));
-            }
-
-            totalhit += (int)iter->second;
+          noisyPixels.clear();
+          mNoisyPixelNumber[mLayer][istave] += pixelHits.extractNoisyPixels(nTriggers, hitCutForNoisyPixel, mOccupancyCutForNoisyPixel, noisyPixels); // count only in 10000 events as soon as nTriggers is 1e6
+          for (const auto& noisyPixel : noisyPixels) {
+            occupancyShard.fill(log10(noisyPixel.hits / nTriggers));
           }
 
           mOccupancyLane[istave][ichip] = mHitnumberLane[istave][ichip] / (GBTLinkInfo->statistics.nTriggers * 1024. * 512.);
@@ -603,21 +536,16 @@ void ITSFhrTask::monitorData(o2::framework::ProcessingContext& ctx)
         for (int ihic = 0; ihic < ((nHicPerStave[mLayer] / NSubStave[mLayer])); ihic++) {
           for (int ichip = 0; ichip < nChipsPerHic[mLayer]; ichip++) {
             if (GBTLinkInfo->statistics.nTriggers > 0) {
+              auto& pixelHits = getPixelHits(istave, ihic + ilink * ((nHicPerStave[mLayer] / NSubStave[mLayer])), ichip);
+              double nTriggers = GBTLinkInfo->statistics.nTriggers;
 
               if (mDoHitmapFilter == 1) {
-                for (auto iter = mHitPixelID_InStave[istave][ihic + ilink * ((nHicPerStave[mLayer] / NSubStave[mLayer]))][ichip].begin(); iter != mHitPixelID_InStave[istave][ihic + ilink * ((nHicPerStave[mLayer] / NSubStave[mLayer]))][ichip].end();) {
-                  if ((double)iter->second / GBTLinkInfo->statistics.nTriggers < mPhysicalOccupancyOB) { // 1 hits/cm^2 * 5 pixels/hits * 4.5 cm^2 / 1024 / 512 = 4.3e-5/pixel/event`
-                    mHitPixelID_InStave[istave][ihic + ilink * ((nHicPerStave[mLayer] / NSubStave[mLayer]))][ichip].erase(iter++);
-                  } else
-                    ++iter;
-                }
+                pixelHits.removeBelowOccupancy(nTriggers, mPhysicalOccupancyOB); // 1 hits/cm^2 * 5 pixels/hits * 4.5 cm^2 / 1024 / 512 = 4.3e-5/pixel/event`
               }
-              for (auto iter = mHitPixelID_InStave[istave][ihic + ilink * ((nHicPerStave[mLayer] / NSubStave[mLayer]))][ichip].begin(); iter != mHitPixelID_InStave[istave][ihic + ilink * ((nHicPerStave[mLayer] / NSubStave[mLayer]))][ichip].end(); iter++) {
-                if ((iter->second > mHitCutForNoisyPixel) &&
-                    (iter->second / (double)GBTLinkInfo->statistics.nTriggers) > mOccupancyCutForNoisyPixel) {
-                  mNoisyPixelNumber[mLayer][istave]++;
-                  occupancyPlotTmp[i]->Fill(log10((double)iter->second / GBTLinkInfo->statistics.nTriggers));
-                }
+              noisyPixels.clear();
+              mNoisyPixelNumber[mLayer][istave] += pixelHits.extractNoisyPixels(nTriggers, hitCutForNoisyPixel, mOccupancyCutForNoisyPixel, noisyPixels);
+              for (const auto& noisyPixel : noisyPixels) {
+                occupancyShard.fill(log10(noisyPixel.hits / nTriggers));
               }
             }
           }
@@ -638,22 +566,22 @@ void ITSFhrTask::monitorData(o2::framework::ProcessingContext& ctx)
         }
       }
     }
-  }
+  });
   // fill Occupancy plots, chip stave occupancy plots and error statistic plots
   for (int i = 0; i < (int)activeStaves.size(); i++) {
     int istave = activeStaves[i];
-    mOccupancyPlot->Add(occupancyPlotTmp[i]);
     if (mLayer < NLayerIB) {
       for (int ichip = 0; ichip < nChipsPerHic[mLayer]; ichip++) {
+        int chipIndex = istave * nChipsPerHic[mLayer] + ichip;
         mChipStaveOccupancy->SetBinContent(ichip + 1, istave + 1, mOccupancyLane[istave][ichip]);
         if (!mChipStat[istave][ichip]) {
-          mDeadChipPos->SetBinContent(mDeadChipPos->GetXaxis()->FindBin(mChipZ[istave][ichip]), mDeadChipPos->GetYaxis()->FindBin(mChipPhi[istave][ichip]), 1);
-          mTotalDeadChipPos->SetBinContent(mTotalDeadChipPos->GetXaxis()->FindBin(mChipZ[istave][ichip]), mTotalDeadChipPos->GetYaxis()->FindBin(mChipPhi[istave][ichip]), 1);
+          mDeadChipPos->SetBinContent(mChipPosBins[chipIndex], 1);
+          mTotalDeadChipPos->SetBinContent(mTotalChipPosBins[chipIndex], 1);
         } else {
-          mAliveChipPos->SetBinContent(mAliveChipPos->GetXaxis()->FindBin(mChipZ[istave][ichip]), mAliveChipPos->GetYaxis()->FindBin(mChipPhi[istave][ichip]), 1);
-          mTotalAliveChipPos->SetBinContent(mTotalAliveChipPos->GetXaxis()->FindBin(mChipZ[istave][ichip]), mTotalAliveChipPos->GetYaxis()->FindBin(mChipPhi[istave][ichip]), 1);
-          mDeadChipPos->SetBinContent(mDeadChipPos->GetXaxis()->FindBin(mChipZ[istave][ichip]), mDeadChipPos->GetYaxis()->FindBin(mChipPhi[istave][ichip]), 0);                // not dead
-          mTotalDeadChipPos->SetBinContent(mTotalDeadChipPos->GetXaxis()->FindBin(mChipZ[istave][ichip]), mTotalDeadChipPos->GetYaxis()->FindBin(mChipPhi[istave][ichip]), 0); // not dead
+          mAliveChipPos->SetBinContent(mChipPosBins[chipIndex], 1);
+          mTotalAliveChipPos->SetBinContent(mTotalChipPosBins[chipIndex], 1);
+          mDeadChipPos->SetBinContent(mChipPosBins[chipIndex], 0);           // not dead
+          mTotalDeadChipPos->SetBinContent(mTotalChipPosBins[chipIndex], 0); // not dead
         }
         int ilink = ichip / 3;
         for (int ierror = 0; ierror < o2::itsmft::GBTLinkDecodingStat::NErrorsDefined; ierror++) {
@@ -666,14 +594,15 @@ void ITSFhrTask::monitorData(o2::framework::ProcessingContext& ctx)
       mGeneralNoisyPixel->SetBinContent(istave + 1 + StaveBoundary[mLayer], mNoisyPixelNumber[mLayer][istave]);
     } else {
       for (int ichip = 0; ichip < nHicPerStave[mLayer] * nChipsPerHic[mLayer]; ichip++) {
+        int chipIndex = istave * nHicPerStave[mLayer] * nChipsPerHic[mLayer] + ichip;
         if (!mChipStat[istave][ichip]) {
-          mDeadChipPos->SetBinContent(mDeadChipPos->GetXaxis()->FindBin(mChipZ[istave][ichip]), mDeadChipPos->GetYaxis()->FindBin(mChipPhi[istave][ichip]), 1);
-          mTotalDeadChipPos->SetBinContent(mTotalDeadChipPos->GetXaxis()->FindBin(mChipZ[istave][ichip]), mTotalDeadChipPos->GetYaxis()->FindBin(mChipPhi[istave][ichip]), 1);
+          mDeadChipPos->SetBinContent(mChipPosBins[chipIndex], 1);
+          mTotalDeadChipPos->SetBinContent(mTotalChipPosBins[chipIndex], 1);
         } else {
-          mAliveChipPos->SetBinContent(mAliveChipPos->GetXaxis()->FindBin(mChipZ[istave][ichip]), mAliveChipPos->GetYaxis()->FindBin(mChipPhi[istave][ichip]), 1);
-          mTotalAliveChipPos->SetBinContent(mTotalAliveChipPos->GetXaxis()->FindBin(mChipZ[istave][ichip]), mTotalAliveChipPos->GetYaxis()->FindBin(mChipPhi[istave][ichip]), 1);
-          mDeadChipPos->SetBinContent(mDeadChipPos->GetXaxis()->FindBin(mChipZ[istave][ichip]), mDeadChipPos->GetYaxis()->FindBin(mChipPhi[istave][ichip]), 0);                // not dead
-          mTotalDeadChipPos->SetBinContent(mTotalDeadChipPos->GetXaxis()->FindBin(mChipZ[istave][ichip]), mTotalDeadChipPos->GetYaxis()->FindBin(mChipPhi[istave][ichip]), 0); // not dead
+          mAliveChipPos->SetBinContent(mChipPosBins[chipIndex], 1);
+          mTotalAliveChipPos->SetBinContent(mTotalChipPosBins[chipIndex], 1);
+          mDeadChipPos->SetBinContent(mChipPosBins[chipIndex], 0);           // not dead
+          mTotalDeadChipPos->SetBinContent(mTotalChipPosBins[chipIndex], 0); // not dead
         }
       }
 
@@ -702,17 +631,6 @@ void ITSFhrTask::monitorData(o2::framework::ProcessingContext& ctx)
     mErrorPlots->SetBinContent(ierror + 1, feeError);
   }
 
-  // delete pointor in monitorData()
-  for (int istave = 0; istave < NStaves[mLayer]; istave++) {
-    delete[] digVec[istave];
-  }
-  delete[] digVec;
-
-  for (int i = 0; i < (int)activeStaves.size(); i++) {
-    delete occupancyPlotTmp[i];
-  }
-  delete[] occupancyPlotTmp;
-
   end = std::chrono::high_resolution_clock::now();
   difference = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
 
@@ -762,7 +680,7 @@ void ITSFhrTask::resetOccupancyPlots()
   memset(mErrors, 0, sizeof(mErrors));
   mChipStaveOccupancy->Reset();
   mChipStaveEventHitCheck->Reset();
-  mOccupancyPlot->Reset();
+  mOccupancyShards->reset();
   mDeadChipPos->Reset();
   mAliveChipPos->Reset();
   mTotalDeadChipPos->Reset();
@@ -798,7 +716,7 @@ void ITSFhrTask::reset()
       for (int ichip = 0; ichip < nChipsPerHic[mLayer]; ichip++) {
         mHitnumberLane[istave][ichip] = 0;
         mOccupancyLane[istave][ichip] = 0;
-        mHitPixelID_InStave[istave][0][ichip].clear();
+        getPixelHits(istave, 0, ichip).clear();
       }
     }
   } else {
@@ -814,7 +732,7 @@ void ITSFhrTask::reset()
         mOccupancyLane[istave][2 * ihic] = 0;
         mOccupancyLane[istave][2 * ihic + 1] = 0;
         for (int ichip = 0; ichip < nChipsPerHic[mLayer]; ichip++) {
-          mHitPixelID_InStave[istave][ihic][ichip].clear();
+          getPixelHits(istave, ihic, ichip).clear();
         }
       }
     }
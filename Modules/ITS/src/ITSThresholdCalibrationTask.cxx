@@ -32,6 +32,62 @@ using namespace o2::its;
 namespace o2::quality_control_modules::its
 {
 
+namespace
+{
+
+/// The chip results received in one kind of input: the binary records are kept in place, the text payloads are
+/// concatenated and parsed afterwards.
+template <typename Record>
+struct ChipResultsInput {
+  std::string text;
+  std::vector<gsl::span<const Record>> records;
+  std::vector<std::vector<Record>> alignedCopies; // only used for the payloads which are not aligned
+  size_t nInvalid = 0;
+
+  void add(gsl::span<const char> payload)
+  {
+    if (!hasRecordsHeader(payload)) {
+      auto size = payload.size();
+      while (size > 0 && payload[size - 1] == '\0') { // the strings may be sent with their terminating null character
+        size--;
+      }
+      text.append(payload.data(), size);
+      return;
+    }
+    alignedCopies.emplace_back();
+    auto payloadRecords = getRecords(payload, alignedCopies.back());
+    if (payloadRecords.empty() && payload.size() > sizeof(CalibrationRecordsHeader)) {
+      nInvalid++;
+    }
+    records.push_back(payloadRecords);
+  }
+
+  /// Calls f for each record which describes one of the nChips chips, the other ones are counted in nInvalid.
+  template <typename F>
+  void forEach(bool (*parse)(std::string_view, Record&), uint32_t nChips, F&& f)
+  {
+    for (const auto& payloadRecords : records) {
+      for (const auto& record : payloadRecords) {
+        if (isValidRecord(record, nChips)) {
+          f(record);
+        } else {
+          nInvalid++;
+        }
+      }
+    }
+    Record parsed;
+    forEachTextRecord(text, [&](std::string_view textRecord) {
+      if (parse(textRecord, parsed) && isValidRecord(parsed, nChips)) {
+        f(parsed);
+      } else {
+        nInvalid++;
+      }
+    });
+  }
+};
+
+} // namespace
+
 ITSThresholdCalibrationTask::ITSThresholdCalibrationTask() : TaskInterface()
 {
 }
@@ -99,23 +155,21 @@ void ITSThresholdCalibrationTask::startOfCycle()
 void ITSThresholdCalibrationTask::monitorData(o2::framework::ProcessingContext& ctx)
 {
 
-  string inStringChipDone, inString, inPixel;
+  ChipResultsInput<ThresholdChipRecord> inputTHR, inputChipDone;
+  ChipResultsInput<PixelChipRecord> inputPixel;
   char scanType;
   for (auto&& input : o2::framework::InputRecordWalker(ctx.inputs())) {
     if (input.header != nullptr && input.payload != nullptr) {
       const auto* header = o2::framework::DataRefUtils::getHeader<header::DataHeader*>(input);
 
       if ((strcmp(header->dataOrigin.str, "ITS") == 0) && (strcmp(header->dataDescription.str, "TSTR") == 0)) {
-        const auto tmpstring = ctx.inputs().get<gsl::span<char>>(input);
-        std::copy(tmpstring.begin(), tmpstring.end(), std::back_inserter(inString));
+        inputTHR.add(ctx.inputs().get<gsl::span<char>>(input));
       }
       if ((strcmp(header->dataOrigin.str, "ITS") == 0) && (strcmp(header->dataDescription.str, "QCSTR") == 0)) {
-        const auto tmpstring = ctx.inputs().get<gsl::span<char>>(input);
-        std::copy(tmpstring.begin(), tmpstring.end(), std::back_inserter(inStringChipDone));
+        inputChipDone.add(ctx.inputs().get<gsl::span<char>>(input));
       }
       if ((strcmp(header->dataOrigin.str, "ITS") == 0) && (strcmp(header->dataDescription.str, "PIXTYP") == 0)) {
-        const auto tmpstring = ctx.inputs().get<gsl::span<char>>(input);
-        std::copy(tmpstring.begin(), tmpstring.end(), std::back_inserter(inPixel));
+        inputPixel.add(ctx.inputs().get<gsl::span<char>>(input));
       }
 
       if ((strcmp(header->dataOrigin.str, "ITS") == 0) && (strcmp(header->dataDescription.str, "SCANT") == 0)) {
@@ -136,93 +190,79 @@ void ITSThresholdCalibrationTask::monitorData(o2::framework::ProcessingContext&
   else if (scanType == 'P') {
     iScan = 4;
   }
-  auto splitRes = splitString(inString, "O2");
 
+  // the chip IDs and the pixel types are used as indices, the records which do not describe an ITS chip are skipped
+  const uint32_t nChips = mp.getNChips();
   if (scanType == 'A' || scanType == 'D')
-    doAnalysisPixel(inPixel);
+    inputPixel.forEach(parsePixelRecord, nChips, [&](const PixelChipRecord& record) { doAnalysisPixel(CalibrationParserPixel(record)); });
   else
-    doAnalysisTHR(inString, iScan);
+    inputTHR.forEach(parseThresholdRecord, nChips, [&](const ThresholdChipRecord& record) { doAnalysisTHR(CalibrationParserTHR(record), iScan); });
 
   //--------------- Fill chips for which scan is completed
-  auto splitResChipDone = splitString(inStringChipDone, "O2");
-  for (auto StaveStr : splitResChipDone) {
-    if (StaveStr.size() > 0) {
-      CalibrationResStructTHR result = CalibrationParserTHR(StaveStr);
-
-      int currentStave = StaveBoundary[result.Layer] + result.Stave + 1;
-      int iBarrel = getBarrel(result.Layer);
-      int currentChip = getCurrentChip(iBarrel, result.ChipID, result.HIC, result.Hs);
-      if (hCalibrationChipDone[iBarrel]->GetBinContent(currentChip, currentStave) > 0) {
-        continue; // chip may appear >twice here
-      }
-      hCalibrationChipDone[iBarrel]->Fill(currentChip - 1, currentStave - 1);
-    }
+  inputChipDone.forEach(parseThresholdRecord, nChips, [&](const ThresholdChipRecord& record) { fillChipDone(CalibrationParserTHR(record)); });
+
+  auto nInvalid = inputTHR.nInvalid + inputChipDone.nInvalid + inputPixel.nInvalid;
+  if (nInvalid > 0) {
+    ILOG(Warning, Support) << "Skipped " << nInvalid << " invalid calibration records or payloads" << ENDM;
   }
 }
 
-void ITSThresholdCalibrationTask::doAnalysisTHR(string inString, int iScan)
+void ITSThresholdCalibrationTask::fillChipDone(const CalibrationResStructTHR& result)
 {
+  int currentStave = StaveBoundary[result.Layer] + result.Stave + 1;
+  int iBarrel = getBarrel(result.Layer);
+  int currentChip = getCurrentChip(iBarrel, result.ChipID, result.HIC, result.Hs);
+  if (hCalibrationChipDone[iBarrel]->GetBinContent(currentChip, currentStave) > 0) {
+    return; // chip may appear >twice here
+  }
+  hCalibrationChipDone[iBarrel]->Fill(currentChip - 1, currentStave - 1);
+}
 
-  auto splitRes = splitString(inString, "O2");
-
+void ITSThresholdCalibrationTask::doAnalysisTHR(const CalibrationResStructTHR& result, int iScan)
+{
   //-------------- General TH2 plots
-  for (auto StaveStr : splitRes) {
-    if (StaveStr.size() > 0) {
-      CalibrationResStructTHR result = CalibrationParserTHR(StaveStr);
-
-      int currentStave = StaveBoundary[result.Layer] + result.Stave + 1;
-      int iBarrel = getBarrel(result.Layer);
-      int currentChip = getCurrentChip(iBarrel, result.ChipID, result.HIC, result.Hs);
-
-      if (iScan <= 3) {
-        // fill 2D and 1D plots for THR/ITHR/VCASN
-        hCalibrationChipAverage[iScan][iBarrel]->SetBinContent(currentChip, currentStave, result.MainVal);
-        hCalibrationRMSChipAverage[iScan][iBarrel]->SetBinContent(currentChip, currentStave, result.RMS);
-        hCalibrationLayer[result.Layer][iScan]->Fill(result.MainVal);
-        hCalibrationRMSLayer[result.Layer][iScan]->Fill(result.RMS);
-        if (iScan == 2) {
-          hCalibrationThrNoiseChipAverage[iBarrel]->SetBinContent(currentChip, currentStave, result.Noise);
-          hCalibrationThrNoiseRMSChipAverage[iBarrel]->Fill(currentChip, currentStave, result.NoiseRMS);
-          hCalibrationThrNoiseLayer[result.Layer]->Fill(result.Noise);
-          hCalibrationThrNoiseRMSLayer[result.Layer]->Fill(result.NoiseRMS);
-        }
-        // Fill percentage of unsuccess
-        hUnsuccess[iBarrel]->SetBinContent(currentChip, currentStave, result.status);
-      } else if (iScan == 4) {
-        // fill 2D plots for the pulse length scan
-        hTimeOverThreshold[iBarrel]->SetBinContent(currentChip, currentStave, result.Tot);
-        hTimeOverThresholdRms[iBarrel]->SetBinContent(currentChip, currentStave, result.TotRms);
-        hRiseTime[iBarrel]->SetBinContent(currentChip, currentStave, result.Rt);
-        hRiseTimeRms[iBarrel]->SetBinContent(currentChip, currentStave, result.RtRms);
-        // fill 1D plots for the pulse length scan
-        hTimeOverThresholdLayer[result.Layer]->Fill(result.Tot);
-        hTimeOverThresholdRmsLayer[result.Layer]->Fill(result.TotRms);
-        hRiseTimeLayer[result.Layer]->Fill(result.Rt);
-        hRiseTimeRmsLayer[result.Layer]->Fill(result.RtRms);
-      }
+  int currentStave = StaveBoundary[result.Layer] + result.Stave + 1;
+  int iBarrel = getBarrel(result.Layer);
+  int currentChip = getCurrentChip(iBarrel, result.ChipID, result.HIC, result.Hs);
+
+  if (iScan <= 3) {
+    // fill 2D and 1D plots for THR/ITHR/VCASN
+    hCalibrationChipAverage[iScan][iBarrel]->SetBinContent(currentChip, currentStave, result.MainVal);
+    hCalibrationRMSChipAverage[iScan][iBarrel]->SetBinContent(currentChip, currentStave, result.RMS);
+    hCalibrationLayer[result.Layer][iScan]->Fill(result.MainVal);
+    hCalibrationRMSLayer[result.Layer][iScan]->Fill(result.RMS);
+    if (iScan == 2) {
+      hCalibrationThrNoiseChipAverage[iBarrel]->SetBinContent(currentChip, currentStave, result.Noise);
+      hCalibrationThrNoiseRMSChipAverage[iBarrel]->Fill(currentChip, currentStave, result.NoiseRMS);
+      hCalibrationThrNoiseLayer[result.Layer]->Fill(result.Noise);
+      hCalibrationThrNoiseRMSLayer[result.Layer]->Fill(result.NoiseRMS);
     }
+    // Fill percentage of unsuccess
+    hUnsuccess[iBarrel]->SetBinContent(currentChip, currentStave, result.status);
+  } else if (iScan == 4) {
+    // fill 2D plots for the pulse length scan
+    hTimeOverThreshold[iBarrel]->SetBinContent(currentChip, currentStave, result.Tot);
+    hTimeOverThresholdRms[iBarrel]->SetBinContent(currentChip, currentStave, result.TotRms);
+    hRiseTime[iBarrel]->SetBinContent(currentChip, currentStave, result.Rt);
+    hRiseTimeRms[iBarrel]->SetBinContent(currentChip, currentStave, result.RtRms);
+    // fill 1D plots for the pulse length scan
+    hTimeOverThresholdLayer[result.Layer]->Fill(result.Tot);
+    hTimeOverThresholdRmsLayer[result.Layer]->Fill(result.TotRms);
+    hRiseTimeLayer[result.Layer]->Fill(result.Rt);
+    hRiseTimeRmsLayer[result.Layer]->Fill(result.RtRms);
   }
 }
 
-void ITSThresholdCalibrationTask::doAnalysisPixel(string inString)
+void ITSThresholdCalibrationTask::doAnalysisPixel(const CalibrationResStructPixel& result)
 {
-
-  auto splitRes = splitString(inString, "O2");
-
   //-------------- General TH2 plots
-  for (auto StaveStr : splitRes) {
-    if (StaveStr.size() > 0) {
-      CalibrationResStructPixel result = CalibrationParserPixel(StaveStr);
-
-      int currentStave = StaveBoundary[result.Layer] + result.Stave + 1;
-      int iBarrel = getBarrel(result.Layer);
-      int currentChip = getCurrentChip(iBarrel, result.ChipID, result.HIC, result.Hs);
+  int currentStave = StaveBoundary[result.Layer] + result.Stave + 1;
+  int iBarrel = getBarrel(result.Layer);
+  int currentChip = getCurrentChip(iBarrel, result.ChipID, result.HIC, result.Hs);
 
-      hCalibrationPixelpAverage[result.Type][iBarrel]->SetBinContent(currentChip, currentStave, result.counts);
-      if (result.Type == 0)
-        hCalibrationDColChipAverage[iBarrel]->SetBinContent(currentChip, currentStave, result.Dcols);
-    }
-  }
+  hCalibrationPixelpAverage[result.Type][iBarrel]->SetBinContent(currentChip, currentStave, result.counts);
+  if (result.Type == 0)
+    hCalibrationDColChipAverage[iBarrel]->SetBinContent(currentChip, currentStave, result.Dcols);
 }
 
 int ITSThresholdCalibrationTask::getCurrentChip(int barrel, int chipid, int hic, int hs)
@@ -245,89 +285,29 @@ int ITSThresholdCalibrationTask::getCurrentChip(int barrel, int chipid, int hic,
   return currentChip;
 }
 
-ITSThresholdCalibrationTask::CalibrationResStructPixel ITSThresholdCalibrationTask::CalibrationParserPixel(string input)
+ITSThresholdCalibrationTask::CalibrationResStructPixel ITSThresholdCalibrationTask::CalibrationParserPixel(const PixelChipRecord& record)
 {
   CalibrationResStructPixel result;
-  auto StaveINFO = splitString(input, ",");
-
-  for (string info : StaveINFO) {
-    if (info.size() == 0)
-      continue;
-
-    std::cout << "We have string: " << info << std::endl;
-    std::string name = splitString(info, ":")[0];
-    string data = splitString(info, ":")[1];
-
-    if (name == "ChipID") {
-      int o2chipid = std::stod(data);
-      int Hs, HIC, ChipID, Layer, Stave;
-      mp.expandChipInfoHW(o2chipid, Layer, Stave, Hs, HIC, ChipID);
-      result.Hs = Hs;
-      result.HIC = HIC;
-      result.Layer = Layer;
-      result.Stave = Stave;
-      result.ChipID = ChipID;
-    } else if (name == "PixelType") {
-      if (data == "Noisy")
-        result.Type = 0;
-      else if (data == "Dead")
-        result.Type = 1;
-      else if (data == "Ineff")
-        result.Type = 2;
-    } else if (name == "PixelNos") {
-      result.counts = std::stoi(data);
-    } else if (name == "DcolNos") {
-      result.Dcols = std::stoi(data);
-    }
-  }
+  mp.expandChipInfoHW(record.chipID, result.Layer, result.Stave, result.Hs, result.HIC, result.ChipID);
+  result.Type = record.type;
+  result.counts = record.counts;
+  result.Dcols = record.dcols;
   return result;
 }
 
-ITSThresholdCalibrationTask::CalibrationResStructTHR ITSThresholdCalibrationTask::CalibrationParserTHR(string input)
+ITSThresholdCalibrationTask::CalibrationResStructTHR ITSThresholdCalibrationTask::CalibrationParserTHR(const ThresholdChipRecord& record)
 {
   CalibrationResStructTHR result;
-  auto StaveINFO = splitString(input, ",");
-  for (string info : StaveINFO) {
-    if (info.size() == 0)
-      continue;
-
-    if (info.substr(0, 1) == "L") {
-      result.Layer = std::stod(info.substr(1, 1));
-      result.Stave = std::stod(info.substr(3, 2));
-    } else {
-
-      std::string name = splitString(info, ":")[0];
-      string data = splitString(info, ":")[1];
-      if (name == "ChipID") {
-        int o2chipid = std::stod(data);
-        int Hs, HIC, ChipID, Layer, Stave;
-        mp.expandChipInfoHW(o2chipid, Layer, Stave, Hs, HIC, ChipID);
-        result.Hs = Hs;
-        result.HIC = HIC;
-        result.Layer = Layer;
-        result.Stave = Stave;
-        result.ChipID = ChipID;
-      } else if (name == "VCASN" || name == "THR" || name == "ITHR") {
-        result.MainVal = std::stof(data);
-      } else if (name == "Rms") {
-        result.RMS = std::stof(data);
-      } else if (name == "Status") {
-        result.status = std::stof(data);
-      } else if (name == "Noise") {
-        result.Noise = std::stof(data);
-      } else if (name == "NoiseRms") {
-        result.NoiseRMS = std::stof(data);
-      } else if (name == "Tot") {
-        result.Tot = std::stof(data) / 1000; // to get micro-seconds
-      } else if (name == "TotRms") {
-        result.TotRms = std::stof(data) / 1000; // to get micro-seconds
-      } else if (name == "Rt") {
-        result.Rt = std::stof(data); // this will be in nano-seconds automatically
-      } else if (name == "RtRms") {
-        result.RtRms = std::stof(data); // this will be in nano-seconds automatically
-      }
-    }
-  }
+  mp.expandChipInfoHW(record.chipID, result.Layer, result.Stave, result.Hs, result.HIC, result.ChipID);
+  result.MainVal = record.mainVal;
+  result.RMS = record.rms;
+  result.status = record.status;
+  result.Noise = record.noise;
+  result.NoiseRMS = record.noiseRms;
+  result.Tot = record.tot / 1000;       // to get micro-seconds
+  result.TotRms = record.totRms / 1000; // to get micro-seconds
+  result.Rt = record.rt;                // this will be in nano-seconds automatically
+  result.RtRms = record.rtRms;          // this will be in nano-seconds automatically
   return result;
 }
 
@@ -639,20 +619,4 @@ void ITSThresholdCalibrationTask::publishHistos()
   }
 }
 
-std::vector<std::string> ITSThresholdCalibrationTask::splitString(std::string s, std::string delimiter)
-{
-  size_t pos_start = 0, pos_end, delim_len = delimiter.length();
-  std::string token;
-  std::vector<std::string> res;
-
-  while ((pos_end = s.find(delimiter, pos_start)) != string::npos) {
-    token = s.substr(pos_start, pos_end - pos_start);
-    pos_start = pos_end + delim_len;
-    res.push_back(token);
-  }
-
-  res.push_back(s.substr(pos_start));
-  return res;
-}
-
 } // namespace o2::quality_control_modules::its
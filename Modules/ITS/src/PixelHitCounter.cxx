@@ -0,0 +1,98 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   PixelHitCounter.cxx
+///
+
+#include "ITS/PixelHitCounter.h"
+
+#include <algorithm>
+
+namespace o2::quality_control_modules::its
+{
+
+uint32_t PixelHitCounter::get(uint16_t row, uint16_t col) const
+{
+  if (mSize == 0) {
+    return 0;
+  }
+  size_t slot = findSlot(makeKey(row, col));
+  return mKeys[slot] == EmptyKey ? 0 : mCounts[slot];
+}
+
+void PixelHitCounter::clear()
+{
+  if (mSize > 0) {
+    std::fill(mKeys.begin(), mKeys.end(), EmptyKey);
+    std::fill(mCounts.begin(), mCounts.end(), 0);
+  }
+  mSize = 0;
+  mTotalHits = 0;
+}
+
+void PixelHitCounter::grow()
+{
+  // we start small, as most of the chips have only a few fired pixels
+  rehash(mKeys.empty() ? 16 : mKeys.size() * 2);
+}
+
+void PixelHitCounter::rehash(size_t capacity)
+{
+  std::vector<uint32_t> oldKeys(capacity, EmptyKey);
+  std::vector<uint32_t> oldCounts(capacity, 0);
+  oldKeys.swap(mKeys);
+  oldCounts.swap(mCounts);
+  mShift = 32;
+  for (size_t c = capacity; c > 1; c >>= 1) {
+    mShift--;
+  }
+
+  for (size_t slot = 0; slot < oldKeys.size(); slot++) {
+    if (oldKeys[slot] != EmptyKey) {
+      size_t newSlot = findSlot(oldKeys[slot]);
+      mKeys[newSlot] = oldKeys[slot];
+      mCounts[newSlot] = oldCounts[slot];
+    }
+  }
+}
+
+size_t PixelHitCounter::removeBelowOccupancy(double nTriggers, double minOccupancy)
+{
+  // Removing from an open-addressing table would break the probe sequences, thus we rebuild it with the pixels we keep.
+  size_t removed = 0;
+  for (size_t slot = 0; slot < mKeys.size(); slot++) {
+    if (mKeys[slot] != EmptyKey && mCounts[slot] / nTriggers < minOccupancy) {
+      mTotalHits -= mCounts[slot];
+      mKeys[slot] = EmptyKey;
+      mCounts[slot] = 0;
+      removed++;
+    }
+  }
+  if (removed > 0) {
+    mSize -= removed;
+    rehash(mKeys.size());
+  }
+  return removed;
+}
+
+size_t PixelHitCounter::extractNoisyPixels(double nTriggers, uint32_t minHits, double minOccupancy, std::vector<NoisyPixel>& noisyPixels) const
+{
+  size_t before = noisyPixels.size();
+  for (size_t slot = 0; slot < mKeys.size(); slot++) {
+    if (mKeys[slot] != EmptyKey && mCounts[slot] > minHits && mCounts[slot] / nTriggers > minOccupancy) {
+      noisyPixels.push_back({ getRow(mKeys[slot]), getCol(mKeys[slot]), mCounts[slot] });
+    }
+  }
+  return noisyPixels.size() - before;
+}
+
+} // namespace o2::quality_control_modules::its
@@ -0,0 +1,245 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCalibrationRecords.cxx
+///
+
+#include "ITS/CalibrationRecords.h"
+
+#define BOOST_TEST_MODULE CalibrationRecords test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+using namespace o2::quality_control_modules::its;
+
+namespace
+{
+
+constexpr uint32_t NChips = 24120; // the whole barrel
+
+std::vector<ThresholdChipRecord> makeRecords()
+{
+  std::mt19937 gen(7);
+  std::normal_distribution<float> thr(100, 10);
+  std::vector<ThresholdChipRecord> records(NChips);
+  for (uint32_t chip = 0; chip < NChips; chip++) {
+    auto& record = records[chip];
+    record.chipID = chip;
+    record.mainVal = thr(gen);
+    record.rms = thr(gen) / 20;
+    record.noise = thr(gen) / 10;
+    record.noiseRms = thr(gen) / 50;
+    record.status = chip % 100 == 0 ? 1 : 0;
+  }
+  return records;
+}
+
+// the text format sent by the ITS calibration, with the values rounded as it does
+std::string toText(const std::vector<ThresholdChipRecord>& records)
+{
+  std::string text;
+  char buffer[256];
+  for (const auto& record : records) {
+    std::snprintf(buffer, sizeof(buffer), "L%d_%02d,ChipID:%u,THR:%.2f,Rms:%.2f,Noise:%.2f,NoiseRms:%.2f,Status:%.0fO2",
+                  record.chipID * 7 / NChips, record.chipID % 12, record.chipID, record.mainVal, record.rms, record.noise, record.noiseRms, record.status);
+    text += buffer;
+  }
+  return text;
+}
+
+// the parsing done by ITSThresholdCalibrationTask before the binary format
+std::vector<std::string> splitString(std::string s, std::string delimiter)
+{
+  size_t pos_start = 0, pos_end, delim_len = delimiter.length();
+  std::vector<std::string> res;
+  while ((pos_end = s.find(delimiter, pos_start)) != std::string::npos) {
+    res.push_back(s.substr(pos_start, pos_end - pos_start));
+    pos_start = pos_end + delim_len;
+  }
+  res.push_back(s.substr(pos_start));
+  return res;
+}
+
+ThresholdChipRecord parseWithSplit(std::string input)
+{
+  ThresholdChipRecord result;
+  for (std::string info : splitString(input, ",")) {
+    if (info.size() == 0 || info.substr(0, 1) == "L") {
+      continue;
+    }
+    std::string name = splitString(info, ":")[0];
+    std::string data = splitString(info, ":")[1];
+    if (name == "ChipID") {
+      result.chipID = std::stod(data);
+    } else if (name == "THR") {
+      result.mainVal = std::stof(data);
+    } else if (name == "Rms") {
+      result.rms = std::stof(data);
+    } else if (name == "Status") {
+      result.status = std::stof(data);
+    } else if (name == "Noise") {
+      result.noise = std::stof(data);
+    } else if (name == "NoiseRms") {
+      result.noiseRms = std::stof(data);
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(text_records)
+{
+  std::vector<std::string_view> records;
+  forEachTextRecord("O2abcO2O2defO2g", [&](std::string_view record) { records.push_back(record); });
+  BOOST_CHECK(records == (std::vector<std::string_view>{ "abc", "def", "g" }));
+
+  ThresholdChipRecord thr;
+  BOOST_REQUIRE(parseThresholdRecord("L3_05,ChipID:3120,THR:100.5,Rms:5.25,Noise:4,NoiseRms:0.5,Status:1,Unknown:2,Tot:5000", thr));
+  BOOST_CHECK_EQUAL(thr.chipID, 3120);
+  BOOST_CHECK_EQUAL(thr.mainVal, 100.5);
+  BOOST_CHECK_EQUAL(thr.rms, 5.25);
+  BOOST_CHECK_EQUAL(thr.noise, 4);
+  BOOST_CHECK_EQUAL(thr.noiseRms, 0.5);
+  BOOST_CHECK_EQUAL(thr.status, 1);
+  BOOST_CHECK_EQUAL(thr.tot, 5000);
+  BOOST_CHECK(!parseThresholdRecord("THR:100.5,Rms:5.25", thr));
+  BOOST_CHECK(!parseThresholdRecord("ChipID:abc,THR:100.5", thr));
+
+  PixelChipRecord pixel;
+  BOOST_REQUIRE(parsePixelRecord("ChipID:12,PixelType:Dead,PixelNos:42,DcolNos:3", pixel));
+  BOOST_CHECK_EQUAL(pixel.chipID, 12);
+  BOOST_CHECK_EQUAL(pixel.type, 1);
+  BOOST_CHECK_EQUAL(pixel.counts, 42);
+  BOOST_CHECK_EQUAL(pixel.dcols, 3);
+  BOOST_REQUIRE(parsePixelRecord("ChipID:13,PixelType:Ineff", pixel));
+  BOOST_CHECK_EQUAL(pixel.type, 2);
+  BOOST_CHECK_EQUAL(pixel.counts, 0);
+  // an unknown or missing pixel type is not taken for a noisy pixel
+  BOOST_CHECK(!parsePixelRecord("ChipID:13,PixelType:Hot,PixelNos:42", pixel));
+  BOOST_CHECK(!parsePixelRecord("ChipID:13,PixelNos:42", pixel));
+}
+
+BOOST_AUTO_TEST_CASE(record_validation)
+{
+  const uint32_t nChips = 24120;
+  ThresholdChipRecord thr;
+  thr.chipID = nChips - 1;
+  BOOST_CHECK(isValidRecord(thr, nChips));
+  thr.chipID = nChips;
+  BOOST_CHECK(!isValidRecord(thr, nChips));
+
+  PixelChipRecord pixel;
+  pixel.chipID = 12;
+  for (int32_t type : { 0, 1, 2 }) {
+    pixel.type = type;
+    BOOST_CHECK(isValidRecord(pixel, nChips));
+  }
+  pixel.type = 3;
+  BOOST_CHECK(!isValidRecord(pixel, nChips));
+  pixel.type = -1;
+  BOOST_CHECK(!isValidRecord(pixel, nChips));
+  pixel.type = 0;
+  pixel.chipID = 0xffffffff;
+  BOOST_CHECK(!isValidRecord(pixel, nChips));
+}
+
+BOOST_AUTO_TEST_CASE(binary_records)
+{
+  std::vector<PixelChipRecord> records(3);
+  for (uint32_t i = 0; i < records.size(); i++) {
+    records[i].chipID = i;
+    records[i].counts = 10 * i;
+  }
+  auto payload = makeRecordsPayload<PixelChipRecord>(records);
+  BOOST_CHECK(hasRecordsHeader(payload));
+  BOOST_CHECK(!hasRecordsHeader(gsl::span<const char>("ChipID:12,PixelType:Dead,PixelNos:42", 36)));
+
+  std::vector<PixelChipRecord> copy;
+  auto view = getRecords<PixelChipRecord>(payload, copy);
+  BOOST_REQUIRE_EQUAL(view.size(), 3);
+  BOOST_CHECK_EQUAL(view[2].counts, 20);
+  BOOST_CHECK(copy.empty()); // read in place
+
+  // a payload which is not aligned is copied
+  std::vector<char> shifted(payload.size() + 1);
+  std::copy(payload.begin(), payload.end(), shifted.begin() + 1);
+  view = getRecords<PixelChipRecord>(gsl::span<const char>(shifted.data() + 1, payload.size()), copy);
+  BOOST_REQUIRE_EQUAL(view.size(), 3);
+  BOOST_CHECK_EQUAL(view.data(), copy.data());
+  BOOST_CHECK_EQUAL(view[1].counts, 10);
+
+  // wrong record type, truncated payload
+  std::vector<ThresholdChipRecord> thrCopy;
+  BOOST_CHECK(getRecords<ThresholdChipRecord>(payload, thrCopy).empty());
+  payload.pop_back();
+  BOOST_CHECK(getRecords<PixelChipRecord>(payload, copy).empty());
+}
+
+BOOST_AUTO_TEST_CASE(full_barrel_benchmark)
+{
+  // The results of a threshold scan of the whole barrel, one record per chip, parsed as text as the task used to do,
+  // with the new text parser and read from the binary payload. The three must give the same records.
+  const auto records = makeRecords();
+  const auto text = toText(records);
+  const auto payload = makeRecordsPayload<ThresholdChipRecord>(records);
+  BOOST_TEST_MESSAGE("Text payload: " << text.size() << " bytes, binary payload: " << payload.size() << " bytes");
+
+  auto run = [](auto parse) {
+    std::vector<ThresholdChipRecord> parsed;
+    auto start = std::chrono::steady_clock::now();
+    parse(parsed);
+    std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+    return std::make_pair(parsed, duration.count());
+  };
+  auto [withSplit, durationSplit] = run([&](auto& parsed) {
+    for (const auto& record : splitString(text, "O2")) {
+      if (record.size() > 0) {
+        parsed.push_back(parseWithSplit(record));
+      }
+    }
+  });
+  auto [withParser, durationParser] = run([&](auto& parsed) {
+    ThresholdChipRecord record;
+    forEachTextRecord(text, [&](std::string_view textRecord) {
+      if (parseThresholdRecord(textRecord, record)) {
+        parsed.push_back(record);
+      }
+    });
+  });
+  auto [fromBinary, durationBinary] = run([&](auto& parsed) {
+    std::vector<ThresholdChipRecord> copy;
+    for (const auto& record : getRecords<ThresholdChipRecord>(payload, copy)) {
+      parsed.push_back(record);
+    }
+  });
+
+  BOOST_REQUIRE_EQUAL(withSplit.size(), NChips);
+  BOOST_REQUIRE_EQUAL(withParser.size(), NChips);
+  BOOST_REQUIRE_EQUAL(fromBinary.size(), NChips);
+  for (uint32_t chip = 0; chip < NChips; chip++) {
+    BOOST_CHECK_EQUAL(withParser[chip].chipID, withSplit[chip].chipID);
+    BOOST_CHECK_CLOSE(withParser[chip].mainVal, withSplit[chip].mainVal, 1e-4);
+    BOOST_CHECK_CLOSE(withParser[chip].noiseRms, withSplit[chip].noiseRms, 1e-4);
+    BOOST_CHECK_EQUAL(withParser[chip].status, withSplit[chip].status);
+    BOOST_CHECK_EQUAL(fromBinary[chip].chipID, withSplit[chip].chipID);
+    BOOST_CHECK_CLOSE(fromBinary[chip].mainVal, withSplit[chip].mainVal, 0.01); // the text is rounded
+  }
+  BOOST_TEST_MESSAGE("Parsing " << NChips << " chips, former text parsing: " << durationSplit << " ms, text parser: "
+                                << durationParser << " ms, binary records: " << durationBinary << " ms");
+}
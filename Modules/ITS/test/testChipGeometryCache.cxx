@@ -0,0 +1,124 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testChipGeometryCache.cxx
+///
+
+#include "ITS/ChipGeometryCache.h"
+
+#include <TH2F.h>
+
+#define BOOST_TEST_MODULE ChipGeometryCache test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control_modules::its;
+
+namespace
+{
+// the numbering of the chips, as in ITSFhrTask
+constexpr int NStaves[7] = { 12, 16, 20, 24, 30, 42, 48 };
+constexpr int nHicPerStave[7] = { 1, 1, 1, 8, 8, 14, 14 };
+constexpr int nChipsPerHic[7] = { 9, 9, 9, 14, 14, 14, 14 };
+constexpr int ChipBoundary[8] = { 0, 108, 252, 432, 3120, 6480, 14712, 24120 };
+
+/// A simplified geometry in which each chip is at the centre of its cell in the chip maps of ITSFhrTask, 3 cm long in z.
+/// The IB staves have their 9 chips along z. The OB half-staves have two rows of 7 chips per HIC, each row taking its
+/// own phi cell, and their HICs are along z.
+std::vector<ChipGeometryCache::ChipInfo> makeChips()
+{
+  std::vector<ChipGeometryCache::ChipInfo> chips(ChipGeometryCache::NChips);
+  for (int layer = 0; layer < 7; layer++) {
+    const int hicsPerHalfStave = nHicPerStave[layer] / 2;
+    for (int stave = 0; stave < NStaves[layer]; stave++) {
+      for (int hic = 0; hic < nHicPerStave[layer]; hic++) {
+        for (int chip = 0; chip < nChipsPerHic[layer]; chip++) {
+          auto& info = chips[ChipBoundary[layer] + (stave * nHicPerStave[layer] + hic) * nChipsPerHic[layer] + chip];
+          info.layer = layer;
+          info.stave = stave;
+          info.chipInModule = chip;
+          if (layer < 3) {
+            info.z = (chip - 4) * 3.f;
+            info.phi = -180 + (stave + 0.5) * 360. / NStaves[layer];
+          } else {
+            info.subStave = hic / hicsPerHalfStave;
+            info.module = hic % hicsPerHalfStave;
+            info.z = (info.module * 7 + chip % 7 + 0.5 - hicsPerHalfStave * 3.5) * 3;
+            info.phi = -180 + (stave * 4 + info.subStave * 2 + chip / 7 + 0.5) * 360. / (NStaves[layer] * 4);
+          }
+        }
+      }
+    }
+  }
+  return chips;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(chip_table)
+{
+  ChipGeometryCache cache(makeChips(), 123);
+  BOOST_CHECK_EQUAL(cache.getRunNumber(), 123);
+  BOOST_REQUIRE_EQUAL(cache.size(), ChipGeometryCache::NChips);
+  BOOST_CHECK_EQUAL(cache[107].layer, 0);
+  BOOST_CHECK_EQUAL(cache[108].layer, 1);
+  BOOST_CHECK_EQUAL(cache[7000].layer, 5);
+  BOOST_CHECK_EQUAL(cache[ChipGeometryCache::NChips - 1].layer, 6);
+}
+
+BOOST_AUTO_TEST_CASE(ib_chip_map)
+{
+  ChipGeometryCache cache(makeChips(), 123);
+  // the chip map of the second layer: 9 chips along z and 16 staves in phi, i.e. 11 bins per row with the under/overflows
+  TH2F map("map", "map", 9, -13.5, 13.5, 16, -180, 180);
+  const int layer = 1;
+  auto bins = cache.getBins(&map, ChipBoundary[layer], ChipBoundary[layer + 1]);
+  BOOST_REQUIRE_EQUAL(bins.size(), 144);
+  BOOST_CHECK_EQUAL(bins[0], 12);    // stave 0, chip 0
+  BOOST_CHECK_EQUAL(bins[48], 70);   // stave 5, chip 3
+  BOOST_CHECK_EQUAL(bins[143], 185); // stave 15, chip 8
+
+  // ITSFhrTask looks the bins up with chipIndex = istave * nChipsPerHic + ichip
+  for (int istave = 0; istave < NStaves[layer]; istave++) {
+    for (int ichip = 0; ichip < nChipsPerHic[layer]; ichip++) {
+      int chipIndex = istave * nChipsPerHic[layer] + ichip;
+      BOOST_CHECK_EQUAL(cache[ChipBoundary[layer] + chipIndex].stave, istave);
+      BOOST_CHECK_EQUAL(bins[chipIndex], (ichip + 1) + 11 * (istave + 1));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ob_chip_map)
+{
+  ChipGeometryCache cache(makeChips(), 123);
+  // the chip map of the fourth layer: 4 HICs of 7 chips along z, 24 staves of 2 half-staves of 2 rows in phi
+  TH2F map("map", "map", 28, -42, 42, 96, -180, 180);
+  const int layer = 3;
+  auto bins = cache.getBins(&map, ChipBoundary[layer], ChipBoundary[layer + 1]);
+  BOOST_REQUIRE_EQUAL(bins.size(), 2688);
+  BOOST_CHECK_EQUAL(bins[0], 31);      // stave 0, HIC 0, chip 0
+  BOOST_CHECK_EQUAL(bins[415], 490);   // stave 3, HIC 5 (second half-stave, second HIC), chip 9 (second row)
+  BOOST_CHECK_EQUAL(bins[2687], 2908); // stave 23, HIC 7, chip 13
+
+  // ITSFhrTask looks the bins up with chipIndex = istave * nHicPerStave * nChipsPerHic + ichip
+  for (int istave = 0; istave < NStaves[layer]; istave++) {
+    for (int ichip = 0; ichip < nHicPerStave[layer] * nChipsPerHic[layer]; ichip++) {
+      int chipIndex = istave * nHicPerStave[layer] * nChipsPerHic[layer] + ichip;
+      int hic = ichip / 14, chip = ichip % 14;
+      int zCell = (hic % 4) * 7 + chip % 7;
+      int phiCell = istave * 4 + (hic / 4) * 2 + chip / 7;
+      BOOST_CHECK_EQUAL(cache[ChipBoundary[layer] + chipIndex].stave, istave);
+      BOOST_CHECK_EQUAL(bins[chipIndex], (zCell + 1) + 30 * (phiCell + 1));
+    }
+  }
+}
@@ -0,0 +1,106 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testPixelHitCounter.cxx
+///
+
+#include "ITS/PixelHitCounter.h"
+
+#define BOOST_TEST_MODULE PixelHitCounter test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include <unordered_map>
+
+using namespace o2::quality_control_modules::its;
+
+BOOST_AUTO_TEST_CASE(test_counting)
+{
+  PixelHitCounter counter;
+  BOOST_CHECK(counter.empty());
+  BOOST_CHECK_EQUAL(counter.get(3, 4), 0);
+
+  counter.add(3, 4);
+  counter.add(3, 4);
+  counter.add(4, 3);
+  counter.add(511, 1023, 5);
+  BOOST_CHECK_EQUAL(counter.size(), 3);
+  BOOST_CHECK_EQUAL(counter.getTotalHits(), 8);
+  BOOST_CHECK_EQUAL(counter.get(3, 4), 2);
+  BOOST_CHECK_EQUAL(counter.get(4, 3), 1);
+  BOOST_CHECK_EQUAL(counter.get(511, 1023), 5);
+  BOOST_CHECK_EQUAL(counter.get(0, 0), 0);
+
+  size_t visited = 0;
+  uint64_t sum = 0;
+  counter.forEach([&](uint16_t, uint16_t, uint32_t hits) {
+    visited++;
+    sum += hits;
+  });
+  BOOST_CHECK_EQUAL(visited, 3);
+  BOOST_CHECK_EQUAL(sum, 8);
+
+  counter.clear();
+  BOOST_CHECK(counter.empty());
+  BOOST_CHECK_EQUAL(counter.get(3, 4), 0);
+  BOOST_CHECK_EQUAL(counter.getTotalHits(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_against_unordered_map)
+{
+  // many pixels, so that the table grows several times, with counts on both sides of the occupancy filter
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> rows(0, PixelHitCounter::NRows - 1);
+  std::uniform_int_distribution<int> cols(0, PixelHitCounter::NCols - 1);
+  PixelHitCounter counter;
+  std::unordered_map<uint32_t, uint32_t> reference;
+  for (int pixel = 0; pixel < 5000; pixel++) {
+    uint16_t row = rows(generator), col = cols(generator);
+    for (int hit = 0; hit <= pixel % 10; hit++) {
+      counter.add(row, col);
+      reference[row * PixelHitCounter::NCols + col]++;
+    }
+  }
+  BOOST_REQUIRE_EQUAL(counter.size(), reference.size());
+  counter.forEach([&](uint16_t row, uint16_t col, uint32_t count) {
+    BOOST_REQUIRE_EQUAL(reference.at(row * PixelHitCounter::NCols + col), count);
+  });
+
+  // the filter keeps the remaining pixels reachable
+  size_t expectedRemoved = 0;
+  for (const auto& [key, count] : reference) {
+    expectedRemoved += count / 100. < 0.05;
+  }
+  BOOST_CHECK_EQUAL(counter.removeBelowOccupancy(100, 0.05), expectedRemoved);
+  BOOST_CHECK_EQUAL(counter.size(), reference.size() - expectedRemoved);
+  for (const auto& [key, count] : reference) {
+    BOOST_CHECK_EQUAL(counter.get(key / PixelHitCounter::NCols, key % PixelHitCounter::NCols), count / 100. < 0.05 ? 0 : count);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_noisy_pixels)
+{
+  PixelHitCounter counter;
+  counter.add(1, 1, 95);
+  counter.add(2, 2, 20);
+  counter.add(3, 3, 1);
+
+  std::vector<PixelHitCounter::NoisyPixel> noisyPixels;
+  BOOST_CHECK_EQUAL(counter.extractNoisyPixels(100, 10, 0.1, noisyPixels), 2);
+  BOOST_CHECK_EQUAL(counter.extractNoisyPixels(100, 50, 0.1, noisyPixels), 1);
+  BOOST_REQUIRE_EQUAL(noisyPixels.size(), 3);
+  BOOST_CHECK_EQUAL(noisyPixels.back().row, 1);
+  BOOST_CHECK_EQUAL(noisyPixels.back().col, 1);
+  BOOST_CHECK_EQUAL(noisyPixels.back().hits, 95);
+}
@@ -0,0 +1,109 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testPixelHitCounterReplay.cxx
+///
+
+#include "ITS/PixelHitCounter.h"
+
+#define BOOST_TEST_MODULE PixelHitCounter replay
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <random>
+#include <unordered_map>
+
+using namespace o2::quality_control_modules::its;
+
+namespace
+{
+
+struct Hit {
+  uint16_t chip;
+  uint16_t row;
+  uint16_t col;
+};
+
+/// Produces the hits of one TF: a uniform noise plus a few pixels firing in most of the triggers.
+std::vector<Hit> recordTF(size_t nChips, size_t nTriggers, double occupancy, size_t noisyPerChip)
+{
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> rows(0, PixelHitCounter::NRows - 1);
+  std::uniform_int_distribution<int> cols(0, PixelHitCounter::NCols - 1);
+  std::bernoulli_distribution fires(0.9);
+  size_t hitsPerTrigger = occupancy * PixelHitCounter::NRows * PixelHitCounter::NCols;
+
+  std::vector<Hit> hits;
+  for (size_t chip = 0; chip < nChips; chip++) {
+    std::vector<std::pair<uint16_t, uint16_t>> noisyPixels;
+    for (size_t i = 0; i < noisyPerChip; i++) {
+      noisyPixels.emplace_back(rows(generator), cols(generator));
+    }
+    for (size_t trigger = 0; trigger < nTriggers; trigger++) {
+      for (size_t i = 0; i < hitsPerTrigger; i++) {
+        hits.push_back({ static_cast<uint16_t>(chip), static_cast<uint16_t>(rows(generator)), static_cast<uint16_t>(cols(generator)) });
+      }
+      for (auto [row, col] : noisyPixels) {
+        if (fires(generator)) {
+          hits.push_back({ static_cast<uint16_t>(chip), row, col });
+        }
+      }
+    }
+  }
+  return hits;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_replay_ob_stave)
+{
+  // One OB stave (14 HICs of 14 chips) at an occupancy typical of high rate pp, counted as ITSFhrTask did before
+  // with one unordered_map per chip and now with PixelHitCounter.
+  const size_t nChips = 196, nReplays = 5;
+  auto hits = recordTF(nChips, 20, 1e-4, 5);
+
+  std::vector<PixelHitCounter> counters(nChips);
+  std::vector<std::unordered_map<unsigned int, int>> maps(nChips);
+  std::vector<PixelHitCounter::NoisyPixel> noisyPixels;
+  size_t noisyFromCounters = 0, noisyFromMaps = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t replay = 0; replay < nReplays; replay++) {
+    for (const auto& hit : hits) {
+      counters[hit.chip].add(hit.row, hit.col);
+    }
+    for (auto& counter : counters) {
+      noisyPixels.clear();
+      noisyFromCounters += counter.extractNoisyPixels(20. * (replay + 1), 10, 0.5, noisyPixels);
+    }
+  }
+  auto countersDone = std::chrono::steady_clock::now();
+  for (size_t replay = 0; replay < nReplays; replay++) {
+    for (const auto& hit : hits) {
+      maps[hit.chip][1000 * hit.col + hit.row]++;
+    }
+    for (auto& map : maps) {
+      for (const auto& [key, count] : map) {
+        noisyFromMaps += count > 10 && count / (20. * (replay + 1)) > 0.5;
+      }
+    }
+  }
+  auto mapsDone = std::chrono::steady_clock::now();
+
+  BOOST_CHECK_EQUAL(noisyFromCounters, noisyFromMaps);
+  using milliseconds = std::chrono::duration<double, std::milli>;
+  BOOST_TEST_MESSAGE("Replayed " << nReplays << " times " << hits.size() << " hits: PixelHitCounter "
+                                 << milliseconds(countersDone - start).count() << " ms, unordered_map "
+                                 << milliseconds(mapsDone - countersDone).count() << " ms");
+}
@@ -0,0 +1,104 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file MergeableTH2CounterRatio.h
+/// \brief A MergeableTH2Ratio accumulating its numerator and denominator in integer counters
+
+#ifndef O2_MERGEABLETH2COUNTERRATIO_H
+#define O2_MERGEABLETH2COUNTERRATIO_H
+
+#include "MUONCommon/MergeableTH2Ratio.h"
+#include <vector>
+
+namespace o2::quality_control_modules::muon
+{
+
+/// \brief MergeableTH2Ratio whose numerator and denominator are plain arrays of counters, indexed by global bin.
+///
+/// Filling is a single increment, without the overhead of TH1::Fill, and merging adds the counter arrays.
+/// The numerator and denominator histograms, as well as the ratio, are only computed from the counters by update(),
+/// thus it has to be called before the object is published. The denominator counters are multiplied by a constant
+/// scale, e.g. to express a number of orbits as a time.
+/// Only the histograms are streamed. The counters of an object which was read are rebuilt from them when they are
+/// needed, e.g. by postDeserialization() or merge(), while incrementNum() and setDen() expect them to be built already.
+class MergeableTH2CounterRatio : public MergeableTH2Ratio
+{
+ public:
+  MergeableTH2CounterRatio();
+  MergeableTH2CounterRatio(MergeableTH2CounterRatio const& copymerge);
+  MergeableTH2CounterRatio(const char* name, const char* title, int nbinsx, double xmin, double xmax, int nbinsy, double ymin, double ymax, bool showZeroBins = false);
+
+  ~MergeableTH2CounterRatio() = default;
+
+  void merge(MergeInterface* const other) override;
+
+  /// Adds one count to the numerator, the global bin is as given by TH2::GetBin().
+  void incrementNum(int bin)
+  {
+    mNumCounters[bin]++;
+    mNumEntries++;
+  }
+  void setDen(int bin, ULong64_t count)
+  {
+    mDenCounters[bin] = count;
+  }
+  void setDenScale(double scale)
+  {
+    mDenScale = scale;
+  }
+  double getDenScale() const
+  {
+    return mDenScale;
+  }
+  const std::vector<ULong64_t>& getNumCounters() const
+  {
+    ensureCounters();
+    return mNumCounters;
+  }
+  const std::vector<ULong64_t>& getDenCounters() const
+  {
+    ensureCounters();
+    return mDenCounters;
+  }
+
+  /// Rebuilds the counters, which are not streamed, from the histograms.
+  void postDeserialization() override;
+
+  /// Fills the numerator and denominator histograms from the counters, then computes the ratio.
+  void update() override;
+
+  // functions inherited from TH2F
+  void Reset(Option_t* option = "") override;
+  void Copy(TObject& obj) const override;
+  /// Only the sums of counter ratios are supported, as the counters cannot be scaled nor subtracted.
+  Bool_t Add(const TH1* h1, const TH1* h2, Double_t c1 = 1, Double_t c2 = 1) override;
+  Bool_t Add(const TH1* h1, Double_t c1 = 1) override;
+  using MergeableTH2Ratio::SetBins;
+  void SetBins(Int_t nx, Double_t xmin, Double_t xmax, Int_t ny, Double_t ymin, Double_t ymax) override;
+
+ private:
+  void resizeCounters();
+  /// Rebuilds the counters from the histograms if they do not match their binning, e.g. after the object was read.
+  void ensureCounters() const;
+  /// Adds the counters of another ratio with the same binning, returns false if they do not match.
+  bool addCounters(const MergeableTH2CounterRatio& other);
+
+  mutable std::vector<ULong64_t> mNumCounters; //! the histograms are streamed instead, see ensureCounters()
+  mutable std::vector<ULong64_t> mDenCounters; //!
+  ULong64_t mNumEntries{ 0 };
+  double mDenScale{ 1 };
+
+  ClassDefOverride(MergeableTH2CounterRatio, 2);
+};
+
+} // namespace o2::quality_control_modules::muon
+
+#endif // O2_MERGEABLETH2COUNTERRATIO_H
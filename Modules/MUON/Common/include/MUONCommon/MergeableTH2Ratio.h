@@ -59,7 +59,7 @@ class MergeableTH2Ratio : public TH2F, public o2::mergers::MergeInterface
     mShowZeroBins = showZeroBins;
   }
 
-  void update();
+  virtual void update();
 
   void beautify();
 
@@ -0,0 +1,219 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file MergeableTH2CounterRatio.cxx
+/// \brief A MergeableTH2Ratio accumulating its numerator and denominator in integer counters
+
+#include "MUONCommon/MergeableTH2CounterRatio.h"
+#include "QualityControl/QcInfoLogger.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace o2::quality_control_modules::muon
+{
+
+MergeableTH2CounterRatio::MergeableTH2CounterRatio() : MergeableTH2Ratio()
+{
+  // the counters are built on demand, as this constructor is used by ROOT before reading the histograms
+}
+
+MergeableTH2CounterRatio::MergeableTH2CounterRatio(MergeableTH2CounterRatio const& copymerge)
+  : MergeableTH2Ratio(copymerge),
+    mNumCounters(copymerge.mNumCounters),
+    mDenCounters(copymerge.mDenCounters),
+    mNumEntries(copymerge.mNumEntries),
+    mDenScale(copymerge.mDenScale)
+{
+  update();
+}
+
+MergeableTH2CounterRatio::MergeableTH2CounterRatio(const char* name, const char* title, int nbinsx, double xmin, double xmax, int nbinsy, double ymin, double ymax, bool showZeroBins)
+  : MergeableTH2Ratio(name, title, nbinsx, xmin, xmax, nbinsy, ymin, ymax, showZeroBins)
+{
+  resizeCounters();
+  update();
+}
+
+void MergeableTH2CounterRatio::resizeCounters()
+{
+  auto nCells = static_cast<size_t>(getNum()->GetNcells());
+  mNumCounters.assign(nCells, 0);
+  mDenCounters.assign(nCells, 0);
+  mNumEntries = 0;
+}
+
+void MergeableTH2CounterRatio::ensureCounters() const
+{
+  auto num = getNum();
+  auto den = getDen();
+  const auto nCells = num ? static_cast<size_t>(num->GetNcells()) : 0;
+  if (!num || !den || mNumCounters.size() == nCells || static_cast<size_t>(den->GetNcells()) != nCells) {
+    return;
+  }
+  // update() filled the histograms with the counters, we revert it. The bins are floats, thus the counts above 2^24
+  // come back as they were approximated in the histograms.
+  mNumCounters.resize(nCells);
+  mDenCounters.resize(nCells);
+  const float* numBins = num->GetArray();
+  const float* denBins = den->GetArray();
+  for (size_t i = 0; i < nCells; i++) {
+    mNumCounters[i] = std::llround(numBins[i]);
+    mDenCounters[i] = mDenScale != 0 ? std::llround(denBins[i] / mDenScale) : 0;
+  }
+}
+
+void MergeableTH2CounterRatio::postDeserialization()
+{
+  ensureCounters();
+}
+
+bool MergeableTH2CounterRatio::addCounters(const MergeableTH2CounterRatio& other)
+{
+  ensureCounters();
+  other.ensureCounters();
+  if (other.mNumCounters.size() != mNumCounters.size() || other.mDenCounters.size() != mDenCounters.size()) {
+    ILOG(Error, Support) << "Cannot add the counters of " << other.GetName() << " to " << GetName() << ", the binnings differ" << ENDM;
+    return false;
+  }
+  // plain loops over contiguous arrays, which the compiler vectorizes
+  const size_t n = mNumCounters.size();
+  ULong64_t* __restrict num = mNumCounters.data();
+  ULong64_t* __restrict den = mDenCounters.data();
+  const ULong64_t* __restrict otherNum = other.mNumCounters.data();
+  const ULong64_t* __restrict otherDen = other.mDenCounters.data();
+  for (size_t i = 0; i < n; i++) {
+    num[i] += otherNum[i];
+  }
+  for (size_t i = 0; i < n; i++) {
+    den[i] += otherDen[i];
+  }
+  mNumEntries += other.mNumEntries;
+  return true;
+}
+
+void MergeableTH2CounterRatio::merge(MergeInterface* const other)
+{
+  auto otherRatio = dynamic_cast<const MergeableTH2CounterRatio*>(other);
+  if (!otherRatio) {
+    ILOG(Error, Support) << "Cannot merge " << GetName() << " with an object which is not a MergeableTH2CounterRatio" << ENDM;
+    return;
+  }
+  if (addCounters(*otherRatio)) {
+    update();
+  }
+}
+
+void MergeableTH2CounterRatio::update()
+{
+  auto num = getNum();
+  auto den = getDen();
+  if (!num || !den) {
+    return;
+  }
+  ensureCounters();
+  if (mNumCounters.size() != static_cast<size_t>(num->GetNcells())) {
+    // the numerator and denominator do not have the same binning
+    MergeableTH2Ratio::update();
+    return;
+  }
+
+  // the histograms are never filled, thus their statistics are computed from the bin contents
+  num->Reset("ICES");
+  den->Reset("ICES");
+  float* numBins = num->GetArray();
+  float* denBins = den->GetArray();
+  for (size_t i = 0; i < mNumCounters.size(); i++) {
+    numBins[i] = mNumCounters[i];
+    denBins[i] = mDenCounters[i] * mDenScale;
+  }
+  // the counts follow Poisson statistics
+  if (num->GetSumw2N() > 0) {
+    std::copy(mNumCounters.begin(), mNumCounters.end(), num->GetSumw2()->GetArray());
+  }
+  if (den->GetSumw2N() > 0) {
+    std::transform(mDenCounters.begin(), mDenCounters.end(), den->GetSumw2()->GetArray(),
+                   [scale2 = mDenScale * mDenScale](ULong64_t c) { return c * scale2; });
+  }
+  num->SetEntries(mNumEntries);
+  den->SetEntries(std::count_if(mDenCounters.begin(), mDenCounters.end(), [](ULong64_t c) { return c > 0; }));
+
+  MergeableTH2Ratio::update();
+}
+
+void MergeableTH2CounterRatio::Reset(Option_t* option)
+{
+  std::fill(mNumCounters.begin(), mNumCounters.end(), 0);
+  std::fill(mDenCounters.begin(), mDenCounters.end(), 0);
+  mNumEntries = 0;
+  MergeableTH2Ratio::Reset(option);
+}
+
+void MergeableTH2CounterRatio::Copy(TObject& obj) const
+{
+  auto dest = dynamic_cast<MergeableTH2CounterRatio*>(&obj);
+  if (!dest) {
+    return;
+  }
+  ensureCounters();
+
+  dest->mNumCounters = mNumCounters;
+  dest->mDenCounters = mDenCounters;
+  dest->mNumEntries = mNumEntries;
+  dest->mDenScale = mDenScale;
+  MergeableTH2Ratio::Copy(obj);
+}
+
+Bool_t MergeableTH2CounterRatio::Add(const TH1* h1, const TH1* h2, Double_t c1, Double_t c2)
+{
+  auto m1 = dynamic_cast<const MergeableTH2CounterRatio*>(h1);
+  auto m2 = dynamic_cast<const MergeableTH2CounterRatio*>(h2);
+  if (!m1 || !m2 || c1 != 1 || c2 != 1) {
+    ILOG(Error, Support) << "MergeableTH2CounterRatio supports only the sum of two MergeableTH2CounterRatio" << ENDM;
+    return kFALSE;
+  }
+
+  if (m1 == this || m2 == this) {
+    auto copy = *this; // the counters are reset below
+    return Add(m1 == this ? &copy : m1, m2 == this ? &copy : m2, c1, c2);
+  }
+
+  Reset();
+  if (!addCounters(*m1) || !addCounters(*m2)) {
+    return kFALSE;
+  }
+  update();
+  return kTRUE;
+}
+
+Bool_t MergeableTH2CounterRatio::Add(const TH1* h1, Double_t c1)
+{
+  auto m1 = dynamic_cast<const MergeableTH2CounterRatio*>(h1);
+  if (!m1 || c1 != 1) {
+    ILOG(Error, Support) << "MergeableTH2CounterRatio supports only the sum with another MergeableTH2CounterRatio" << ENDM;
+    return kFALSE;
+  }
+
+  if (!addCounters(*m1)) {
+    return kFALSE;
+  }
+  update();
+  return kTRUE;
+}
+
+void MergeableTH2CounterRatio::SetBins(Int_t nx, Double_t xmin, Double_t xmax,
+                                       Int_t ny, Double_t ymin, Double_t ymax)
+{
+  MergeableTH2Ratio::SetBins(nx, xmin, xmax, ny, ymin, ymax);
+  resizeCounters();
+}
+
+} // namespace o2::quality_control_modules::muon
@@ -0,0 +1,115 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testMergeableTH2CounterRatio.cxx
+///
+
+#include "MUONCommon/MergeableTH2CounterRatio.h"
+
+#include <TBufferFile.h>
+#include <memory>
+
+#define BOOST_TEST_MODULE MergeableTH2CounterRatio test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control_modules::muon;
+
+BOOST_AUTO_TEST_CASE(test_update)
+{
+  MergeableTH2CounterRatio ratio("ratio", "ratio", 10, 0, 10, 4, 0, 4);
+  ratio.setDenScale(0.5);
+  int bin = ratio.GetBin(3, 2);
+  ratio.incrementNum(bin);
+  ratio.incrementNum(bin);
+  ratio.setDen(bin, 8);
+  ratio.setDen(ratio.GetBin(4, 2), 8);
+
+  // nothing is visible before the update
+  BOOST_CHECK_EQUAL(ratio.getNum()->GetBinContent(3, 2), 0);
+
+  ratio.update();
+  BOOST_CHECK_EQUAL(ratio.getNum()->GetBinContent(3, 2), 2);
+  BOOST_CHECK_EQUAL(ratio.getNum()->GetEntries(), 2);
+  BOOST_CHECK_EQUAL(ratio.getDen()->GetBinContent(3, 2), 4);
+  BOOST_CHECK_CLOSE(ratio.GetBinContent(3, 2), 0.5, 1e-6);
+  BOOST_CHECK_EQUAL(ratio.GetBinContent(4, 2), 0);
+
+  ratio.Reset();
+  ratio.update();
+  BOOST_CHECK_EQUAL(ratio.getNum()->GetBinContent(3, 2), 0);
+  BOOST_CHECK_EQUAL(ratio.getDen()->GetBinContent(3, 2), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_merge)
+{
+  MergeableTH2CounterRatio target("ratio", "ratio", 10, 0, 10, 4, 0, 4);
+  MergeableTH2CounterRatio other("ratio", "ratio", 10, 0, 10, 4, 0, 4);
+  int bin = target.GetBin(1, 1);
+  target.incrementNum(bin);
+  target.setDen(bin, 4);
+  other.incrementNum(bin);
+  other.incrementNum(target.GetBin(10, 4));
+  other.setDen(bin, 4);
+
+  target.merge(&other);
+  BOOST_CHECK_EQUAL(target.getNumCounters()[bin], 2);
+  BOOST_CHECK_EQUAL(target.getDenCounters()[bin], 8);
+  BOOST_CHECK_EQUAL(target.getNum()->GetEntries(), 3);
+  BOOST_CHECK_CLOSE(target.GetBinContent(1, 1), 0.25, 1e-6);
+
+  // the copies keep the counters
+  MergeableTH2CounterRatio copy(target);
+  BOOST_CHECK_EQUAL(copy.getNumCounters()[bin], 2);
+  BOOST_CHECK_CLOSE(copy.GetBinContent(1, 1), 0.25, 1e-6);
+
+  // different binnings are not merged
+  MergeableTH2CounterRatio different("ratio", "ratio", 5, 0, 10, 4, 0, 4);
+  different.incrementNum(bin);
+  target.merge(&different);
+  BOOST_CHECK_EQUAL(target.getNumCounters()[bin], 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_streaming)
+{
+  MergeableTH2CounterRatio ratio("ratio", "ratio", 100, 0, 100, 100, 0, 100);
+  ratio.setDenScale(0.5);
+  int bin = ratio.GetBin(3, 2);
+  ratio.incrementNum(bin);
+  ratio.incrementNum(bin);
+  ratio.setDen(bin, 8);
+  ratio.update();
+
+  TBufferFile buffer(TBuffer::kWrite);
+  buffer.WriteObject(&ratio);
+  // only the histograms are streamed, the counters would take 16 bytes more per bin
+  size_t nCells = ratio.getNum()->GetNcells();
+  BOOST_CHECK_LT(static_cast<size_t>(buffer.Length()), 3 * nCells * sizeof(float) + 10000);
+
+  buffer.SetReadMode();
+  buffer.SetBufferOffset(0);
+  std::unique_ptr<MergeableTH2CounterRatio> read(static_cast<MergeableTH2CounterRatio*>(buffer.ReadObject(MergeableTH2CounterRatio::Class())));
+  BOOST_REQUIRE(read != nullptr);
+  read->postDeserialization();
+  BOOST_REQUIRE_EQUAL(read->getNumCounters().size(), nCells);
+  BOOST_CHECK_EQUAL(read->getNumCounters()[bin], 2);
+  BOOST_CHECK_EQUAL(read->getDenCounters()[bin], 8);
+
+  // the counters rebuilt from the histograms are merged as the original ones
+  ratio.merge(read.get());
+  BOOST_CHECK_EQUAL(ratio.getNumCounters()[bin], 4);
+  BOOST_CHECK_EQUAL(ratio.getDenCounters()[bin], 16);
+  BOOST_CHECK_EQUAL(ratio.getNum()->GetEntries(), 4);
+  BOOST_CHECK_CLOSE(ratio.GetBinContent(3, 2), 0.5, 1e-6);
+}
@@ -27,8 +27,9 @@
 #include "MCHBase/Digit.h"
 #endif
 #include "MCHDigitFiltering/DigitFilter.h"
-#include "MUONCommon/MergeableTH2Ratio.h"
+#include "MUONCommon/MergeableTH2CounterRatio.h"
 #include "MCH/Helpers.h"
+#include "MCH/PadLookupTable.h"
 
 class TH1F;
 class TH2F;
@@ -67,6 +68,7 @@ class DigitsTask /*final*/ : public TaskInterface // todo add back the "final" w
   void storeOrbit(const uint64_t& orb);
   void addDefaultOrbitsInTF();
   void plotDigit(const o2::mch::Digit& digit);
+  void updateEntries();
   void updateOrbits();
   void resetOrbits();
 
@@ -91,12 +93,17 @@ class DigitsTask /*final*/ : public TaskInterface // todo add back the "final" w
 
   o2::mch::DigitFilter mIsSignalDigit;
 
+  PadLookupTable mPadLookupTable; // electronics coordinates and histogram bins of each pad
+  // digits plotted since the last update of the number of entries of the electronics view histograms
+  uint64_t mNofPlottedDigits{ 0 };
+  uint64_t mNofPlottedSignalDigits{ 0 };
+
   uint32_t mNOrbits[FecId::sFeeNum][FecId::sLinkNum];
   uint32_t mLastOrbitSeen[FecId::sFeeNum][FecId::sLinkNum];
 
   // 2D Histograms, using Elec view (where x and y uniquely identify each pad based on its Elec info (fee, link, de)
-  std::unique_ptr<MergeableTH2Ratio> mHistogramOccupancyElec;       // Occupancy histogram (Elec view)
-  std::unique_ptr<MergeableTH2Ratio> mHistogramSignalOccupancyElec; // Occupancy histogram (Elec view) for signal-like digits
+  std::unique_ptr<MergeableTH2CounterRatio> mHistogramOccupancyElec;       // Occupancy histogram (Elec view)
+  std::unique_ptr<MergeableTH2CounterRatio> mHistogramSignalOccupancyElec; // Occupancy histogram (Elec view) for signal-like digits
 
   // TH2F* mHistNum;
   // TH2F* mHistDen;
@@ -107,7 +114,7 @@ class DigitsTask /*final*/ : public TaskInterface // todo add back the "final" w
   std::unique_ptr<TH2F> mHistogramDigitsBcInOrbit;
   std::unique_ptr<TH2F> mHistogramAmplitudeVsSamples;
 
-  std::map<int, std::unique_ptr<TH1F>> mHistogramADCamplitudeDE; // Histogram of ADC distribution per DE
+  std::array<std::unique_ptr<TH1F>, getNumDE()> mHistogramADCamplitudeDE; // Histogram of ADC distribution per DE, indexed by getDEindex()
 
   std::vector<TH1*> mAllHistograms;
 };
@@ -0,0 +1,75 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   PadLookupTable.h
+///
+
+#ifndef QC_MODULE_MUONCHAMBERS_PADLOOKUPTABLE_H
+#define QC_MODULE_MUONCHAMBERS_PADLOOKUPTABLE_H
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace o2
+{
+namespace quality_control_modules
+{
+namespace muonchambers
+{
+
+/// \brief Flat table giving the electronics coordinates of each pad of the spectrometer.
+///
+/// The table is built once from the mapping, then (deId, padId) is resolved with two array accesses instead of
+/// querying the segmentation and the global DS index for each digit. The entries of a detection element are
+/// contiguous, the detection elements being indexed by their id.
+class PadLookupTable
+{
+ public:
+  struct Entry {
+    uint32_t elecBin; ///< global bin of the pad in the histograms of the electronics view (DS index vs channel)
+    uint16_t dsIndex; ///< global index of the dual SAMPA, i.e. the x bin in the electronics view
+    uint8_t channel;  ///< channel of the pad in the dual SAMPA
+    uint8_t deIndex;  ///< slot of the detection element, as given by getDEindex()
+  };
+
+  /// largest detection element id + 1
+  static constexpr int sMaxDeId = 1026;
+  /// number of x bins of the electronics view histograms, without under- and overflow
+  static int nElecXbins();
+
+  /// Fills the table for all the detection elements. It takes some time, it should be called once at initialization.
+  void build();
+  bool empty() const { return mEntries.empty(); }
+  size_t size() const { return mEntries.size(); }
+
+  /// Returns the entry of the pad or nullptr if the pad does not exist.
+  const Entry* find(int deId, int padId) const
+  {
+    if (deId < 0 || deId >= sMaxDeId || padId < 0) {
+      return nullptr;
+    }
+    const auto& [offset, nPads] = mDetectionElements[deId];
+    return padId < nPads ? &mEntries[offset + padId] : nullptr;
+  }
+
+ private:
+  std::array<std::pair<uint32_t, int32_t>, sMaxDeId> mDetectionElements{}; // offset of the first pad and number of pads
+  std::vector<Entry> mEntries;
+};
+
+} // namespace muonchambers
+} // namespace quality_control_modules
+} // namespace o2
+
+#endif // QC_MODULE_MUONCHAMBERS_PADLOOKUPTABLE_H
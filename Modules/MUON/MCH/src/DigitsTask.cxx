@@ -40,6 +40,10 @@ using namespace o2::mch::raw;
 
 static int nCycles = 0;
 
+static constexpr double sOrbitLengthInNanoseconds = 3564 * 25;
+static constexpr double sOrbitLengthInMicroseconds = sOrbitLengthInNanoseconds / 1000;
+static constexpr double sOrbitLengthInMilliseconds = sOrbitLengthInMicroseconds / 1000;
+
 namespace o2
 {
 namespace quality_control_modules
@@ -69,15 +73,18 @@ void DigitsTask::initialize(o2::framework::InitContext& /*ctx*/)
   mElec2DetMapper = createElec2DetMapper<ElectronicMapperGenerated>();
   mFeeLink2SolarMapper = createFeeLink2SolarMapper<ElectronicMapperGenerated>();
 
-  const uint32_t nElecXbins = NumberOfDualSampas;
+  const uint32_t nElecXbins = PadLookupTable::nElecXbins();
+  mPadLookupTable.build();
 
   resetOrbits();
 
   // Histograms in electronics coordinates
-  mHistogramOccupancyElec = std::make_unique<MergeableTH2Ratio>("Occupancy_Elec", "Occupancy", nElecXbins, 0, nElecXbins, 64, 0, 64);
+  mHistogramOccupancyElec = std::make_unique<MergeableTH2CounterRatio>("Occupancy_Elec", "Occupancy", nElecXbins, 0, nElecXbins, 64, 0, 64);
+  mHistogramOccupancyElec->setDenScale(sOrbitLengthInMilliseconds);
   publishObject(mHistogramOccupancyElec.get(), "colz", false, false);
 
-  mHistogramSignalOccupancyElec = std::make_unique<MergeableTH2Ratio>("OccupancySignal_Elec", "Occupancy (signal)", nElecXbins, 0, nElecXbins, 64, 0, 64);
+  mHistogramSignalOccupancyElec = std::make_unique<MergeableTH2CounterRatio>("OccupancySignal_Elec", "Occupancy (signal)", nElecXbins, 0, nElecXbins, 64, 0, 64);
+  mHistogramSignalOccupancyElec->setDenScale(sOrbitLengthInMilliseconds);
   publishObject(mHistogramSignalOccupancyElec.get(), "colz", false, false);
 
   mHistogramDigitsOrbitElec = std::make_unique<TH2F>("DigitOrbit_Elec", "Digit orbits vs DS Id", nElecXbins, 0, nElecXbins, 768, -384, 384);
@@ -97,7 +104,7 @@ void DigitsTask::initialize(o2::framework::InitContext& /*ctx*/)
     auto h = std::make_unique<TH1F>(TString::Format("Expert/%sADCamplitude_DE%03d", getHistoPath(de).c_str(), de),
                                     TString::Format("ADC amplitude (DE%03d)", de), 5000, 0, 5000);
     publishObject(h.get(), "hist", false, true);
-    mHistogramADCamplitudeDE.emplace(de, std::move(h));
+    mHistogramADCamplitudeDE[getDEindex(de)] = std::move(h);
   }
 }
 
@@ -148,6 +155,7 @@ void DigitsTask::monitorData(o2::framework::ProcessingContext& ctx)
   for (auto& d : digits) {
     plotDigit(d);
   }
+  updateEntries();
 }
 
 void DigitsTask::storeOrbit(const uint64_t& orb)
@@ -179,6 +187,16 @@ void DigitsTask::addDefaultOrbitsInTF()
   }
 }
 
+/// Increments a bin of a histogram which is never filled with TH1::Fill, its statistics are then computed from the bin
+/// contents when needed. The number of entries has to be updated separately.
+static void incrementBin(TH2F* histogram, int bin)
+{
+  histogram->AddBinContent(bin);
+  if (histogram->GetSumw2N() > 0) {
+    histogram->GetSumw2()->fArray[bin] += 1;
+  }
+}
+
 void DigitsTask::plotDigit(const o2::mch::Digit& digit)
 {
   int ADC = digit.getADC();
@@ -189,34 +207,33 @@ void DigitsTask::plotDigit(const o2::mch::Digit& digit)
     return;
   }
 
-  // Fill NHits Elec Histogram and ADC distribution
-  const o2::mch::mapping::Segmentation& segment = o2::mch::mapping::segmentation(deId);
-
-  int dsId = segment.padDualSampaId(padId);
-  int channel = segment.padDualSampaChannel(padId);
+  // electronics coordinates and bins of the pad, which uniquely identify each physical pad
+  const auto* pad = mPadLookupTable.find(deId, padId);
+  if (pad == nullptr) {
+    return;
+  }
 
   bool isSignal = mIsSignalDigit(digit);
+  mNofPlottedDigits++;
+  if (isSignal) {
+    mNofPlottedSignalDigits++;
+  }
 
   //--------------------------------------------------------------------------
   // Occupancy plots
   //--------------------------------------------------------------------------
 
-  // xbin and ybin uniquely identify each physical pad
-  int xbin = getDsIndex(DsDetId{ deId, dsId });
-  int ybin = channel + 1;
-
-  mHistogramOccupancyElec->getNum()->Fill(xbin - 0.5, ybin - 0.5);
+  mHistogramOccupancyElec->incrementNum(pad->elecBin);
   if (isSignal) {
-    mHistogramSignalOccupancyElec->getNum()->Fill(xbin - 0.5, ybin - 0.5);
+    mHistogramSignalOccupancyElec->incrementNum(pad->elecBin);
   }
 
   //--------------------------------------------------------------------------
   // ADC amplitude plots
   //--------------------------------------------------------------------------
 
-  auto h = mHistogramADCamplitudeDE.find(deId);
-  if ((h != mHistogramADCamplitudeDE.end()) && (h->second != NULL)) {
-    h->second->Fill(ADC);
+  if (const auto& h = mHistogramADCamplitudeDE[pad->deIndex]; h) {
+    h->Fill(ADC);
   }
   mHistogramAmplitudeVsSamples->Fill(digit.getNofSamples(), ADC);
 
@@ -231,19 +248,28 @@ void DigitsTask::plotDigit(const o2::mch::Digit& digit)
     orbit = digit.getTime() / static_cast<int32_t>(o2::constants::lhc::LHCMaxBunches);
     bc = digit.getTime() % static_cast<int32_t>(o2::constants::lhc::LHCMaxBunches);
   }
-  mHistogramDigitsOrbitElec->Fill(xbin - 0.5, orbit);
-  mHistogramDigitsBcInOrbit->Fill(xbin - 0.5, bc);
+  // the x bin is the DS index, as in the occupancy plots, and the y axes have fixed bins
+  const int nx = mHistogramDigitsOrbitElec->GetNbinsX() + 2;
+  int orbitBin = pad->dsIndex + nx * mHistogramDigitsOrbitElec->GetYaxis()->FindFixBin(orbit);
+  incrementBin(mHistogramDigitsOrbitElec.get(), orbitBin);
+  incrementBin(mHistogramDigitsBcInOrbit.get(), pad->dsIndex + nx * mHistogramDigitsBcInOrbit->GetYaxis()->FindFixBin(bc));
   if (isSignal) {
-    mHistogramDigitsSignalOrbitElec->Fill(xbin - 0.5, orbit);
+    incrementBin(mHistogramDigitsSignalOrbitElec.get(), orbitBin);
   }
 }
 
-void DigitsTask::updateOrbits()
+void DigitsTask::updateEntries()
 {
-  static constexpr double sOrbitLengthInNanoseconds = 3564 * 25;
-  static constexpr double sOrbitLengthInMicroseconds = sOrbitLengthInNanoseconds / 1000;
-  static constexpr double sOrbitLengthInMilliseconds = sOrbitLengthInMicroseconds / 1000;
+  for (auto* h : { mHistogramDigitsOrbitElec.get(), mHistogramDigitsBcInOrbit.get() }) {
+    h->SetEntries(h->GetEntries() + mNofPlottedDigits);
+  }
+  mHistogramDigitsSignalOrbitElec->SetEntries(mHistogramDigitsSignalOrbitElec->GetEntries() + mNofPlottedSignalDigits);
+  mNofPlottedDigits = 0;
+  mNofPlottedSignalDigits = 0;
+}
 
+void DigitsTask::updateOrbits()
+{
   // Fill NOrbits, in Elec view, for electronics channels associated to readout pads (in order to then compute the Occupancy in Elec view, physically meaningful because in Elec view, each bin is a physical pad)
   for (uint16_t feeId = 0; feeId < FecId::sFeeNum; feeId++) {
 
@@ -282,8 +308,10 @@ void DigitsTask::updateOrbits()
           }
 
           int ybin = channel + 1;
-          mHistogramOccupancyElec->getDen()->SetBinContent(xbin, ybin, mNOrbits[feeId][linkId] * sOrbitLengthInMilliseconds);
-          mHistogramSignalOccupancyElec->getDen()->SetBinContent(xbin, ybin, mNOrbits[feeId][linkId] * sOrbitLengthInMilliseconds);
+          // the denominators count the orbits, which are converted to milliseconds by update()
+          int bin = mHistogramOccupancyElec->GetBin(xbin, ybin);
+          mHistogramOccupancyElec->setDen(bin, mNOrbits[feeId][linkId]);
+          mHistogramSignalOccupancyElec->setDen(bin, mNOrbits[feeId][linkId]);
         }
       }
     }
@@ -323,6 +351,8 @@ void DigitsTask::reset()
   ILOG(Debug, Devel) << "Resetting the histograms" << AliceO2::InfoLogger::InfoLogger::endm;
 
   resetOrbits();
+  mNofPlottedDigits = 0;
+  mNofPlottedSignalDigits = 0;
 
   for (auto h : mAllHistograms) {
     h->Reset();
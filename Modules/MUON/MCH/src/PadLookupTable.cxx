@@ -0,0 +1,67 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   PadLookupTable.cxx
+///
+
+#include "MCH/PadLookupTable.h"
+#include "MCH/Helpers.h"
+#include "MCHConstants/DetectionElements.h"
+#include "MCHGlobalMapping/DsIndex.h"
+#include "MCHMappingInterface/Segmentation.h"
+
+using namespace o2::mch;
+
+namespace o2
+{
+namespace quality_control_modules
+{
+namespace muonchambers
+{
+
+int PadLookupTable::nElecXbins()
+{
+  return NumberOfDualSampas;
+}
+
+void PadLookupTable::build()
+{
+  mDetectionElements.fill({ 0, 0 });
+  mEntries.clear();
+
+  size_t nPadsTotal = 0;
+  for (auto deId : o2::mch::constants::deIdsForAllMCH) {
+    nPadsTotal += o2::mch::mapping::segmentation(deId).nofPads();
+  }
+  mEntries.reserve(nPadsTotal);
+
+  // the histograms have one underflow and one overflow bin on each axis
+  const uint32_t nx = nElecXbins() + 2;
+  for (auto deId : o2::mch::constants::deIdsForAllMCH) {
+    const auto& segment = o2::mch::mapping::segmentation(deId);
+    int nPads = segment.nofPads();
+    mDetectionElements[deId] = { static_cast<uint32_t>(mEntries.size()), nPads };
+    auto deIndex = static_cast<uint8_t>(getDEindex(deId));
+    for (int padId = 0; padId < nPads; padId++) {
+      int dsId = segment.padDualSampaId(padId);
+      int channel = segment.padDualSampaChannel(padId);
+      auto dsIndex = static_cast<uint16_t>(getDsIndex(DsDetId{ deId, dsId }));
+      // same bin as Fill(dsIndex - 0.5, channel + 0.5) on an axis starting at 0
+      uint32_t elecBin = dsIndex + nx * (channel + 1);
+      mEntries.push_back({ elecBin, dsIndex, static_cast<uint8_t>(channel), deIndex });
+    }
+  }
+}
+
+} // namespace muonchambers
+} // namespace quality_control_modules
+} // namespace o2
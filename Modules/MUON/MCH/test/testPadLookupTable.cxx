@@ -0,0 +1,98 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testPadLookupTable.cxx
+///
+
+#include "MCH/PadLookupTable.h"
+#include "MCH/Helpers.h"
+#include "MCHConstants/DetectionElements.h"
+#include "MCHGlobalMapping/DsIndex.h"
+#include "MCHMappingInterface/Segmentation.h"
+
+#include <TH2F.h>
+
+#define BOOST_TEST_MODULE PadLookupTable test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::mch;
+using namespace o2::quality_control_modules::muonchambers;
+
+namespace
+{
+TH2F makeElecHistogram(const char* name)
+{
+  const int nx = PadLookupTable::nElecXbins();
+  return TH2F(name, name, nx, 0, nx, 64, 0, 64);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_entries)
+{
+  PadLookupTable table;
+  BOOST_CHECK(table.empty());
+  table.build();
+  BOOST_REQUIRE(!table.empty());
+
+  size_t nPads = 0;
+  for (auto deId : o2::mch::constants::deIdsForAllMCH) {
+    const auto& segment = o2::mch::mapping::segmentation(deId);
+    nPads += segment.nofPads();
+    for (int padId : { 0, segment.nofPads() / 2, segment.nofPads() - 1 }) {
+      const auto* pad = table.find(deId, padId);
+      BOOST_REQUIRE(pad != nullptr);
+      int dsId = segment.padDualSampaId(padId);
+      BOOST_CHECK_EQUAL(pad->dsIndex, getDsIndex(DsDetId{ deId, dsId }));
+      BOOST_CHECK_EQUAL(int(pad->channel), segment.padDualSampaChannel(padId));
+      BOOST_CHECK_EQUAL(int(pad->deIndex), getDEindex(deId));
+    }
+    BOOST_CHECK(table.find(deId, segment.nofPads()) == nullptr);
+  }
+  BOOST_CHECK_EQUAL(table.size(), nPads);
+  BOOST_CHECK(table.find(0, 0) == nullptr);
+  BOOST_CHECK(table.find(100, -1) == nullptr);
+  BOOST_CHECK(table.find(PadLookupTable::sMaxDeId, 0) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_electronics_view)
+{
+  // the table fills the same bins as the mapping calls which DigitsTask used to make per digit
+  auto before = makeElecHistogram("before");
+  auto after = makeElecHistogram("after");
+  PadLookupTable table;
+  table.build();
+
+  size_t nDigits = 0;
+  for (auto deId : o2::mch::constants::deIdsForAllMCH) {
+    const auto& segment = o2::mch::mapping::segmentation(deId);
+    for (int padId = 0; padId < segment.nofPads(); padId += 97) {
+      int dsId = segment.padDualSampaId(padId);
+      int channel = segment.padDualSampaChannel(padId);
+      int xbin = getDsIndex(DsDetId{ deId, dsId });
+      before.Fill(xbin - 0.5, channel + 0.5);
+
+      const auto* pad = table.find(deId, padId);
+      BOOST_REQUIRE(pad != nullptr);
+      after.AddBinContent(pad->elecBin);
+      nDigits++;
+    }
+  }
+  after.SetEntries(nDigits);
+
+  BOOST_CHECK_EQUAL(before.GetEntries(), after.GetEntries());
+  for (int bin = 0; bin < before.GetNcells(); bin++) {
+    BOOST_REQUIRE_EQUAL(before.GetBinContent(bin), after.GetBinContent(bin));
+  }
+}
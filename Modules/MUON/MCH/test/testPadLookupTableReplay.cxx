@@ -0,0 +1,102 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testPadLookupTableReplay.cxx
+///
+
+#include "MCH/PadLookupTable.h"
+#include "MCH/Helpers.h"
+#include "MCHConstants/DetectionElements.h"
+#include "MCHGlobalMapping/DsIndex.h"
+#include "MCHMappingInterface/Segmentation.h"
+
+#include <TH2F.h>
+
+#define BOOST_TEST_MODULE PadLookupTable replay
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <random>
+
+using namespace o2::mch;
+using namespace o2::quality_control_modules::muonchambers;
+
+namespace
+{
+struct RecordedDigit {
+  int deId;
+  int padId;
+};
+
+/// Digits spread over all the pads of the spectrometer, as in a central Pb-Pb TF chunk
+std::vector<RecordedDigit> recordDigits(size_t nDigits)
+{
+  std::vector<int> deIds(o2::mch::constants::deIdsForAllMCH.begin(), o2::mch::constants::deIdsForAllMCH.end());
+  std::vector<int> nPads;
+  for (auto deId : deIds) {
+    nPads.push_back(o2::mch::mapping::segmentation(deId).nofPads());
+  }
+  std::mt19937 generator(42);
+  std::discrete_distribution<size_t> deDistribution(nPads.begin(), nPads.end());
+  std::vector<RecordedDigit> digits;
+  digits.reserve(nDigits);
+  for (size_t i = 0; i < nDigits; i++) {
+    auto de = deDistribution(generator);
+    digits.push_back({ deIds[de], std::uniform_int_distribution<int>(0, nPads[de] - 1)(generator) });
+  }
+  return digits;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_replay_pbpb_chunk)
+{
+  // Two million digits, i.e. the order of magnitude of a central Pb-Pb TF chunk, put in the electronics view
+  // with the mapping calls per digit and then with the table, whose build time is reported apart.
+  auto digits = recordDigits(2000000);
+  const int nx = PadLookupTable::nElecXbins();
+  TH2F before("before", "before", nx, 0, nx, 64, 0, 64);
+  TH2F after("after", "after", nx, 0, nx, 64, 0, 64);
+
+  auto start = std::chrono::steady_clock::now();
+  for (const auto& digit : digits) {
+    const auto& segment = o2::mch::mapping::segmentation(digit.deId);
+    int dsId = segment.padDualSampaId(digit.padId);
+    int channel = segment.padDualSampaChannel(digit.padId);
+    int xbin = getDsIndex(DsDetId{ digit.deId, dsId });
+    before.Fill(xbin - 0.5, channel + 0.5);
+  }
+  auto mappingDone = std::chrono::steady_clock::now();
+
+  PadLookupTable table;
+  table.build();
+  auto tableBuilt = std::chrono::steady_clock::now();
+  for (const auto& digit : digits) {
+    if (const auto* pad = table.find(digit.deId, digit.padId); pad) {
+      after.AddBinContent(pad->elecBin);
+    }
+  }
+  after.SetEntries(digits.size());
+  auto tableDone = std::chrono::steady_clock::now();
+
+  using ms = std::chrono::duration<double, std::milli>;
+  BOOST_TEST_MESSAGE("mapping per digit: " << ms(mappingDone - start).count() << " ms, table: "
+                                           << ms(tableDone - tableBuilt).count() << " ms (+ "
+                                           << ms(tableBuilt - mappingDone).count() << " ms to build it) for "
+                                           << digits.size() << " digits");
+
+  BOOST_CHECK_EQUAL(before.GetEntries(), after.GetEntries());
+  for (int bin = 0; bin < before.GetNcells(); bin++) {
+    BOOST_REQUIRE_EQUAL(before.GetBinContent(bin), after.GetBinContent(bin));
+  }
+}
@@ -30,8 +30,9 @@ using namespace o2::tof::compressed;
 
 // QC includes
 #include "QualityControl/TaskInterface.h"
-#include "Base/Counter.h"
+#include "Common/CounterArray.h"
 using namespace o2::quality_control::core;
+using o2::quality_control_modules::common::CounterArray;
 
 class TH1;
 class TH1F;
@@ -78,19 +79,19 @@ class RawDataDecoder final : public DecoderBase
   static const char* LTMDiagnosticName[nwords];     /// LTM Counter names
   static const char* TRMDiagnosticName[nwords];     /// TRM Counter names
   // Diagnostic counters
-  Counter<nRDHwords, RDHDiagnosticsName> mCounterRDH[ncrates];    /// RDH Counters
-  Counter<nwords, DRMDiagnosticName> mCounterDRM[ncrates];        /// DRM Counters
-  Counter<nwords, LTMDiagnosticName> mCounterLTM[ncrates];        /// LTM Counters
-  Counter<nwords, TRMDiagnosticName> mCounterTRM[ncrates][ntrms]; /// TRM Counters
+  CounterArray<nRDHwords> mCounterRDH[ncrates];     /// RDH Counters
+  CounterArray<nwords> mCounterDRM[ncrates];        /// DRM Counters
+  CounterArray<nwords> mCounterLTM[ncrates];        /// LTM Counters
+  CounterArray<nwords> mCounterTRM[ncrates][ntrms]; /// TRM Counters
   // Global counters
-  Counter<nequipments, nullptr> mCounterIndexEO;          /// Counter for the single electronic index
-  Counter<nequipments, nullptr> mCounterIndexEOInTimeWin; /// Counter for the single electronic index for noise analysis
-  Counter<nequipments, nullptr> mCounterNoisyChannels;    /// Counter for noisy channels
-  Counter<1024, nullptr> mCounterTimeBC;                  /// Counter for the Bunch Crossing Time
-  Counter<nstrips, nullptr> mCounterNoiseMap[ncrates][4]; /// Counter for the Noise Hit Map, counts per crate and per FEA (4 per strip)
-  Counter<ncrates, nullptr> mCounterRDHTriggers[2];       /// Counter for RDH triggers, one counts the triggers served to TDCs and one counts the triggers received
-  Counter<ncrates, nullptr> mCounterRDHOpen;              /// Counter for RDH open
-  Counter<800, nullptr> mCounterOrbitsPerCrate[ncrates];  /// Counter for orbits per crate
+  CounterArray<nequipments> mCounterIndexEO;          /// Counter for the single electronic index
+  CounterArray<nequipments> mCounterIndexEOInTimeWin; /// Counter for the single electronic index for noise analysis
+  CounterArray<nequipments> mCounterNoisyChannels;    /// Counter for noisy channels
+  CounterArray<1024> mCounterTimeBC;                  /// Counter for the Bunch Crossing Time
+  CounterArray<nstrips> mCounterNoiseMap[ncrates][4]; /// Counter for the Noise Hit Map, counts per crate and per FEA (4 per strip)
+  CounterArray<ncrates> mCounterRDHTriggers[2];       /// Counter for RDH triggers, one counts the triggers served to TDCs and one counts the triggers received
+  CounterArray<ncrates> mCounterRDHOpen;              /// Counter for RDH open
+  CounterArray<800> mCounterOrbitsPerCrate[ncrates];  /// Counter for orbits per crate
 
   /// Function to init histograms
   void initHistograms();
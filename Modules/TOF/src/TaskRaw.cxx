@@ -24,6 +24,7 @@
 #include <TH1F.h>
 #include <TH2F.h>
 #include <TEfficiency.h>
+#include <TMath.h>
 
 // O2 includes
 #include "DataFormatsTOF/CompressedDataFormat.h"
@@ -63,14 +64,14 @@ void RawDataDecoder::rdhHandler(const o2::header::RAWDataHeader* rdh)
 
   constexpr auto rdhCrateWord = 0xFF;
   if (RDHUtils::getPageCounter(rdh) == 0) { // if RDH open
-    mCounterRDHOpen.Count(rdh->feeId & rdhCrateWord);
+    mCounterRDHOpen.count(rdh->feeId & rdhCrateWord);
   }
 
-  mCounterRDH[rdh->feeId & rdhCrateWord].Count(0);
+  mCounterRDH[rdh->feeId & rdhCrateWord].count(0);
 
   // Case for the RDH word "fatal"
   if ((rdh->detectorField & 0x00001000) != 0) {
-    mCounterRDH[rdh->feeId & rdhCrateWord].Count(1);
+    mCounterRDH[rdh->feeId & rdhCrateWord].count(1);
     // LOG(warn) << "RDH flag \"fatal\" error occurred in crate " << static_cast<int>(rdh->feeId & rdhCrateWord);
   }
 
@@ -80,11 +81,11 @@ void RawDataDecoder::rdhHandler(const o2::header::RAWDataHeader* rdh)
     const int triggerreceived = ((rdh->detectorField >> 16) & rdhCrateWord);
     if (triggerserved < triggerreceived) {
       // RDH word "trigger error": served < received
-      mCounterRDH[rdh->feeId & rdhCrateWord].Count(2);
+      mCounterRDH[rdh->feeId & rdhCrateWord].count(2);
     }
     // Numerator and denominator for the trigger efficiency
-    mCounterRDHTriggers[0].Add(rdh->feeId & rdhCrateWord, triggerserved);
-    mCounterRDHTriggers[1].Add(rdh->feeId & rdhCrateWord, triggerreceived);
+    mCounterRDHTriggers[0].add(rdh->feeId & rdhCrateWord, triggerserved);
+    mCounterRDHTriggers[1].add(rdh->feeId & rdhCrateWord, triggerreceived);
   }
 }
 
@@ -92,18 +93,18 @@ void RawDataDecoder::headerHandler(const CrateHeader_t* crateHeader, const Crate
 {
 
   // DRM Counter
-  mCounterDRM[crateHeader->drmID].Count(0);
+  mCounterDRM[crateHeader->drmID].count(0);
 
   // LTM Counter
   if (crateHeader->slotPartMask & (1 << 0)) {
-    mCounterLTM[crateHeader->drmID].Count(0);
+    mCounterLTM[crateHeader->drmID].count(0);
   }
 
   // Participating slot
   for (int ibit = 1; ibit < 11; ++ibit) {
     if (crateHeader->slotPartMask & (1 << ibit)) {
       // TRM Counter
-      mCounterTRM[crateHeader->drmID][ibit - 1].Count(0);
+      mCounterTRM[crateHeader->drmID][ibit - 1].count(0);
     }
   }
 
@@ -132,18 +133,18 @@ void RawDataDecoder::frameHandler(const CrateHeader_t* crateHeader, const CrateO
     const int timebc = time % 1024;
 
     // Equipment index (Electronics Oriented)
-    mCounterIndexEO.Count(indexE);
+    mCounterIndexEO.count(indexE);
     // Raw time
     mHistoTime->Fill(time);
     // BC time
-    mCounterTimeBC.Count(timebc);
+    mCounterTimeBC.count(timebc);
     // ToT
     mHistoTOT->Fill(packedHit->tot);
     // Equipment index for noise analysis (Electronics Oriented)
     if (time < mTimeMin || time >= mTimeMax) {
       continue;
     }
-    mCounterIndexEOInTimeWin.Count(indexE);
+    mCounterIndexEOInTimeWin.count(indexE);
   }
 }
 
@@ -161,19 +162,19 @@ void RawDataDecoder::trailerHandler(const CrateHeader_t* crateHeader, const Crat
     if (slotID == 1) { // Here we have a DRM
       for (unsigned int j = 0; j < words_to_check; j++) {
         if (diagnostic->faultBits & 1 << j) {
-          mCounterDRM[drmID].Count(j + reserved_words);
+          mCounterDRM[drmID].count(j + reserved_words);
         }
       }
     } else if (slotID == 2) { // Here we have a LTM
       for (unsigned int j = 0; j < words_to_check; j++) {
         if (diagnostic->faultBits & 1 << j) {
-          mCounterLTM[drmID].Count(j + reserved_words);
+          mCounterLTM[drmID].count(j + reserved_words);
         }
       }
     } else { // Here we have a TRM
       for (unsigned int j = 0; j < words_to_check; j++) {
         if (diagnostic->faultBits & 1 << j) {
-          mCounterTRM[drmID][slotID - 3].Count(j + reserved_words);
+          mCounterTRM[drmID][slotID - 3].count(j + reserved_words);
         }
       }
     }
@@ -235,19 +236,19 @@ void RawDataDecoder::initHistograms() // Initialization of histograms in Decoder
 void RawDataDecoder::resetHistograms() // Reset of histograms in Decoder
 {
   // Reset counters
-  mCounterIndexEO.Reset();
-  mCounterIndexEOInTimeWin.Reset();
-  mCounterNoisyChannels.Reset();
-  mCounterTimeBC.Reset();
+  mCounterIndexEO.reset();
+  mCounterIndexEOInTimeWin.reset();
+  mCounterNoisyChannels.reset();
+  mCounterTimeBC.reset();
   for (unsigned int i = 0; i < ncrates; i++) {
-    mCounterOrbitsPerCrate[i].Reset();
+    mCounterOrbitsPerCrate[i].reset();
     for (unsigned int j = 0; j < 4; j++) {
-      mCounterNoiseMap[i][j].Reset();
+      mCounterNoiseMap[i][j].reset();
     }
   }
-  mCounterRDHTriggers[0].Reset();
-  mCounterRDHTriggers[1].Reset();
-  mCounterRDHOpen.Reset();
+  mCounterRDHTriggers[0].reset();
+  mCounterRDHTriggers[1].reset();
+  mCounterRDHOpen.reset();
 
   // Reset histograms
   mHistoHits->Reset();
@@ -276,12 +277,12 @@ void RawDataDecoder::estimateNoise(std::shared_ptr<TH1F> hIndexEOIsNoise)
   double IntegratedTime[nstrips][ncrates] = { { 0. } };
 
   for (unsigned int i = 0; i < nequipments; ++i) {
-    const auto indexcounter = mCounterIndexEOInTimeWin.HowMany(i);
+    const auto indexcounter = mCounterIndexEOInTimeWin.get(i);
     const unsigned int crate = i / 2400;
     const int crate_ = i % 2400;
     const int slot = crate_ / 240;
     const double time_window = mTDCWidth * (mTimeMax - mTimeMin);
-    const double time = mCounterTRM[crate][slot - 3].HowMany(0) * time_window;
+    const double time = mCounterTRM[crate][slot - 3].get(0) * time_window;
 
     // start measure time from 1 micro second
     if (time < 1.e-6) {
@@ -319,14 +320,14 @@ void RawDataDecoder::estimateNoise(std::shared_ptr<TH1F> hIndexEOIsNoise)
     const auto strrow_ = strip_ % 48;
     const auto fea = strrow_ / 12;
 
-    mCounterNoisyChannels.Add(i, indexcounter);
+    mCounterNoisyChannels.add(i, indexcounter);
     IntegratedTime[strip][crate] += time;
-    mCounterNoiseMap[crate][fea].Add(strip, indexcounter);
+    mCounterNoiseMap[crate][fea].add(strip, indexcounter);
     IntegratedTimeFea[strip][crate][fea] += time;
   } // end loop over index
 
   // Fill noisy channels histogram
-  mCounterNoisyChannels.FillHistogram(hIndexEOIsNoise.get());
+  mCounterNoisyChannels.fill(hIndexEOIsNoise.get());
 
   for (unsigned int icrate = 0; icrate < ncrates; icrate++) {
     for (unsigned int istrip = 0; istrip < nstrips; istrip++) {
@@ -338,7 +339,7 @@ void RawDataDecoder::estimateNoise(std::shared_ptr<TH1F> hIndexEOIsNoise)
       }
 
       for (int iFea = 0; iFea < 4; iFea++) {
-        const auto indexcounterFea = mCounterNoiseMap[icrate][iFea].HowMany(istrip);
+        const auto indexcounterFea = mCounterNoiseMap[icrate][iFea].get(istrip);
         const auto timeFea = IntegratedTimeFea[istrip][icrate][iFea];
 
         // start measure time from 1 micro second
@@ -379,28 +380,28 @@ void TaskRaw::initialize(o2::framework::InitContext& /*ctx*/)
 
   // RDH
   mHistoRDH = std::make_shared<TH2F>("RDHCounter", "RDH Diagnostics;RDH Word;Crate;Words",
-                                     RawDataDecoder::nwords, 0, RawDataDecoder::nwords,
+                                     RawDataDecoder::nRDHwords, 0, RawDataDecoder::nRDHwords,
                                      RawDataDecoder::ncrates, 0, RawDataDecoder::ncrates);
-  mDecoderRaw.mCounterRDH[0].MakeHistogram(mHistoRDH.get());
+  common::setBinLabels(mHistoRDH->GetXaxis(), RawDataDecoder::RDHDiagnosticsName, RawDataDecoder::nRDHwords);
   getObjectsManager()->startPublishing(mHistoRDH.get());
   // DRM
   mHistoDRM = std::make_shared<TH2F>("DRMCounter", "DRM Diagnostics;DRM Word;Crate;Words",
                                      RawDataDecoder::nwords, 0, RawDataDecoder::nwords,
                                      RawDataDecoder::ncrates, 0, RawDataDecoder::ncrates);
-  mDecoderRaw.mCounterDRM[0].MakeHistogram(mHistoDRM.get());
+  common::setBinLabels(mHistoDRM->GetXaxis(), RawDataDecoder::DRMDiagnosticName, RawDataDecoder::nwords);
   getObjectsManager()->startPublishing(mHistoDRM.get());
   // LTM
   mHistoLTM = std::make_shared<TH2F>("LTMCounter", "LTM Diagnostics;LTM Word;Crate;Words",
                                      RawDataDecoder::nwords, 0, RawDataDecoder::nwords,
                                      RawDataDecoder::ncrates, 0, RawDataDecoder::ncrates);
-  mDecoderRaw.mCounterLTM[0].MakeHistogram(mHistoLTM.get());
+  common::setBinLabels(mHistoLTM->GetXaxis(), RawDataDecoder::LTMDiagnosticName, RawDataDecoder::nwords);
   getObjectsManager()->startPublishing(mHistoLTM.get());
   // TRMs
   for (unsigned int j = 0; j < RawDataDecoder::ntrms; j++) {
     mHistoTRM[j] = std::make_shared<TH2F>(Form("TRMCounterSlot%02i", j + 3), Form("TRM Slot %i Diagnostics;TRM Word;Crate;Words", j + 3),
                                           RawDataDecoder::nwords, 0, RawDataDecoder::nwords,
                                           RawDataDecoder::ncrates, 0, RawDataDecoder::ncrates);
-    mDecoderRaw.mCounterTRM[0][j].MakeHistogram(mHistoTRM[j].get());
+    common::setBinLabels(mHistoTRM[j]->GetXaxis(), RawDataDecoder::TRMDiagnosticName, RawDataDecoder::nwords);
     getObjectsManager()->startPublishing(mHistoTRM[j].get());
   }
   // Whole Crates
@@ -432,27 +433,20 @@ void TaskRaw::initialize(o2::framework::InitContext& /*ctx*/)
   getObjectsManager()->startPublishing(mHistoSlotParticipating.get());
 
   mHistoIndexEO = std::make_shared<TH1F>("hIndexEO", "Index Electronics Oriented;index EO;Counts", RawDataDecoder::nequipments, 0., RawDataDecoder::nequipments);
-  mDecoderRaw.mCounterIndexEO.MakeHistogram(mHistoIndexEO.get());
   getObjectsManager()->startPublishing(mHistoIndexEO.get());
   mHistoIndexEOInTimeWin = std::make_shared<TH1F>("hIndexEOInTimeWin", "Index Electronics Oriented for noise analysis;index EO;Counts", RawDataDecoder::nequipments, 0., RawDataDecoder::nequipments);
-  mDecoderRaw.mCounterIndexEOInTimeWin.MakeHistogram(mHistoIndexEOInTimeWin.get());
   getObjectsManager()->startPublishing(mHistoIndexEOInTimeWin.get());
   mHistoTimeBC = std::make_shared<TH1F>("hTimeBC", "Raw BC Time;BC time (24.4 ps);Counts", 1024, 0., 1024.);
-  mDecoderRaw.mCounterTimeBC.MakeHistogram(mHistoTimeBC.get());
   getObjectsManager()->startPublishing(mHistoTimeBC.get());
   mHistoIndexEOIsNoise = std::make_shared<TH1F>("hIndexEOIsNoise", "Noisy Channels; index EO;Counts", RawDataDecoder::nequipments, 0., RawDataDecoder::nequipments);
-  mDecoderRaw.mCounterNoisyChannels.MakeHistogram(mHistoIndexEOIsNoise.get());
   getObjectsManager()->startPublishing(mHistoIndexEOIsNoise.get());
-  mHistoRDHReceived = std::make_shared<TH1F>("hRDHTriggersReceived", "RDH Trigger Received;Crate;Triggers_{received}", RawDataDecoder::ncrates, 0, RawDataDecoder::ncrates + 1);
-  mDecoderRaw.mCounterRDHTriggers[1].MakeHistogram(mHistoRDHReceived.get());
+  mHistoRDHReceived = std::make_shared<TH1F>("hRDHTriggersReceived", "RDH Trigger Received;Crate;Triggers_{received}", RawDataDecoder::ncrates, 0, RawDataDecoder::ncrates);
   getObjectsManager()->startPublishing(mHistoRDHReceived.get());
-  mHistoRDHServed = std::make_shared<TH1F>("hRDHTriggersServed", "RDH Trigger Served;Crate;Triggers_{served}", RawDataDecoder::ncrates, 0, RawDataDecoder::ncrates + 1);
-  mDecoderRaw.mCounterRDHTriggers[0].MakeHistogram(mHistoRDHServed.get());
+  mHistoRDHServed = std::make_shared<TH1F>("hRDHTriggersServed", "RDH Trigger Served;Crate;Triggers_{served}", RawDataDecoder::ncrates, 0, RawDataDecoder::ncrates);
   getObjectsManager()->startPublishing(mHistoRDHServed.get());
-  mEffRDHTriggers = new TEfficiency("hEffRDHTriggers", "RDH Efficiency vs Crate; Crate; Eff(Served/Received)", RawDataDecoder::ncrates, 0, RawDataDecoder::ncrates + 1);
+  mEffRDHTriggers = new TEfficiency("hEffRDHTriggers", "RDH Efficiency vs Crate; Crate; Eff(Served/Received)", RawDataDecoder::ncrates, 0, RawDataDecoder::ncrates);
   getObjectsManager()->startPublishing(mEffRDHTriggers);
   mHistoOrbitsPerCrate = std::make_shared<TH2F>("hOrbitsPerCrate", "Orbits per Crate;Orbits;Crate;Events", 800, 0, 800., RawDataDecoder::ncrates, 0, RawDataDecoder::ncrates + 1);
-  mDecoderRaw.mCounterOrbitsPerCrate[0].MakeHistogram(mHistoOrbitsPerCrate.get());
   getObjectsManager()->startPublishing(mHistoOrbitsPerCrate.get());
 
   mDecoderRaw.initHistograms();
@@ -491,7 +485,7 @@ void TaskRaw::startOfCycle()
 void TaskRaw::monitorData(o2::framework::ProcessingContext& ctx)
 {
   // Reset counter before decode() call
-  mDecoderRaw.mCounterRDHOpen.Reset();
+  mDecoderRaw.mCounterRDHOpen.reset();
   //
   {
     /** loop over input parts **/
@@ -511,10 +505,10 @@ void TaskRaw::monitorData(o2::framework::ProcessingContext& ctx)
   }
   // Count number of orbits per crate
   for (unsigned int ncrate = 0; ncrate < RawDataDecoder::ncrates; ncrate++) { // loop over crates
-    if (mDecoderRaw.mCounterRDHOpen.HowMany(ncrate) <= 799) {
-      mDecoderRaw.mCounterOrbitsPerCrate[ncrate].Count(mDecoderRaw.mCounterRDHOpen.HowMany(ncrate));
+    if (mDecoderRaw.mCounterRDHOpen.get(ncrate) <= 799) {
+      mDecoderRaw.mCounterOrbitsPerCrate[ncrate].count(mDecoderRaw.mCounterRDHOpen.get(ncrate));
     } else {
-      mDecoderRaw.mCounterOrbitsPerCrate[ncrate].Count(799);
+      mDecoderRaw.mCounterOrbitsPerCrate[ncrate].count(799);
     }
   }
 }
@@ -523,25 +517,25 @@ void TaskRaw::endOfCycle()
 {
   ILOG(Debug, Devel) << "endOfCycle" << ENDM;
   for (unsigned int crate = 0; crate < RawDataDecoder::ncrates; crate++) { // Filling histograms only at the end of the cycle
-    mDecoderRaw.mCounterRDH[crate].FillHistogram(mHistoRDH.get(), crate + 1);
-    mDecoderRaw.mCounterDRM[crate].FillHistogram(mHistoDRM.get(), crate + 1);
-    mDecoderRaw.mCounterLTM[crate].FillHistogram(mHistoLTM.get(), crate + 1);
-    mHistoSlotParticipating->SetBinContent(crate + 1, 2, mDecoderRaw.mCounterDRM[crate].HowMany(0));
-    mHistoSlotParticipating->SetBinContent(crate + 1, 3, mDecoderRaw.mCounterLTM[crate].HowMany(0));
-    mDecoderRaw.mCounterOrbitsPerCrate[crate].FillHistogram(mHistoOrbitsPerCrate.get(), crate + 1);
+    mDecoderRaw.mCounterRDH[crate].fill(mHistoRDH.get(), crate + 1);
+    mDecoderRaw.mCounterDRM[crate].fill(mHistoDRM.get(), crate + 1);
+    mDecoderRaw.mCounterLTM[crate].fill(mHistoLTM.get(), crate + 1);
+    mHistoSlotParticipating->SetBinContent(crate + 1, 2, mDecoderRaw.mCounterDRM[crate].get(0));
+    mHistoSlotParticipating->SetBinContent(crate + 1, 3, mDecoderRaw.mCounterLTM[crate].get(0));
+    mDecoderRaw.mCounterOrbitsPerCrate[crate].fill(mHistoOrbitsPerCrate.get(), crate + 1);
     for (unsigned int j = 0; j < RawDataDecoder::ntrms; j++) {
-      mDecoderRaw.mCounterTRM[crate][j].FillHistogram(mHistoTRM[j].get(), crate + 1);
-      mHistoSlotParticipating->SetBinContent(crate + 1, j + 4, mDecoderRaw.mCounterTRM[crate][j].HowMany(0));
+      mDecoderRaw.mCounterTRM[crate][j].fill(mHistoTRM[j].get(), crate + 1);
+      mHistoSlotParticipating->SetBinContent(crate + 1, j + 4, mDecoderRaw.mCounterTRM[crate][j].get(0));
     }
-    mHistoSlotParticipating->SetBinContent(crate + 1, 1, mDecoderRaw.mCounterRDH[crate].HowMany(0));
-    mDecoderRaw.mCounterRDHTriggers[1].FillHistogram(mHistoRDHReceived.get());
-    mDecoderRaw.mCounterRDHTriggers[0].FillHistogram(mHistoRDHServed.get());
+    mHistoSlotParticipating->SetBinContent(crate + 1, 1, mDecoderRaw.mCounterRDH[crate].get(0));
+    mDecoderRaw.mCounterRDHTriggers[1].fill(mHistoRDHReceived.get());
+    mDecoderRaw.mCounterRDHTriggers[0].fill(mHistoRDHServed.get());
   }
   mEffRDHTriggers->SetTotalHistogram(*mHistoRDHReceived, "f");
   mEffRDHTriggers->SetPassedHistogram(*mHistoRDHServed, "");
-  mDecoderRaw.mCounterIndexEO.FillHistogram(mHistoIndexEO.get());
-  mDecoderRaw.mCounterIndexEOInTimeWin.FillHistogram(mHistoIndexEOInTimeWin.get());
-  mDecoderRaw.mCounterTimeBC.FillHistogram(mHistoTimeBC.get());
+  mDecoderRaw.mCounterIndexEO.fill(mHistoIndexEO.get());
+  mDecoderRaw.mCounterIndexEOInTimeWin.fill(mHistoIndexEOInTimeWin.get());
+  mDecoderRaw.mCounterTimeBC.fill(mHistoTimeBC.get());
   mDecoderRaw.estimateNoise(mHistoIndexEOIsNoise);
 
   // Reshuffling information from the cards to the whole crate
@@ -566,8 +560,8 @@ void TaskRaw::endOfCycle()
     }
   }
   for (unsigned int crate = 0; crate < RawDataDecoder::ncrates; crate++) {              // Loop over crates for how many RDH read
-    for (unsigned int word = 0; word < mDecoderRaw.mCounterRDH[crate].Size(); word++) { // Loop over words
-      mHistoCrate[crate]->SetBinContent(word + 1, 1, mDecoderRaw.mCounterRDH[crate].HowMany(word));
+    for (unsigned int word = 0; word < mDecoderRaw.mCounterRDH[crate].size(); word++) { // Loop over words
+      mHistoCrate[crate]->SetBinContent(word + 1, 1, mDecoderRaw.mCounterRDH[crate].get(word));
     }
   }
 }
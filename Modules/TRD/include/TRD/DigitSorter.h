@@ -0,0 +1,63 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   DigitSorter.h
+///
+
+#ifndef QC_MODULE_TRD_DIGITSORTER_H
+#define QC_MODULE_TRD_DIGITSORTER_H
+
+#include "DataFormatsTRD/Digit.h"
+#include <gsl/span>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace o2::quality_control_modules::trd
+{
+
+/// \brief Orders the digits of a TF by detector, pad row and pad column, without copying them.
+///
+/// The digits stay in the input span, the sorter keeps a vector of indices into it. The ranges of the trigger records
+/// are sorted with a two pass radix sort on a packed (detector, row, column) key, which is linear in the number of
+/// digits. The buffers are kept from one TF to the next, so that no allocation is needed once they are large enough.
+class DigitSorter
+{
+ public:
+  /// Prepares the indices for a new TF, they are in the order of the span until the ranges are sorted.
+  void reset(gsl::span<const o2::trd::Digit> digits);
+  /// Sorts the indices in [first, first + count), e.g. the digits of one trigger record.
+  void sort(size_t first, size_t count);
+
+  /// Returns the index in the span of the i-th digit in the sorted order.
+  unsigned int operator[](size_t i) const { return mIndices[i]; }
+  const std::vector<unsigned int>& getIndices() const { return mIndices; }
+
+  /// Returns the sorting key of a digit. Invalid detectors are sorted last.
+  static uint32_t key(const o2::trd::Digit& digit);
+
+ private:
+  static constexpr int sRadixBits = 11;
+  static constexpr uint32_t sRadixSize = 1u << sRadixBits;
+
+  gsl::span<const o2::trd::Digit> mDigits;
+  std::vector<unsigned int> mIndices;
+  std::vector<unsigned int> mScratchIndices;
+  std::vector<uint32_t> mKeys;
+  std::vector<uint32_t> mScratchKeys;
+  std::vector<uint64_t> mPackedKeys; // key and index, for the small ranges
+  std::array<uint32_t, sRadixSize> mHistogram;
+};
+
+} // namespace o2::quality_control_modules::trd
+
+#endif // QC_MODULE_TRD_DIGITSORTER_H
@@ -21,6 +21,7 @@
 #include <array>
 #include "DataFormatsTRD/NoiseCalibration.h"
 #include "TRDQC/StatusHelper.h"
+#include "TRD/DigitSorter.h"
 
 class TH1F;
 class TH2F;
@@ -125,6 +126,7 @@ class DigitsTask final : public TaskInterface
   o2::trd::HalfChamberStatusQC* mChamberStatus = nullptr;
   std::string mChambersToIgnore;
   std::bitset<o2::trd::constants::MAXCHAMBER> mChambersToIgnoreBP;
+  DigitSorter mDigitSorter; // orders the digits of the current TF, its buffers are reused
 };
 
 } // namespace o2::quality_control_modules::trd
@@ -0,0 +1,100 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   DigitSorter.cxx
+///
+
+#include "TRD/DigitSorter.h"
+#include "DataFormatsTRD/Constants.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace o2::quality_control_modules::trd
+{
+
+// below this number of digits, sorting the keys is faster than clearing and scanning the radix histograms
+constexpr size_t sMinRadixSortSize = 256;
+
+uint32_t DigitSorter::key(const o2::trd::Digit& digit)
+{
+  using namespace o2::trd::constants;
+  int detector = digit.getDetector();
+  uint32_t det = (detector < 0 || detector >= MAXCHAMBER) ? MAXCHAMBER : detector;
+  uint32_t row = std::min<uint32_t>(digit.getPadRow(), NROWC1 - 1);
+  uint32_t col = std::min<uint32_t>(digit.getPadCol(), NCOLUMN - 1);
+  return (det * NROWC1 + row) * NCOLUMN + col;
+}
+
+void DigitSorter::reset(gsl::span<const o2::trd::Digit> digits)
+{
+  mDigits = digits;
+  mIndices.resize(digits.size());
+  std::iota(mIndices.begin(), mIndices.end(), 0);
+}
+
+void DigitSorter::sort(size_t first, size_t count)
+{
+  static_assert((o2::trd::constants::MAXCHAMBER + 1) * o2::trd::constants::NROWC1 * o2::trd::constants::NCOLUMN <= (1u << (2 * sRadixBits)),
+                "the keys must fit in two radix passes");
+  if (count < 2 || first + count > mIndices.size()) {
+    return;
+  }
+
+  unsigned int* indices = mIndices.data() + first;
+
+  if (count < sMinRadixSortSize) {
+    mPackedKeys.resize(count);
+    for (size_t i = 0; i < count; i++) {
+      mPackedKeys[i] = (uint64_t(key(mDigits[indices[i]])) << 32) | indices[i];
+    }
+    std::sort(mPackedKeys.begin(), mPackedKeys.end());
+    for (size_t i = 0; i < count; i++) {
+      indices[i] = static_cast<unsigned int>(mPackedKeys[i]);
+    }
+    return;
+  }
+
+  mKeys.resize(count);
+  for (size_t i = 0; i < count; i++) {
+    mKeys[i] = key(mDigits[indices[i]]);
+  }
+  mScratchKeys.resize(count);
+  mScratchIndices.resize(count);
+
+  // least significant digit first, each pass is stable. After the two passes the result is back in the input buffers.
+  uint32_t* keysIn = mKeys.data();
+  uint32_t* keysOut = mScratchKeys.data();
+  unsigned int* indicesIn = indices;
+  unsigned int* indicesOut = mScratchIndices.data();
+  for (int shift = 0; shift < 2 * sRadixBits; shift += sRadixBits) {
+    mHistogram.fill(0);
+    for (size_t i = 0; i < count; i++) {
+      mHistogram[(keysIn[i] >> shift) & (sRadixSize - 1)]++;
+    }
+    uint32_t offset = 0;
+    for (auto& bucket : mHistogram) {
+      auto size = bucket;
+      bucket = offset;
+      offset += size;
+    }
+    for (size_t i = 0; i < count; i++) {
+      auto position = mHistogram[(keysIn[i] >> shift) & (sRadixSize - 1)]++;
+      keysOut[position] = keysIn[i];
+      indicesOut[position] = indicesIn[i];
+    }
+    std::swap(keysIn, keysOut);
+    std::swap(indicesIn, indicesOut);
+  }
+}
+
+} // namespace o2::quality_control_modules::trd
@@ -562,29 +562,6 @@ void DigitsTask::startOfCycle()
   ILOG(Debug, Devel) << "startOfCycle" << ENDM;
 }
 
-bool digitIndexCompare(unsigned int A, unsigned int B, const std::vector<o2::trd::Digit>& originalDigits)
-{
-  // sort into ROC:padrow
-  const o2::trd::Digit *a, *b;
-  a = &originalDigits[A];
-  b = &originalDigits[B];
-  if (a->getDetector() < b->getDetector()) {
-    return 1;
-  }
-  if (a->getDetector() > b->getDetector()) {
-    return 0;
-  }
-  if (a->getPadRow() < b->getPadRow()) {
-    return 1;
-  }
-  if (a->getPadRow() > b->getPadRow()) {
-    return 0;
-  }
-  if (a->getPadCol() < b->getPadCol()) {
-    return 1;
-  }
-  return 0;
-}
 bool DigitsTask::isChamberToBeIgnored(unsigned int sm, unsigned int stack, unsigned int layer)
 {
   // just to make the calling method a bit cleaner
@@ -593,246 +570,239 @@ bool DigitsTask::isChamberToBeIgnored(unsigned int sm, unsigned int stack, unsig
 
 void DigitsTask::monitorData(o2::framework::ProcessingContext& ctx)
 {
-  for (auto&& input : ctx.inputs()) {
-    if (input.header != nullptr && input.payload != nullptr) {
-
-      auto digits = ctx.inputs().get<gsl::span<o2::trd::Digit>>("digits");
-      std::vector<o2::trd::Digit> digitv(digits.begin(), digits.end());
-
-      if (digitv.size() == 0)
+  // the inputs are read once per TF, the digits are used in place
+  auto digits = ctx.inputs().get<gsl::span<o2::trd::Digit>>("digits");
+  if (digits.empty()) {
+    return;
+  }
+  auto tracklets = ctx.inputs().get<gsl::span<o2::trd::Tracklet64>>("tracklets"); // still deciding if we will ever need the tracklets here.
+  auto triggerrecords = ctx.inputs().get<gsl::span<o2::trd::TriggerRecord>>("triggers");
+  // indices into the digits, which are sorted per trigger record
+  mDigitSorter.reset(digits);
+  const auto& digitsIndex = mDigitSorter.getIndices();
+  int DigitTrig = 0;
+
+  // we now have sorted digits, can loop sequentially and be going over det/row/pad
+  for (auto& trigger : triggerrecords) {
+    uint64_t numtracklets = trigger.getNumberOfTracklets();
+    uint64_t numdigits = trigger.getNumberOfDigits();
+    if (trigger.getNumberOfDigits() == 0)
+      continue; // bail if we have no digits in this trigger
+                // now sort digits to det,row,pad
+    DigitTrig++;
+    mDigitSorter.sort(trigger.getFirstDigit(), trigger.getNumberOfDigits());
+
+    ///////////////////////////////////////////////////
+    // Go through all chambers (using digits)
+    const int adcThresh = 13;
+    const int clsCutoff = 1000;
+    const int startRow[5] = { 0, 16, 32, 44, 60 };
+    if (trigger.getNumberOfDigits() > 10000) {
+      mDigitsPerEvent->Fill(9999);
+    } else {
+      mDigitsPerEvent->Fill(trigger.getNumberOfDigits());
+    }
+    int trackletnumfix = trigger.getNumberOfTracklets();
+    int digitnumfix = trigger.getNumberOfDigits();
+    if (trigger.getNumberOfTracklets() > 2499)
+      trackletnumfix = 2499;
+    if (trigger.getNumberOfDigits() > 24999)
+      trackletnumfix = 24999;
+    mDigitsSizevsTrackletSize->Fill(trigger.getNumberOfTracklets(), trigger.getNumberOfDigits());
+    int tbmax = 0;
+    int tbhi = 0;
+    int tblo = 0;
+
+    int det = 0;
+    int row = 0;
+    int pad = 0;
+    int channel = 0;
+
+    for (int currentdigit = trigger.getFirstDigit() + 1; currentdigit < trigger.getFirstDigit() + trigger.getNumberOfDigits() - 1; ++currentdigit) { // -1 and +1 as we are looking for consecutive digits pre and post the current one indexed.
+
+      if (digits[digitsIndex[currentdigit]].getChannel() > 21)
         continue;
-      auto tracklets = ctx.inputs().get<gsl::span<o2::trd::Tracklet64>>("tracklets"); // still deciding if we will ever need the tracklets here.
-      auto triggerrecords = ctx.inputs().get<gsl::span<o2::trd::TriggerRecord>>("triggers");
-      // create a vector indexing into the digits in question
-      std::vector<unsigned int> digitsIndex(digitv.size());
-      std::iota(digitsIndex.begin(), digitsIndex.end(), 0);
-      int DigitTrig = 0;
-
-      // we now have sorted digits, can loop sequentially and be going over det/row/pad
-      for (auto& trigger : triggerrecords) {
-        uint64_t numtracklets = trigger.getNumberOfTracklets();
-        uint64_t numdigits = trigger.getNumberOfDigits();
-        if (trigger.getNumberOfDigits() == 0)
-          continue; // bail if we have no digits in this trigger
-                    // now sort digits to det,row,pad
-        DigitTrig++;
-        std::sort(std::begin(digitsIndex) + trigger.getFirstDigit(), std::begin(digitsIndex) + trigger.getFirstDigit() + trigger.getNumberOfDigits(),
-                  [&digitv](unsigned int i, unsigned int j) { return digitIndexCompare(i, j, digitv); });
-
-        ///////////////////////////////////////////////////
-        // Go through all chambers (using digits)
-        const int adcThresh = 13;
-        const int clsCutoff = 1000;
-        const int startRow[5] = { 0, 16, 32, 44, 60 };
-        if (trigger.getNumberOfDigits() > 10000) {
-          mDigitsPerEvent->Fill(9999);
-        } else {
-          mDigitsPerEvent->Fill(trigger.getNumberOfDigits());
-        }
-        int trackletnumfix = trigger.getNumberOfTracklets();
-        int digitnumfix = trigger.getNumberOfDigits();
-        if (trigger.getNumberOfTracklets() > 2499)
-          trackletnumfix = 2499;
-        if (trigger.getNumberOfDigits() > 24999)
-          trackletnumfix = 24999;
-        mDigitsSizevsTrackletSize->Fill(trigger.getNumberOfTracklets(), trigger.getNumberOfDigits());
-        int tbmax = 0;
-        int tbhi = 0;
-        int tblo = 0;
-
-        int det = 0;
-        int row = 0;
-        int pad = 0;
-        int channel = 0;
-
-        for (int currentdigit = trigger.getFirstDigit() + 1; currentdigit < trigger.getFirstDigit() + trigger.getNumberOfDigits() - 1; ++currentdigit) { // -1 and +1 as we are looking for consecutive digits pre and post the current one indexed.
-
-          if (digits[digitsIndex[currentdigit]].getChannel() > 21)
-            continue;
-          int detector = digits[digitsIndex[currentdigit]].getDetector();
-          if (detector < 0 || detector >= 540) {
-            // for some reason online the sm value causes an error below and digittrask crashes.
-            // the only possibility is detector number is invalid
-            ILOG(Info, Support) << "Bad detector number from digit : " << detector << " for digit index of " << digitsIndex[currentdigit] << ENDM;
-            continue;
-          }
-          int sm = detector / 30;
-          int detLoc = detector % 30;
-          int layer = detector % 6;
-          int stack = detLoc / 6;
-          int chamber = sm * 30 + stack * o2::trd::constants::NLAYER + layer;
-          int nADChigh = 0;
-          int stackoffset = stack * o2::trd::constants::NROWC1;
-          int row = 0, col = 0;
-          if (stack >= 2)
-            stackoffset -= 4; // account for stack 2 having 4 less.
-          // for now the if statement is commented as there is a problem finding isShareDigit, will come back to that.
-          /// if (!digits[digitsIndex[currentdigit]].isSharedDigit() && !mSkipSharedDigits.second) {
-          int rowGlb = stack < 3 ? digits[digitsIndex[currentdigit]].getPadRow() + stack * 16 : digits[digitsIndex[currentdigit]].getPadRow() + 44 + (stack - 3) * 16; // pad row within whole sector
-          int colGlb = digits[digitsIndex[currentdigit]].getPadCol() + sm * 144;                                                                                       // pad column number from 0 to NSectors * 144
-          mLayers[layer]->Fill(rowGlb, colGlb);
-          //}
-          mHCMCM[sm]->Fill(digits[digitsIndex[currentdigit]].getPadRow() + stackoffset, digits[digitsIndex[currentdigit]].getPadCol());
-          mDigitHCID->Fill(digits[digitsIndex[currentdigit]].getHCId());
-          // after updating the 2 above histograms the first and last digits are of no use, as we are looking for 3 neighbouring digits after this.
-
-          auto adcs = digits[digitsIndex[currentdigit]].getADC();
-          row = digits[digitsIndex[currentdigit]].getPadRow();
-          pad = digits[digitsIndex[currentdigit]].getPadCol();
-          int sector = detector / 30;
-          // do we have 3 digits next to each other:
-          std::tuple<unsigned int, unsigned int, unsigned int> aa, ba, ca;
-          aa = std::make_tuple(digits[digitsIndex[currentdigit - 1]].getDetector(), digits[digitsIndex[currentdigit - 1]].getPadRow(), digits[digitsIndex[currentdigit - 1]].getPadCol());
-          ba = std::make_tuple(digits[digitsIndex[currentdigit]].getDetector(), digits[digitsIndex[currentdigit]].getPadRow(), digits[digitsIndex[currentdigit]].getPadCol());
-          ca = std::make_tuple(digits[digitsIndex[currentdigit + 1]].getDetector(), digits[digitsIndex[currentdigit + 1]].getPadRow(), digits[digitsIndex[currentdigit + 1]].getPadCol());
-          auto [det1, row1, col1] = aa;
-          auto [det2, row2, col2] = ba;
-          auto [det3, row3, col3] = ca;
-          // do we have 3 digits next to each other:
-          // check we 3 consecutive adc
-          bool consecutive = false;
-          if (det1 == det2 && det2 == det3 && row1 == row2 && row2 == row3 && col1 + 1 == col2 && col2 + 1 == col3) {
-            consecutive = true;
-          }
-          // illumination
-          mNClsLayer[layer]->Fill(sm - 0.5 + col / 144., startRow[stack] + row);
-          int digitindex = digitsIndex[currentdigit];
-          int digitindexbelow = digitsIndex[currentdigit - 1];
-          int digitindexabove = digitsIndex[currentdigit + 1];
-          for (int time = 1; time < o2::trd::constants::TIMEBINS - 1; ++time) {
-            int value = digits[digitsIndex[currentdigit]].getADC()[time];
-            if (value > adcThresh)
-              nADChigh++;
-
-            mADCvalue->Fill(value);
-            mADC[sm]->Fill(value);
-            mADCTB[sm]->Fill(time, value);
-
-            if (consecutive) {
-              // clusterize
-              if (value > digits[digitindexbelow].getADC()[time] &&
-                  value > digits[digitindexabove].getADC()[time]) {
-                // How do we determine this? HV/LME/other?
-                // if(ChamberHasProblems(sm,istack,layer)) continue;
-
-                value -= 10;
-
-                int value = digits[digitindex].getADC()[time];
-                int valueLU = (digits[digitindexbelow].getADC()[time - 1] < 10) ? 0 : digits[digitindexbelow].getADC()[time - 1] - 10;
-                int valueRU = (digits[digitindexabove].getADC()[time - 1] < 10) ? 0 : digits[digitindexabove].getADC()[time - 1] - 10;
-                int valueU = digits[digitindex].getADC()[time - 1] - 10;
-
-                int valueLD = (digits[digitindexbelow].getADC()[time + 1] < 10) ? 0 : digits[digitindexbelow].getADC()[time + 1] - 10;
-                int valueRD = (digits[digitindexabove].getADC()[time + 1] < 10) ? 0 : digits[digitindexabove].getADC()[time + 1] - 10;
-                int valueD = digits[digitindex].getADC()[time + 1] - 10;
-
-                int valueL = (digits[digitindexbelow].getADC()[time] < 10) ? 0 : digits[digitindexbelow].getADC()[time] - 10;
-                int valueR = (digits[digitindexabove].getADC()[time] < 10) ? 0 : digits[digitindexabove].getADC()[time] - 10;
-
-                int sum = value + valueL + valueR;
-                int sumU = valueU + valueLU + valueRU;
-                int sumD = valueD + valueLD + valueRD;
-
-                if (sumU < 10 || sumD < 10)
-                  continue;
-                if (TMath::Abs(1. * sum / sumU - 1) < 0.01)
-                  continue;
-                if (TMath::Abs(1. * sum / sumD - 1) < 0.01)
-                  continue;
-                if (TMath::Abs(1. * sumU / sumD - 1) < 0.01)
-                  continue;
-
-                mNCls->Fill(sm);
-                mTotNClsLayer->Fill(layer);
-                mClsSM[sm]->Fill(sum);
-                mClsTbSM[sm]->Fill(time, sum);
-                mClsTb->Fill(time, sum);
-                mClsChargeFirst->Fill(sum, (1. * sum / sumU) - 1.);
-                mClsChargeFirst->Fill(sum, (1. * sum / sumD) - 1.);
-
-                if (sum > 10 && sum < clsCutoff) {
-                  mClsChargeTb->Fill(time, sum);
-                  mClsNTb->Fill(time);
-                }
-
-                mClsAmp->Fill(sum);
-
-                if (time > mDriftRegion.first && time < mDriftRegion.second) {
-                  mClsAmpDrift->Fill(sum);
-                  mClsDetAmp[sm]->Fill(detLoc, sum);
+      int detector = digits[digitsIndex[currentdigit]].getDetector();
+      if (detector < 0 || detector >= 540) {
+        // for some reason online the sm value causes an error below and digittrask crashes.
+        // the only possibility is detector number is invalid
+        ILOG(Info, Support) << "Bad detector number from digit : " << detector << " for digit index of " << digitsIndex[currentdigit] << ENDM;
+        continue;
+      }
+      int sm = detector / 30;
+      int detLoc = detector % 30;
+      int layer = detector % 6;
+      int stack = detLoc / 6;
+      int chamber = sm * 30 + stack * o2::trd::constants::NLAYER + layer;
+      int nADChigh = 0;
+      int stackoffset = stack * o2::trd::constants::NROWC1;
+      int row = 0, col = 0;
+      if (stack >= 2)
+        stackoffset -= 4; // account for stack 2 having 4 less.
+      // for now the if statement is commented as there is a problem finding isShareDigit, will come back to that.
+      /// if (!digits[digitsIndex[currentdigit]].isSharedDigit() && !mSkipSharedDigits.second) {
+      int rowGlb = stack < 3 ? digits[digitsIndex[currentdigit]].getPadRow() + stack * 16 : digits[digitsIndex[currentdigit]].getPadRow() + 44 + (stack - 3) * 16; // pad row within whole sector
+      int colGlb = digits[digitsIndex[currentdigit]].getPadCol() + sm * 144;                                                                                       // pad column number from 0 to NSectors * 144
+      mLayers[layer]->Fill(rowGlb, colGlb);
+      //}
+      mHCMCM[sm]->Fill(digits[digitsIndex[currentdigit]].getPadRow() + stackoffset, digits[digitsIndex[currentdigit]].getPadCol());
+      mDigitHCID->Fill(digits[digitsIndex[currentdigit]].getHCId());
+      // after updating the 2 above histograms the first and last digits are of no use, as we are looking for 3 neighbouring digits after this.
+
+      auto adcs = digits[digitsIndex[currentdigit]].getADC();
+      row = digits[digitsIndex[currentdigit]].getPadRow();
+      pad = digits[digitsIndex[currentdigit]].getPadCol();
+      int sector = detector / 30;
+      // do we have 3 digits next to each other:
+      std::tuple<unsigned int, unsigned int, unsigned int> aa, ba, ca;
+      aa = std::make_tuple(digits[digitsIndex[currentdigit - 1]].getDetector(), digits[digitsIndex[currentdigit - 1]].getPadRow(), digits[digitsIndex[currentdigit - 1]].getPadCol());
+      ba = std::make_tuple(digits[digitsIndex[currentdigit]].getDetector(), digits[digitsIndex[currentdigit]].getPadRow(), digits[digitsIndex[currentdigit]].getPadCol());
+      ca = std::make_tuple(digits[digitsIndex[currentdigit + 1]].getDetector(), digits[digitsIndex[currentdigit + 1]].getPadRow(), digits[digitsIndex[currentdigit + 1]].getPadCol());
+      auto [det1, row1, col1] = aa;
+      auto [det2, row2, col2] = ba;
+      auto [det3, row3, col3] = ca;
+      // do we have 3 digits next to each other:
+      // check we 3 consecutive adc
+      bool consecutive = false;
+      if (det1 == det2 && det2 == det3 && row1 == row2 && row2 == row3 && col1 + 1 == col2 && col2 + 1 == col3) {
+        consecutive = true;
+      }
+      // illumination
+      mNClsLayer[layer]->Fill(sm - 0.5 + col / 144., startRow[stack] + row);
+      int digitindex = digitsIndex[currentdigit];
+      int digitindexbelow = digitsIndex[currentdigit - 1];
+      int digitindexabove = digitsIndex[currentdigit + 1];
+      for (int time = 1; time < o2::trd::constants::TIMEBINS - 1; ++time) {
+        int value = digits[digitsIndex[currentdigit]].getADC()[time];
+        if (value > adcThresh)
+          nADChigh++;
+
+        mADCvalue->Fill(value);
+        mADC[sm]->Fill(value);
+        mADCTB[sm]->Fill(time, value);
+
+        if (consecutive) {
+          // clusterize
+          if (value > digits[digitindexbelow].getADC()[time] &&
+              value > digits[digitindexabove].getADC()[time]) {
+            // How do we determine this? HV/LME/other?
+            // if(ChamberHasProblems(sm,istack,layer)) continue;
+
+            value -= 10;
+
+            int value = digits[digitindex].getADC()[time];
+            int valueLU = (digits[digitindexbelow].getADC()[time - 1] < 10) ? 0 : digits[digitindexbelow].getADC()[time - 1] - 10;
+            int valueRU = (digits[digitindexabove].getADC()[time - 1] < 10) ? 0 : digits[digitindexabove].getADC()[time - 1] - 10;
+            int valueU = digits[digitindex].getADC()[time - 1] - 10;
+
+            int valueLD = (digits[digitindexbelow].getADC()[time + 1] < 10) ? 0 : digits[digitindexbelow].getADC()[time + 1] - 10;
+            int valueRD = (digits[digitindexabove].getADC()[time + 1] < 10) ? 0 : digits[digitindexabove].getADC()[time + 1] - 10;
+            int valueD = digits[digitindex].getADC()[time + 1] - 10;
+
+            int valueL = (digits[digitindexbelow].getADC()[time] < 10) ? 0 : digits[digitindexbelow].getADC()[time] - 10;
+            int valueR = (digits[digitindexabove].getADC()[time] < 10) ? 0 : digits[digitindexabove].getADC()[time] - 10;
+
+            int sum = value + valueL + valueR;
+            int sumU = valueU + valueLU + valueRU;
+            int sumD = valueD + valueLD + valueRD;
+
+            if (sumU < 10 || sumD < 10)
+              continue;
+            if (TMath::Abs(1. * sum / sumU - 1) < 0.01)
+              continue;
+            if (TMath::Abs(1. * sum / sumD - 1) < 0.01)
+              continue;
+            if (TMath::Abs(1. * sumU / sumD - 1) < 0.01)
+              continue;
+
+            mNCls->Fill(sm);
+            mTotNClsLayer->Fill(layer);
+            mClsSM[sm]->Fill(sum);
+            mClsTbSM[sm]->Fill(time, sum);
+            mClsTb->Fill(time, sum);
+            mClsChargeFirst->Fill(sum, (1. * sum / sumU) - 1.);
+            mClsChargeFirst->Fill(sum, (1. * sum / sumD) - 1.);
+
+            if (sum > 10 && sum < clsCutoff) {
+              mClsChargeTb->Fill(time, sum);
+              mClsNTb->Fill(time);
+            }
+
+            mClsAmp->Fill(sum);
+
+            if (time > mDriftRegion.first && time < mDriftRegion.second) {
+              mClsAmpDrift->Fill(sum);
+              mClsDetAmp[sm]->Fill(detLoc, sum);
+            }
+            mClusterAmplitudeChamber->Fill(sum, chamber);
+
+            mClsSector->Fill(sm, sum);
+            mClsStack->Fill(stack, sum);
+
+            // This is pulseheight lifted from run2, probably not what was used.
+            mClsChargeTbTigg->Fill(time, sum);
+
+          } // if consecutive adc ( 3 next to each other and we are on the middle on
+        }   // loop over time-bins
+      }     // loop over col-pads
+
+      const o2::trd::Digit* mid = &digits[digitsIndex[currentdigit]];
+      const o2::trd::Digit* before = &digits[digitsIndex[currentdigit - 1]];
+      const o2::trd::Digit* after = &digits[digitsIndex[currentdigit + 1]];
+      uint32_t suma = before->getADCsum();
+      uint32_t sumb = mid->getADCsum();
+      uint32_t sumc = after->getADCsum();
+      if (!isChamberToBeIgnored(sm, stack, layer)) {
+        if (det1 == det2 && det2 == det3 && row1 == row2 && row2 == row3 && col1 + 1 == col2 && col2 + 1 == col3) {
+          if (sumb > suma && sumb > sumc) {
+            if (suma > sumc) {
+              tbmax = sumb;
+              tbhi = suma;
+              tblo = sumc;
+              if (tblo > mPulseHeightThreshold) {
+                int phVal = 0;
+                for (int tb = 0; tb < 30; tb++) {
+                  phVal = (mid->getADC()[tb] + before->getADC()[tb] + after->getADC()[tb]);
+                  // TODO do we have a corresponding tracklet?
+                  mPulseHeight->Fill(tb, phVal);
+                  mTotalPulseHeight2D->Fill(tb, phVal);
+                  mPulseHeight2DperSM[sector]->Fill(tb, phVal);
+                  mPulseHeightpro->Fill(tb, phVal);
+                  mPulseHeight2DperSM[sector]->Fill(tb, phVal);
+                  mPulseHeightperchamber->Fill(tb, det1, phVal);
+                  // mPulseHeightPerChamber_1D[det1]->Fill(tb, phVal);
+                  if (mNoiseMap != nullptr && !mNoiseMap->getIsNoisy(mid->getHCId(), mid->getROB(), mid->getMCM()))
+                    mPulseHeightn->Fill(tb, phVal);
                 }
-                mClusterAmplitudeChamber->Fill(sum, chamber);
-
-                mClsSector->Fill(sm, sum);
-                mClsStack->Fill(stack, sum);
-
-                // This is pulseheight lifted from run2, probably not what was used.
-                mClsChargeTbTigg->Fill(time, sum);
-
-              } // if consecutive adc ( 3 next to each other and we are on the middle on
-            }   // loop over time-bins
-          }     // loop over col-pads
-
-          const o2::trd::Digit* mid = &digits[digitsIndex[currentdigit]];
-          const o2::trd::Digit* before = &digits[digitsIndex[currentdigit - 1]];
-          const o2::trd::Digit* after = &digits[digitsIndex[currentdigit + 1]];
-          uint32_t suma = before->getADCsum();
-          uint32_t sumb = mid->getADCsum();
-          uint32_t sumc = after->getADCsum();
-          if (!isChamberToBeIgnored(sm, stack, layer)) {
-            if (det1 == det2 && det2 == det3 && row1 == row2 && row2 == row3 && col1 + 1 == col2 && col2 + 1 == col3) {
-              if (sumb > suma && sumb > sumc) {
-                if (suma > sumc) {
-                  tbmax = sumb;
-                  tbhi = suma;
-                  tblo = sumc;
-                  if (tblo > mPulseHeightThreshold) {
-                    int phVal = 0;
-                    for (int tb = 0; tb < 30; tb++) {
-                      phVal = (mid->getADC()[tb] + before->getADC()[tb] + after->getADC()[tb]);
-                      // TODO do we have a corresponding tracklet?
-                      mPulseHeight->Fill(tb, phVal);
-                      mTotalPulseHeight2D->Fill(tb, phVal);
-                      mPulseHeight2DperSM[sector]->Fill(tb, phVal);
-                      mPulseHeightpro->Fill(tb, phVal);
-                      mPulseHeight2DperSM[sector]->Fill(tb, phVal);
-                      mPulseHeightperchamber->Fill(tb, det1, phVal);
-                      // mPulseHeightPerChamber_1D[det1]->Fill(tb, phVal);
-                      if (mNoiseMap != nullptr && !mNoiseMap->getIsNoisy(mid->getHCId(), mid->getROB(), mid->getMCM()))
-                        mPulseHeightn->Fill(tb, phVal);
-                    }
-                  }
-                } else {
-                  tbmax = sumb;
-                  tblo = suma;
-                  tbhi = sumc;
-                  if (tblo > mPulseHeightThreshold) {
-                    int phVal = 0;
-                    for (int tb = 0; tb < 30; tb++) {
-                      phVal = (mid->getADC()[tb] + before->getADC()[tb] + after->getADC()[tb]);
-                      mPulseHeight->Fill(tb, phVal);
-                      mTotalPulseHeight2D->Fill(tb, phVal);
-                      mPulseHeight2DperSM[sector]->Fill(tb, phVal);
-                      mPulseHeightpro->Fill(tb, phVal);
-                      mPulseHeight2DperSM[sector]->Fill(tb, phVal);
-                      mPulseHeightperchamber->Fill(tb, det1, phVal);
-                      // mPulseHeightPerChamber_1D[det1]->Fill(tb, phVal);
-                      if (mNoiseMap != nullptr && !mNoiseMap->getIsNoisy(mid->getHCId(), mid->getROB(), mid->getMCM()))
-                        mPulseHeightn->Fill(tb, phVal);
-                    }
-                  }
+              }
+            } else {
+              tbmax = sumb;
+              tblo = suma;
+              tbhi = sumc;
+              if (tblo > mPulseHeightThreshold) {
+                int phVal = 0;
+                for (int tb = 0; tb < 30; tb++) {
+                  phVal = (mid->getADC()[tb] + before->getADC()[tb] + after->getADC()[tb]);
+                  mPulseHeight->Fill(tb, phVal);
+                  mTotalPulseHeight2D->Fill(tb, phVal);
+                  mPulseHeight2DperSM[sector]->Fill(tb, phVal);
+                  mPulseHeightpro->Fill(tb, phVal);
+                  mPulseHeight2DperSM[sector]->Fill(tb, phVal);
+                  mPulseHeightperchamber->Fill(tb, det1, phVal);
+                  // mPulseHeightPerChamber_1D[det1]->Fill(tb, phVal);
+                  if (mNoiseMap != nullptr && !mNoiseMap->getIsNoisy(mid->getHCId(), mid->getROB(), mid->getMCM()))
+                    mPulseHeightn->Fill(tb, phVal);
                 }
-              } // end else
-            }   // end if 3 pads next to each other
-          }     // end for c
-        }
-      } // end for r
-
-      mEventswDigitsPerTimeFrame->Fill(DigitTrig);
+              }
+            }
+          } // end else
+        }   // end if 3 pads next to each other
+      }     // end for c
+    }
+  } // end for r
 
-    } // end for d
-  }   // for loop over digits
-} // loop over triggers
+  mEventswDigitsPerTimeFrame->Fill(DigitTrig);
+}
 
 void DigitsTask::endOfCycle()
 {
@@ -360,67 +360,62 @@ void TrackletsTask::startOfCycle()
 
 void TrackletsTask::monitorData(o2::framework::ProcessingContext& ctx)
 {
-  for (auto&& input : ctx.inputs()) {
-    if (input.header != nullptr && input.payload != nullptr) {
-
-      auto digits = ctx.inputs().get<gsl::span<o2::trd::Digit>>("digits");
-      auto tracklets = ctx.inputs().get<gsl::span<o2::trd::Tracklet64>>("tracklets");
-      auto triggerrecords = ctx.inputs().get<gsl::span<o2::trd::TriggerRecord>>("triggers");
-      // std::cout << "Tracklets per time frame: " << tracklets.size();
-      mTrackletsPerTimeFrame->Fill(tracklets.size());
-      mTrackletsPerTimeFrameCycled->Fill(tracklets.size());
-      mTriggersPerTimeFrame->Fill(triggerrecords.size());
-      for (auto& trigger : triggerrecords) {
-        mTrackletsPerEvent->Fill(trigger.getNumberOfTracklets());
-        if (trigger.getNumberOfTracklets() == 0) {
-          continue; // bail if we have no digits in this trigger
-        }
-        // now sort digits to det,row,pad
-        for (int currenttracklet = trigger.getFirstTracklet(); currenttracklet < trigger.getFirstTracklet() + trigger.getNumberOfTracklets() - 1; ++currenttracklet) {
-          int detector = tracklets[currenttracklet].getDetector();
-          int sm = detector / 30;
-          int detLoc = detector % 30;
-          int layer = detector % 6;
-          int istack = detLoc / 6;
-          int iChamber = sm * 30 + istack * o2::trd::constants::NLAYER + layer;
-          int stackoffset = istack * o2::trd::constants::NSTACK * o2::trd::constants::NROBC1;
-          if (istack >= 2) {
-            stackoffset -= 2; // only 12in stack 2
-          }
-          // 8 rob x 16 mcm each per chamber
-          //  5 stack(y), 6 layers(x)
-          //  y=stack_rob, x=layer_mcm
-          int x = o2::trd::constants::NMCMROB * layer + tracklets[currenttracklet].getMCM();
-          int y = o2::trd::constants::NROBC1 * istack + tracklets[currenttracklet].getROB();
-          if (mNoiseMap != nullptr && mNoiseMap->isTrackletFromNoisyMCM(tracklets[currenttracklet])) {
-            moHCMCMn[sm]->Fill(x, y);
-            mTrackletSlopen->Fill(tracklets[currenttracklet].getUncalibratedDy());
-            mTrackletSlopeRawn->Fill(tracklets[currenttracklet].getSlope());
-            mTrackletPositionn->Fill(tracklets[currenttracklet].getUncalibratedY());
-            mTrackletPositionRawn->Fill(tracklets[currenttracklet].getPosition());
-            mTrackletHCIDn->Fill(tracklets[currenttracklet].getHCID());
-          } else {
-            moHCMCM[sm]->Fill(x, y);
-            mTrackletSlope->Fill(tracklets[currenttracklet].getUncalibratedDy());
-            mTrackletSlopeRaw->Fill(tracklets[currenttracklet].getSlope());
-            mTrackletPosition->Fill(tracklets[currenttracklet].getUncalibratedY());
-            mTrackletPositionRaw->Fill(tracklets[currenttracklet].getPosition());
-            mTrackletHCID->Fill(tracklets[currenttracklet].getHCID());
-            mTrackletQ[0]->Fill(tracklets[currenttracklet].getQ0());
-            mTrackletQ[1]->Fill(tracklets[currenttracklet].getQ1());
-            mTrackletQ[2]->Fill(tracklets[currenttracklet].getQ2());
-            mTrackletQ0perSector[sm]->Fill(tracklets[currenttracklet].getQ0());
-            mTrackletQ1perSector[sm]->Fill(tracklets[currenttracklet].getQ1());
-            mTrackletQ2perSector[sm]->Fill(tracklets[currenttracklet].getQ2());
-          }
-          int side = tracklets[currenttracklet].getHCID() % 2; // 0: A-side, 1: B-side
-          int stack = (detector % 30) / 6;
-          int sec = detector / 30;
-          int rowGlb = stack < 3 ? tracklets[currenttracklet].getPadRow() + stack * 16 : tracklets[currenttracklet].getPadRow() + 44 + (stack - 3) * 16; // pad row within whole sector
-          int colGlb = tracklets[currenttracklet].getColumn() + sec * 8 + side * 4;
-          mLayers[layer]->Fill(rowGlb, colGlb);
-        }
+  // the inputs are read once per TF and used in place
+  auto tracklets = ctx.inputs().get<gsl::span<o2::trd::Tracklet64>>("tracklets");
+  auto triggerrecords = ctx.inputs().get<gsl::span<o2::trd::TriggerRecord>>("triggers");
+  // std::cout << "Tracklets per time frame: " << tracklets.size();
+  mTrackletsPerTimeFrame->Fill(tracklets.size());
+  mTrackletsPerTimeFrameCycled->Fill(tracklets.size());
+  mTriggersPerTimeFrame->Fill(triggerrecords.size());
+  for (auto& trigger : triggerrecords) {
+    mTrackletsPerEvent->Fill(trigger.getNumberOfTracklets());
+    if (trigger.getNumberOfTracklets() == 0) {
+      continue; // bail if we have no digits in this trigger
+    }
+    // now sort digits to det,row,pad
+    for (int currenttracklet = trigger.getFirstTracklet(); currenttracklet < trigger.getFirstTracklet() + trigger.getNumberOfTracklets() - 1; ++currenttracklet) {
+      int detector = tracklets[currenttracklet].getDetector();
+      int sm = detector / 30;
+      int detLoc = detector % 30;
+      int layer = detector % 6;
+      int istack = detLoc / 6;
+      int iChamber = sm * 30 + istack * o2::trd::constants::NLAYER + layer;
+      int stackoffset = istack * o2::trd::constants::NSTACK * o2::trd::constants::NROBC1;
+      if (istack >= 2) {
+        stackoffset -= 2; // only 12in stack 2
+      }
+      // 8 rob x 16 mcm each per chamber
+      //  5 stack(y), 6 layers(x)
+      //  y=stack_rob, x=layer_mcm
+      int x = o2::trd::constants::NMCMROB * layer + tracklets[currenttracklet].getMCM();
+      int y = o2::trd::constants::NROBC1 * istack + tracklets[currenttracklet].getROB();
+      if (mNoiseMap != nullptr && mNoiseMap->isTrackletFromNoisyMCM(tracklets[currenttracklet])) {
+        moHCMCMn[sm]->Fill(x, y);
+        mTrackletSlopen->Fill(tracklets[currenttracklet].getUncalibratedDy());
+        mTrackletSlopeRawn->Fill(tracklets[currenttracklet].getSlope());
+        mTrackletPositionn->Fill(tracklets[currenttracklet].getUncalibratedY());
+        mTrackletPositionRawn->Fill(tracklets[currenttracklet].getPosition());
+        mTrackletHCIDn->Fill(tracklets[currenttracklet].getHCID());
+      } else {
+        moHCMCM[sm]->Fill(x, y);
+        mTrackletSlope->Fill(tracklets[currenttracklet].getUncalibratedDy());
+        mTrackletSlopeRaw->Fill(tracklets[currenttracklet].getSlope());
+        mTrackletPosition->Fill(tracklets[currenttracklet].getUncalibratedY());
+        mTrackletPositionRaw->Fill(tracklets[currenttracklet].getPosition());
+        mTrackletHCID->Fill(tracklets[currenttracklet].getHCID());
+        mTrackletQ[0]->Fill(tracklets[currenttracklet].getQ0());
+        mTrackletQ[1]->Fill(tracklets[currenttracklet].getQ1());
+        mTrackletQ[2]->Fill(tracklets[currenttracklet].getQ2());
+        mTrackletQ0perSector[sm]->Fill(tracklets[currenttracklet].getQ0());
+        mTrackletQ1perSector[sm]->Fill(tracklets[currenttracklet].getQ1());
+        mTrackletQ2perSector[sm]->Fill(tracklets[currenttracklet].getQ2());
       }
+      int side = tracklets[currenttracklet].getHCID() % 2; // 0: A-side, 1: B-side
+      int stack = (detector % 30) / 6;
+      int sec = detector / 30;
+      int rowGlb = stack < 3 ? tracklets[currenttracklet].getPadRow() + stack * 16 : tracklets[currenttracklet].getPadRow() + 44 + (stack - 3) * 16; // pad row within whole sector
+      int colGlb = tracklets[currenttracklet].getColumn() + sec * 8 + side * 4;
+      mLayers[layer]->Fill(rowGlb, colGlb);
     }
   }
 }
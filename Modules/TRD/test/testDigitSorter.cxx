@@ -0,0 +1,78 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testDigitSorter.cxx
+///
+
+#include "TRD/DigitSorter.h"
+#include "DataFormatsTRD/Constants.h"
+
+#define BOOST_TEST_MODULE DigitSorter test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <random>
+#include <tuple>
+
+using namespace o2::quality_control_modules::trd;
+using o2::trd::Digit;
+
+namespace
+{
+auto asTuple(const Digit& d)
+{
+  return std::make_tuple(d.getDetector(), d.getPadRow(), d.getPadCol());
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_sort)
+{
+  // trigger records on both sides of the size from which the radix sort is used, the digits being in random order
+  const std::vector<size_t> triggerSizes{ 0, 1, 2, 100, 255, 256, 1000, 3 };
+  std::mt19937 generator(1234);
+  std::uniform_int_distribution<int> detector(0, o2::trd::constants::MAXCHAMBER - 1);
+  std::uniform_int_distribution<int> row(0, o2::trd::constants::NROWC1 - 1);
+  std::uniform_int_distribution<int> col(0, o2::trd::constants::NCOLUMN - 1);
+  std::vector<Digit> digits;
+  std::vector<std::pair<size_t, size_t>> triggers; // first digit and number of digits
+  for (auto n : triggerSizes) {
+    triggers.emplace_back(digits.size(), n);
+    for (size_t d = 0; d < n; d++) {
+      digits.emplace_back(detector(generator), row(generator), col(generator), o2::trd::ArrayADC{});
+    }
+  }
+  // an invalid detector is sorted last
+  digits[triggers[3].first].setDetector(-1);
+  digits[triggers[6].first].setDetector(-1);
+
+  DigitSorter sorter;
+  sorter.reset(digits);
+  for (const auto& [first, count] : triggers) {
+    sorter.sort(first, count);
+    std::vector<unsigned int> used;
+    for (size_t i = first; i < first + count; i++) {
+      BOOST_REQUIRE_GE(sorter[i], first);
+      BOOST_REQUIRE_LT(sorter[i], first + count);
+      used.push_back(sorter[i]);
+      if (i > first) {
+        BOOST_REQUIRE(DigitSorter::key(digits[sorter[i - 1]]) <= DigitSorter::key(digits[sorter[i]]));
+        if (digits[sorter[i]].getDetector() >= 0) {
+          BOOST_REQUIRE(asTuple(digits[sorter[i - 1]]) <= asTuple(digits[sorter[i]]));
+        }
+      }
+    }
+    std::sort(used.begin(), used.end());
+    BOOST_REQUIRE(std::adjacent_find(used.begin(), used.end()) == used.end());
+  }
+}
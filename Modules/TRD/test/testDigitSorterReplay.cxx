@@ -0,0 +1,103 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testDigitSorterReplay.cxx
+///
+
+#include "TRD/DigitSorter.h"
+#include "DataFormatsTRD/Constants.h"
+
+#define BOOST_TEST_MODULE DigitSorter replay
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <tuple>
+
+using namespace o2::quality_control_modules::trd;
+using o2::trd::Digit;
+
+namespace
+{
+struct RecordedTF {
+  std::vector<Digit> digits;
+  std::vector<std::pair<size_t, size_t>> triggers; // first digit and number of digits
+};
+
+/// TFs with trigger records of various sizes, the digits of a trigger record being in random order
+std::vector<RecordedTF> recordTFs(size_t nTFs, size_t nTriggers, size_t maxDigitsPerTrigger)
+{
+  std::mt19937 generator(1234);
+  std::uniform_int_distribution<int> detector(0, o2::trd::constants::MAXCHAMBER - 1);
+  std::uniform_int_distribution<int> row(0, o2::trd::constants::NROWC1 - 1);
+  std::uniform_int_distribution<int> col(0, o2::trd::constants::NCOLUMN - 1);
+  std::uniform_int_distribution<size_t> size(0, maxDigitsPerTrigger);
+  std::vector<RecordedTF> tfs(nTFs);
+  for (auto& tf : tfs) {
+    for (size_t t = 0; t < nTriggers; t++) {
+      size_t n = size(generator);
+      tf.triggers.emplace_back(tf.digits.size(), n);
+      for (size_t d = 0; d < n; d++) {
+        tf.digits.emplace_back(detector(generator), row(generator), col(generator), o2::trd::ArrayADC{});
+      }
+    }
+  }
+  return tfs;
+}
+
+auto asTuple(const Digit& d)
+{
+  return std::make_tuple(d.getDetector(), d.getPadRow(), d.getPadCol());
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_replay_tfs)
+{
+  // The per TF latency of the preparation of the digits in DigitsTask: a copy of the span and a std::sort of the
+  // indices of each trigger record, as done before, against DigitSorter.
+  auto tfs = recordTFs(10, 200, 3000);
+
+  auto start = std::chrono::steady_clock::now();
+  size_t checksumBefore = 0;
+  for (const auto& tf : tfs) {
+    gsl::span<const Digit> digits(tf.digits);
+    std::vector<Digit> digitv(digits.begin(), digits.end());
+    std::vector<unsigned int> digitsIndex(digitv.size());
+    std::iota(digitsIndex.begin(), digitsIndex.end(), 0);
+    for (const auto& [first, count] : tf.triggers) {
+      std::sort(digitsIndex.begin() + first, digitsIndex.begin() + first + count,
+                [&digitv](unsigned int i, unsigned int j) { return asTuple(digitv[i]) < asTuple(digitv[j]); });
+      checksumBefore += count > 0 ? DigitSorter::key(digitv[digitsIndex[first]]) : 0;
+    }
+  }
+  auto sortDone = std::chrono::steady_clock::now();
+
+  DigitSorter sorter;
+  size_t checksumAfter = 0;
+  for (const auto& tf : tfs) {
+    sorter.reset(tf.digits);
+    for (const auto& [first, count] : tf.triggers) {
+      sorter.sort(first, count);
+      checksumAfter += count > 0 ? DigitSorter::key(tf.digits[sorter[first]]) : 0;
+    }
+  }
+  auto sorterDone = std::chrono::steady_clock::now();
+
+  using ms = std::chrono::duration<double, std::milli>;
+  BOOST_TEST_MESSAGE("per TF latency, copy and std::sort: " << ms(sortDone - start).count() / tfs.size()
+                                                            << " ms, DigitSorter: " << ms(sorterDone - sortDone).count() / tfs.size() << " ms");
+  BOOST_CHECK_EQUAL(checksumBefore, checksumAfter);
+}
@@ -0,0 +1,76 @@
+// Copyright 2019-2022 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   IdleWordScanner.h
+///
+
+#ifndef QC_MODULE_ZDC_IDLEWORDSCANNER_H
+#define QC_MODULE_ZDC_IDLEWORDSCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace o2::quality_control_modules::zdc
+{
+
+/// \brief Returns the position of the first byte in [begin, end) which is not 0xff, or end if there is none.
+/// The idle padding of the raw pages is skipped 16 bytes at a time when SSE2 is available, 8 bytes at a time otherwise.
+inline size_t findFirstNonIdleByte(const uint8_t* data, size_t begin, size_t end)
+{
+  size_t i = begin;
+#ifdef __SSE2__
+  const __m128i idle = _mm_set1_epi8(static_cast<char>(0xff));
+  for (; i + 16 <= end; i += 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, idle)));
+    if (mask != 0xffff) {
+      return i + __builtin_ctz(~mask);
+    }
+  }
+#endif
+  for (; i + 8 <= end; i += 8) {
+    uint64_t block;
+    std::memcpy(&block, data + i, sizeof(block));
+    if (block != ~uint64_t(0)) {
+      break;
+    }
+  }
+  for (; i < end; ++i) {
+    if (data[i] != 0xff) {
+      return i;
+    }
+  }
+  return end;
+}
+
+/// \brief Returns the offset of the first GBT word at or after offset which is not idle, i.e. not entirely made of 0xff.
+/// The words are wordSize bytes long and start every wordSize bytes from offset. If all the remaining words are idle,
+/// the returned offset is such that offset + wordSize > size.
+inline size_t findNextNonIdleWord(const uint8_t* payload, size_t offset, size_t size, size_t wordSize)
+{
+  const size_t nWords = offset < size ? (size - offset) / wordSize : 0;
+  const size_t scanEnd = offset + nWords * wordSize;
+  const size_t firstNonIdle = findFirstNonIdleByte(payload, offset, scanEnd);
+  if (firstNonIdle == scanEnd) {
+    return scanEnd;
+  }
+  // the word which contains the first non-idle byte, all the words before are idle
+  return offset + (firstNonIdle - offset) / wordSize * wordSize;
+}
+
+} // namespace o2::quality_control_modules::zdc
+
+#endif // QC_MODULE_ZDC_IDLEWORDSCANNER_H
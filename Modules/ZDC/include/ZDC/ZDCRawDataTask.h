@@ -23,6 +23,8 @@
 #include "ZDCBase/Constants.h"
 #include "ZDCSimulation/ZDCSimParam.h"
 #include "DataFormatsZDC/RawEventData.h"
+#include "Common/CounterArray.h"
+#include <array>
 #include <string>
 #include <vector>
 
@@ -69,6 +71,8 @@ class ZDCRawDataTask final : public TaskInterface
   int process(const o2::zdc::EventData& ev);
   int process(const o2::zdc::EventChData& ch);
   int processWord(const uint32_t* word);
+  /// Adds the trigger bits counted since the last call to fTriggerBits and fTriggerBitsHits
+  void fillTriggerBits();
   int getHPos(uint32_t board, uint32_t ch, int matrix[o2::zdc::NModules][o2::zdc::NChPerModule]);
   std::string getNameChannel(int imod, int ich);
   void setNameChannel(int imod, int ich, std::string namech);
@@ -114,8 +118,21 @@ class ZDCRawDataTask final : public TaskInterface
   int getVerbosity() const { return mVerbosity; }
 
  private:
+  static constexpr int sNTriggerBits = 10; // "None", Auto_m, Auto_0-3, Alice_0-3
+  static constexpr int sNTriggerChannels = o2::zdc::NModules * o2::zdc::NChPerModule;
+  using TriggerBitCounters = std::array<o2::quality_control_modules::common::CounterArray<sNTriggerChannels, uint64_t>, sNTriggerBits>;
+
   int mVerbosity = 1;
 
+  // raw pages which could not be decoded, exported as metrics
+  uint64_t mNofPagesWithoutRdh = 0;
+  uint64_t mNofPagesWithoutPayload = 0;
+  uint64_t mNofEmptyPages = 0;
+
+  // occurrences of each trigger bit, one row of the histograms per bit, indexed by 4 * board + channel
+  TriggerBitCounters mTriggerBitCounts;
+  TriggerBitCounters mTriggerBitHitCounts;
+
   o2::zdc::EventChData mCh;
   std::string fNameChannel[o2::zdc::NModules][o2::zdc::NChPerModule];
   std::vector<infoHisto1D> fMatrixHistoBaseline[o2::zdc::NModules][o2::zdc::NChPerModule];
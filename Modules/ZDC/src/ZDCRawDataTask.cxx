@@ -19,8 +19,10 @@
 
 #include "QualityControl/QcInfoLogger.h"
 #include "ZDC/ZDCRawDataTask.h"
+#include "ZDC/IdleWordScanner.h"
 #include <Framework/InputRecord.h>
 #include <Framework/InputRecordWalker.h>
+#include <Monitoring/Monitoring.h>
 #include "DPLUtils/DPLRawParser.h"
 #include <TROOT.h>
 #include <TPad.h>
@@ -72,6 +74,9 @@ void ZDCRawDataTask::startOfActivity(Activity& activity)
   ILOG(Debug, Devel) << "startOfActivity" << activity.mId << ENDM;
   // reset for all object
   reset();
+  mNofPagesWithoutRdh = 0;
+  mNofPagesWithoutPayload = 0;
+  mNofEmptyPages = 0;
 }
 
 void ZDCRawDataTask::startOfCycle()
@@ -82,45 +87,33 @@ void ZDCRawDataTask::startOfCycle()
 void ZDCRawDataTask::monitorData(o2::framework::ProcessingContext& ctx)
 {
   o2::framework::DPLRawParser parser(ctx.inputs());
-  int PayloadPerGBTW = 10;
+  size_t PayloadPerGBTW = 10;
   int dataFormat;
-  const uint32_t* gbtw;
-  uint64_t count = 0;
   size_t payloadSize;
-  size_t offset;
-  static uint64_t nErr[3] = { 0 };
 
   for (auto it = parser.begin(), end = parser.end(); it != end; ++it) {
     auto rdhPtr = reinterpret_cast<const o2::header::RDHAny*>(it.raw());
     if (rdhPtr == nullptr || !o2::raw::RDHUtils::checkRDH(rdhPtr, true)) {
-      nErr[0]++;
-      /*if (nErr[0] < 5) {
-        LOG(warning) << "ZDCDataReaderDPLSpec::run - Missing RAWDataHeader on page " << count;
-      } else if (nErr[0] == 5) {
-        LOG(warning) << "ZDCDataReaderDPLSpec::run - Missing RAWDataHeader on page " << count << " suppressing further messages";
-      }*/
+      mNofPagesWithoutRdh++;
     } else {
       if (it.data() == nullptr) {
-        nErr[1]++;
+        mNofPagesWithoutPayload++;
       } else if (it.size() == 0) {
-        nErr[2]++;
+        mNofEmptyPages++;
       } else {
         // retrieving payload pointer of the page
-        auto const* payload = it.data();
+        auto const* payload = reinterpret_cast<const uint8_t*>(it.data());
         // size of payload
         payloadSize = it.size();
-        // offset of payload in the raw page
-        offset = it.offset();
         dataFormat = o2::raw::RDHUtils::getDataFormat(rdhPtr);
         if (dataFormat == 2) {
-          for (int32_t ip = 0; (ip + PayloadPerGBTW) <= payloadSize; ip += PayloadPerGBTW) {
-            gbtw = (const uint32_t*)&payload[ip];
-            if (gbtw[0] != 0xffffffff || gbtw[1] != 0xffffffff || (gbtw[2] & 0xffff) != 0xffff) {
-              processWord(gbtw);
-            }
+          // the idle words (0xff padding) are skipped in bulk, only the words carrying data are decoded
+          for (size_t ip = findNextNonIdleWord(payload, 0, payloadSize, PayloadPerGBTW); ip + PayloadPerGBTW <= payloadSize;
+               ip = findNextNonIdleWord(payload, ip + PayloadPerGBTW, payloadSize, PayloadPerGBTW)) {
+            processWord((const uint32_t*)&payload[ip]);
           }
         } else if (dataFormat == 0) {
-          for (int32_t ip = 0; ip < (int32_t)payloadSize; ip += 16) {
+          for (size_t ip = 0; ip < payloadSize; ip += 16) {
             processWord((const uint32_t*)&payload[ip]);
           }
         }
@@ -132,6 +125,13 @@ void ZDCRawDataTask::monitorData(o2::framework::ProcessingContext& ctx)
 void ZDCRawDataTask::endOfCycle()
 {
   ILOG(Debug, Devel) << "endOfCycle" << ENDM;
+  fillTriggerBits();
+  if (mMonitoring) {
+    mMonitoring->send(o2::monitoring::Metric{ "zdc_raw_errors" }
+                        .addValue(mNofPagesWithoutRdh, "pages_without_rdh")
+                        .addValue(mNofPagesWithoutPayload, "pages_without_payload")
+                        .addValue(mNofEmptyPages, "empty_pages"));
+  }
 }
 
 void ZDCRawDataTask::endOfActivity(Activity& /*activity*/)
@@ -186,6 +186,10 @@ void ZDCRawDataTask::reset()
     fTriggerBits->Reset();
   if (fTriggerBitsHits)
     fTriggerBitsHits->Reset();
+  for (int ib = 0; ib < sNTriggerBits; ib++) {
+    mTriggerBitCounts[ib].reset();
+    mTriggerBitHitCounts[ib].reset();
+  }
   if (fDataLoss)
     fDataLoss->Reset();
   if (fOverBc)
@@ -570,68 +574,18 @@ int ZDCRawDataTask::process(const o2::zdc::EventChData& ch)
       }
     }
   }
-  if ((f.Alice_0 || f.Auto_0 || f.Alice_1 || f.Auto_1 || f.Alice_2 || f.Auto_2 || f.Alice_3 || f.Auto_3 || f.Auto_m) && fTriggerBits && fTriggerBitsHits) {
-    if (f.Alice_3) {
-      fTriggerBits->Fill(itb, 9);
-      if (f.Hit) {
-        if (f.Hit)
-          fTriggerBitsHits->Fill(itb, 9);
-      }
-    }
-    if (f.Alice_2) {
-      fTriggerBits->Fill(itb, 8);
-      if (f.Hit) {
-        fTriggerBitsHits->Fill(itb, 8);
-      }
-    }
-    if (f.Alice_1) {
-      fTriggerBits->Fill(itb, 7);
-      if (f.Hit) {
-        fTriggerBitsHits->Fill(itb, 7);
-      }
-    }
-    if (f.Alice_0) {
-      fTriggerBits->Fill(itb, 6);
-      if (f.Hit) {
-        fTriggerBitsHits->Fill(itb, 6);
-      }
-    }
-    if (f.Auto_3) {
-      fTriggerBits->Fill(itb, 5);
-      if (f.Hit) {
-        fTriggerBitsHits->Fill(itb, 5);
-      }
-    }
-    if (f.Auto_2) {
-      fTriggerBits->Fill(itb, 4);
-      if (f.Hit) {
-        fTriggerBitsHits->Fill(itb, 4);
-      }
-    }
-    if (f.Auto_1) {
-      fTriggerBits->Fill(itb, 3);
-      if (f.Hit) {
-        fTriggerBitsHits->Fill(itb, 3);
-      }
-    }
-    if (f.Auto_0) {
-      fTriggerBits->Fill(itb, 2);
-      if (f.Hit) {
-        fTriggerBitsHits->Fill(itb, 2);
-      }
-    }
-    if (f.Auto_m) {
-      fTriggerBits->Fill(itb, 1);
-      if (f.Hit) {
-        fTriggerBitsHits->Fill(itb, 1);
-      }
-    }
+  // Trigger bits, counted here and added to the histograms at the end of the cycle.
+  // The index of each bit is the y coordinate of its bin, 0 stands for no bit set.
+  uint32_t triggerBits = (f.Auto_m << 1) | (f.Auto_0 << 2) | (f.Auto_1 << 3) | (f.Auto_2 << 4) | (f.Auto_3 << 5) |
+                         (f.Alice_0 << 6) | (f.Alice_1 << 7) | (f.Alice_2 << 8) | (f.Alice_3 << 9);
+  if (triggerBits == 0) {
+    triggerBits = 1;
   }
-  if (!(f.Alice_3 || f.Alice_2 || f.Alice_1 || f.Alice_0 || f.Alice_1 || f.Auto_3 || f.Auto_2 || f.Auto_1 || f.Auto_0 || f.Auto_m)) {
-    if (fTriggerBits && fTriggerBitsHits) {
-      fTriggerBits->Fill(itb, 0);
-      if (f.Hit)
-        fTriggerBitsHits->Fill(itb, 0);
+  if (itb < sNTriggerChannels) {
+    for (; triggerBits != 0; triggerBits &= triggerBits - 1) {
+      int ib = __builtin_ctz(triggerBits);
+      mTriggerBitCounts[ib].count(itb);
+      mTriggerBitHitCounts[ib].add(itb, f.Hit);
     }
   }
   // Bunch
@@ -686,6 +640,58 @@ int ZDCRawDataTask::process(const o2::zdc::EventChData& ch)
   return 0;
 }
 
+void ZDCRawDataTask::fillTriggerBits()
+{
+  // true if each of the values 0 to nValues - 1 falls in its own bin, the bin number being the value + 1
+  auto hasOneBinPerValue = [](const TAxis* axis, int nValues) {
+    if (axis->GetNbins() != nValues) {
+      return false;
+    }
+    for (int i = 0; i < nValues; i++) {
+      if (axis->FindFixBin(i) != i + 1) {
+        return false;
+      }
+    }
+    return true;
+  };
+  auto fill = [&](TH2* histo, TriggerBitCounters& counters) {
+    if (histo == nullptr) {
+      for (auto& counter : counters) {
+        counter.reset();
+      }
+      return;
+    }
+    if (hasOneBinPerValue(histo->GetXaxis(), sNTriggerChannels) && hasOneBinPerValue(histo->GetYaxis(), sNTriggerBits)) {
+      for (int ib = 0; ib < sNTriggerBits; ib++) {
+        counters[ib].addTo(histo, ib + 1);
+        counters[ib].reset();
+      }
+      return;
+    }
+    // The binning is configurable, we look for the bin of each channel and bit as Fill(itb, ib) would.
+    double entries = histo->GetEntries();
+    for (int ib = 0; ib < sNTriggerBits; ib++) {
+      for (int itb = 0; itb < sNTriggerChannels; itb++) {
+        auto count = counters[ib].get(itb);
+        if (count == 0) {
+          continue;
+        }
+        int bin = histo->GetBin(histo->GetXaxis()->FindBin(itb), histo->GetYaxis()->FindBin(ib));
+        histo->AddBinContent(bin, count);
+        if (histo->GetSumw2N() > 0) {
+          histo->GetSumw2()->fArray[bin] += count;
+        }
+        entries += count;
+      }
+      counters[ib].reset();
+    }
+    histo->ResetStats();
+    histo->SetEntries(entries);
+  };
+  fill(fTriggerBits, mTriggerBitCounts);
+  fill(fTriggerBitsHits, mTriggerBitHitCounts);
+}
+
 int ZDCRawDataTask::process(const o2::zdc::EventData& ev)
 {
   for (int32_t im = 0; im < o2::zdc::NModules; im++) {
@@ -0,0 +1,133 @@
+// Copyright 2019-2022 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testIdleWordScanner.cxx
+///
+
+#include "ZDC/IdleWordScanner.h"
+
+#define BOOST_TEST_MODULE IdleWordScanner test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace o2::quality_control_modules::zdc
+{
+
+constexpr size_t wordSize = 10;
+
+// the selection done by ZDCRawDataTask before the bulk scan
+std::vector<size_t> nonIdleWordsScalar(const std::vector<uint8_t>& page)
+{
+  std::vector<size_t> offsets;
+  for (size_t ip = 0; ip + wordSize <= page.size(); ip += wordSize) {
+    bool idle = true;
+    for (size_t i = 0; i < wordSize; i++) {
+      idle = idle && page[ip + i] == 0xff;
+    }
+    if (!idle) {
+      offsets.push_back(ip);
+    }
+  }
+  return offsets;
+}
+
+std::vector<size_t> nonIdleWords(const std::vector<uint8_t>& page)
+{
+  std::vector<size_t> offsets;
+  for (size_t ip = findNextNonIdleWord(page.data(), 0, page.size(), wordSize); ip + wordSize <= page.size();
+       ip = findNextNonIdleWord(page.data(), ip + wordSize, page.size(), wordSize)) {
+    offsets.push_back(ip);
+  }
+  return offsets;
+}
+
+// a page of nWords words, the first nData carry random data, the others are idle
+std::vector<uint8_t> makePage(size_t nWords, size_t nData, std::mt19937& gen)
+{
+  std::vector<uint8_t> page(nWords * wordSize, 0xff);
+  std::uniform_int_distribution<int> byte(0, 255);
+  for (size_t i = 0; i < nData * wordSize; i++) {
+    page[i] = byte(gen);
+  }
+  return page;
+}
+
+BOOST_AUTO_TEST_CASE(find_first_non_idle_byte)
+{
+  std::vector<uint8_t> data(100, 0xff);
+  BOOST_CHECK_EQUAL(findFirstNonIdleByte(data.data(), 0, data.size()), data.size());
+  BOOST_CHECK_EQUAL(findFirstNonIdleByte(data.data(), 50, 50), 50);
+  for (size_t pos : { 0, 7, 8, 15, 16, 17, 63, 99 }) {
+    data[pos] = 0xfe;
+    BOOST_CHECK_EQUAL(findFirstNonIdleByte(data.data(), 0, data.size()), pos);
+    BOOST_CHECK_EQUAL(findFirstNonIdleByte(data.data(), pos + 1, data.size()), data.size());
+    // the end of the range is excluded
+    BOOST_CHECK_EQUAL(findFirstNonIdleByte(data.data(), 0, pos), pos);
+    data[pos] = 0xff;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(find_next_non_idle_word)
+{
+  std::vector<uint8_t> page(10 * wordSize + 4, 0xff); // a truncated word at the end is never selected
+  page[page.size() - 1] = 0;
+  BOOST_CHECK(nonIdleWords(page).empty());
+
+  page[3 * wordSize + 9] = 0;
+  page[7 * wordSize] = 0;
+  BOOST_CHECK(nonIdleWords(page) == (std::vector<size_t>{ 3 * wordSize, 7 * wordSize }));
+
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> flip(0, 3);
+  for (int i = 0; i < 100; i++) {
+    auto random = makePage(50, 50, gen);
+    for (size_t j = 0; j < random.size(); j++) {
+      // mostly idle bytes, such that some words are idle and some are not
+      random[j] = flip(gen) == 0 ? random[j] : 0xff;
+    }
+    BOOST_CHECK(nonIdleWords(random) == nonIdleWordsScalar(random));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(replay_benchmark)
+{
+  // Pages of 8 kB where a fraction of the GBT words carry data, the rest being the idle padding, which is what
+  // the task receives from the ZDC readout. Both the selections are run on the same pages and must agree.
+  std::mt19937 gen(1);
+  std::vector<std::vector<uint8_t>> pages;
+  for (int i = 0; i < 200; i++) {
+    pages.push_back(makePage(819, 819 * (i % 10) / 20, gen));
+  }
+
+  auto run = [&](auto selection) {
+    size_t nWords = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int repetition = 0; repetition < 20; repetition++) {
+      for (const auto& page : pages) {
+        nWords += selection(page).size();
+      }
+    }
+    std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+    return std::make_pair(nWords, duration.count());
+  };
+  auto [nScalar, durationScalar] = run(nonIdleWordsScalar);
+  auto [nBulk, durationBulk] = run(nonIdleWords);
+  BOOST_CHECK_EQUAL(nScalar, nBulk);
+  BOOST_TEST_MESSAGE("Selected " << nBulk << " words, word by word: " << durationScalar << " ms, bulk scan: " << durationBulk << " ms");
+}
+
+} // namespace o2::quality_control_modules::zdc